@@ -393,9 +393,9 @@ pvr::Result OGLESNavigation2D::initApplication()
 	setDepthBitsPerPixel(0);
 	setStencilBitsPerPixel(0);
 
-	// Load and process the map.
+	// Load the map processed by a previous run, or load and process the map.
 	_OSMdata.reset(new NavDataProcess(getAssetStream(MapFile), glm::ivec2(getWidth(), getHeight())));
-	pvr::Result result = _OSMdata->loadAndProcessData();
+	pvr::Result result = _OSMdata->loadAndProcessData(getWritePath() + getApplicationName() + ".navmap");
 
 	Log(LogLevel::Information, "MAP SIZE IS: [ %d x %d ] TILES", _OSMdata->getNumRows(), _OSMdata->getNumCols());
 
@@ -1009,6 +1009,44 @@ void OGLESNavigation2D::createBuffers()
 	// calculate the aspect ratio
 	// rescale the map with the aspect ratio
 
+	// Generate the vertices and indices of the tiles on all the threads, each tile only writes its own data
+	parallelFor(_numCols * _numRows, [&](uint32_t tileIndex) {
+		const uint32_t col = tileIndex / _numRows;
+		const uint32_t row = tileIndex % _numRows;
+		Tile& tile = _OSMdata->getTiles()[col][row];
+
+		// Create vertices for tile, in node id order
+		for (auto nodeIterator : tile.nodes.getSortedById())
+		{
+			nodeIterator->second.index = static_cast<uint32_t>(tile.vertices.size());
+
+			Tile::VertexData vertData(glm::vec3(remap(nodeIterator->second.coords, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[_numCols - 1][_numRows - 1].max,
+													-_mapWorldDim * .5, _mapWorldDim * .5),
+										  0.0f),
+				nodeIterator->second.texCoords);
+
+			tile.vertices.push_back(vertData);
+		}
+
+		auto& renderingResources = _tileRenderingResources[col][row];
+
+		// Add car parking to indices
+		renderingResources.properties.parkingNum = generateIndices(tile, tile.parkingWays);
+		// Add buildings to indices
+		renderingResources.properties.buildNum = generateIndices(tile, tile.buildWays);
+		// Add inner ways to indices
+		renderingResources.properties.innerNum = generateIndices(tile, tile.innerWays);
+		// Add road area ways to indices
+		renderingResources.properties.areaNum = generateIndices(tile, tile.areaWays);
+		// Add roads to indices
+		renderingResources.properties.serviceRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Service);
+		renderingResources.properties.otherRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Other);
+		renderingResources.properties.secondaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Secondary);
+		renderingResources.properties.primaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Primary);
+		renderingResources.properties.trunkRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Trunk);
+		renderingResources.properties.motorwayNum = generateIndices(tile, tile.roadWays, RoadTypes::Motorway);
+	});
+
 	for (uint32_t col = 0; col < _OSMdata->getTiles().size(); ++col)
 	{
 		auto& tileCol = _OSMdata->getTiles()[col];
@@ -1016,37 +1054,6 @@ void OGLESNavigation2D::createBuffers()
 		{
 			Tile& tile = tileCol[row];
 
-			// Create vertices for tile
-			for (auto nodeIterator = tile.nodes.begin(); nodeIterator != tile.nodes.end(); ++nodeIterator)
-			{
-				nodeIterator->second.index = static_cast<uint32_t>(tile.vertices.size());
-
-				Tile::VertexData vertData(glm::vec3(remap(nodeIterator->second.coords, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[_numCols - 1][_numRows - 1].max,
-														-_mapWorldDim * .5, _mapWorldDim * .5),
-											  0.0f),
-					nodeIterator->second.texCoords);
-
-				tile.vertices.push_back(vertData);
-			}
-
-			auto& renderingResources = _tileRenderingResources[col][row];
-
-			// Add car parking to indices
-			renderingResources.properties.parkingNum = generateIndices(tile, tile.parkingWays);
-			// Add buildings to indices
-			renderingResources.properties.buildNum = generateIndices(tile, tile.buildWays);
-			// Add inner ways to indices
-			renderingResources.properties.innerNum = generateIndices(tile, tile.innerWays);
-			// Add road area ways to indices
-			renderingResources.properties.areaNum = generateIndices(tile, tile.areaWays);
-			// Add roads to indices
-			renderingResources.properties.serviceRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Service);
-			renderingResources.properties.otherRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Other);
-			renderingResources.properties.secondaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Secondary);
-			renderingResources.properties.primaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Primary);
-			renderingResources.properties.trunkRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Trunk);
-			renderingResources.properties.motorwayNum = generateIndices(tile, tile.roadWays, RoadTypes::Motorway);
-
 			// Create vertex and index buffers
 			// Interleaved vertex buffer (vertex position + texCoord)
 			if (tile.vertices.size())
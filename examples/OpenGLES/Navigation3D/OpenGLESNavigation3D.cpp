@@ -341,7 +341,7 @@ pvr::Result OGLESNavigation3D::initApplication()
 	// for performance/color space correctness.
 
 	_OSMdata.reset(new NavDataProcess(getAssetStream(MapFile), glm::ivec2(getWidth(), getHeight())));
-	pvr::Result result = _OSMdata->loadAndProcessData();
+	pvr::Result result = _OSMdata->loadAndProcessData(getWritePath() + getApplicationName() + ".navmap");
 
 	if (result != pvr::Result::Success)
 		return result;
@@ -552,59 +552,66 @@ void OGLESNavigation3D::setUniforms()
 ***********************************************************************************************************************/
 void OGLESNavigation3D::createBuffers()
 {
-	uint32_t col = 0;
-	uint32_t row = 0;
+	// Generate the vertices, indices and normals of the tiles on all the threads, each tile only writes its own data
+	parallelFor(_numCols * _numRows, [&](uint32_t tileIndex) {
+		const uint32_t col = tileIndex / _numRows;
+		const uint32_t row = tileIndex % _numRows;
+		Tile& tile = _OSMdata->getTiles()[col][row];
 
-	for (auto& tileCol : _OSMdata->getTiles())
-	{
-		for (Tile& tile : tileCol)
-		{
-			_tileRenderingResources[col][row].reset(new TileRenderingResources());
-			TileRenderingResources& tileResource = *_tileRenderingResources[col][row];
+		_tileRenderingResources[col][row].reset(new TileRenderingResources());
+		TileRenderingResources& tileResource = *_tileRenderingResources[col][row];
 
-			// Set the min and max coordinates for the tile
-			tile.screenMin = remap(tile.min, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5));
-			tile.screenMax = remap(tile.max, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5));
+		// Set the min and max coordinates for the tile
+		tile.screenMin = remap(tile.min, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5));
+		tile.screenMax = remap(tile.max, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5));
 
-			// Create vertices for tile
-			for (auto nodeIterator = tile.nodes.begin(); nodeIterator != tile.nodes.end(); ++nodeIterator)
-			{
-				nodeIterator->second.index = static_cast<uint32_t>(tile.vertices.size());
+		// Create vertices for tile, in node id order
+		for (auto nodeIterator : tile.nodes.getSortedById())
+		{
+			nodeIterator->second.index = static_cast<uint32_t>(tile.vertices.size());
 
-				glm::vec2 remappedPos =
-					glm::vec2(remap(nodeIterator->second.coords, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5)));
-				glm::vec3 vertexPos = glm::vec3(remappedPos.x, nodeIterator->second.height, remappedPos.y);
+			glm::vec2 remappedPos =
+				glm::vec2(remap(nodeIterator->second.coords, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5)));
+			glm::vec3 vertexPos = glm::vec3(remappedPos.x, nodeIterator->second.height, remappedPos.y);
 
-				Tile::VertexData vertData(vertexPos, nodeIterator->second.texCoords);
+			Tile::VertexData vertData(vertexPos, nodeIterator->second.texCoords);
 
-				tile.vertices.push_back(vertData);
-			}
+			tile.vertices.push_back(vertData);
+		}
+
+		// Add car parking to indices
+		tileResource.parkingNum = generateIndices(tile, tile.parkingWays);
 
-			// Add car parking to indices
-			tileResource.parkingNum = generateIndices(tile, tile.parkingWays);
+		// Add road area ways to indices
+		tileResource.areaNum = generateIndices(tile, tile.areaWays);
 
-			// Add road area ways to indices
-			tileResource.areaNum = generateIndices(tile, tile.areaWays);
+		// Add road area outlines to indices
+		tileResource.roadAreaOutlineNum = generateIndices(tile, tile.areaOutlineIds);
 
-			// Add road area outlines to indices
-			tileResource.roadAreaOutlineNum = generateIndices(tile, tile.areaOutlineIds);
+		// Add roads to indices
+		tileResource.motorwayNum = generateIndices(tile, tile.roadWays, RoadTypes::Motorway);
+		tileResource.trunkRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Trunk);
+		tileResource.primaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Primary);
+		tileResource.secondaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Secondary);
+		tileResource.serviceRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Service);
+		tileResource.otherRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Other);
 
-			// Add roads to indices
-			tileResource.motorwayNum = generateIndices(tile, tile.roadWays, RoadTypes::Motorway);
-			tileResource.trunkRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Trunk);
-			tileResource.primaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Primary);
-			tileResource.secondaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Secondary);
-			tileResource.serviceRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Service);
-			tileResource.otherRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Other);
+		// Add buildings to indices
+		tileResource.buildNum = generateIndices(tile, tile.buildWays);
 
-			// Add buildings to indices
-			tileResource.buildNum = generateIndices(tile, tile.buildWays);
+		// Add inner ways to indices
+		tileResource.innerNum = generateIndices(tile, tile.innerWays);
 
-			// Add inner ways to indices
-			tileResource.innerNum = generateIndices(tile, tile.innerWays);
+		generateNormals(tile, static_cast<uint32_t>(tile.indices.size() - (tileResource.innerNum + tileResource.buildNum)), tileResource.buildNum);
+	});
 
-			generateNormals(tile, static_cast<uint32_t>(tile.indices.size() - (tileResource.innerNum + tileResource.buildNum)), tileResource.buildNum);
+	uint32_t col = 0;
+	uint32_t row = 0;
 
+	for (auto& tileCol : _OSMdata->getTiles())
+	{
+		for (Tile& tile : tileCol)
+		{
 			// Create vertex and index buffers
 			// Interleaved vertex buffer (vertex position + texCoord)
 			gl::GenBuffers(1, &_tileRenderingResources[col][row]->vbo);
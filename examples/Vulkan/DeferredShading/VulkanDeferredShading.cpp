@@ -1973,28 +1973,32 @@ void VulkanDeferredShading::updateDynamicSceneData()
 	// update the model matrices
 	for (uint32_t i = 0; i < _mainScene->getNumMeshNodes(); ++i)
 	{
-		uint32_t dynamicSlice = i + _swapchainIndex * _mainScene->getNumMeshNodes();
-
 		const pvr::assets::Model::Node& node = _mainScene->getNode(i);
 		pass.storeLocalMemoryPass.objects[i].world = _mainScene->getWorldMatrix(node.getObjectId());
 		pass.storeLocalMemoryPass.objects[i].worldView = _viewMatrix * pass.storeLocalMemoryPass.objects[i].world;
 		pass.storeLocalMemoryPass.objects[i].worldViewProj = _viewProjectionMatrix * pass.storeLocalMemoryPass.objects[i].world;
 		pass.storeLocalMemoryPass.objects[i].worldViewIT4x4 = glm::inverseTranspose(pass.storeLocalMemoryPass.objects[i].worldView);
-
-		_deviceResources->modelMatrixBufferView.getElementByName(BufferEntryNames::PerModel::WorldViewMatrix, 0, dynamicSlice).setValue(pass.storeLocalMemoryPass.objects[i].worldView);
-
-		_deviceResources->modelMatrixBufferView.getElementByName(BufferEntryNames::PerModel::WorldViewProjectionMatrix, 0, dynamicSlice)
-			.setValue(pass.storeLocalMemoryPass.objects[i].worldViewProj);
-
-		_deviceResources->modelMatrixBufferView.getElementByName(BufferEntryNames::PerModel::WorldViewITMatrix, 0, dynamicSlice).setValue(pass.storeLocalMemoryPass.objects[i].worldViewIT4x4);
 	}
 
-	// if the memory property flags used by the buffers' device memory do not contain e_HOST_COHERENT_BIT then we must flush the memory
-	if (static_cast<uint32_t>(_deviceResources->modelMatrixBuffer->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == 0)
+	// copy each matrix of every object into this swapchain's dynamic slices with a single strided copy per matrix
+	if (_mainScene->getNumMeshNodes())
 	{
-		_deviceResources->modelMatrixBuffer->getDeviceMemory()->flushRange(
-			_deviceResources->modelMatrixBufferView.getDynamicSliceOffset(_swapchainIndex * _mainScene->getNumMeshNodes()),
-			_deviceResources->modelMatrixBufferView.getDynamicSliceSize() * _mainScene->getNumMeshNodes());
+		pvr::utils::StructuredBufferView& modelMatrixView = _deviceResources->modelMatrixBufferView;
+		const DrawGBuffer::Objects* objects = pass.storeLocalMemoryPass.objects.data();
+		uint32_t firstDynamicSlice = _swapchainIndex * _mainScene->getNumMeshNodes();
+
+		modelMatrixView.setElementForDynamicSlices(modelMatrixView.getIndex(BufferEntryNames::PerModel::WorldViewMatrix), &objects->worldView, firstDynamicSlice,
+			_mainScene->getNumMeshNodes(), sizeof(DrawGBuffer::Objects));
+		modelMatrixView.setElementForDynamicSlices(modelMatrixView.getIndex(BufferEntryNames::PerModel::WorldViewProjectionMatrix), &objects->worldViewProj, firstDynamicSlice,
+			_mainScene->getNumMeshNodes(), sizeof(DrawGBuffer::Objects));
+		pvr::utils::StructuredBufferRange writtenRange = modelMatrixView.setElementForDynamicSlices(modelMatrixView.getIndex(BufferEntryNames::PerModel::WorldViewITMatrix),
+			&objects->worldViewIT4x4, firstDynamicSlice, _mainScene->getNumMeshNodes(), sizeof(DrawGBuffer::Objects));
+
+		// if the memory property flags used by the buffers' device memory do not contain e_HOST_COHERENT_BIT then we must flush the memory
+		if (static_cast<uint32_t>(_deviceResources->modelMatrixBuffer->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == 0)
+		{
+			_deviceResources->modelMatrixBuffer->getDeviceMemory()->flushRange(writtenRange.offset, writtenRange.size);
+		}
 	}
 
 	int32_t pointLight = 0;
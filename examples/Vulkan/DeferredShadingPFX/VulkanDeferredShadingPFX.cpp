@@ -530,6 +530,8 @@ pvr::Result VulkanDeferredShadingPFX::initView()
 	{
 		return pvr::Result::UnknownError;
 	}
+	// Warm-start the pipeline compilation with the pipeline cache saved by the previous run
+	_deviceResources->render_mgr.setPipelineCache(pvr::utils::loadPipelineCache(_deviceResources->device, getWritePath() + getApplicationName() + ".pipelinecache"));
 	_deviceResources->render_mgr.addEffect(*rd.getAssetHandle(), _deviceResources->commandBufferMain[0]);
 
 	//--- Gbuffer renders the scene
@@ -595,6 +597,11 @@ pvr::Result VulkanDeferredShadingPFX::initView()
 ***********************************************************************************************************************/
 pvr::Result VulkanDeferredShadingPFX::releaseView()
 {
+	if (_deviceResources && _deviceResources->render_mgr.getPipelineCache().isValid())
+	{
+		pvr::utils::savePipelineCache(
+			_deviceResources->device, _deviceResources->render_mgr.getPipelineCache(), getWritePath() + getApplicationName() + ".pipelinecache");
+	}
 	_deviceResources.reset();
 	return pvr::Result::Success;
 }
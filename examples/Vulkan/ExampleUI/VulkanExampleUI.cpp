@@ -585,6 +585,7 @@ private:
 	void createPageClock();
 	void createClockSprite(SpriteClock& outClock, Sprites::Enum sprite);
 	void recordSecondaryCommandBuffers(uint32_t swapchain);
+	void recordBaseUI(uint32_t swapchain);
 	void loadSprites(pvrvk::CommandBuffer& uploadCmd);
 
 public:
@@ -1171,6 +1172,10 @@ pvr::Result VulkanExampleUI::initView()
 		_deviceResources->perFrameAcquireFence[i] = _deviceResources->device->createFence(pvrvk::FenceCreateFlags::e_SIGNALED_BIT);
 	}
 	updateTitleAndDesc((DisplayOption::Enum)_displayOption);
+
+	// Everything recorded so far renders each sprite separately and is never recorded again. The base UI is recorded every frame in batching
+	// mode instead (see renderFrame), so that its sprites are drawn with as few draw calls as possible.
+	_deviceResources->uiRenderer.enableBatching();
 	return pvr::Result::Success;
 }
 
@@ -1507,6 +1512,10 @@ pvr::Result VulkanExampleUI::renderFrame()
 	_deviceResources->perFrameCommandBufferFence[swapchainIndex]->wait();
 	_deviceResources->perFrameCommandBufferFence[swapchainIndex]->reset();
 
+	// The batched base UI is only valid for a single frame, so record it again now that the previous frame using it has completed
+	_deviceResources->uiRenderer.beginFrame(swapchainIndex, _deviceResources->perFrameCommandBufferFence[swapchainIndex]);
+	recordBaseUI(swapchainIndex);
+
 	_deviceResources->commandBuffer[swapchainIndex]->begin(pvrvk::CommandBufferUsageFlags::e_ONE_TIME_SUBMIT_BIT);
 	_currTime = this->getTime();
 	float deltaTime = (_currTime - _prevTime) * 0.001f;
@@ -1590,13 +1599,8 @@ pvr::Result VulkanExampleUI::renderFrame()
 ***********************************************************************************************************************/
 void VulkanExampleUI::recordSecondaryCommandBuffers(uint32_t swapchain)
 {
-	// record the base ui
-	{
-		_deviceResources->commandBufferBaseUI[swapchain] = _deviceResources->commandPool->allocateSecondaryCommandBuffer();
-		_deviceResources->uiRenderer.beginRendering(_deviceResources->commandBufferBaseUI[swapchain]);
-		_deviceResources->groupBaseUI->render(); // render the base GUI
-		_deviceResources->uiRenderer.endRendering();
-	}
+	// the base ui is recorded every frame (see recordBaseUI)
+	_deviceResources->commandBufferBaseUI[swapchain] = _deviceResources->commandPool->allocateSecondaryCommandBuffer();
 
 	// record DrawClock commands
 	{
@@ -1637,6 +1641,18 @@ void VulkanExampleUI::recordSecondaryCommandBuffers(uint32_t swapchain)
 	}
 }
 
+/*!*********************************************************************************************************************
+\brief  Record the secondary command buffer drawing the base UI. The UIRenderer is in batching mode, so the sprites of the base UI are
+		drawn with one draw call per batch of sprites sharing a texture, and the command buffer must be recorded again every frame.
+\param  swapchain The swapchain index of the frame being recorded
+***********************************************************************************************************************/
+void VulkanExampleUI::recordBaseUI(uint32_t swapchain)
+{
+	_deviceResources->uiRenderer.beginRendering(_deviceResources->commandBufferBaseUI[swapchain]);
+	_deviceResources->groupBaseUI->render(); // render the base GUI
+	_deviceResources->uiRenderer.endRendering();
+}
+
 /*!*********************************************************************************************************************
 \brief Handle input events
 \param[in] action Input event to handle
@@ -37,6 +37,14 @@ each of them generate the command buffers, and enter them into the "tiles to dra
 
 const glm::vec4 DirectionToLight = glm::vec4(0.0f, 1.0f, 0.65f, 0.0f);
 
+// Compile-time layout of the per-object UBO (modelMatrix, modelMatrixIT) allowing the per-object matrices to be written with plain stores
+typedef pvr::utils::StructuredMemoryLayout<pvr::utils::StructuredMemoryMember<glm::mat4>, pvr::utils::StructuredMemoryMember<glm::mat4> > PerObjectUboLayout;
+enum PerObjectUboElements
+{
+	ModelMatrix,
+	ModelMatrixIT
+};
+
 enum CONSTANTS
 {
 	MAX_NUMBER_OF_SWAP_IMAGES = 4,
@@ -1326,8 +1334,7 @@ void VulkanGnomeHorde::createDescSetsAndTiles(const pvrvk::DescriptorSetLayout&
 	// Using the StructuredMemoryView to update the objects
 	pvr::utils::StructuredBufferView& perObj = _deviceResources->uboPerObjectBufferView;
 	pvrvk::Buffer& perObjBuffer = _deviceResources->uboPerObject;
-	uint32_t mIndex = perObj.getIndex("modelMatrix");
-	uint32_t mITIndex = perObj.getIndex("modelMatrixIT");
+	pvr::utils::StructuredBufferWriter<PerObjectUboLayout> perObjWriter(perObj);
 
 	for (uint32_t y = 0; y < NUM_TILES_Z; ++y)
 	{
@@ -1420,8 +1427,8 @@ void VulkanGnomeHorde::createDescSetsAndTiles(const pvrvk::DescriptorSetLayout&
 					thisTile.aabb.add(pos);
 				}
 
-				perObj.getElement(mIndex, 0, tileBaseIndex + obj).setValue(xform);
-				perObj.getElement(mITIndex, 0, tileBaseIndex + obj).setValue(xformIT);
+				perObjWriter.setValue<ModelMatrix>(xform, 0, tileBaseIndex + obj);
+				perObjWriter.setValue<ModelMatrixIT>(xformIT, 0, tileBaseIndex + obj);
 
 				// if the memory property flags used by the buffers' device memory do not contain e_HOST_COHERENT_BIT then we must flush the memory
 				if (static_cast<uint32_t>(perObjBuffer->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == 0)
@@ -1431,8 +1438,8 @@ void VulkanGnomeHorde::createDescSetsAndTiles(const pvrvk::DescriptorSetLayout&
 
 				if (objShadow != 9)
 				{
-					perObj.getElement(mIndex, 0, tileBaseIndex + objShadow).setValue(xform);
-					perObj.getElement(mITIndex, 0, tileBaseIndex + objShadow).setValue(xformIT);
+					perObjWriter.setValue<ModelMatrix>(xform, 0, tileBaseIndex + objShadow);
+					perObjWriter.setValue<ModelMatrixIT>(xformIT, 0, tileBaseIndex + objShadow);
 
 					// if the memory property flags used by the buffers' device memory do not contain e_HOST_COHERENT_BIT then we must flush the memory
 					if (static_cast<uint32_t>(perObjBuffer->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == 0)
@@ -1529,9 +1536,7 @@ void VulkanGnomeHorde::initUboStructuredObjects()
 	}
 
 	{
-		pvr::utils::StructuredMemoryDescription desc;
-		desc.addElement("modelMatrix", pvr::GpuDatatypes::mat4x4);
-		desc.addElement("modelMatrixIT", pvr::GpuDatatypes::mat4x4);
+		pvr::utils::StructuredMemoryDescription desc = PerObjectUboLayout::createDescription({ "modelMatrix", "modelMatrixIT" });
 
 		_deviceResources->uboPerObjectBufferView.initDynamic(desc, TOTAL_NUMBER_OF_OBJECTS, pvr::BufferUsageFlags::UniformBuffer,
 			static_cast<uint32_t>(_deviceResources->device->getPhysicalDevice()->getProperties().getLimits().getMinUniformBufferOffsetAlignment()));
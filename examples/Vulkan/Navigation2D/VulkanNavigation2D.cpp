@@ -8,12 +8,27 @@ creating a navigational map from raw XML data.
 ***********************************************************************************************************************/
 
 #include "../../common/NavDataProcess.h"
+#include "../../common/LabelCollisionGrid.h"
+#include "../../common/TileResidency.h"
 #include "PVRShell/PVRShell.h"
 #include "PVRUtils/PVRUtilsVk.h"
 const float CameraMoveSpeed = 100.f;
 const float CameraRotationSpeed = 50.f;
 const float CamRotationTime = 5000.f;
 
+// Label placement. Labels are placed again when the scale or the rotation of the camera drift further than these
+// tolerances from those they were placed with, and the padding keeps labels apart while the camera drifts.
+const float LabelPlacementScaleTolerance = 0.05f;
+const float LabelPlacementRotationTolerance = 10.0f;
+const float LabelPadding = 2.0f;
+const float LabelGridCellSize = 64.0f;
+const uint32_t LabelGridMaxCells = 128;
+
+// Tile streaming. The memory the vertex and index buffers of the tiles may use before tiles are evicted, and the
+// largest number of tiles that start uploading in a frame.
+const uint64_t TileMemoryBudget = 64 * 1024 * 1024;
+const uint32_t MaxTileLoadsPerFrame = 4;
+
 // PVR texture file names.
 const pvr::StringHash SpriteFileNames[BuildingType::None] = {
 	pvr::StringHash("shop.pvr"),
@@ -57,6 +72,8 @@ const char* MapFile = "map.osm";
 const char* FontFile = "font.pvr";
 float scales[LOD::Count] = { 10.0f, 7.0f, 5.0f, 3.0f, 2.0f };
 float MapScales[LOD::Count] = { 11.0f, 10.0f, 7.0f, 5.0f, 2.0f };
+// The level of detail of the geometry drawn at each scale level, the roads and outlines are simplified when zoomed out
+uint32_t MapGeometryLODs[LOD::Count] = { GeometryLOD::L0, GeometryLOD::L0, GeometryLOD::L0, GeometryLOD::L1, GeometryLOD::L2 };
 
 enum class MapColors
 {
@@ -90,6 +107,13 @@ struct Icon
 struct Label
 {
 	pvr::ui::Text text;
+
+	// The rotation and visibility last committed to the text, so that it is only updated when they change. The angle
+	// starts as NaN so that the first update always commits.
+	float angle;
+	bool isPlaced;
+
+	Label() : angle(std::numeric_limits<float>::quiet_NaN()), isPlaced(true) {}
 };
 
 struct AmenityIconGroup
@@ -106,6 +130,31 @@ struct AmenityLabelGroup
 	IconData iconData;
 };
 
+// A label, amenity icon or amenity label competing for space on the screen
+struct LabelCandidate
+{
+	uint32_t lod;
+	uint32_t kind; // Amenity icons are placed before labels, and labels before amenity labels
+	float importance; // The width of the road, which follows its type
+	LabelCollisionGrid::Box box;
+	std::vector<bool>* isPlaced;
+	uint32_t index;
+
+	// Labels shown at more levels of detail are placed first
+	bool operator<(const LabelCandidate& other) const
+	{
+		if (lod != other.lod)
+		{
+			return lod > other.lod;
+		}
+		if (kind != other.kind)
+		{
+			return kind < other.kind;
+		}
+		return importance > other.importance;
+	}
+};
+
 enum class CameraMode
 {
 	Auto,
@@ -186,6 +235,9 @@ struct DeviceResources
 	// Caches used for pipeline creation.
 	pvrvk::PipelineCache pipelineCache;
 
+	// Uploads the buffers of the tiles as they are streamed in
+	pvr::utils::StreamingUploader tileUploader;
+
 	~DeviceResources()
 	{
 		if (device.isValid())
@@ -220,7 +272,7 @@ struct Plane
 struct PerSwapTileResources
 {
 	pvrvk::SecondaryCommandBuffer uicbuff[LOD::Count];
-	pvrvk::SecondaryCommandBuffer secCbo;
+	pvrvk::SecondaryCommandBuffer secCbo[GeometryLOD::Count];
 
 	bool tileWasVisible;
 	bool uiWasVisible;
@@ -232,23 +284,58 @@ struct PerSwapTileResources
 	std::vector<AmenityIconGroup> amenityIcons[LOD::Count];
 	std::vector<AmenityLabelGroup> amenityLabels[LOD::Count];
 	pvr::ui::Image spriteImages[BuildingType::None];
+
+	// The camera (pixel offset, scale and rotation) and the label placement last applied to the UI of each level
+	glm::vec4 uiCamera[LOD::Count];
+	uint32_t uiLabelPlacementId[LOD::Count];
+
 	PerSwapTileResources()
 	{
 		tileWasVisible = false;
 		uiWasVisible = false;
+		for (uint32_t lod = 0; lod < LOD::Count; ++lod)
+		{
+			uiCamera[lod] = glm::vec4(0.0f);
+			uiLabelPlacementId[lod] = 0;
+		}
 	}
 };
 
+// The number of indices of each kind of geometry of a level of detail in a tile's index buffer, in the order that they are drawn
+struct TileRenderProperties
+{
+	uint32_t firstIndex;
+	uint32_t parkingNum;
+	uint32_t buildNum;
+	uint32_t innerNum;
+	uint32_t areaNum;
+	uint32_t serviceRoadNum;
+	uint32_t otherRoadNum;
+	uint32_t secondaryRoadNum;
+	uint32_t primaryRoadNum;
+	uint32_t trunkRoadNum;
+	uint32_t motorwayNum;
+};
+
 struct TileRenderingResources
 {
 	pvrvk::Buffer vbo;
 	pvrvk::Buffer ibo;
 	uint32_t numSpriteInstances;
 	uint32_t numSprites;
+	TileRenderProperties properties[GeometryLOD::Count];
+
+	// Whether each label, amenity icon and amenity label survived the label placement. Shared by all the swapchain images.
+	std::vector<bool> labelIsPlaced[LOD::Count];
+	std::vector<bool> amenityIconIsPlaced[LOD::Count];
+	std::vector<bool> amenityLabelIsPlaced[LOD::Count];
 
 	PerSwapTileResources swapResources[pvrvk::FrameworkCaps::MaxSwapChains];
 
-	TileRenderingResources() {}
+	// The upload of the buffers while the tile is loading
+	pvr::utils::StreamingUploader::Token uploadToken;
+
+	TileRenderingResources() : uploadToken(0) {}
 };
 
 /*!*********************************************************************************************************************
@@ -300,6 +387,22 @@ class VulkanNavigation2D : public pvr::Shell
 	float _screenWidth, _screenHeight;
 	bool _destinationReached = false;
 
+	// Tile streaming
+	TileResidency _tileResidency;
+	std::vector<uint32_t> _loadingTiles;
+	std::vector<uint32_t> _tileLoads;
+	std::vector<uint32_t> _tileEvictions;
+
+	// Label placement
+	LabelCollisionGrid _labelGrid;
+	std::vector<LabelCandidate> _labelCandidates;
+	std::vector<uint32_t> _visibleTiles;
+	std::vector<uint32_t> _placedTiles;
+	uint32_t _labelPlacementId;
+	uint16_t _placedScaleLevel;
+	float _placedScale;
+	float _placedRotation;
+
 	glm::vec4 _clearColor;
 
 	glm::vec4 _roadAreaColor;
@@ -341,7 +444,12 @@ public:
 
 	bool initializeRenderers(TileRenderingResources* begin, TileRenderingResources* end, Tile& tile);
 	bool createDescriptorSets();
-	void createBuffers(pvrvk::CommandBuffer& uploadCmd);
+	void createTileGeometry();
+	void generateTileGeometry(uint32_t col, uint32_t row);
+	void loadTile(uint32_t col, uint32_t row);
+	void unloadTile(uint32_t col, uint32_t row);
+	void recordTileCommands(uint32_t col, uint32_t row);
+	void updateTileStreaming();
 	bool createUbos();
 	void loadTexture(pvrvk::CommandBuffer& uploadCmd);
 	void setColors();
@@ -351,6 +459,7 @@ public:
 	void updateLabels(uint32_t col, uint32_t row, uint32_t swapchainIndex);
 	void updateAmenities(uint32_t col, uint32_t row, uint32_t swapchainIndex);
 	void updateGroups(uint32_t col, uint32_t row, uint32_t swapindex);
+	void updateLabelPlacement();
 	void updateAnimation();
 	void calculateClipPlanes();
 	bool inFrustum(glm::vec2 min, glm::vec2 max);
@@ -410,9 +519,9 @@ pvr::Result VulkanNavigation2D::initApplication()
 	setDepthBitsPerPixel(0);
 	setStencilBitsPerPixel(0);
 
-	// Load and process the map.
+	// Load the map processed by a previous run, or load and process the map.
 	_OSMdata.reset(new NavDataProcess(getAssetStream(MapFile), glm::ivec2(getWidth(), getHeight())));
-	pvr::Result result = _OSMdata->loadAndProcessData();
+	pvr::Result result = _OSMdata->loadAndProcessData(getWritePath() + getApplicationName() + ".navmap");
 
 	Log(LogLevel::Information, "MAP SIZE IS: [ %d x %d ] TILES", _OSMdata->getNumRows(), _OSMdata->getNumCols());
 
@@ -584,6 +693,11 @@ pvr::Result VulkanNavigation2D::initView()
 		_tileRenderingResources[i].resize(_numRows);
 	}
 
+	// Place the labels on the first frame
+	_labelPlacementId = 0;
+	_placedScaleLevel = LOD::Count;
+	_placedTiles.clear();
+
 	// Craate the uniform buffer objects.
 	if (!createUbos())
 	{
@@ -656,8 +770,13 @@ pvr::Result VulkanNavigation2D::initView()
 	// Create the projection matrices.
 	_projMtx = pvr::math::ortho(pvr::Api::Vulkan, 0.0, static_cast<float>(_screenWidth), 0.0f, static_cast<float>(_screenHeight));
 
-	Log(LogLevel::Information, "Creating per Tile buffers");
-	createBuffers(_deviceResources->commandBuffers[0]);
+	Log(LogLevel::Information, "Creating per Tile geometry");
+	_tileResidency.init(_numCols * _numRows, TileMemoryBudget, _numSwapchains, MaxTileLoadsPerFrame);
+	createTileGeometry();
+
+	// The buffers of the tiles are streamed in once rendering starts
+	_deviceResources->tileUploader.init(_deviceResources->device, _deviceResources->queue, queueAccessInfo.familyId, _deviceResources->vmaAllocator);
+	_loadingTiles.clear();
 
 	Log(LogLevel::Information, "Converting Route");
 	initRoute();
@@ -720,6 +839,8 @@ pvr::Result VulkanNavigation2D::renderFrame()
 			_deviceResources->uboMvp.bufferView.getDynamicSliceOffset(swapchainIndex), _deviceResources->uboMvp.bufferView.getDynamicSliceSize());
 	}
 	calculateClipPlanes();
+	updateTileStreaming();
+	updateLabelPlacement();
 
 	updateCommandBuffer(_deviceResources->commandBuffers[swapchainIndex], swapchainIndex);
 
@@ -768,7 +889,11 @@ or before a change in the rendering context.
 ***********************************************************************************************************************/
 pvr::Result VulkanNavigation2D::releaseView()
 {
-	// Clean up tile rendering resource data.
+	// Clean up tile rendering resource data, once the tile uploads and the frames in flight have completed.
+	if (_deviceResources && _deviceResources->device.isValid())
+	{
+		_deviceResources->device->waitIdle();
+	}
 	_tileRenderingResources.clear();
 	_deviceResources.reset(); // destroy the vulkan resoures
 	return pvr::Result::Success;
@@ -1121,217 +1246,354 @@ void VulkanNavigation2D::initRoute()
 }
 
 /*!*********************************************************************************************************************
-\brief  Creates vertex and index buffers and records the secondary command
-buffers for each tile.
+\brief  Generate the vertices and indices of all the tiles, and set the size of the buffers of each tile. The buffers are
+created when the tiles are streamed in.
 ***********************************************************************************************************************/
-void VulkanNavigation2D::createBuffers(pvrvk::CommandBuffer& uploadCmd)
+void VulkanNavigation2D::createTileGeometry()
 {
-	for (uint32_t col = 0; col < _OSMdata->getTiles().size(); ++col)
+	// Generate the vertices and indices of the tiles on all the threads, each tile only writes its own data
+	parallelFor(_numCols * _numRows, [&](uint32_t tileIndex) { generateTileGeometry(tileIndex / _numRows, tileIndex % _numRows); });
+
+	for (uint32_t tileIndex = 0; tileIndex < _numCols * _numRows; ++tileIndex)
 	{
-		auto& tileCol = _OSMdata->getTiles()[col];
-		for (uint32_t row = 0; row < tileCol.size(); ++row)
-		{
-			Tile& tile = tileCol[row];
+		const Tile& tile = _OSMdata->getTiles()[tileIndex / _numRows][tileIndex % _numRows];
+		_tileResidency.setSize(tileIndex, tile.vertices.size() * sizeof(tile.vertices[0]) + tile.indices.size() * sizeof(tile.indices[0]));
+	}
+}
 
-			// Create vertices for tile
-			for (auto nodeIterator = tile.nodes.begin(); nodeIterator != tile.nodes.end(); ++nodeIterator)
-			{
-				nodeIterator->second.index = static_cast<uint32_t>(tile.vertices.size());
+/*!*********************************************************************************************************************
+\param col  Column index for tile.
+\param row  Row index for tile.
+\brief  Generate the vertices and indices of a tile. They are released once they have been uploaded, and generated again
+if the tile is streamed in again after being evicted.
+***********************************************************************************************************************/
+void VulkanNavigation2D::generateTileGeometry(uint32_t col, uint32_t row)
+{
+	Tile& tile = _OSMdata->getTiles()[col][row];
+	tile.vertices.clear();
+	tile.indices.clear();
 
-				Tile::VertexData vertData(glm::vec3(remap(nodeIterator->second.coords, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[_numCols - 1][_numRows - 1].max,
-														-_mapWorldDim * .5, _mapWorldDim * .5),
-											  0.0f),
-					nodeIterator->second.texCoords);
-				tile.vertices.push_back(vertData);
-			}
+	// Create vertices for tile, in node id order
+	for (auto nodeIterator : tile.nodes.getSortedById())
+	{
+		nodeIterator->second.index = static_cast<uint32_t>(tile.vertices.size());
 
-			// Add car parking to indices
-			uint32_t parkingNum = generateIndices(tile, tile.parkingWays);
+		Tile::VertexData vertData(glm::vec3(remap(nodeIterator->second.coords, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[_numCols - 1][_numRows - 1].max,
+												-_mapWorldDim * .5, _mapWorldDim * .5),
+									  0.0f),
+			nodeIterator->second.texCoords);
+		tile.vertices.push_back(vertData);
+	}
 
-			// Add buildings to indices
-			uint32_t buildNum = generateIndices(tile, tile.buildWays);
+	// The indices of each level of detail follow those of the previous level
+	for (uint32_t lod = 0; lod < GeometryLOD::Count; ++lod)
+	{
+		Tile::SimplifiedWays* simplifiedWays = lod != GeometryLOD::L0 ? &tile.simplifiedWays[lod - 1] : nullptr;
+		std::vector<Way>& parkingWays = simplifiedWays ? simplifiedWays->parkingWays : tile.parkingWays;
+		std::vector<Way>& buildWays = simplifiedWays ? simplifiedWays->buildWays : tile.buildWays;
+		std::vector<Way>& innerWays = simplifiedWays ? simplifiedWays->innerWays : tile.innerWays;
+		std::vector<Way>& areaWays = simplifiedWays ? simplifiedWays->areaWays : tile.areaWays;
+		std::vector<Way>& roadWays = simplifiedWays ? simplifiedWays->roadWays : tile.roadWays;
+
+		TileRenderProperties& properties = _tileRenderingResources[col][row].properties[lod];
+		properties.firstIndex = static_cast<uint32_t>(tile.indices.size());
+
+		// Add car parking to indices
+		properties.parkingNum = generateIndices(tile, parkingWays);
+
+		// Add buildings to indices
+		properties.buildNum = generateIndices(tile, buildWays);
+
+		// Add inner ways to indices
+		properties.innerNum = generateIndices(tile, innerWays);
+
+		// Add road area ways to indices
+		properties.areaNum = generateIndices(tile, areaWays);
+
+		// Add roads to indices
+		properties.serviceRoadNum = generateIndices(tile, roadWays, RoadTypes::Service);
+		properties.otherRoadNum = generateIndices(tile, roadWays, RoadTypes::Other);
+		properties.secondaryRoadNum = generateIndices(tile, roadWays, RoadTypes::Secondary);
+		properties.primaryRoadNum = generateIndices(tile, roadWays, RoadTypes::Primary);
+		properties.trunkRoadNum = generateIndices(tile, roadWays, RoadTypes::Trunk);
+		properties.motorwayNum = generateIndices(tile, roadWays, RoadTypes::Motorway);
+	}
+}
 
-			// Add inner ways to indices
-			uint32_t innerNum = generateIndices(tile, tile.innerWays);
+/*!*********************************************************************************************************************
+\param col  Column index for tile.
+\param row  Row index for tile.
+\brief  Create the device local vertex and index buffers of a tile and queue their uploads. The uploads of all the tiles
+loaded in a frame are submitted together, and the tile is drawn once they have completed. The vertices and indices of
+the tile are released once they have been copied for the upload.
+***********************************************************************************************************************/
+void VulkanNavigation2D::loadTile(uint32_t col, uint32_t row)
+{
+	Tile& tile = _OSMdata->getTiles()[col][row];
+	TileRenderingResources& tileRes = _tileRenderingResources[col][row];
+	const uint32_t tileIndex = col * _numRows + row;
+	if (!_tileResidency.getSize(tileIndex))
+	{
+		_tileResidency.setResident(tileIndex);
+		return;
+	}
+	if (tile.vertices.empty())
+	{
+		generateTileGeometry(col, row);
+	}
 
-			// Add road area ways to indices
-			uint32_t areaNum = generateIndices(tile, tile.areaWays);
+	// Interleaved vertex buffer (vertex position + texCoord)
+	const pvrvk::DeviceSize vboSize = static_cast<pvrvk::DeviceSize>(tile.vertices.size() * sizeof(tile.vertices[0]));
+	tileRes.vbo = pvr::utils::createBuffer(_deviceResources->device, vboSize, pvrvk::BufferUsageFlags::e_VERTEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT,
+		pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, &_deviceResources->vmaAllocator, pvr::utils::vma::AllocationCreateFlags::e_NONE);
 
-			// Add roads to indices
-			uint32_t serviceRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Service);
-			uint32_t otherRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Other);
-			uint32_t secondaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Secondary);
-			uint32_t primaryRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Primary);
-			uint32_t trunkRoadNum = generateIndices(tile, tile.roadWays, RoadTypes::Trunk);
-			uint32_t motorwayNum = generateIndices(tile, tile.roadWays, RoadTypes::Motorway);
+	const pvrvk::DeviceSize iboSize = static_cast<pvrvk::DeviceSize>(tile.indices.size() * sizeof(tile.indices[0]));
+	tileRes.ibo = pvr::utils::createBuffer(_deviceResources->device, iboSize, pvrvk::BufferUsageFlags::e_INDEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT,
+		pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, &_deviceResources->vmaAllocator, pvr::utils::vma::AllocationCreateFlags::e_NONE);
 
-			if (tile.vertices.size())
-			{
-				auto& tileRes = _tileRenderingResources[col][row];
-				// Create vertex and index buffers
-				// Interleaved vertex buffer (vertex position + texCoord)
+	_deviceResources->tileUploader.uploadBuffer(tileRes.vbo, tile.vertices.data(), 0, vboSize);
+	tileRes.uploadToken = _deviceResources->tileUploader.uploadBuffer(tileRes.ibo, tile.indices.data(), 0, iboSize);
+	_loadingTiles.push_back(tileIndex);
 
-				{
-					const pvrvk::DeviceSize vboSize = static_cast<pvrvk::DeviceSize>(tile.vertices.size() * sizeof(tile.vertices[0]));
-					tileRes.vbo = pvr::utils::createBuffer(_deviceResources->device, vboSize,
-						pvrvk::BufferUsageFlags::e_VERTEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
-						pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT | pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT,
-						&_deviceResources->vmaAllocator, pvr::utils::vma::AllocationCreateFlags::e_MAPPED_BIT);
-
-					bool isBufferHostVisible = (tileRes.vbo->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT) != 0;
-					if (isBufferHostVisible)
-					{
-						pvr::utils::updateHostVisibleBuffer(tileRes.vbo, tile.vertices.data(), 0, vboSize, true);
-					}
-					else
-					{
-						pvr::utils::updateBufferUsingStagingBuffer(_deviceResources->device, tileRes.vbo, uploadCmd, tile.vertices.data(), 0, vboSize, &_deviceResources->vmaAllocator);
-					}
-				}
-
-				{
-					const pvrvk::DeviceSize iboSize = static_cast<pvrvk::DeviceSize>(tile.indices.size() * sizeof(tile.indices[0]));
-
-					tileRes.ibo = pvr::utils::createBuffer(_deviceResources->device, iboSize,
-						pvrvk::BufferUsageFlags::e_INDEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
-						pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT | pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT,
-						&_deviceResources->vmaAllocator, pvr::utils::vma::AllocationCreateFlags::e_MAPPED_BIT);
+	// The uploader has copied the data, so the tile keeps no copy of its geometry while it is resident
+	std::vector<Tile::VertexData>().swap(tile.vertices);
+	std::vector<uint32_t>().swap(tile.indices);
+}
 
-					bool isBufferHostVisible = (tileRes.ibo->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT) != 0;
-					if (isBufferHostVisible)
-					{
-						pvr::utils::updateHostVisibleBuffer(tileRes.ibo, tile.indices.data(), 0, iboSize, true);
-					}
-					else
-					{
-						pvr::utils::updateBufferUsingStagingBuffer(_deviceResources->device, tileRes.ibo, uploadCmd, tile.indices.data(), 0, iboSize, &_deviceResources->vmaAllocator);
-					}
-				}
+/*!*********************************************************************************************************************
+\param col  Column index for tile.
+\param row  Row index for tile.
+\brief  Release the buffers and command buffers of a tile that has been evicted.
+***********************************************************************************************************************/
+void VulkanNavigation2D::unloadTile(uint32_t col, uint32_t row)
+{
+	TileRenderingResources& tileRes = _tileRenderingResources[col][row];
+	for (uint32_t i = 0; i < _numSwapchains; ++i)
+	{
+		for (uint32_t lod = 0; lod < GeometryLOD::Count; ++lod)
+		{
+			tileRes.swapResources[i].secCbo[lod].reset();
+		}
+	}
+	tileRes.vbo.reset();
+	tileRes.ibo.reset();
+}
 
-				uint32_t uboOffset = 0;
+/*!*********************************************************************************************************************
+\param col  Column index for tile.
+\param row  Row index for tile.
+\brief  Record the secondary command buffers drawing a tile whose buffers have been uploaded.
+***********************************************************************************************************************/
+void VulkanNavigation2D::recordTileCommands(uint32_t col, uint32_t row)
+{
+	TileRenderingResources& tileRes = _tileRenderingResources[col][row];
+	uint32_t uboOffset = 0;
 
-				// Secondary commands
-				for (uint32_t i = 0; i < _numSwapchains; ++i)
-				{
-					uint32_t offset = 0;
-					tileRes.swapResources[i].secCbo = _deviceResources->commandPool->allocateSecondaryCommandBuffer();
-					tileRes.swapResources[i].secCbo->begin(_deviceResources->framebuffer[i]);
+	// Secondary commands, one for each level of detail
+	for (uint32_t i = 0; i < _numSwapchains; ++i)
+	{
+		for (uint32_t lod = 0; lod < GeometryLOD::Count; ++lod)
+		{
+			const TileRenderProperties& properties = tileRes.properties[lod];
+			pvrvk::SecondaryCommandBuffer& secCbo = tileRes.swapResources[i].secCbo[lod];
+			uint32_t offset = properties.firstIndex;
+			secCbo = _deviceResources->commandPool->allocateSecondaryCommandBuffer();
+			secCbo->begin(_deviceResources->framebuffer[i]);
+
+			// Bind the vertex and index buffers for the tile
+			secCbo->bindVertexBuffer(tileRes.vbo, 0, 0);
+			secCbo->bindIndexBuffer(tileRes.ibo, 0, pvrvk::IndexType::e_UINT32);
+
+			secCbo->bindPipeline(_deviceResources->fillPipe);
+			secCbo->bindDescriptorSet(
+				pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(), SetBinding::UBOStatic, _deviceResources->uboMvp.sets[i]);
+
+			// Draw the car parking
+			if (properties.parkingNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Parking));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.parkingNum);
+				offset += properties.parkingNum;
+			}
 
-					// Bind the vertex and index buffers for the tile
-					tileRes.swapResources[i].secCbo->bindVertexBuffer(tileRes.vbo, 0, 0);
-					tileRes.swapResources[i].secCbo->bindIndexBuffer(tileRes.ibo, 0, pvrvk::IndexType::e_UINT32);
+			// Draw the buildings
+			if (properties.buildNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Building));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.buildNum);
+				offset += properties.buildNum;
+			}
 
-					tileRes.swapResources[i].secCbo->bindPipeline(_deviceResources->fillPipe);
-					tileRes.swapResources[i].secCbo->bindDescriptorSet(
-						pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(), SetBinding::UBOStatic, _deviceResources->uboMvp.sets[i]);
+			// Draw the insides of car parking and buildings for polygons with
+			// holes
+			if (properties.innerNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Clear));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.innerNum);
+				offset += properties.innerNum;
+			}
 
-					// Draw the car parking
-					if (parkingNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Parking));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(0, parkingNum);
-						offset += parkingNum;
-					}
+			// Draw the road areas
+			if (properties.areaNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::RoadArea));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.areaNum);
+				offset += properties.areaNum;
+			}
 
-					// Draw the buildings
-					if (buildNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Building));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, buildNum);
-						offset += buildNum;
-					}
+			secCbo->bindPipeline(_deviceResources->roadPipe);
+			secCbo->bindDescriptorSet(
+				pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(), SetBinding::UBOStatic, _deviceResources->uboMvp.sets[i]);
 
-					// Draw the insides of car parking and buildings for polygons with
-					// holes
-					if (innerNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Clear));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, innerNum);
-						offset += innerNum;
-					}
+			/**** Draw the roads ****/
 
-					// Draw the road areas
-					if (areaNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::RoadArea));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, areaNum);
-						offset += areaNum;
-					}
+			// Service Roads
+			if (properties.serviceRoadNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Service));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.serviceRoadNum);
+				offset += properties.serviceRoadNum;
+			}
+			// Other (any other roads)
+			if (properties.otherRoadNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Other));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.otherRoadNum);
+				offset += properties.otherRoadNum;
+			}
+			// Secondary Roads
+			if (properties.secondaryRoadNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Secondary));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.secondaryRoadNum);
+				offset += properties.secondaryRoadNum;
+			}
+			// Primary Roads
+			if (properties.primaryRoadNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Primary));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.primaryRoadNum);
+				offset += properties.primaryRoadNum;
+			}
+			// Trunk Roads
+			if (properties.trunkRoadNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Trunk));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.trunkRoadNum);
+				offset += properties.trunkRoadNum;
+			}
+			// Motorways
+			if (properties.motorwayNum > 0)
+			{
+				uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Motorway));
+				secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
+					SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
+				secCbo->drawIndexed(offset, properties.motorwayNum);
+				offset += properties.motorwayNum;
+			}
 
-					tileRes.swapResources[i].secCbo->bindPipeline(_deviceResources->roadPipe);
-					tileRes.swapResources[i].secCbo->bindDescriptorSet(
-						pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(), SetBinding::UBOStatic, _deviceResources->uboMvp.sets[i]);
+			secCbo->end();
+		}
+	}
+}
 
-					/**** Draw the roads ****/
+/*!*********************************************************************************************************************
+\brief  Stream the tiles in and out of GPU memory. The visible tiles are requested, followed by the tiles around them
+so that they are loaded before they come into view. Tiles whose uploads have completed are recorded and drawn from
+this frame on, and the tiles least recently needed are evicted when the loaded tiles exceed the memory budget.
+***********************************************************************************************************************/
+void VulkanNavigation2D::updateTileStreaming()
+{
+	// Draw the tiles whose uploads have completed
+	for (size_t i = 0; i < _loadingTiles.size();)
+	{
+		const uint32_t col = _loadingTiles[i] / _numRows;
+		const uint32_t row = _loadingTiles[i] % _numRows;
+		TileRenderingResources& tileRes = _tileRenderingResources[col][row];
+		if (_deviceResources->tileUploader.isComplete(tileRes.uploadToken))
+		{
+			recordTileCommands(col, row);
+			_tileResidency.setResident(_loadingTiles[i]);
+			_loadingTiles[i] = _loadingTiles.back();
+			_loadingTiles.pop_back();
+		}
+		else
+		{
+			++i;
+		}
+	}
 
-					// Service Roads
-					if (serviceRoadNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Service));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, serviceRoadNum);
-						offset += serviceRoadNum;
-					}
-					// Other (any other roads)
-					if (otherRoadNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Other));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, otherRoadNum);
-						offset += otherRoadNum;
-					}
-					// Secondary Roads
-					if (secondaryRoadNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Secondary));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, secondaryRoadNum);
-						offset += secondaryRoadNum;
-					}
-					// Primary Roads
-					if (primaryRoadNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Primary));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, primaryRoadNum);
-						offset += primaryRoadNum;
-					}
-					// Trunk Roads
-					if (trunkRoadNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Trunk));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, trunkRoadNum);
-						offset += trunkRoadNum;
-					}
-					// Motorways
-					if (motorwayNum > 0)
-					{
-						uboOffset = _deviceResources->uboColor.bufferView.getDynamicSliceOffset(static_cast<uint32_t>(MapColors::Motorway));
-						tileRes.swapResources[i].secCbo->bindDescriptorSet(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(),
-							SetBinding::UBODynamic, _deviceResources->uboColor.sets[0], &uboOffset, 1);
-						tileRes.swapResources[i].secCbo->drawIndexed(offset, motorwayNum);
-						offset += motorwayNum;
-					}
+	_tileResidency.beginFrame();
+	_visibleTiles.clear();
+	glm::vec2 visibleCenter(0.0f);
+	for (uint32_t col = 0; col < _numCols; ++col)
+	{
+		for (uint32_t row = 0; row < _numRows; ++row)
+		{
+			const Tile& tile = _OSMdata->getTiles()[col][row];
+			if (inFrustum(tile.screenMin, tile.screenMax))
+			{
+				_visibleTiles.push_back(col * _numRows + row);
+				visibleCenter += (tile.screenMin + tile.screenMax) * .5f;
+			}
+		}
+	}
+	if (!_visibleTiles.empty())
+	{
+		visibleCenter /= static_cast<float>(_visibleTiles.size());
+	}
 
-					tileRes.swapResources[i].secCbo->end();
-				}
+	// Tiles nearer the middle of the view are loaded first
+	auto getPriority = [&](uint32_t col, uint32_t row) {
+		const Tile& tile = _OSMdata->getTiles()[col][row];
+		const glm::vec2 offset = (tile.screenMin + tile.screenMax) * .5f - visibleCenter;
+		return glm::dot(offset, offset);
+	};
+	for (uint32_t tileIndex : _visibleTiles)
+	{
+		_tileResidency.request(tileIndex, getPriority(tileIndex / _numRows, tileIndex % _numRows), true);
+	}
+	for (uint32_t tileIndex : _visibleTiles)
+	{
+		const int32_t col = static_cast<int32_t>(tileIndex / _numRows);
+		const int32_t row = static_cast<int32_t>(tileIndex % _numRows);
+		for (int32_t neighbourCol = std::max(col - 1, 0); neighbourCol <= std::min(col + 1, static_cast<int32_t>(_numCols) - 1); ++neighbourCol)
+		{
+			for (int32_t neighbourRow = std::max(row - 1, 0); neighbourRow <= std::min(row + 1, static_cast<int32_t>(_numRows) - 1); ++neighbourRow)
+			{
+				_tileResidency.request(neighbourCol * _numRows + neighbourRow, getPriority(neighbourCol, neighbourRow), false);
 			}
 		}
 	}
+
+	_tileResidency.update(_tileLoads, _tileEvictions);
+	for (uint32_t tileIndex : _tileEvictions)
+	{
+		unloadTile(tileIndex / _numRows, tileIndex % _numRows);
+	}
+	for (uint32_t tileIndex : _tileLoads)
+	{
+		loadTile(tileIndex / _numRows, tileIndex % _numRows);
+	}
+	_deviceResources->tileUploader.submit();
 }
 
 /*!*********************************************************************************************************************
@@ -1470,34 +1732,10 @@ void VulkanNavigation2D::updateAnimation()
 	_rotation = wrapToSignedAngle(_rotation);
 }
 
-bool skipAmenityLabel(AmenityLabelData& labelData, Label& label, glm::dvec3& extent)
-{
-	// Check if labels overlap.
-	// Almost half extent (dividing by 1.95 to leave some padding between text) of
-	// the scaled text.
-	float halfExtent_x = label.text->getScaledDimension().x / 1.95f;
-
-	// Check if this and the previous text (in the same LOD level) overlap, if
-	// they do skip this text.
-	float distance = static_cast<float>(glm::distance(labelData.coords, glm::dvec2(extent)));
-	if (distance < (extent.z + halfExtent_x) && glm::abs(extent.z - halfExtent_x) < distance)
-	{
-		label.text.reset();
-		return true;
-	}
-
-	// Update with fresh data - position (stored in x, y components) and half
-	// extent (stored in z component).
-	extent = glm::vec3(labelData.coords, halfExtent_x);
-
-	return false;
-}
-
-bool skipLabel(LabelData& labelData, Label& label, glm::dvec3& extent)
+bool skipLabel(LabelData& labelData, Label& label)
 {
-	// Check if labels overlap.
 	// Almost half extent (dividing by 1.95 to leave some padding between text) of
-	// the scaled text.
+	// the scaled text. Overlaps between labels are resolved when they are placed.
 	float halfExtent_x = label.text->getScaledDimension().x / 1.95f;
 
 	// Check if this text crosses the tile boundary or the text overruns the end
@@ -1515,19 +1753,6 @@ bool skipLabel(LabelData& labelData, Label& label, glm::dvec3& extent)
 		return true;
 	}
 
-	// Check if this and the previous text (in the same LOD level) overlap, if
-	// they do skip this text.
-	float distance = static_cast<float>(glm::distance(labelData.coords, glm::dvec2(extent)));
-	if (distance < (extent.z + halfExtent_x) && glm::abs(extent.z - halfExtent_x) < distance)
-	{
-		label.text.reset();
-		return true;
-	}
-
-	// Update with fresh data - position (stored in x, y components) and half
-	// extent (stored in z component).
-	extent = glm::vec3(labelData.coords, halfExtent_x);
-
 	return false;
 }
 
@@ -1541,7 +1766,15 @@ void VulkanNavigation2D::createUIRendererItems()
 		for (uint32_t row = 0; row < _numRows; row++)
 		{
 			auto& tile = _OSMdata->getTiles()[col][row];
-			initializeRenderers(&_tileRenderingResources[col][row], &_tileRenderingResources[col][std::min(row + 1, _numRows - 1)], tile);
+			auto& tileRes = _tileRenderingResources[col][row];
+			initializeRenderers(&tileRes, &_tileRenderingResources[col][std::min(row + 1, _numRows - 1)], tile);
+
+			for (uint32_t lod = 0; lod < LOD::Count; ++lod)
+			{
+				tileRes.labelIsPlaced[lod].assign(tile.labels[lod].size(), false);
+				tileRes.amenityIconIsPlaced[lod].assign(tile.icons[lod].size(), false);
+				tileRes.amenityLabelIsPlaced[lod].assign(tile.amenityLabels[lod].size(), false);
+			}
 		}
 	}
 
@@ -1557,7 +1790,6 @@ void VulkanNavigation2D::createUIRendererItems()
 				{
 					const float txtScale = 1.0f / (scales[lod] * 12.0f);
 
-					glm::dvec3 extent(0, 0, 0);
 					if (!tile.icons[lod].empty() || !tile.labels[lod].empty() || !tile.amenityLabels[lod].empty())
 					{
 						tileRes.swapResources[swapIndex].tileGroup[lod] = tileRes.swapResources[swapIndex].renderer->createPixelGroup();
@@ -1609,11 +1841,6 @@ void VulkanNavigation2D::createUIRendererItems()
 							tileResAmenityLabel.label.text->setPixelOffset(-glm::abs(tileResAmenityLabel.iconData.coords - amenityLabel.coords));
 							tileResAmenityLabel.label.text->commitUpdates();
 
-							if (skipAmenityLabel(amenityLabel, tileResAmenityLabel.label, extent))
-							{
-								continue;
-							}
-
 							// add the label to its corresponding amenity group
 							tileResAmenityLabel.group->add(tileResAmenityLabel.label.text);
 							tileResAmenityLabel.group->commitUpdates();
@@ -1638,7 +1865,7 @@ void VulkanNavigation2D::createUIRendererItems()
 							tileResLabel.text->setPixelOffset(label.coords);
 							tileResLabel.text->commitUpdates();
 
-							if (skipLabel(label, tileResLabel, extent))
+							if (skipLabel(label, tileResLabel))
 							{
 								continue;
 							}
@@ -1706,8 +1933,9 @@ void VulkanNavigation2D::updateCommandBuffer(pvrvk::CommandBuffer& cbo, uint32_t
 		for (uint32_t j = 0; j < _numRows; ++j)
 		{
 			auto& tile = _tileRenderingResources[i][j];
-			// Render the tiles in the camera frustum.
-			if (inFrustum(_OSMdata->getTiles()[i][j].screenMin, _OSMdata->getTiles()[i][j].screenMax))
+			// Render the tiles in the camera frustum which have been streamed in.
+			if (inFrustum(_OSMdata->getTiles()[i][j].screenMin, _OSMdata->getTiles()[i][j].screenMax) &&
+				_tileResidency.getState(i * _numRows + j) == TileResidency::State::Resident)
 			{
 				if (!tile.swapResources[swapchainIndex].tileWasVisible)
 				{
@@ -1748,9 +1976,10 @@ void VulkanNavigation2D::updateCommandBuffer(pvrvk::CommandBuffer& cbo, uint32_t
 
 		for (auto&& tile : renderqueue)
 		{
-			if (tile->swapResources[swapchainIndex].secCbo.isValid())
+			const pvrvk::SecondaryCommandBuffer& secCbo = tile->swapResources[swapchainIndex].secCbo[MapGeometryLODs[_currentScaleLevel]];
+			if (secCbo.isValid())
 			{
-				cbo->executeCommands(tile->swapResources[swapchainIndex].secCbo);
+				cbo->executeCommands(secCbo);
 			}
 
 			for (uint16_t lod = _currentScaleLevel; lod < LOD::Count; ++lod)
@@ -1794,27 +2023,145 @@ bool VulkanNavigation2D::inFrustum(glm::vec2 min, glm::vec2 max)
 	return pvr::math::aabbInFrustum(aabb, _viewFrustum);
 }
 
+/*!*********************************************************************************************************************
+\param col  Column index for tile.
+\param row  Row index for tile.
+\brief Move the label groups of a tile with the camera. A group is only committed, which updates every item in it, when
+the camera moved or the labels were placed again since the last update.
+***********************************************************************************************************************/
 void VulkanNavigation2D::updateGroups(uint32_t col, uint32_t row, uint32_t swapindex)
 {
 	const glm::vec2 pixelOffset = _translation * _scale;
-	TileRenderingResources& tileRes = _tileRenderingResources[col][row];
+	const float cameraRotation = _rotation + MapScreenAlignRotation;
+	const glm::vec4 camera(pixelOffset, _scale, cameraRotation);
+	PerSwapTileResources& swapRes = _tileRenderingResources[col][row].swapResources[swapindex];
 
 	for (uint32_t lod = _currentScaleLevel; lod < LOD::Count; ++lod)
 	{
-		if (tileRes.swapResources[swapindex].tileGroup[lod].isValid())
+		if (swapRes.uiCamera[lod] == camera && swapRes.uiLabelPlacementId[lod] == _labelPlacementId)
+		{
+			continue;
+		}
+		swapRes.uiCamera[lod] = camera;
+		swapRes.uiLabelPlacementId[lod] = _labelPlacementId;
+
+		if (swapRes.tileGroup[lod].isValid())
+		{
+			swapRes.tileGroup[lod]->setAnchor(pvr::ui::Anchor::Center, 0, 0);
+			swapRes.tileGroup[lod]->setPixelOffset(pixelOffset.x, pixelOffset.y);
+			swapRes.tileGroup[lod]->setScale(_scale, _scale);
+			swapRes.tileGroup[lod]->commitUpdates();
+		}
+		if (swapRes.cameraRotateGroup[lod].isValid())
+		{
+			swapRes.cameraRotateGroup[lod]->setRotation(glm::radians(cameraRotation));
+			swapRes.cameraRotateGroup[lod]->setAnchor(pvr::ui::Anchor::Center, 0, 0);
+			swapRes.cameraRotateGroup[lod]->commitUpdates();
+		}
+	}
+}
+
+/*!*********************************************************************************************************************
+\brief  Place the labels, amenity icons and amenity labels of the visible tiles in order of priority, hiding the ones
+that overlap an item placed before them. Items are placed in screen pixels relative to the camera before it rotates,
+where the map only moves when the camera zooms. The placement is only repeated when the visible tiles or the level of
+detail change, or when the scale or the rotation of the camera drift from those the items were placed with.
+***********************************************************************************************************************/
+void VulkanNavigation2D::updateLabelPlacement()
+{
+	const float cameraRotation = _rotation + MapScreenAlignRotation;
+
+	_visibleTiles.clear();
+	for (uint32_t col = 0; col < _numCols; ++col)
+	{
+		for (uint32_t row = 0; row < _numRows; ++row)
 		{
-			tileRes.swapResources[swapindex].tileGroup[lod]->setAnchor(pvr::ui::Anchor::Center, 0, 0);
-			tileRes.swapResources[swapindex].tileGroup[lod]->setPixelOffset(pixelOffset.x, pixelOffset.y);
-			tileRes.swapResources[swapindex].tileGroup[lod]->setScale(_scale, _scale);
-			tileRes.swapResources[swapindex].tileGroup[lod]->commitUpdates();
+			if (inFrustum(_OSMdata->getTiles()[col][row].screenMin, _OSMdata->getTiles()[col][row].screenMax))
+			{
+				_visibleTiles.push_back(col * _numRows + row);
+			}
 		}
-		if (tileRes.swapResources[swapindex].cameraRotateGroup[lod].isValid())
+	}
+
+	if (_visibleTiles == _placedTiles && _currentScaleLevel == _placedScaleLevel && glm::abs(_scale / _placedScale - 1.0f) <= LabelPlacementScaleTolerance &&
+		glm::abs(wrapToSignedAngle(cameraRotation - _placedRotation)) <= LabelPlacementRotationTolerance)
+	{
+		return;
+	}
+	_placedTiles.swap(_visibleTiles);
+	_placedScaleLevel = _currentScaleLevel;
+	_placedScale = _scale;
+	_placedRotation = cameraRotation;
+	++_labelPlacementId;
+
+	// Amenities stay upright on the screen, so they turn against the camera
+	const float amenityAngle = glm::radians(-cameraRotation);
+	const glm::vec2 amenityAxis(glm::cos(amenityAngle), glm::sin(amenityAngle));
+	const float amenityTextScale = 1.0f / (_scale * 15.0f);
+
+	glm::vec2 gridMin(std::numeric_limits<float>::max());
+	glm::vec2 gridMax(-std::numeric_limits<float>::max());
+	_labelCandidates.clear();
+	for (uint32_t tileIndex : _placedTiles)
+	{
+		const uint32_t col = tileIndex / _numRows;
+		const uint32_t row = tileIndex % _numRows;
+		const Tile& tile = _OSMdata->getTiles()[col][row];
+		TileRenderingResources& tileRes = _tileRenderingResources[col][row];
+		// The items of every swapchain image have the same size
+		const PerSwapTileResources& swapRes = tileRes.swapResources[0];
+
+		gridMin = glm::min(gridMin, tile.screenMin * _scale);
+		gridMax = glm::max(gridMax, tile.screenMax * _scale);
+
+		for (uint32_t lod = _currentScaleLevel; lod < LOD::Count; ++lod)
 		{
-			tileRes.swapResources[swapindex].cameraRotateGroup[lod]->setRotation(glm::radians(_rotation + MapScreenAlignRotation));
-			tileRes.swapResources[swapindex].cameraRotateGroup[lod]->setAnchor(pvr::ui::Anchor::Center, 0, 0);
-			tileRes.swapResources[swapindex].cameraRotateGroup[lod]->commitUpdates();
+			for (uint32_t i = 0; i < swapRes.amenityIcons[lod].size(); ++i)
+			{
+				const AmenityIconGroup& amenityIcon = swapRes.amenityIcons[lod][i];
+				const float iconScale = glm::clamp(1.0f / (_scale * 20.0f), amenityIcon.iconData.scale, amenityIcon.iconData.scale * 2.0f);
+				const glm::vec2 halfExtent = amenityIcon.icon.image->getDimensions() * (iconScale * _scale * .5f) + LabelPadding;
+				_labelCandidates.push_back(LabelCandidate{ lod, 0, 0.0f,
+					LabelCollisionGrid::makeBox(glm::vec2(amenityIcon.iconData.coords) * _scale, halfExtent, amenityAngle, amenityIcon.iconData.id),
+					&tileRes.amenityIconIsPlaced[lod], i });
+			}
+
+			for (uint32_t i = 0; i < swapRes.labels[lod].size(); ++i)
+			{
+				const Label& label = swapRes.labels[lod][i];
+				if (label.text.isNull())
+				{
+					continue;
+				}
+				const LabelData& labelData = tile.labels[lod][i];
+				const glm::vec2 halfExtent = label.text->getScaledDimension() * (_scale * .5f) + LabelPadding;
+				_labelCandidates.push_back(LabelCandidate{ lod, 1, labelData.scale,
+					LabelCollisionGrid::makeBox(glm::vec2(labelData.coords) * _scale, halfExtent, glm::radians(labelData.rotation)), &tileRes.labelIsPlaced[lod], i });
+			}
+
+			for (uint32_t i = 0; i < swapRes.amenityLabels[lod].size(); ++i)
+			{
+				const AmenityLabelGroup& amenityLabel = swapRes.amenityLabels[lod][i];
+				if (amenityLabel.label.text.isNull())
+				{
+					continue;
+				}
+				// The label is below its icon on the screen, so it may overlap the icon but nothing else
+				const float below = 2.2f * amenityLabel.label.text->getBoundingBox().getHalfExtent().y * amenityTextScale * _scale;
+				const glm::vec2 center = glm::vec2(amenityLabel.iconData.coords) * _scale + glm::vec2(amenityAxis.y, -amenityAxis.x) * below;
+				const glm::vec2 halfExtent = amenityLabel.label.text->getDimensions() * (amenityTextScale * _scale * .5f) + LabelPadding;
+				_labelCandidates.push_back(LabelCandidate{ lod, 2, 0.0f, LabelCollisionGrid::makeBox(center, halfExtent, amenityAngle, amenityLabel.iconData.id),
+					&tileRes.amenityLabelIsPlaced[lod], i });
+			}
 		}
 	}
+
+	std::stable_sort(_labelCandidates.begin(), _labelCandidates.end());
+	_labelGrid.reset(gridMin, gridMax, LabelGridCellSize, LabelGridMaxCells);
+	for (const LabelCandidate& candidate : _labelCandidates)
+	{
+		(*candidate.isPlaced)[candidate.index] = _labelGrid.tryPlace(candidate.box);
+	}
 }
 
 /*!*********************************************************************************************************************
@@ -1822,37 +2169,35 @@ void VulkanNavigation2D::updateGroups(uint32_t col, uint32_t row, uint32_t swapi
 \param row  Row index for tile.
 \brief Update the renderable text (dependant on LOD level) using the
 pre-processed data (position, _scale, _rotation, std::string) and UIRenderer.
+Only the labels that flip or were placed differently are committed.
 ***********************************************************************************************************************/
 void VulkanNavigation2D::updateLabels(uint32_t col, uint32_t row, uint32_t swapchainIndex)
 {
 	Tile& tile = _OSMdata->getTiles()[col][row];
 	TileRenderingResources& tileRes = _tileRenderingResources[col][row];
+	PerSwapTileResources& swapRes = tileRes.swapResources[swapchainIndex];
+	const float cameraRotation = _rotation + MapScreenAlignRotation;
 
 	for (uint32_t lod = _currentScaleLevel; lod < LOD::Count; ++lod)
 	{
-		for (uint32_t labelIdx = 0; labelIdx < tile.labels[lod].size(); ++labelIdx)
+		// The labels only change when the camera rotates or they are placed again
+		if (swapRes.uiCamera[lod].w == cameraRotation && swapRes.uiLabelPlacementId[lod] == _labelPlacementId)
 		{
-			auto& tileResLabelLod = tileRes.swapResources[swapchainIndex].labels[lod];
-
-			if (tileResLabelLod.empty())
-			{
-				continue;
-			}
+			continue;
+		}
 
-			auto& tileLabel = tile.labels[lod][labelIdx];
-			auto& tileResLabel = tileRes.swapResources[swapchainIndex].labels[lod][labelIdx];
+		for (uint32_t labelIdx = 0; labelIdx < swapRes.labels[lod].size(); ++labelIdx)
+		{
+			Label& tileResLabel = swapRes.labels[lod][labelIdx];
 			if (tileResLabel.text.isNull())
 			{
 				continue;
 			}
-
-			glm::dvec2 offset(0, 0);
-
-			float txtScale = tileLabel.scale * 2.0f;
+			const LabelData& tileLabel = tile.labels[lod][labelIdx];
 
 			// Make sure road text is displayed upright (between 90 deg and -90 deg),
 			// otherwise flip it.
-			float total_angle = tileLabel.rotation + _rotation + MapScreenAlignRotation; // Use that to calculate if the text is upright
+			float total_angle = tileLabel.rotation + cameraRotation; // Use that to calculate if the text is upright
 			float angle = tileLabel.rotation;
 
 			// check whether the label needs flipping
@@ -1870,13 +2215,17 @@ void VulkanNavigation2D::updateLabels(uint32_t col, uint32_t row, uint32_t swapc
 			// make the angle between (-180, 180]
 			angle = wrapToSignedAngle(angle);
 
-			float aabbHeight = tileResLabel.text->getBoundingBox().getSize().y;
-
-			offset.y += tileLabel.scale * aabbHeight * 0.6f; // CENTRE THE TEXT ON THE ROAD
+			const bool isPlaced = tileRes.labelIsPlaced[lod][labelIdx];
+			if (angle == tileResLabel.angle && isPlaced == tileResLabel.isPlaced)
+			{
+				continue;
+			}
+			tileResLabel.angle = angle;
+			tileResLabel.isPlaced = isPlaced;
 
-			// rotate the label to align with the road rotation
+			// rotate the label to align with the road rotation, and hide it if it overlaps a more important label
 			tileResLabel.text->setRotation(glm::radians(angle));
-			tileResLabel.text->setScale(txtScale, txtScale);
+			tileResLabel.text->setColor(0.f, 0.f, 0.f, isPlaced ? 1.f : 0.f);
 			tileResLabel.text->commitUpdates();
 		}
 	}
@@ -1892,12 +2241,20 @@ UIRenderer.
 void VulkanNavigation2D::updateAmenities(uint32_t col, uint32_t row, uint32_t swapchainIndex)
 {
 	TileRenderingResources& tileRes = _tileRenderingResources[col][row];
-	const float rotation = -_rotation - MapScreenAlignRotation;
+	PerSwapTileResources& swapRes = tileRes.swapResources[swapchainIndex];
+	const float cameraRotation = _rotation + MapScreenAlignRotation;
+	const float rotation = -cameraRotation;
 	for (uint32_t lod = _currentScaleLevel; lod < LOD::Count; ++lod)
 	{
-		for (uint32_t amenityIconIndex = 0; amenityIconIndex < tileRes.swapResources[swapchainIndex].amenityIcons[lod].size(); ++amenityIconIndex)
+		// The amenities only change when the camera zooms or rotates, or they are placed again
+		if (swapRes.uiCamera[lod].z == _scale && swapRes.uiCamera[lod].w == cameraRotation && swapRes.uiLabelPlacementId[lod] == _labelPlacementId)
+		{
+			continue;
+		}
+
+		for (uint32_t amenityIconIndex = 0; amenityIconIndex < swapRes.amenityIcons[lod].size(); ++amenityIconIndex)
 		{
-			AmenityIconGroup& amenityIcon = tileRes.swapResources[swapchainIndex].amenityIcons[lod][amenityIconIndex];
+			AmenityIconGroup& amenityIcon = swapRes.amenityIcons[lod][amenityIconIndex];
 			debug_assertion(amenityIcon.icon.image.isValid(), "Amenity Icon must be a valid UIRenderer Icon");
 
 			float iconScale = (1.0f / (_scale * 20.0f));
@@ -1906,15 +2263,18 @@ void VulkanNavigation2D::updateAmenities(uint32_t col, uint32_t row, uint32_t sw
 			amenityIcon.icon.image->setScale(glm::vec2(iconScale));
 			amenityIcon.icon.image->commitUpdates();
 
-			// reverse the rotation applied by the camera rotation group
+			// reverse the rotation applied by the camera rotation group, and hide the icon if it overlaps a more
+			// important label. The image is shared by all the icons of its type, so the group is scaled instead.
+			const float groupScale = tileRes.amenityIconIsPlaced[lod][amenityIconIndex] ? 1.f : 0.f;
 			amenityIcon.group->setRotation(glm::radians(rotation));
+			amenityIcon.group->setScale(groupScale, groupScale);
 			amenityIcon.group->setPixelOffset(static_cast<float>(amenityIcon.iconData.coords.x), static_cast<float>(amenityIcon.iconData.coords.y));
 			amenityIcon.group->commitUpdates();
 		}
 
-		for (uint32_t amenityLabelIndex = 0; amenityLabelIndex < tileRes.swapResources[swapchainIndex].amenityLabels[lod].size(); ++amenityLabelIndex)
+		for (uint32_t amenityLabelIndex = 0; amenityLabelIndex < swapRes.amenityLabels[lod].size(); ++amenityLabelIndex)
 		{
-			AmenityLabelGroup& amenityLabel = tileRes.swapResources[swapchainIndex].amenityLabels[lod][amenityLabelIndex];
+			AmenityLabelGroup& amenityLabel = swapRes.amenityLabels[lod][amenityLabelIndex];
 			if (amenityLabel.label.text.isNull())
 			{
 				continue;
@@ -1927,8 +2287,11 @@ void VulkanNavigation2D::updateAmenities(uint32_t col, uint32_t row, uint32_t sw
 			amenityLabel.label.text->setPixelOffset(0.0f, -2.2f * amenityLabel.label.text->getBoundingBox().getHalfExtent().y * txtScale);
 			amenityLabel.label.text->commitUpdates();
 
-			// reverse the rotation applied by the camera rotation group
+			// reverse the rotation applied by the camera rotation group, and hide the label if it overlaps a more
+			// important one
+			const float groupScale = tileRes.amenityLabelIsPlaced[lod][amenityLabelIndex] ? 1.f : 0.f;
 			amenityLabel.group->setRotation(glm::radians(rotation));
+			amenityLabel.group->setScale(groupScale, groupScale);
 			amenityLabel.group->setPixelOffset(static_cast<float>(amenityLabel.iconData.coords.x), static_cast<float>(amenityLabel.iconData.coords.y));
 			amenityLabel.group->commitUpdates();
 		}
@@ -10,6 +10,7 @@
 #include "PVRUtils/PVRUtilsVk.h"
 #define NAV_3D
 #include "../../common/NavDataProcess.h"
+#include "../../common/TileResidency.h"
 #include "../../../external/glm/gtx/vector_angle.hpp"
 #include "PVRCore/math/AxisAlignedBox.h"
 #include "PVRCore/cameras/TPSCamera.h"
@@ -95,6 +96,9 @@ struct DeviceResources
 	pvr::ui::Font font;
 	pvr::ui::Text text[pvrvk::FrameworkCaps::MaxSwapChains];
 
+	// Uploads the buffers of the tiles as they are streamed in
+	pvr::utils::StreamingUploader tileUploader;
+
 	~DeviceResources()
 	{
 		if (device.isValid())
@@ -115,6 +119,24 @@ struct TileRenderingResources
 	pvrvk::Buffer vbo;
 	pvrvk::Buffer ibo;
 	pvr::Multi<pvrvk::SecondaryCommandBuffer> secCbo;
+
+	// The number of indices of each kind of geometry in the index buffer, in the order that they are drawn
+	uint32_t parkingNum;
+	uint32_t areaNum;
+	uint32_t roadAreaOutlineNum;
+	uint32_t motorwayNum;
+	uint32_t trunkRoadNum;
+	uint32_t primaryRoadNum;
+	uint32_t secondaryRoadNum;
+	uint32_t serviceRoadNum;
+	uint32_t otherRoadNum;
+	uint32_t buildNum;
+	uint32_t innerNum;
+
+	// The upload of the buffers while the tile is loading
+	pvr::utils::StreamingUploader::Token uploadToken;
+
+	TileRenderingResources() : uploadToken(0) {}
 };
 
 // Alpha, luminance texture.
@@ -127,6 +149,11 @@ static const float CameraMoveSpeed = 1.f;
 static const float CameraRotationSpeed = .5f;
 static const float CamRotationTime = 10000.f;
 
+// Tile streaming. The memory the vertex and index buffers of the tiles may use before tiles are evicted, and the
+// largest number of tiles that start uploading in a frame.
+static const uint64_t TileMemoryBudget = 64 * 1024 * 1024;
+static const uint32_t MaxTileLoadsPerFrame = 4;
+
 inline float cameraRotationTimeInMs(float angleDeg)
 {
 	return glm::abs(angleDeg / 360.f * CamRotationTime);
@@ -154,6 +181,13 @@ private:
 
 	std::vector<std::vector<std::unique_ptr<TileRenderingResources> > > _tileRenderingResources;
 
+	// Tile streaming
+	TileResidency _tileResidency;
+	std::vector<uint32_t> _visibleTiles;
+	std::vector<uint32_t> _loadingTiles;
+	std::vector<uint32_t> _tileLoads;
+	std::vector<uint32_t> _tileEvictions;
+
 	// Uniforms
 	glm::mat4 _viewProjMatrix;
 	glm::mat4 _viewMatrix;
@@ -191,7 +225,12 @@ private:
 	glm::vec4 _parkingColor;
 	glm::vec4 _outlineColor;
 
-	void createBuffers(pvrvk::CommandBuffer& uploadCmd);
+	void createTileGeometry();
+	void generateTileGeometry(uint32_t col, uint32_t row);
+	void loadTile(uint32_t col, uint32_t row);
+	void unloadTile(uint32_t col, uint32_t row);
+	void recordTileCommands(uint32_t col, uint32_t row);
+	void updateTileStreaming();
 	bool createUbos();
 	void initTextureAndSampler(pvrvk::CommandBuffer& uploadCmdBuffer);
 
@@ -262,7 +301,7 @@ pvr::Result VulkanNavigation3D::initApplication()
 	// for performance/color space correctness.
 
 	_OSMdata.reset(new NavDataProcess(getAssetStream(MapFile), glm::ivec2(_windowWidth, _windowHeight)));
-	pvr::Result result = _OSMdata->loadAndProcessData();
+	pvr::Result result = _OSMdata->loadAndProcessData(getWritePath() + getApplicationName() + ".navmap");
 	if (result != pvr::Result::Success)
 	{
 		return result;
@@ -434,7 +473,12 @@ pvr::Result VulkanNavigation3D::initView()
 	}
 
 	setUniforms();
-	createBuffers(_deviceResources->cbos[0]);
+	_tileResidency.init(_numCols * _numRows, TileMemoryBudget, _deviceResources->swapchain->getSwapchainLength(), MaxTileLoadsPerFrame);
+	createTileGeometry();
+
+	// The buffers of the tiles are streamed in once rendering starts
+	_deviceResources->tileUploader.init(_deviceResources->device, _deviceResources->queue, queueAccessInfo.familyId, _deviceResources->vmaAllocator);
+	_loadingTiles.clear();
 	recordUICommands();
 	_OSMdata->convertRoute(glm::dvec2(0), 0, 0, _totalRouteDistance);
 	_deviceResources->cbos[0]->end();
@@ -616,287 +660,400 @@ void VulkanNavigation3D::createShadowMatrix()
 }
 
 /*!*********************************************************************************************************************
-\brief	Creates vertex and index buffers and records the secondary command buffers for each tile.
+\brief	Generate the vertices, indices and normals of all the tiles, and set the size of the buffers of each tile. Their
+buffers are created when the tiles are streamed in.
 ***********************************************************************************************************************/
-void VulkanNavigation3D::createBuffers(pvrvk::CommandBuffer& uploadCmd)
+void VulkanNavigation3D::createTileGeometry()
 {
-	uint32_t col = 0;
-	uint32_t row = 0;
+	// Generate the vertices, indices and normals of the tiles on all the threads, each tile only writes its own data
+	parallelFor(_numCols * _numRows, [&](uint32_t tileIndex) {
+		const uint32_t col = tileIndex / _numRows;
+		const uint32_t row = tileIndex % _numRows;
+		Tile& tile = _OSMdata->getTiles()[col][row];
+
+		_tileRenderingResources[col][row].reset(new TileRenderingResources());
+
+		// Set the min and max coordinates for the tile
+		tile.screenMin = remap(tile.min, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5));
+		tile.screenMax = remap(tile.max, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5));
+
+		generateTileGeometry(col, row);
+	});
 
+	for (uint32_t tileIndex = 0; tileIndex < _numCols * _numRows; ++tileIndex)
+	{
+		const Tile& tile = _OSMdata->getTiles()[tileIndex / _numRows][tileIndex % _numRows];
+		_tileResidency.setSize(tileIndex, tile.vertices.size() * sizeof(tile.vertices[0]) + tile.indices.size() * sizeof(tile.indices[0]));
+	}
+}
+
+/*!*********************************************************************************************************************
+\param	col Column index for tile.
+\param	row Row index for tile.
+\brief	Generate the vertices, indices and normals of a tile. They are released once they have been uploaded, and generated
+again if the tile is streamed in again after being evicted.
+***********************************************************************************************************************/
+void VulkanNavigation3D::generateTileGeometry(uint32_t col, uint32_t row)
+{
+	Tile& tile = _OSMdata->getTiles()[col][row];
+	TileRenderingResources& tileResource = *_tileRenderingResources[col][row];
+	tile.vertices.clear();
+	tile.indices.clear();
+
+	// Create vertices for tile, in node id order
+	for (auto nodeIterator : tile.nodes.getSortedById())
+	{
+		nodeIterator->second.index = static_cast<uint32_t>(tile.vertices.size());
+
+		glm::vec2 remappedPos =
+			glm::vec2(remap(nodeIterator->second.coords, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5)));
+		glm::vec3 vertexPos = glm::vec3(remappedPos.x, nodeIterator->second.height, remappedPos.y);
+		tile.vertices.push_back(Tile::VertexData(vertexPos, nodeIterator->second.texCoords));
+	}
+
+	// Add car parking to indices
+	tileResource.parkingNum = ::generateIndices(tile, tile.parkingWays);
+
+	// Add road area ways to indices
+	tileResource.areaNum = ::generateIndices(tile, tile.areaWays);
+
+	// Add road area outlines to indices
+	tileResource.roadAreaOutlineNum = ::generateIndices(tile, tile.areaOutlineIds);
+
+	// Add roads to indices
+	tileResource.motorwayNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Motorway);
+	tileResource.trunkRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Trunk);
+	tileResource.primaryRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Primary);
+	tileResource.secondaryRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Secondary);
+	tileResource.serviceRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Service);
+	tileResource.otherRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Other);
+
+	// Add buildings to indices
+	tileResource.buildNum = ::generateIndices(tile, tile.buildWays);
+
+	// Add inner ways to indices
+	tileResource.innerNum = ::generateIndices(tile, tile.innerWays);
+
+	::generateNormals(tile, static_cast<uint32_t>(tile.indices.size() - (tileResource.innerNum + tileResource.buildNum)), tileResource.buildNum);
+}
+
+/*!*********************************************************************************************************************
+\param	col Column index for tile.
+\param	row Row index for tile.
+\brief	Create the device local vertex and index buffers of a tile and queue their uploads. The uploads of all the tiles
+loaded in a frame are submitted together, and the tile is drawn once they have completed. The vertices and indices of
+the tile are released once they have been copied for the upload.
+***********************************************************************************************************************/
+void VulkanNavigation3D::loadTile(uint32_t col, uint32_t row)
+{
+	Tile& tile = _OSMdata->getTiles()[col][row];
+	TileRenderingResources& tileRes = *_tileRenderingResources[col][row];
+	const uint32_t tileIndex = col * _numRows + row;
+	if (!_tileResidency.getSize(tileIndex))
+	{
+		_tileResidency.setResident(tileIndex);
+		return;
+	}
+	if (tile.vertices.empty())
+	{
+		generateTileGeometry(col, row);
+	}
+
+	// Interleaved vertex buffer (vertex position + texCoord)
+	const pvrvk::DeviceSize vboSize = static_cast<pvrvk::DeviceSize>(tile.vertices.size() * sizeof(tile.vertices[0]));
+	tileRes.vbo = pvr::utils::createBuffer(_deviceResources->device, vboSize, pvrvk::BufferUsageFlags::e_VERTEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT,
+		pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, &_deviceResources->vmaAllocator, pvr::utils::vma::AllocationCreateFlags::e_NONE);
+
+	const pvrvk::DeviceSize iboSize = static_cast<pvrvk::DeviceSize>(tile.indices.size() * sizeof(tile.indices[0]));
+	tileRes.ibo = pvr::utils::createBuffer(_deviceResources->device, iboSize, pvrvk::BufferUsageFlags::e_INDEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT,
+		pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, &_deviceResources->vmaAllocator, pvr::utils::vma::AllocationCreateFlags::e_NONE);
+
+	_deviceResources->tileUploader.uploadBuffer(tileRes.vbo, tile.vertices.data(), 0, vboSize);
+	tileRes.uploadToken = _deviceResources->tileUploader.uploadBuffer(tileRes.ibo, tile.indices.data(), 0, iboSize);
+	_loadingTiles.push_back(tileIndex);
+
+	// The uploader has copied the data, so the tile keeps no copy of its geometry while it is resident
+	std::vector<Tile::VertexData>().swap(tile.vertices);
+	std::vector<uint32_t>().swap(tile.indices);
+}
+
+/*!*********************************************************************************************************************
+\param	col Column index for tile.
+\param	row Row index for tile.
+\brief	Release the buffers and command buffers of a tile that has been evicted.
+***********************************************************************************************************************/
+void VulkanNavigation3D::unloadTile(uint32_t col, uint32_t row)
+{
+	TileRenderingResources& tileRes = *_tileRenderingResources[col][row];
+	for (uint32_t i = 0; i < tileRes.secCbo.size(); ++i)
+	{
+		tileRes.secCbo[i].reset();
+	}
+	tileRes.secCbo.clear();
+	tileRes.vbo.reset();
+	tileRes.ibo.reset();
+}
+
+/*!*********************************************************************************************************************
+\param	col Column index for tile.
+\param	row Row index for tile.
+\brief	Record the secondary command buffers drawing a tile whose buffers have been uploaded.
+***********************************************************************************************************************/
+void VulkanNavigation3D::recordTileCommands(uint32_t col, uint32_t row)
+{
+	TileRenderingResources* tileRes = _tileRenderingResources[col][row].get();
 	const uint32_t swapchainLength = _deviceResources->swapchain->getSwapchainLength();
-	for (auto& tileCol : _OSMdata->getTiles())
+	uint32_t uboOffset = 0;
+
+	// Record Secondary commands
+	for (uint32_t i = 0; i < swapchainLength; ++i)
 	{
-		for (Tile& tile : tileCol)
-		{
-			_tileRenderingResources[col][row].reset(new TileRenderingResources());
+		uint32_t offset = 0;
+		tileRes->secCbo.add(_deviceResources->cmdPool->allocateSecondaryCommandBuffer());
+		pvrvk::SecondaryCommandBuffer& cmdBuffer = tileRes->secCbo[i];
 
-			// Set the min and max coordinates for the tile
-			tile.screenMin = remap(tile.min, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5));
-			tile.screenMax = remap(tile.max, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5));
+		uboOffset = _deviceResources->uboDynamic.bufferView.getDynamicSliceOffset(i);
+		cmdBuffer->begin(_deviceResources->fbo[i]);
 
-			// Create vertices for tile
-			for (auto nodeIterator = tile.nodes.begin(); nodeIterator != tile.nodes.end(); ++nodeIterator)
-			{
-				nodeIterator->second.index = static_cast<uint32_t>(tile.vertices.size());
+		// Bind the Dynamic and static buffers
+		pvrvk::DescriptorSet descSets[] = { _deviceResources->uboDynamic.set, _deviceResources->uboStatic.set };
+		cmdBuffer->bindDescriptorSets(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(), 0, descSets, ARRAY_SIZE(descSets), &uboOffset, 1);
+
+		// Bind the vertex and index buffers for the tile
+		cmdBuffer->bindVertexBuffer(tileRes->vbo, 0, 0);
+		cmdBuffer->bindIndexBuffer(tileRes->ibo, 0, pvrvk::IndexType::e_UINT32);
+
+		pvrvk::GraphicsPipeline lastBoundPipeline;
+		// Draw the car parking
+		if (tileRes->parkingNum > 0)
+		{
+			glm::vec4 colorId = _parkingColor;
+			cmdBuffer->pushConstants(_deviceResources->fillPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			cmdBuffer->bindPipeline(_deviceResources->fillPipe);
+			lastBoundPipeline = _deviceResources->fillPipe;
+			cmdBuffer->drawIndexed(0, tileRes->parkingNum);
+			offset += tileRes->parkingNum;
+		}
 
-				glm::vec2 remappedPos =
-					glm::vec2(remap(nodeIterator->second.coords, _OSMdata->getTiles()[0][0].min, _OSMdata->getTiles()[0][0].max, glm::dvec2(-5, -5), glm::dvec2(5, 5)));
-				glm::vec3 vertexPos = glm::vec3(remappedPos.x, nodeIterator->second.height, remappedPos.y);
-				tile.vertices.push_back(Tile::VertexData(vertexPos, nodeIterator->second.texCoords));
+		// Draw the road areas
+		if (tileRes->areaNum > 0)
+		{
+			const glm::vec4 colorId = _roadAreaColor;
+			cmdBuffer->pushConstants(_deviceResources->fillPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			if (lastBoundPipeline != _deviceResources->fillPipe)
+			{
+				cmdBuffer->bindPipeline(_deviceResources->fillPipe);
+				lastBoundPipeline = _deviceResources->fillPipe;
 			}
+			cmdBuffer->drawIndexed(offset, tileRes->areaNum);
+			offset += tileRes->areaNum;
+		}
 
-			// Add car parking to indices
-			uint32_t parkingNum = ::generateIndices(tile, tile.parkingWays);
+		// Draw the outlines for road areas
+		if (tileRes->roadAreaOutlineNum > 0)
+		{
+			const glm::vec4 colorId = _outlineColor;
+			cmdBuffer->pushConstants(_deviceResources->outlinePipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			if (lastBoundPipeline != _deviceResources->outlinePipe)
+			{
+				cmdBuffer->bindPipeline(_deviceResources->outlinePipe);
+				lastBoundPipeline = _deviceResources->outlinePipe;
+			}
+			cmdBuffer->drawIndexed(offset, tileRes->roadAreaOutlineNum);
+			offset += tileRes->roadAreaOutlineNum;
+		}
 
-			// Add road area ways to indices
-			uint32_t areaNum = ::generateIndices(tile, tile.areaWays);
+		/**** Draw the roads ****/
+		if (lastBoundPipeline != _deviceResources->roadPipe &&
+			(tileRes->motorwayNum + tileRes->trunkRoadNum + tileRes->primaryRoadNum + tileRes->secondaryRoadNum + tileRes->serviceRoadNum + tileRes->otherRoadNum) > 0)
+		{
+			cmdBuffer->bindPipeline(_deviceResources->roadPipe);
+			lastBoundPipeline = _deviceResources->roadPipe;
+			cmdBuffer->bindDescriptorSet(
+				pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(), SetBinding::TextureSampler, _deviceResources->imageSamplerDescSet);
+		}
 
-			// Add road area outlines to indices
-			uint32_t roadAreaOutlineNum = ::generateIndices(tile, tile.areaOutlineIds);
+		// Motorways
+		if (tileRes->motorwayNum > 0)
+		{
+			const glm::vec4 colorId = _motorwayColor;
+			cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			cmdBuffer->bindPipeline(_deviceResources->roadPipe);
+			lastBoundPipeline = _deviceResources->roadPipe;
+			cmdBuffer->drawIndexed(offset, tileRes->motorwayNum);
+			offset += tileRes->motorwayNum;
+		}
 
-			// Add roads to indices
-			uint32_t motorwayNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Motorway);
-			uint32_t trunkRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Trunk);
-			uint32_t primaryRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Primary);
-			uint32_t secondaryRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Secondary);
-			uint32_t serviceRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Service);
-			uint32_t otherRoadNum = ::generateIndices(tile, tile.roadWays, RoadTypes::Other);
+		// Trunk Roads
+		if (tileRes->trunkRoadNum > 0)
+		{
+			const glm::vec4 colorId = _trunkRoadColor;
+			cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			cmdBuffer->bindPipeline(_deviceResources->roadPipe);
+			lastBoundPipeline = _deviceResources->roadPipe;
+			cmdBuffer->drawIndexed(offset, tileRes->trunkRoadNum);
+			offset += tileRes->trunkRoadNum;
+		}
 
-			// Add buildings to indices
-			uint32_t buildNum = ::generateIndices(tile, tile.buildWays);
+		// Primary Roads
+		if (tileRes->primaryRoadNum > 0)
+		{
+			const glm::vec4 colorId = _primaryRoadColor;
+			cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			cmdBuffer->bindPipeline(_deviceResources->roadPipe);
+			lastBoundPipeline = _deviceResources->roadPipe;
+			cmdBuffer->drawIndexed(offset, tileRes->primaryRoadNum);
+			offset += tileRes->primaryRoadNum;
+		}
 
-			// Add inner ways to indices
-			uint32_t innerNum = ::generateIndices(tile, tile.innerWays);
+		// Secondary Roads
+		if (tileRes->secondaryRoadNum > 0)
+		{
+			const glm::vec4 colorId = _secondaryRoadColor;
+			cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			cmdBuffer->bindPipeline(_deviceResources->roadPipe);
+			lastBoundPipeline = _deviceResources->roadPipe;
+			cmdBuffer->drawIndexed(offset, tileRes->secondaryRoadNum);
+			offset += tileRes->secondaryRoadNum;
+		}
 
-			::generateNormals(tile, static_cast<uint32_t>(tile.indices.size() - (innerNum + buildNum)), buildNum);
+		// Service Roads
+		if (tileRes->serviceRoadNum > 0)
+		{
+			const glm::vec4 colorId = _serviceRoadColor;
+			cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			cmdBuffer->bindPipeline(_deviceResources->roadPipe);
+			lastBoundPipeline = _deviceResources->roadPipe;
+			cmdBuffer->drawIndexed(offset, tileRes->serviceRoadNum);
+			offset += tileRes->serviceRoadNum;
+		}
 
-			// Create vertex and index buffers
-			// Interleaved vertex buffer (vertex position + texCoord)
-			auto& tileRes = _tileRenderingResources[col][row];
-			// Create vertex and index buffers
-			// Interleaved vertex buffer (vertex position + texCoord)
+		// Other (any other roads)
+		if (tileRes->otherRoadNum > 0)
+		{
+			const glm::vec4 colorId = _otherRoadColor;
+			cmdBuffer->bindPipeline(_deviceResources->roadPipe);
+			cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			lastBoundPipeline = _deviceResources->roadPipe;
+			cmdBuffer->drawIndexed(offset, tileRes->otherRoadNum);
+			offset += tileRes->otherRoadNum;
+		}
 
+		// Draw the buildings & shadows
+		if (tileRes->buildNum > 0)
+		{
+			const glm::vec4 colorId = BuildingColorLinearSpace;
+			cmdBuffer->pushConstants(_deviceResources->buildingPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			if (lastBoundPipeline != _deviceResources->buildingPipe)
 			{
-				const pvrvk::DeviceSize vboSize = static_cast<pvrvk::DeviceSize>(tile.vertices.size() * sizeof(tile.vertices[0]));
-				tileRes->vbo = pvr::utils::createBuffer(_deviceResources->device, vboSize,
-					pvrvk::BufferUsageFlags::e_VERTEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
-					pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT | pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT,
-					&_deviceResources->vmaAllocator, pvr::utils::vma::AllocationCreateFlags::e_MAPPED_BIT);
-
-				bool isBufferHostVisible = (tileRes->vbo->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT) != 0;
-				if (isBufferHostVisible)
-				{
-					pvr::utils::updateHostVisibleBuffer(tileRes->vbo, tile.vertices.data(), 0, vboSize, true);
-				}
-				else
-				{
-					pvr::utils::updateBufferUsingStagingBuffer(_deviceResources->device, tileRes->vbo, uploadCmd, tile.vertices.data(), 0, vboSize, &_deviceResources->vmaAllocator);
-				}
+				cmdBuffer->bindPipeline(_deviceResources->buildingPipe);
+				lastBoundPipeline = _deviceResources->buildingPipe;
 			}
+			cmdBuffer->drawIndexed(offset, tileRes->buildNum);
+
+			cmdBuffer->bindPipeline(_deviceResources->planarShadowPipe);
+			lastBoundPipeline = _deviceResources->planarShadowPipe;
+			cmdBuffer->drawIndexed(offset, tileRes->buildNum);
+			offset += tileRes->buildNum;
+		}
 
+		// Draw the insides of car parking and buildings for polygons with holes
+		if (tileRes->innerNum > 0)
+		{
+			if (lastBoundPipeline != _deviceResources->fillPipe)
 			{
-				const pvrvk::DeviceSize iboSize = static_cast<pvrvk::DeviceSize>(tile.indices.size() * sizeof(tile.indices[0]));
-
-				tileRes->ibo = pvr::utils::createBuffer(_deviceResources->device, iboSize,
-					pvrvk::BufferUsageFlags::e_INDEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
-					pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT | pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT,
-					&_deviceResources->vmaAllocator, pvr::utils::vma::AllocationCreateFlags::e_MAPPED_BIT);
-
-				bool isBufferHostVisible = (tileRes->ibo->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT) != 0;
-				if (isBufferHostVisible)
-				{
-					pvr::utils::updateHostVisibleBuffer(tileRes->ibo, tile.indices.data(), 0, iboSize, true);
-				}
-				else
-				{
-					pvr::utils::updateBufferUsingStagingBuffer(_deviceResources->device, tileRes->ibo, uploadCmd, tile.indices.data(), 0, iboSize, &_deviceResources->vmaAllocator);
-				}
+				cmdBuffer->bindPipeline(_deviceResources->fillPipe);
+				lastBoundPipeline = _deviceResources->fillPipe;
 			}
+			const glm::vec4 colorId = _clearColor;
+			cmdBuffer->pushConstants(_deviceResources->fillPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
+				static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
+			cmdBuffer->drawIndexed(offset, tileRes->innerNum);
+			offset += tileRes->innerNum;
+		}
+		cmdBuffer->end();
+	}
+}
+
+/*!*********************************************************************************************************************
+\brief	Stream the tiles in and out of GPU memory. The visible tiles are requested, followed by the tiles around them
+so that they are loaded before they come into view. Tiles whose uploads have completed are recorded and drawn from
+this frame on, and the tiles least recently needed are evicted when the loaded tiles exceed the memory budget.
+***********************************************************************************************************************/
+void VulkanNavigation3D::updateTileStreaming()
+{
+	// Draw the tiles whose uploads have completed
+	for (size_t i = 0; i < _loadingTiles.size();)
+	{
+		const uint32_t col = _loadingTiles[i] / _numRows;
+		const uint32_t row = _loadingTiles[i] % _numRows;
+		if (_deviceResources->tileUploader.isComplete(_tileRenderingResources[col][row]->uploadToken))
+		{
+			recordTileCommands(col, row);
+			_tileResidency.setResident(_loadingTiles[i]);
+			_loadingTiles[i] = _loadingTiles.back();
+			_loadingTiles.pop_back();
+		}
+		else
+		{
+			++i;
+		}
+	}
 
-			uint32_t uboOffset = 0;
+	// Tiles nearer the camera are loaded first
+	const glm::vec2 cameraPosition(cameraInfo.translation.x, cameraInfo.translation.z);
+	auto getPriority = [&](uint32_t col, uint32_t row) {
+		const Tile& tile = _OSMdata->getTiles()[col][row];
+		const glm::vec2 offset = (tile.screenMin + tile.screenMax) * .5f - cameraPosition;
+		return glm::dot(offset, offset);
+	};
 
-			// Record Secondary commands
-			for (uint32_t i = 0; i < swapchainLength; ++i)
+	_tileResidency.beginFrame();
+	_visibleTiles.clear();
+	for (uint32_t col = 0; col < _numCols; ++col)
+	{
+		for (uint32_t row = 0; row < _numRows; ++row)
+		{
+			if (inFrustum(_OSMdata->getTiles()[col][row].screenMin, _OSMdata->getTiles()[col][row].screenMax))
+			{
+				_visibleTiles.push_back(col * _numRows + row);
+				_tileResidency.request(col * _numRows + row, getPriority(col, row), true);
+			}
+		}
+	}
+	for (uint32_t tileIndex : _visibleTiles)
+	{
+		const int32_t col = static_cast<int32_t>(tileIndex / _numRows);
+		const int32_t row = static_cast<int32_t>(tileIndex % _numRows);
+		for (int32_t neighbourCol = std::max(col - 1, 0); neighbourCol <= std::min(col + 1, static_cast<int32_t>(_numCols) - 1); ++neighbourCol)
+		{
+			for (int32_t neighbourRow = std::max(row - 1, 0); neighbourRow <= std::min(row + 1, static_cast<int32_t>(_numRows) - 1); ++neighbourRow)
 			{
-				uint32_t offset = 0;
-				_tileRenderingResources[col][row]->secCbo.add(_deviceResources->cmdPool->allocateSecondaryCommandBuffer());
-				pvrvk::SecondaryCommandBuffer& cmdBuffer = _tileRenderingResources[col][row]->secCbo[i];
-
-				uboOffset = _deviceResources->uboDynamic.bufferView.getDynamicSliceOffset(i);
-				cmdBuffer->begin(_deviceResources->fbo[i]);
-
-				// Bind the Dynamic and static buffers
-				pvrvk::DescriptorSet descSets[] = { _deviceResources->uboDynamic.set, _deviceResources->uboStatic.set };
-				cmdBuffer->bindDescriptorSets(pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->fillPipe->getPipelineLayout(), 0, descSets, ARRAY_SIZE(descSets), &uboOffset, 1);
-
-				// Bind the vertex and index buffers for the tile
-				cmdBuffer->bindVertexBuffer(_tileRenderingResources[col][row]->vbo, 0, 0);
-				cmdBuffer->bindIndexBuffer(_tileRenderingResources[col][row]->ibo, 0, pvrvk::IndexType::e_UINT32);
-
-				pvrvk::GraphicsPipeline lastBoundPipeline;
-				// Draw the car parking
-				if (parkingNum > 0)
-				{
-					glm::vec4 colorId = _parkingColor;
-					cmdBuffer->pushConstants(_deviceResources->fillPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					cmdBuffer->bindPipeline(_deviceResources->fillPipe);
-					lastBoundPipeline = _deviceResources->fillPipe;
-					cmdBuffer->drawIndexed(0, parkingNum);
-					offset += parkingNum;
-				}
-
-				// Draw the road areas
-				if (areaNum > 0)
-				{
-					const glm::vec4 colorId = _roadAreaColor;
-					cmdBuffer->pushConstants(_deviceResources->fillPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					if (lastBoundPipeline != _deviceResources->fillPipe)
-					{
-						cmdBuffer->bindPipeline(_deviceResources->fillPipe);
-						lastBoundPipeline = _deviceResources->fillPipe;
-					}
-					cmdBuffer->drawIndexed(offset, areaNum);
-					offset += areaNum;
-				}
-
-				// Draw the outlines for road areas
-				if (roadAreaOutlineNum > 0)
-				{
-					const glm::vec4 colorId = _outlineColor;
-					cmdBuffer->pushConstants(_deviceResources->outlinePipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					if (lastBoundPipeline != _deviceResources->outlinePipe)
-					{
-						cmdBuffer->bindPipeline(_deviceResources->outlinePipe);
-						lastBoundPipeline = _deviceResources->outlinePipe;
-					}
-					cmdBuffer->drawIndexed(offset, roadAreaOutlineNum);
-					offset += roadAreaOutlineNum;
-				}
-
-				/**** Draw the roads ****/
-				if (lastBoundPipeline != _deviceResources->roadPipe && (motorwayNum + trunkRoadNum + primaryRoadNum + secondaryRoadNum + serviceRoadNum + otherRoadNum) > 0)
-				{
-					cmdBuffer->bindPipeline(_deviceResources->roadPipe);
-					lastBoundPipeline = _deviceResources->roadPipe;
-					cmdBuffer->bindDescriptorSet(
-						pvrvk::PipelineBindPoint::e_GRAPHICS, _deviceResources->roadPipe->getPipelineLayout(), SetBinding::TextureSampler, _deviceResources->imageSamplerDescSet);
-				}
-
-				// Motorways
-				if (motorwayNum > 0)
-				{
-					const glm::vec4 colorId = _motorwayColor;
-					cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					cmdBuffer->bindPipeline(_deviceResources->roadPipe);
-					lastBoundPipeline = _deviceResources->roadPipe;
-					cmdBuffer->drawIndexed(offset, motorwayNum);
-					offset += motorwayNum;
-				}
-
-				// Trunk Roads
-				if (trunkRoadNum > 0)
-				{
-					const glm::vec4 colorId = _trunkRoadColor;
-					cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					cmdBuffer->bindPipeline(_deviceResources->roadPipe);
-					lastBoundPipeline = _deviceResources->roadPipe;
-					cmdBuffer->drawIndexed(offset, trunkRoadNum);
-					offset += trunkRoadNum;
-				}
-
-				// Primary Roads
-				if (primaryRoadNum > 0)
-				{
-					const glm::vec4 colorId = _primaryRoadColor;
-					cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					cmdBuffer->bindPipeline(_deviceResources->roadPipe);
-					lastBoundPipeline = _deviceResources->roadPipe;
-					cmdBuffer->drawIndexed(offset, primaryRoadNum);
-					offset += primaryRoadNum;
-				}
-
-				// Secondary Roads
-				if (secondaryRoadNum > 0)
-				{
-					const glm::vec4 colorId = _secondaryRoadColor;
-					cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					cmdBuffer->bindPipeline(_deviceResources->roadPipe);
-					lastBoundPipeline = _deviceResources->roadPipe;
-					cmdBuffer->drawIndexed(offset, secondaryRoadNum);
-					offset += secondaryRoadNum;
-				}
-
-				// Service Roads
-				if (serviceRoadNum > 0)
-				{
-					const glm::vec4 colorId = _serviceRoadColor;
-					cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					cmdBuffer->bindPipeline(_deviceResources->roadPipe);
-					lastBoundPipeline = _deviceResources->roadPipe;
-					cmdBuffer->drawIndexed(offset, serviceRoadNum);
-					offset += serviceRoadNum;
-				}
-
-				// Other (any other roads)
-				if (otherRoadNum > 0)
-				{
-					const glm::vec4 colorId = _otherRoadColor;
-					cmdBuffer->bindPipeline(_deviceResources->roadPipe);
-					cmdBuffer->pushConstants(_deviceResources->roadPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					lastBoundPipeline = _deviceResources->roadPipe;
-					cmdBuffer->drawIndexed(offset, otherRoadNum);
-					offset += otherRoadNum;
-				}
-
-				// Draw the buildings & shadows
-				if (buildNum > 0)
-				{
-					const glm::vec4 colorId = BuildingColorLinearSpace;
-					cmdBuffer->pushConstants(_deviceResources->buildingPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					if (lastBoundPipeline != _deviceResources->buildingPipe)
-					{
-						cmdBuffer->bindPipeline(_deviceResources->buildingPipe);
-						lastBoundPipeline = _deviceResources->buildingPipe;
-					}
-					cmdBuffer->drawIndexed(offset, buildNum);
-
-					cmdBuffer->bindPipeline(_deviceResources->planarShadowPipe);
-					lastBoundPipeline = _deviceResources->planarShadowPipe;
-					cmdBuffer->drawIndexed(offset, buildNum);
-					offset += buildNum;
-				}
-
-				// Draw the insides of car parking and buildings for polygons with holes
-				if (innerNum > 0)
-				{
-					if (lastBoundPipeline != _deviceResources->fillPipe)
-					{
-						cmdBuffer->bindPipeline(_deviceResources->fillPipe);
-						lastBoundPipeline = _deviceResources->fillPipe;
-					}
-					const glm::vec4 colorId = _clearColor;
-					cmdBuffer->pushConstants(_deviceResources->fillPipe->getPipelineLayout(), pvrvk::ShaderStageFlags::e_VERTEX_BIT, 0,
-						static_cast<uint32_t>(pvr::getSize(pvr::GpuDatatypes::vec4)), &colorId);
-					cmdBuffer->drawIndexed(offset, innerNum);
-					offset += innerNum;
-				}
-				cmdBuffer->end();
+				_tileResidency.request(neighbourCol * _numRows + neighbourRow, getPriority(neighbourCol, neighbourRow), false);
 			}
-			row++;
 		}
-		row = 0;
-		col++;
 	}
+
+	_tileResidency.update(_tileLoads, _tileEvictions);
+	for (uint32_t tileIndex : _tileEvictions)
+	{
+		unloadTile(tileIndex / _numRows, tileIndex % _numRows);
+	}
+	for (uint32_t tileIndex : _tileLoads)
+	{
+		loadTile(tileIndex / _numRows, tileIndex % _numRows);
+	}
+	_deviceResources->tileUploader.submit();
 }
 
 uint32_t VulkanNavigation3D::generateIndices(Tile& tile, std::vector<Way>& way, RoadTypes::RoadTypes type)
@@ -927,6 +1084,7 @@ pvr::Result VulkanNavigation3D::renderFrame()
 	calculateClipPlanes();
 	_deviceResources->fencePerFrame[_frameId]->wait();
 	_deviceResources->fencePerFrame[_frameId]->reset();
+	updateTileStreaming();
 	_deviceResources->swapchain->acquireNextImage(uint64_t(-1), _deviceResources->acquireSemaphore[_frameId]);
 	const uint32_t swapchainIndex = _deviceResources->swapchain->getSwapchainIndex();
 	_deviceResources->uboDynamic.bufferView.getElement(0, 0, swapchainIndex).setValue(_viewProjMatrix);
@@ -1120,8 +1278,9 @@ void VulkanNavigation3D::updateCommandBuffer(const uint32_t swapchain)
 	{
 		for (uint32_t j = 0; j < _numRows; ++j)
 		{
-			// Only queue up commands if the tile is visible.
-			if (inFrustum(_OSMdata->getTiles()[i][j].screenMin, _OSMdata->getTiles()[i][j].screenMax))
+			// Only queue up commands if the tile is visible and has been streamed in.
+			if (inFrustum(_OSMdata->getTiles()[i][j].screenMin, _OSMdata->getTiles()[i][j].screenMax) &&
+				_tileResidency.getState(i * _numRows + j) == TileResidency::State::Resident && _tileRenderingResources[i][j]->secCbo.size() != 0)
 			{
 				_deviceResources->cbos[swapchain]->executeCommands(_tileRenderingResources[i][j]->secCbo[swapchain]);
 			}
@@ -1286,6 +1445,11 @@ void VulkanNavigation3D::recordUICommands()
 ***********************************************************************************************************************/
 pvr::Result VulkanNavigation3D::releaseView()
 {
+	// Release the tiles once the tile uploads and the frames in flight have completed.
+	if (_deviceResources && _deviceResources->device.isValid())
+	{
+		_deviceResources->device->waitIdle();
+	}
 	_tileRenderingResources.clear();
 
 	// Reset context and associated resources.
@@ -229,6 +229,8 @@ pvr::Result VulkanSkinning::initView()
 	}
 
 	_deviceResources->mgr.init(*this, _deviceResources->swapchain, _deviceResources->descriptorPool);
+	// Warm-start the pipeline compilation with the pipeline cache saved by the previous run
+	_deviceResources->mgr.setPipelineCache(pvr::utils::loadPipelineCache(_deviceResources->device, getWritePath() + getApplicationName() + ".pipelinecache"));
 	_deviceResources->commandBuffers[0]->begin();
 	_deviceResources->mgr.addEffect(*rd.getAssetHandle(), _deviceResources->commandBuffers[0]);
 	_deviceResources->mgr.addModelForAllPasses(_scene);
@@ -297,6 +299,10 @@ pvr::Result VulkanSkinning::initView()
 ***********************************************************************************************************************/
 pvr::Result VulkanSkinning::releaseView()
 {
+	if (_deviceResources && _deviceResources->mgr.getPipelineCache().isValid())
+	{
+		pvr::utils::savePipelineCache(_deviceResources->device, _deviceResources->mgr.getPipelineCache(), getWritePath() + getApplicationName() + ".pipelinecache");
+	}
 	_deviceResources.reset();
 	return pvr::Result::Success;
 }
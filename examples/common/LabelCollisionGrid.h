@@ -0,0 +1,148 @@
+#pragma once
+#include "PVRCore/glm.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+/*!*****************************************************************************
+Class LabelCollisionGrid Resolves the overlaps between labels on the screen.
+Labels are placed one at a time, in order of priority, and a label is only placed
+if it does not overlap any of the labels placed before it.
+
+Every label is a box which may be rotated. The screen is divided into a uniform
+grid of square cells, each listing the placed boxes that cover it, so a new box
+is only tested against the boxes placed in the cells it covers.
+********************************************************************************/
+class LabelCollisionGrid
+{
+public:
+	struct Box
+	{
+		glm::vec2 center;
+		glm::vec2 axis; // Unit vector along the width of the box
+		glm::vec2 halfExtent;
+		uint64_t owner;
+	};
+
+	LabelCollisionGrid() : _min(0.0f), _invCellSize(1.0f), _numCells(0) {}
+
+	/*!*********************************************************************************************************************
+	\param  center The centre of the box.
+	\param  halfExtent Half the width and height of the box.
+	\param  angle The rotation of the box, in radians.
+	\param  owner Boxes with the same non-zero owner, such as an icon and its caption, may overlap each other.
+	\return The box.
+	***********************************************************************************************************************/
+	static Box makeBox(const glm::vec2& center, const glm::vec2& halfExtent, float angle, uint64_t owner = 0)
+	{
+		return Box{ center, glm::vec2(std::cos(angle), std::sin(angle)), halfExtent, owner };
+	}
+
+	/*!*********************************************************************************************************************
+	\param  min The minimum co-ordinates of the area labels are placed in.
+	\param  max The maximum co-ordinates of the area labels are placed in.
+	\param  cellSize The size of a cell, which is increased if the area would need more than maxCellsPerAxis cells across.
+	\param  maxCellsPerAxis The largest number of cells along each axis.
+	\brief  Remove all the placed labels and cover a new area. Boxes outside the area are kept in the cells at its border.
+	***********************************************************************************************************************/
+	void reset(const glm::vec2& min, const glm::vec2& max, float cellSize, uint32_t maxCellsPerAxis)
+	{
+		const glm::vec2 size = glm::max(max - min, glm::vec2(cellSize));
+		cellSize = std::max(cellSize, std::max(size.x, size.y) / static_cast<float>(maxCellsPerAxis));
+		_min = min;
+		_invCellSize = 1.0f / cellSize;
+		_numCells = glm::clamp(glm::ivec2(glm::ceil(size * _invCellSize)), glm::ivec2(1), glm::ivec2(static_cast<int32_t>(maxCellsPerAxis)));
+
+		// Keep the memory of the cells between placements
+		const size_t numCells = static_cast<size_t>(_numCells.x) * _numCells.y;
+		if (_cells.size() < numCells)
+		{
+			_cells.resize(numCells);
+		}
+		for (size_t i = 0; i < numCells; ++i)
+		{
+			_cells[i].clear();
+		}
+		_boxes.clear();
+	}
+
+	/*!*********************************************************************************************************************
+	\param  box The box of the label.
+	\return True if the label was placed, false if it overlaps a label that has already been placed.
+	***********************************************************************************************************************/
+	bool tryPlace(const Box& box)
+	{
+		glm::ivec2 minCell, maxCell;
+		getCellRange(box, minCell, maxCell);
+		for (int32_t y = minCell.y; y <= maxCell.y; ++y)
+		{
+			for (int32_t x = minCell.x; x <= maxCell.x; ++x)
+			{
+				for (uint32_t index : _cells[y * _numCells.x + x])
+				{
+					const Box& other = _boxes[index];
+					if ((box.owner == 0 || box.owner != other.owner) && overlap(box, other))
+					{
+						return false;
+					}
+				}
+			}
+		}
+
+		const uint32_t index = static_cast<uint32_t>(_boxes.size());
+		_boxes.push_back(box);
+		for (int32_t y = minCell.y; y <= maxCell.y; ++y)
+		{
+			for (int32_t x = minCell.x; x <= maxCell.x; ++x)
+			{
+				_cells[y * _numCells.x + x].push_back(index);
+			}
+		}
+		return true;
+	}
+
+	uint32_t getNumPlaced() const
+	{
+		return static_cast<uint32_t>(_boxes.size());
+	}
+
+private:
+	// The half extent of the axis aligned box around a box
+	static glm::vec2 getBoundsHalfExtent(const Box& box)
+	{
+		const glm::vec2 axis = glm::abs(box.axis);
+		return glm::vec2(box.halfExtent.x * axis.x + box.halfExtent.y * axis.y, box.halfExtent.x * axis.y + box.halfExtent.y * axis.x);
+	}
+
+	// Separating axis test between two rotated boxes, using the edge directions of both boxes as axes
+	static bool overlap(const Box& a, const Box& b)
+	{
+		const glm::vec2 offset = b.center - a.center;
+		const glm::vec2 axes[] = { a.axis, glm::vec2(-a.axis.y, a.axis.x), b.axis, glm::vec2(-b.axis.y, b.axis.x) };
+		for (const glm::vec2& axis : axes)
+		{
+			const float radiusA = a.halfExtent.x * std::abs(glm::dot(a.axis, axis)) + a.halfExtent.y * std::abs(a.axis.x * axis.y - a.axis.y * axis.x);
+			const float radiusB = b.halfExtent.x * std::abs(glm::dot(b.axis, axis)) + b.halfExtent.y * std::abs(b.axis.x * axis.y - b.axis.y * axis.x);
+			if (std::abs(glm::dot(offset, axis)) > radiusA + radiusB)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void getCellRange(const Box& box, glm::ivec2& minCell, glm::ivec2& maxCell) const
+	{
+		const glm::vec2 halfExtent = getBoundsHalfExtent(box);
+		const glm::ivec2 lastCell = _numCells - 1;
+		minCell = glm::clamp(glm::ivec2(glm::floor((box.center - halfExtent - _min) * _invCellSize)), glm::ivec2(0), lastCell);
+		maxCell = glm::clamp(glm::ivec2(glm::floor((box.center + halfExtent - _min) * _invCellSize)), glm::ivec2(0), lastCell);
+	}
+
+	std::vector<Box> _boxes;
+	std::vector<std::vector<uint32_t> > _cells;
+	glm::vec2 _min;
+	float _invCellSize;
+	glm::ivec2 _numCells;
+};
@@ -1,4 +1,6 @@
 #include "NavDataProcess.h"
+#include "PVRCore/stream/FileStream.h"
+#include <sys/stat.h>
 glm::dvec3 NavDataProcess::findIntersect(const glm::dvec2 minBounds, const glm::dvec2 maxBounds, const glm::dvec2 inPoint, const glm::dvec2 outPoint) const
 {
 	double m = (inPoint.y - outPoint.y) / (inPoint.x - outPoint.x);
@@ -107,88 +109,262 @@ std::array<glm::dvec2, 2> NavDataProcess::findPerpendicularPoints(const glm::dve
 	return points;
 }
 
-void NavDataProcess::triangulate(std::vector<uint64_t>& nodeIds, std::vector<std::array<uint64_t, 3> >& triangles) const
+void NavDataProcess::triangulate(
+	const std::vector<uint64_t>& nodeIds, const std::vector<const std::vector<uint64_t>*>& holes, std::vector<std::array<uint64_t, 3> >& triangles)
 {
 	triangles.clear();
-	if (nodeIds.front() == nodeIds.back())
+	if (nodeIds.size() < 3)
 	{
-		nodeIds.pop_back();
+		return;
 	}
 
-	while (nodeIds.size() >= 3)
-	{
-		size_t size = nodeIds.size();
+	_triangulationCoords.clear();
+	_triangulationIds.clear();
+	_triangulationHoleStarts.clear();
 
-		for (uint32_t i = 0; i < nodeIds.size(); ++i)
+	// Flatten the outer way and the holes into a single array of coordinates, dropping the duplicate closing node of each ring
+	for (size_t ring = 0; ring <= holes.size(); ++ring)
+	{
+		const std::vector<uint64_t>& ringIds = ring ? *holes[ring - 1] : nodeIds;
+		size_t numNodes = ringIds.size();
+		if (numNodes > 1 && ringIds.front() == ringIds.back())
 		{
-			Vertex prevNode;
-			Vertex nextNode;
-			Vertex currentNode = _osm.getNodeById(nodeIds[i]);
-			std::vector<uint64_t> otherNodes = nodeIds;
-			otherNodes.erase(otherNodes.begin() + i);
+			--numNodes;
+		}
+		if (ring)
+		{
+			if (numNodes < 3)
+			{
+				continue;
+			}
+			_triangulationHoleStarts.push_back(static_cast<uint32_t>(_triangulationIds.size()));
+		}
+		for (size_t i = 0; i < numNodes; ++i)
+		{
+			_triangulationCoords.push_back(_osm.getNodeById(ringIds[i]).coords);
+			_triangulationIds.push_back(ringIds[i]);
+		}
+	}
+
+	_triangulationIndices.clear();
+	const auto startTime = std::chrono::steady_clock::now();
+	_triangulator.triangulate(_triangulationCoords, _triangulationHoleStarts, _triangulationIndices);
+	_triangulationTime += std::chrono::steady_clock::now() - startTime;
+	++_numTriangulatedPolygons;
+	_numTriangulatedVertices += _triangulationCoords.size();
+	_maxTriangulatedVertices = std::max(_maxTriangulatedVertices, static_cast<uint32_t>(_triangulationCoords.size()));
+
+	triangles.reserve(_triangulationIndices.size() / 3);
+	for (size_t i = 0; i < _triangulationIndices.size(); i += 3)
+	{
+		triangles.push_back(std::array<uint64_t, 3>{
+			_triangulationIds[_triangulationIndices[i]], _triangulationIds[_triangulationIndices[i + 1]], _triangulationIds[_triangulationIndices[i + 2]] });
+	}
+}
+
+/*!*********************************************************************************************************************
+\brief	Logs how many polygons were triangulated while processing the map and how long the triangulation took.
+***********************************************************************************************************************/
+void NavDataProcess::logTriangulationStatistics() const
+{
+	Log(LogLevel::Information, "Triangulated %u polygons (%llu vertices, the largest %u) in %.2f ms", _numTriangulatedPolygons,
+		static_cast<unsigned long long>(_numTriangulatedVertices), _maxTriangulatedVertices,
+		std::chrono::duration<double, std::milli>(_triangulationTime).count());
+}
 
-			if (i == 0)
+/*!*********************************************************************************************************************
+\param  nodeIds The node IDs of a closed way. The first node may be repeated at the end.
+\param  tolerance The largest distance that the simplified way may be from the original one.
+\param  outNodeIds Receives the node IDs of the simplified way, without repeating the first node. It is empty if the way
+		is too small to be seen at the tolerance.
+\brief  Simplify the outline of a closed way.
+***********************************************************************************************************************/
+void NavDataProcess::simplifyRing(const std::vector<uint64_t>& nodeIds, double tolerance, std::vector<uint64_t>& outNodeIds)
+{
+	outNodeIds.clear();
+	const uint32_t numNodes = static_cast<uint32_t>(nodeIds.size() > 1 && nodeIds.front() == nodeIds.back() ? nodeIds.size() - 1 : nodeIds.size());
+	_simplifier.simplifyRing(numNodes, [&](uint32_t i) { return _osm.getNodeById(nodeIds[i]).coords; }, tolerance, _simplifiedIndices);
+	if (_simplifiedIndices.size() < 3)
+	{
+		return;
+	}
+	for (uint32_t index : _simplifiedIndices)
+	{
+		outNodeIds.push_back(nodeIds[index]);
+	}
+}
+
+/*!*********************************************************************************************************************
+\param  nodeIds The node IDs of a triangulated road: pairs of nodes on the left and right of each point of its centre line.
+\param  tolerance The largest distance that the centre line of the simplified road may be from the original one.
+\param  outNodeIds Receives the node IDs of the pairs that are kept. The first and last pairs, which join the road to its
+		intersections and end caps, are always kept.
+\brief  Simplify a triangulated road by removing the pairs of nodes that its shape does not depend on.
+***********************************************************************************************************************/
+void NavDataProcess::simplifyRoadStrip(const std::vector<uint64_t>& nodeIds, double tolerance, std::vector<uint64_t>& outNodeIds)
+{
+	outNodeIds.clear();
+	if (nodeIds.size() % 2)
+	{
+		outNodeIds = nodeIds;
+		return;
+	}
+	_simplifier.simplify(static_cast<uint32_t>(nodeIds.size() / 2),
+		[&](uint32_t i) { return (_osm.getNodeById(nodeIds[2 * i]).coords + _osm.getNodeById(nodeIds[2 * i + 1]).coords) * 0.5; }, tolerance, _simplifiedIndices);
+	for (uint32_t index : _simplifiedIndices)
+	{
+		outNodeIds.push_back(nodeIds[2 * index]);
+		outNodeIds.push_back(nodeIds[2 * index + 1]);
+	}
+}
+
+/*!*********************************************************************************************************************
+\return The node IDs of the inner ways to cut out of the way. Valid until the next call.
+\param  way  An outer parking / building way.
+\param  ways  The ways of the same type as the outer way.
+\brief  Get the holes of a multipolygon outer way.
+***********************************************************************************************************************/
+const std::vector<const std::vector<uint64_t>*>& NavDataProcess::getHoles(const Way& way, const std::map<uint64_t, Way>& ways)
+{
+	_triangulationHoles.clear();
+	const auto holes = _osm.wayHoles.find(way.id);
+	if (holes != _osm.wayHoles.end())
+	{
+		for (uint64_t holeId : holes->second)
+		{
+			const auto hole = ways.find(holeId);
+			if (hole != ways.end())
 			{
-				prevNode = _osm.getNodeById(nodeIds.back());
-				nextNode = _osm.getNodeById(nodeIds[1]);
-				otherNodes.pop_back();
-				otherNodes.erase(otherNodes.begin());
+				_triangulationHoles.push_back(&hole->second.nodeIds);
 			}
-			else if (i == (nodeIds.size() - 1))
+		}
+	}
+	return _triangulationHoles;
+}
+
+namespace {
+// Even-odd test of whether a point lies inside a closed way
+bool isPointInWay(const OSM& osm, const glm::dvec2& point, const std::vector<uint64_t>& nodeIds)
+{
+	bool inside = false;
+	for (size_t i = 0, j = nodeIds.size() - 1; i < nodeIds.size(); j = i++)
+	{
+		const glm::dvec2& a = osm.getNodeById(nodeIds[i]).coords;
+		const glm::dvec2& b = osm.getNodeById(nodeIds[j]).coords;
+		if (((a.y > point.y) != (b.y > point.y)) && (point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x))
+		{
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+} // namespace
+
+/*!*********************************************************************************************************************
+\param  members  The members of the relation.
+\param  numMembers  The number of members.
+\param  tags  The tags of the relation.
+\param  numTags  The number of tags.
+\brief  If a relation describes a multipolygon, mark its inner parking / building ways (holes) as inner.
+***********************************************************************************************************************/
+void NavDataProcess::markInnerWays(const RelationMember* members, size_t numMembers, const Tag* tags, size_t numTags)
+{
+	// Check tags to see if it describes a multipolygon
+	bool multiPolygon = false;
+	for (size_t i = 0; i < numTags; ++i)
+	{
+		if ((tags[i].key == "type") && (tags[i].value == "multipolygon"))
+		{
+			multiPolygon = true;
+		}
+	}
+
+	if (!multiPolygon)
+	{
+		return;
+	}
+
+	// Iterate through members to find outer way type
+	WayTypes::WayTypes outerType = WayTypes::Default;
+	for (size_t i = 0; i < numMembers; ++i)
+	{
+		if ((members[i].type == "way") && (members[i].role == "outer"))
+		{
+			if (_osm.parkingWays.find(members[i].ref) != _osm.parkingWays.end())
 			{
-				prevNode = _osm.getNodeById(nodeIds[i - 1]);
-				nextNode = _osm.getNodeById(nodeIds[0]);
-				otherNodes.pop_back();
-				otherNodes.erase(otherNodes.begin());
+				outerType = WayTypes::Parking;
 			}
-			else
+			else if (_osm.buildWays.find(members[i].ref) != _osm.buildWays.end())
 			{
-				prevNode = _osm.getNodeById(nodeIds[i - 1]);
-				nextNode = _osm.getNodeById(nodeIds[i + 1]);
-				otherNodes.erase(otherNodes.begin() + i);
-				otherNodes.erase(otherNodes.begin() + i - 1);
+				outerType = WayTypes::Building;
 			}
+		}
+	}
 
-			// Check if the vertex is interior or exterior
-			if (checkWinding(std::vector<glm::dvec2>{ prevNode.coords, currentNode.coords, nextNode.coords }) == pvr::PolygonWindingOrder::FrontFaceCW)
-				continue;
+	// Iterate through members again to find inner ways
+	for (size_t i = 0; i < numMembers; ++i)
+	{
+		if ((members[i].type == "way") && (members[i].role == "inner"))
+		{
+			const auto& parkingTemp = _osm.parkingWays.find(members[i].ref);
+			const auto& buildTemp = _osm.buildWays.find(members[i].ref);
+			Way* innerWay = nullptr;
 
-			// Determine if any of the other points are inside the triangle
-			bool pointInTriangle = false;
-			for (uint32_t j = 0; j < otherNodes.size(); ++j)
+			if ((parkingTemp != _osm.parkingWays.end()) && (outerType == WayTypes::Parking))
 			{
-				glm::dvec2 prevPoint = prevNode.coords - currentNode.coords;
-				glm::dvec2 nextPoint = nextNode.coords - currentNode.coords;
-				glm::dvec2 currentPoint = _osm.getNodeById(otherNodes[j]).coords - currentNode.coords;
-				double d = prevPoint.x * nextPoint.y - nextPoint.x * prevPoint.y;
-
-				double currentWeight =
-					(currentPoint.x * (prevPoint.y - nextPoint.y) + currentPoint.y * (nextPoint.x - prevPoint.x) + prevPoint.x * nextPoint.y - nextPoint.x * prevPoint.y) / d;
-
-				double prevWeight = (currentPoint.x * nextPoint.y - currentPoint.y * nextPoint.x) / d;
-				double nextWeight = (currentPoint.y * prevPoint.x - currentPoint.x * prevPoint.y) / d;
-
-				if ((currentWeight > 0.0) && (currentWeight < 1.0) && (prevWeight > 0.0) && (prevWeight < 1.0) && (nextWeight > 0.0) && (nextWeight < 1.0))
-				{
-					pointInTriangle = true;
-					break;
-				}
+				parkingTemp->second.inner = true;
+				innerWay = &parkingTemp->second;
+			}
+			else if ((buildTemp != _osm.buildWays.end()) && (outerType == WayTypes::Building))
+			{
+				buildTemp->second.inner = true;
+				innerWay = &buildTemp->second;
 			}
 
-			if (pointInTriangle)
+			if (innerWay)
 			{
-				continue;
+				addHole(members, numMembers, outerType == WayTypes::Parking ? _osm.parkingWays : _osm.buildWays, *innerWay);
 			}
+		}
+	}
+}
 
-			// Add the new triangle and remove the necessary point
-			triangles.push_back(std::array<uint64_t, 3>{ prevNode.id, currentNode.id, nextNode.id });
-			nodeIds.erase(nodeIds.begin() + i);
-			break;
+/*!*********************************************************************************************************************
+\param  members  The members of the relation.
+\param  numMembers  The number of members.
+\param  ways  The ways of the same type as the inner way.
+\param  innerWay  An inner way of the relation.
+\brief  Find the outer way of the relation an inner way lies in, so that it can be cut out of it when triangulating. Inner ways which
+		do not lie in any outer way are drawn over the outer ways instead.
+***********************************************************************************************************************/
+void NavDataProcess::addHole(const RelationMember* members, size_t numMembers, const std::map<uint64_t, Way>& ways, const Way& innerWay)
+{
+	for (size_t i = 0; i < numMembers; ++i)
+	{
+		if ((members[i].type != "way") || (members[i].role != "outer"))
+		{
+			continue;
+		}
+		const auto outer = ways.find(members[i].ref);
+		if (outer == ways.end() || outer->second.nodeIds.size() < 4)
+		{
+			continue;
 		}
 
-		if (size == nodeIds.size())
+		// Test a node of the inner way which is not shared with the outer way, as shared nodes lie on the outer way
+		const std::vector<uint64_t>& outerIds = outer->second.nodeIds;
+		for (uint64_t nodeId : innerWay.nodeIds)
 		{
-			break;
+			if (std::find(outerIds.begin(), outerIds.end(), nodeId) == outerIds.end())
+			{
+				if (isPointInWay(_osm, _osm.getNodeById(nodeId).coords, outerIds))
+				{
+					_osm.wayHoles[outer->first].push_back(innerWay.id);
+					_osm.holeWays.insert(innerWay.id);
+					return;
+				}
+				break;
+			}
 		}
 	}
 }
@@ -343,6 +519,8 @@ void OSM::cleanData()
 	convertedRoads.clear();
 	original_intersections.clear();
 	triangulatedRoads.clear();
+	wayHoles.clear();
+	holeWays.clear();
 	for (uint32_t lod = 0; lod < LOD::Count; ++lod)
 	{
 		labels[lod].clear();
@@ -462,37 +640,40 @@ void NavDataProcess::fillLabelTiles(LabelData& label, uint32_t lod)
 \param	type		 The type of way to insert (determines which vector the way will be inserted into).
 \param	way			 The way to insert.
 \param	id			 The node ID to insert.
+\param	geometryLod	 The level of detail of the way. Outlines only have the full resolution level.
 \brief	Determine the correct array to insert the way / node id based on way type.
 ***********************************************************************************************************************/
-void NavDataProcess::insert(const glm::uvec2& tileCoords, WayTypes::WayTypes type, Way* w, uint64_t id)
+void NavDataProcess::insert(const glm::uvec2& tileCoords, WayTypes::WayTypes type, Way* w, uint64_t id, uint32_t geometryLod)
 {
+	Tile& tile = _osm.tiles[tileCoords.x][tileCoords.y];
+	Tile::SimplifiedWays* simplifiedWays = geometryLod != GeometryLOD::L0 ? &tile.simplifiedWays[geometryLod - 1] : nullptr;
 	switch (type)
 	{
 	case WayTypes::Road:
 	{
 		if (w->area)
 		{
-			insertWay(_osm.tiles[tileCoords.x][tileCoords.y].areaWays, *w);
+			insertWay(simplifiedWays ? simplifiedWays->areaWays : tile.areaWays, *w);
 		}
 		else
 		{
-			insertWay(_osm.tiles[tileCoords.x][tileCoords.y].roadWays, *w);
+			insertWay(simplifiedWays ? simplifiedWays->roadWays : tile.roadWays, *w);
 		}
 		break;
 	}
 	case WayTypes::Parking:
 	{
-		insertWay(_osm.tiles[tileCoords.x][tileCoords.y].parkingWays, *w);
+		insertWay(simplifiedWays ? simplifiedWays->parkingWays : tile.parkingWays, *w);
 		break;
 	}
 	case WayTypes::Building:
 	{
-		insertWay(_osm.tiles[tileCoords.x][tileCoords.y].buildWays, *w);
+		insertWay(simplifiedWays ? simplifiedWays->buildWays : tile.buildWays, *w);
 		break;
 	}
 	case WayTypes::Inner:
 	{
-		insertWay(_osm.tiles[tileCoords.x][tileCoords.y].innerWays, *w);
+		insertWay(simplifiedWays ? simplifiedWays->innerWays : tile.innerWays, *w);
 		break;
 	}
 	case WayTypes::PolygonOutline:
@@ -543,6 +724,198 @@ void NavDataProcess::fillAmenityTiles(AmenityLabelData& label, uint32_t lod)
 	_osm.tiles[tileCoords.x][tileCoords.y].amenityLabels[lod].push_back(label);
 }
 
+/*!*********************************************************************************************************************
+\brief  Initialise the grid used to find the tile of a point from the bounds of the tiles.
+***********************************************************************************************************************/
+void NavDataProcess::initialiseTileGrid()
+{
+	if (_osm.tiles.empty() || _osm.tiles[0].empty())
+	{
+		_tileGrid = UniformGrid();
+		return;
+	}
+	std::vector<double> columnMax(_osm.tiles.size());
+	std::vector<double> rowMax(_osm.tiles[0].size());
+	for (size_t i = 0; i < columnMax.size(); ++i)
+	{
+		columnMax[i] = _osm.tiles[i][0].max.x;
+	}
+	for (size_t i = 0; i < rowMax.size(); ++i)
+	{
+		rowMax[i] = _osm.tiles[0][i].max.y;
+	}
+	_tileGrid.init(_osm.tiles[0][0].min, columnMax, rowMax);
+}
+
+/*!*********************************************************************************************************************
+\brief  Build the R-tree of the nodes of the road graph, for route queries.
+***********************************************************************************************************************/
+void NavDataProcess::buildRoadNodeIndex() const
+{
+	_roadNodeIndex.clear();
+	_roadNodeIndex.reserve(_roadGraph.getNumNodes());
+	for (const glm::dvec2& coords : _roadGraph.getNodeCoords())
+	{
+		_roadNodeIndex.add(coords, coords);
+	}
+	_roadNodeIndex.build();
+}
+
+/*!*********************************************************************************************************************
+\param  start The point the route starts from, in map co-ordinates.
+\param  end The point the route ends at, in map co-ordinates.
+\param  route Receives the points of the route.
+\return True if a route was found.
+\brief  Find the fastest route between the road nodes closest to two points.
+***********************************************************************************************************************/
+bool NavDataProcess::findRoute(const glm::dvec2& start, const glm::dvec2& end, std::vector<RouteData>& route) const
+{
+	auto distanceSquared = [this](const glm::dvec2& point) {
+		return [this, &point](uint32_t node) {
+			const glm::dvec2 offset = _roadGraph.getCoords(node) - point;
+			return glm::dot(offset, offset);
+		};
+	};
+	std::call_once(_isRoadNodeIndexBuilt, [this] { buildRoadNodeIndex(); });
+	const double maxDistance = std::numeric_limits<double>::max();
+	const uint32_t startNode = _roadNodeIndex.nearest(start, maxDistance, distanceSquared(start));
+	const uint32_t endNode = _roadNodeIndex.nearest(end, maxDistance, distanceSquared(end));
+
+	std::vector<uint32_t> edges;
+	if (startNode == PackedRTree::InvalidIndex || endNode == PackedRTree::InvalidIndex || !_roadGraph.findRoute(startNode, endNode, edges))
+	{
+		return false;
+	}
+	fillRouteData(startNode, edges, route);
+	return true;
+}
+
+/*!*********************************************************************************************************************
+\param  outNodeIndices Receives the node of the graph of every OSM node on a road, or RoadGraph::InvalidIndex for the
+		nodes excluded from the route (see isExcludedFromRoute).
+\brief  Build the road graph from the original road ways. One way streets and roundabouts only get edges in the
+		direction of the way, and the cost of every edge is the time it takes to drive along it.
+***********************************************************************************************************************/
+void NavDataProcess::buildRoadGraph(std::unordered_map<uint64_t, uint32_t>& outNodeIndices)
+{
+	_roadGraph.clear();
+	outNodeIndices.clear();
+	auto getNodeIndex = [&](uint64_t id) {
+		auto it = outNodeIndices.find(id);
+		if (it == outNodeIndices.end())
+		{
+			const glm::dvec2& coords = _osm.getNodeById(id).coords;
+			it = outNodeIndices.insert(std::make_pair(id, isExcludedFromRoute(coords) ? RoadGraph::InvalidIndex : _roadGraph.addNode(coords))).first;
+		}
+		return it->second;
+	};
+
+	for (const auto& wayIterator : _osm.originalRoadWays)
+	{
+		const Way& way = wayIterator.second;
+		const double speed = getRoadSpeed(way.roadType);
+		const uint32_t name = _roadGraph.addName(getAttributeName(way.tags.data(), way.tags.size()));
+		const bool isOneWay = isRoadOneWay(way.tags) || isRoadRoundabout(way.tags);
+
+		for (size_t i = 1; i < way.nodeIds.size(); ++i)
+		{
+			const uint32_t source = getNodeIndex(way.nodeIds[i - 1]);
+			const uint32_t target = getNodeIndex(way.nodeIds[i]);
+			if (source == RoadGraph::InvalidIndex || target == RoadGraph::InvalidIndex || source == target)
+			{
+				continue;
+			}
+			_roadGraph.addEdge(source, target, speed, name);
+			if (!isOneWay)
+			{
+				_roadGraph.addEdge(target, source, speed, name);
+			}
+		}
+	}
+	_roadGraph.build();
+}
+
+/*!*********************************************************************************************************************
+\param  start The node of the road graph the route starts at.
+\param  edges The edges of the route.
+\param  route Receives a point for every node of the route, named after the road that leaves it.
+\brief  Convert a route through the road graph to route data.
+***********************************************************************************************************************/
+void NavDataProcess::fillRouteData(uint32_t start, const std::vector<uint32_t>& edges, std::vector<RouteData>& route) const
+{
+	route.clear();
+	route.reserve(edges.size() + 1);
+	RouteData data;
+	data.point = _roadGraph.getCoords(start);
+	for (uint32_t edgeIndex : edges)
+	{
+		const RoadGraph::Edge& edge = _roadGraph.getEdge(edgeIndex);
+		data.name = _roadGraph.getName(edge.name);
+		if (edge.length > 0.0f) // Nodes in the same place would give the route a segment that takes no time
+		{
+			route.push_back(data);
+		}
+		data.point = _roadGraph.getCoords(edge.target);
+	}
+	route.push_back(data); // The last point keeps the name of the road that arrives at it
+}
+
+/*!*********************************************************************************************************************
+\brief  Builds the road graph and calculates the fastest route from the first intersection to the furthest intersection
+		that can be reached from it, if no interesections are available no route will be calculated.
+***********************************************************************************************************************/
+void NavDataProcess::calculateRoute()
+{
+	std::unordered_map<uint64_t, uint32_t> nodeIndices;
+	buildRoadGraph(nodeIndices);
+	Log(LogLevel::Information, "Calculated intersections: %u", _osm.original_intersections.size());
+
+	std::vector<uint32_t> intersections;
+	std::vector<bool> isIntersectionAdded(_roadGraph.getNumNodes(), false);
+	for (uint64_t id : _osm.original_intersections)
+	{
+		auto it = nodeIndices.find(id);
+		if (it != nodeIndices.end() && it->second != RoadGraph::InvalidIndex && !isIntersectionAdded[it->second])
+		{
+			isIntersectionAdded[it->second] = true;
+			intersections.push_back(it->second);
+		}
+	}
+	if (intersections.size() < 2)
+	{
+		Log(LogLevel::Information, "No Route Calculated - No intersections.");
+		return;
+	}
+
+	// Start from one of the first intersections, in case an intersection only leads out of the map, and drive to the
+	// furthest intersection that can be reached.
+	const uint32_t MaxStarts = 4;
+	const uint32_t MaxGoals = 16;
+	std::vector<uint32_t> edges;
+	for (uint32_t i = 0; i < std::min<size_t>(MaxStarts, intersections.size()); ++i)
+	{
+		const uint32_t start = intersections[i];
+		const glm::dvec2& startCoords = _roadGraph.getCoords(start);
+		std::vector<std::pair<double, uint32_t> > goals;
+		for (uint32_t goal : intersections)
+		{
+			goals.push_back(std::make_pair(-glm::distance(startCoords, _roadGraph.getCoords(goal)), goal));
+		}
+		std::sort(goals.begin(), goals.end());
+
+		for (uint32_t j = 0; j < std::min<size_t>(MaxGoals, goals.size()); ++j)
+		{
+			if (goals[j].second != start && _roadGraph.findRoute(start, goals[j].second, edges))
+			{
+				fillRouteData(start, edges, _osm.route);
+				Log(LogLevel::Information, "Calculated a route of %u points", static_cast<uint32_t>(_osm.route.size()));
+				return;
+			}
+		}
+	}
+	Log(LogLevel::Information, "No Route Calculated - The intersections are not connected.");
+}
+
 /*!*********************************************************************************************************************
 \return	double The calculated area.
 \param	vector An array of points (vec2s) that make up the polygon.
@@ -561,3 +934,654 @@ double NavDataProcess::calculateTriangleArea(const std::vector<glm::dvec2>& poin
 	}
 	return area / 2.0;
 }
+
+// The layout of the processed map file. Every section is an array of plain records starting at an 8 byte aligned offset from the start of the file, and
+// records refer to each other by index only. Strings are stored in a single character section. Loading reads every section and rebuilds the in-memory
+// tiles, route and road graph from it.
+namespace {
+const char ProcessedDataMagic[8] = { 'P', 'V', 'R', 'N', 'A', 'V', 'M', 'P' };
+const uint32_t ProcessedDataVersion = 4; // Increment whenever the layout below or the output of the processing changes
+
+struct Section
+{
+	uint64_t offset;
+	uint64_t count;
+};
+
+struct Range
+{
+	uint32_t first;
+	uint32_t count;
+};
+
+struct ProcessedDataHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+	uint64_t sourceKey;
+	uint32_t numCols;
+	uint32_t numRows;
+	glm::dvec2 boundsMin;
+	glm::dvec2 boundsMax;
+	glm::dvec2 minLonLat;
+	glm::dvec2 maxLonLat;
+	Section tiles;
+	Section nodes;
+	Section ways;
+	Section nodeIds;
+	Section labels;
+	Section icons;
+	Section amenityLabels;
+	Section route;
+	Section roadNodes;
+	Section roadOffsets;
+	Section roadEdges;
+	Section roadNames;
+	Section strings;
+};
+
+namespace TileWays {
+enum TileWays
+{
+	Area,
+	Road,
+	Parking,
+	Build,
+	Inner,
+	Count
+};
+}
+
+struct TileRecord
+{
+	glm::dvec2 min;
+	glm::dvec2 max;
+	Range nodes;
+	Range ways[TileWays::Count];
+	Range simplifiedWays[GeometryLOD::Count - 1][TileWays::Count];
+	Range areaOutlineIds;
+	Range polygonOutlineIds;
+	Range labels[LOD::Count];
+	Range icons[LOD::Count];
+	Range amenityLabels[LOD::Count];
+};
+
+struct NodeRecord
+{
+	uint64_t id;
+	glm::dvec2 coords;
+	double height;
+	glm::vec2 texCoords;
+	uint32_t tileBoundNode;
+	uint32_t padding;
+};
+
+struct WayRecord
+{
+	uint64_t id;
+	double width;
+	Range nodeIds;
+	uint32_t roadType;
+	uint32_t flags;
+};
+
+namespace WayFlags {
+enum WayFlags
+{
+	Area = 1,
+	Inner = 2,
+	TileBoundWay = 4,
+	Intersection = 8,
+	Roundabout = 16,
+	Fork = 32
+};
+}
+
+struct LabelRecord
+{
+	Range name;
+	glm::dvec2 coords;
+	uint64_t id;
+	float rotation;
+	float scale;
+	float distToBoundary;
+	float distToEndOfSegment;
+	uint32_t isAmenityLabel;
+	uint32_t maxLodLevel;
+};
+
+struct IconRecord
+{
+	glm::dvec2 coords;
+	uint64_t id;
+	float scale;
+	uint32_t buildingType;
+	uint32_t lodLevel;
+	uint32_t padding;
+};
+
+struct AmenityLabelRecord
+{
+	LabelRecord label;
+	IconRecord icon;
+};
+
+struct RouteRecord
+{
+	glm::dvec2 point;
+	double rotation;
+	glm::vec2 dir;
+	float distanceToNext;
+	Range name;
+	uint32_t padding;
+};
+
+// Collects the records of every section while the processed map is written.
+struct ProcessedDataWriter
+{
+	std::vector<TileRecord> tiles;
+	std::vector<NodeRecord> nodes;
+	std::vector<WayRecord> ways;
+	std::vector<uint64_t> nodeIds;
+	std::vector<LabelRecord> labels;
+	std::vector<IconRecord> icons;
+	std::vector<AmenityLabelRecord> amenityLabels;
+	std::vector<RouteRecord> route;
+	std::vector<Range> roadNames;
+	std::vector<char> strings;
+
+	Range addString(const std::string& string)
+	{
+		Range range = { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(string.size()) };
+		strings.insert(strings.end(), string.begin(), string.end());
+		return range;
+	}
+
+	Range addNodeIds(const std::vector<uint64_t>& ids)
+	{
+		Range range = { static_cast<uint32_t>(nodeIds.size()), static_cast<uint32_t>(ids.size()) };
+		nodeIds.insert(nodeIds.end(), ids.begin(), ids.end());
+		return range;
+	}
+
+	Range addWays(const std::vector<Way>& tileWays)
+	{
+		Range range = { static_cast<uint32_t>(ways.size()), static_cast<uint32_t>(tileWays.size()) };
+		for (const Way& way : tileWays)
+		{
+			WayRecord record;
+			record.id = way.id;
+			record.width = way.width;
+			record.nodeIds = addNodeIds(way.nodeIds);
+			record.roadType = static_cast<uint32_t>(way.roadType);
+			record.flags = (way.area ? WayFlags::Area : 0) | (way.inner ? WayFlags::Inner : 0) | (way.tileBoundWay ? WayFlags::TileBoundWay : 0) |
+				(way.isIntersection ? WayFlags::Intersection : 0) | (way.isRoundabout ? WayFlags::Roundabout : 0) | (way.isFork ? WayFlags::Fork : 0);
+			ways.push_back(record);
+		}
+		return range;
+	}
+
+	LabelRecord makeLabel(const LabelData& label)
+	{
+		LabelRecord record;
+		record.name = addString(label.name);
+		record.coords = label.coords;
+		record.id = label.id;
+		record.rotation = label.rotation;
+		record.scale = label.scale;
+		record.distToBoundary = label.distToBoundary;
+		record.distToEndOfSegment = label.distToEndOfSegment;
+		record.isAmenityLabel = label.isAmenityLabel ? 1 : 0;
+		record.maxLodLevel = static_cast<uint32_t>(label.maxLodLevel);
+		return record;
+	}
+
+	static IconRecord makeIcon(const IconData& icon)
+	{
+		IconRecord record;
+		record.coords = icon.coords;
+		record.id = icon.id;
+		record.scale = icon.scale;
+		record.buildingType = static_cast<uint32_t>(icon.buildingType);
+		record.lodLevel = static_cast<uint32_t>(icon.lodLevel);
+		record.padding = 0;
+		return record;
+	}
+
+	template<typename T>
+	static void writeSection(pvr::Stream& stream, Section& section, const std::vector<T>& records, uint64_t& offset)
+	{
+		static const char zeros[8] = {};
+		const uint64_t alignedOffset = (offset + 7) & ~uint64_t(7);
+		if (alignedOffset != offset)
+		{
+			stream.writeExact(1, static_cast<size_t>(alignedOffset - offset), zeros);
+		}
+		section.offset = alignedOffset;
+		section.count = records.size();
+		if (!records.empty())
+		{
+			stream.writeExact(sizeof(T), records.size(), records.data());
+		}
+		offset = alignedOffset + sizeof(T) * records.size();
+	}
+};
+
+// Gives access to the sections of a processed map, checking that every section lies within the data.
+struct ProcessedDataReader
+{
+	const char* data;
+	size_t size;
+
+	template<typename T>
+	const T* getSection(const Section& section) const
+	{
+		if ((section.offset & 7) != 0 || section.offset > size || section.count > (size - section.offset) / sizeof(T))
+		{
+			throw pvr::InvalidDataError("[NavDataProcess] Processed map section out of bounds");
+		}
+		return reinterpret_cast<const T*>(data + section.offset);
+	}
+};
+
+void checkRange(const Range& range, uint64_t count)
+{
+	if (static_cast<uint64_t>(range.first) + range.count > count)
+	{
+		throw pvr::InvalidDataError("[NavDataProcess] Processed map record out of bounds");
+	}
+}
+} // namespace
+
+/*!*********************************************************************************************************************
+\return	uint64_t A key identifying the map source.
+\brief	Calculates a hash (FNV-1a) of the identity of the OSM data and the window dimensions the map is processed for, which the
+		processed map file must match to be used. The OSM data is identified by its size and modification time where it is a file on
+		disk, so that a warm start does not read it, and by its contents otherwise (e.g. packaged assets).
+***********************************************************************************************************************/
+uint64_t NavDataProcess::calculateSourceKey() const
+{
+	uint64_t key = 14695981039346656037ull;
+	auto hash = [&key](const unsigned char* data, size_t size) {
+		for (size_t i = 0; i < size; ++i)
+		{
+			key = (key ^ data[i]) * 1099511628211ull;
+		}
+	};
+
+	struct stat fileStatus;
+	if (!_assetStream->getFileName().empty() && stat(_assetStream->getFileName().c_str(), &fileStatus) == 0)
+	{
+		const int64_t fileIdentity[2] = { static_cast<int64_t>(fileStatus.st_size), static_cast<int64_t>(fileStatus.st_mtime) };
+		hash(reinterpret_cast<const unsigned char*>(fileIdentity), sizeof(fileIdentity));
+	}
+	else
+	{
+		_assetStream->open();
+		size_t remaining = _assetStream->getSize() - _assetStream->getPosition();
+		std::vector<unsigned char> buffer(64 * 1024);
+		while (remaining)
+		{
+			size_t dataRead = 0;
+			_assetStream->read(1, std::min(remaining, buffer.size()), buffer.data(), dataRead);
+			if (!dataRead)
+			{
+				break;
+			}
+			hash(buffer.data(), dataRead);
+			remaining -= dataRead;
+		}
+		_assetStream->seek(0, pvr::Stream::SeekOriginFromStart);
+	}
+
+	const int32_t windowsDim[2] = { _windowsDim.x, _windowsDim.y };
+	hash(reinterpret_cast<const unsigned char*>(windowsDim), sizeof(windowsDim));
+	return key;
+}
+
+/*!*********************************************************************************************************************
+\return	bool True if the processed map was loaded, false if there is none or it is out of date.
+\brief	Loads the tiles, the route and the road graph from the processed map file written by a previous run, replacing all processing.
+***********************************************************************************************************************/
+bool NavDataProcess::loadProcessedData()
+{
+	if (_processedDataPath.empty())
+	{
+		return false;
+	}
+	pvr::FileStream stream(_processedDataPath, "rb", false);
+	stream.open();
+	if (!stream.isopen())
+	{
+		return false;
+	}
+
+	try
+	{
+		std::vector<char> data = stream.readToEnd<char>();
+		ProcessedDataHeader header;
+		if (data.size() < sizeof(header))
+		{
+			return false;
+		}
+		memcpy(&header, data.data(), sizeof(header));
+		if (memcmp(header.magic, ProcessedDataMagic, sizeof(header.magic)) != 0 || header.version != ProcessedDataVersion || header.headerSize != sizeof(header))
+		{
+			Log(LogLevel::Information, "Processed map '%s' has a different version and will be rewritten", _processedDataPath.c_str());
+			return false;
+		}
+		if (header.sourceKey != calculateSourceKey())
+		{
+			Log(LogLevel::Information, "Processed map '%s' is out of date and will be rewritten", _processedDataPath.c_str());
+			return false;
+		}
+
+		const ProcessedDataReader reader = { data.data(), data.size() };
+		const TileRecord* tiles = reader.getSection<TileRecord>(header.tiles);
+		const NodeRecord* nodes = reader.getSection<NodeRecord>(header.nodes);
+		const WayRecord* ways = reader.getSection<WayRecord>(header.ways);
+		const uint64_t* nodeIds = reader.getSection<uint64_t>(header.nodeIds);
+		const LabelRecord* labels = reader.getSection<LabelRecord>(header.labels);
+		const IconRecord* icons = reader.getSection<IconRecord>(header.icons);
+		const AmenityLabelRecord* amenityLabels = reader.getSection<AmenityLabelRecord>(header.amenityLabels);
+		const RouteRecord* route = reader.getSection<RouteRecord>(header.route);
+		const glm::dvec2* roadNodes = reader.getSection<glm::dvec2>(header.roadNodes);
+		const uint32_t* roadOffsets = reader.getSection<uint32_t>(header.roadOffsets);
+		const RoadGraph::Edge* roadEdges = reader.getSection<RoadGraph::Edge>(header.roadEdges);
+		const Range* roadNames = reader.getSection<Range>(header.roadNames);
+		const char* strings = reader.getSection<char>(header.strings);
+		if (header.numCols == 0 || header.numRows == 0 || header.tiles.count != static_cast<uint64_t>(header.numCols) * header.numRows)
+		{
+			return false;
+		}
+
+		auto getString = [&](const Range& range) {
+			checkRange(range, header.strings.count);
+			return std::string(strings + range.first, range.count);
+		};
+		auto getWays = [&](const Range& range, std::vector<Way>& outWays) {
+			checkRange(range, header.ways.count);
+			outWays.resize(range.count);
+			for (uint32_t i = 0; i < range.count; ++i)
+			{
+				const WayRecord& record = ways[range.first + i];
+				Way& way = outWays[i];
+				checkRange(record.nodeIds, header.nodeIds.count);
+				way.id = record.id;
+				way.width = record.width;
+				way.nodeIds.assign(nodeIds + record.nodeIds.first, nodeIds + record.nodeIds.first + record.nodeIds.count);
+				way.roadType = static_cast<RoadTypes::RoadTypes>(record.roadType);
+				way.area = (record.flags & WayFlags::Area) != 0;
+				way.inner = (record.flags & WayFlags::Inner) != 0;
+				way.tileBoundWay = (record.flags & WayFlags::TileBoundWay) != 0;
+				way.isIntersection = (record.flags & WayFlags::Intersection) != 0;
+				way.isRoundabout = (record.flags & WayFlags::Roundabout) != 0;
+				way.isFork = (record.flags & WayFlags::Fork) != 0;
+			}
+		};
+		auto getLabel = [&](const LabelRecord& record, LabelData& label) {
+			label.name = getString(record.name);
+			label.coords = record.coords;
+			label.id = record.id;
+			label.rotation = record.rotation;
+			label.scale = record.scale;
+			label.distToBoundary = record.distToBoundary;
+			label.distToEndOfSegment = record.distToEndOfSegment;
+			label.isAmenityLabel = record.isAmenityLabel != 0;
+			label.maxLodLevel = static_cast<LOD::Levels>(record.maxLodLevel);
+		};
+		auto getIcon = [](const IconRecord& record, IconData& icon) {
+			icon.coords = record.coords;
+			icon.id = record.id;
+			icon.scale = record.scale;
+			icon.buildingType = static_cast<BuildingType::BuildingType>(record.buildingType);
+			icon.lodLevel = static_cast<LOD::Levels>(record.lodLevel);
+		};
+
+		OSM osm;
+		osm.numCols = header.numCols;
+		osm.numRows = header.numRows;
+		osm.bounds.min = header.boundsMin;
+		osm.bounds.max = header.boundsMax;
+		osm.minLonLat = header.minLonLat;
+		osm.maxLonLat = header.maxLonLat;
+		osm.lonTileScale = _osm.lonTileScale;
+		osm.latTileScale = _osm.latTileScale;
+		osm.tiles.resize(osm.numCols, std::vector<Tile>(osm.numRows));
+		for (uint32_t col = 0; col < osm.numCols; ++col)
+		{
+			for (uint32_t row = 0; row < osm.numRows; ++row)
+			{
+				const TileRecord& record = tiles[col * osm.numRows + row];
+				Tile& tile = osm.tiles[col][row];
+				tile.min = record.min;
+				tile.max = record.max;
+
+				checkRange(record.nodes, header.nodes.count);
+				for (uint32_t i = record.nodes.first; i < record.nodes.first + record.nodes.count; ++i)
+				{
+					Vertex& node = tile.nodes[nodes[i].id];
+					node.id = nodes[i].id;
+					node.coords = nodes[i].coords;
+					node.height = nodes[i].height;
+					node.texCoords = nodes[i].texCoords;
+					node.tileBoundNode = nodes[i].tileBoundNode != 0;
+				}
+
+				getWays(record.ways[TileWays::Area], tile.areaWays);
+				getWays(record.ways[TileWays::Road], tile.roadWays);
+				getWays(record.ways[TileWays::Parking], tile.parkingWays);
+				getWays(record.ways[TileWays::Build], tile.buildWays);
+				getWays(record.ways[TileWays::Inner], tile.innerWays);
+				for (uint32_t lod = 0; lod < GeometryLOD::Count - 1; ++lod)
+				{
+					Tile::SimplifiedWays& simplifiedWays = tile.simplifiedWays[lod];
+					getWays(record.simplifiedWays[lod][TileWays::Area], simplifiedWays.areaWays);
+					getWays(record.simplifiedWays[lod][TileWays::Road], simplifiedWays.roadWays);
+					getWays(record.simplifiedWays[lod][TileWays::Parking], simplifiedWays.parkingWays);
+					getWays(record.simplifiedWays[lod][TileWays::Build], simplifiedWays.buildWays);
+					getWays(record.simplifiedWays[lod][TileWays::Inner], simplifiedWays.innerWays);
+				}
+				checkRange(record.areaOutlineIds, header.nodeIds.count);
+				tile.areaOutlineIds.assign(nodeIds + record.areaOutlineIds.first, nodeIds + record.areaOutlineIds.first + record.areaOutlineIds.count);
+				checkRange(record.polygonOutlineIds, header.nodeIds.count);
+				tile.polygonOutlineIds.assign(nodeIds + record.polygonOutlineIds.first, nodeIds + record.polygonOutlineIds.first + record.polygonOutlineIds.count);
+
+				for (uint32_t lod = 0; lod < LOD::Count; ++lod)
+				{
+					checkRange(record.labels[lod], header.labels.count);
+					tile.labels[lod].resize(record.labels[lod].count);
+					for (uint32_t i = 0; i < record.labels[lod].count; ++i)
+					{
+						getLabel(labels[record.labels[lod].first + i], tile.labels[lod][i]);
+					}
+					checkRange(record.icons[lod], header.icons.count);
+					tile.icons[lod].resize(record.icons[lod].count);
+					for (uint32_t i = 0; i < record.icons[lod].count; ++i)
+					{
+						getIcon(icons[record.icons[lod].first + i], tile.icons[lod][i]);
+					}
+					checkRange(record.amenityLabels[lod], header.amenityLabels.count);
+					tile.amenityLabels[lod].resize(record.amenityLabels[lod].count);
+					for (uint32_t i = 0; i < record.amenityLabels[lod].count; ++i)
+					{
+						const AmenityLabelRecord& amenityLabel = amenityLabels[record.amenityLabels[lod].first + i];
+						getLabel(amenityLabel.label, tile.amenityLabels[lod][i]);
+						getIcon(amenityLabel.icon, tile.amenityLabels[lod][i].iconData);
+					}
+				}
+			}
+		}
+
+		osm.route.resize(static_cast<size_t>(header.route.count));
+		for (size_t i = 0; i < osm.route.size(); ++i)
+		{
+			osm.route[i].point = route[i].point;
+			osm.route[i].rotation = route[i].rotation;
+			osm.route[i].dir = route[i].dir;
+			osm.route[i].distanceToNext = route[i].distanceToNext;
+			osm.route[i].name = getString(route[i].name);
+		}
+
+		std::vector<std::string> roadNameStrings(static_cast<size_t>(header.roadNames.count));
+		for (size_t i = 0; i < roadNameStrings.size(); ++i)
+		{
+			roadNameStrings[i] = getString(roadNames[i]);
+		}
+		RoadGraph roadGraph;
+		roadGraph.assign(std::vector<glm::dvec2>(roadNodes, roadNodes + header.roadNodes.count),
+			std::vector<uint32_t>(roadOffsets, roadOffsets + header.roadOffsets.count),
+			std::vector<RoadGraph::Edge>(roadEdges, roadEdges + header.roadEdges.count), std::move(roadNameStrings));
+
+		_osm = std::move(osm);
+		_roadGraph = std::move(roadGraph);
+		initialiseTileGrid();
+	}
+	catch (const std::exception& e)
+	{
+		Log(LogLevel::Warning, "Failed to load the processed map '%s' (%s), the map will be processed again", _processedDataPath.c_str(), e.what());
+		return false;
+	}
+	Log(LogLevel::Information, "Loaded the processed map '%s'", _processedDataPath.c_str());
+	return true;
+}
+
+/*!*********************************************************************************************************************
+\brief	Writes the processed tiles, the route and the road graph to the processed map file, so that the next run can load them with
+		loadProcessedData instead of processing the map again. Must be called once the tiles have been initialised.
+***********************************************************************************************************************/
+void NavDataProcess::saveProcessedData() const
+{
+	if (_processedDataPath.empty())
+	{
+		return;
+	}
+
+	ProcessedDataWriter writer;
+	for (uint32_t col = 0; col < _osm.numCols; ++col)
+	{
+		for (uint32_t row = 0; row < _osm.numRows; ++row)
+		{
+			const Tile& tile = _osm.tiles[col][row];
+			TileRecord record;
+			record.min = tile.min;
+			record.max = tile.max;
+
+			record.nodes.first = static_cast<uint32_t>(writer.nodes.size());
+			record.nodes.count = static_cast<uint32_t>(tile.nodes.size());
+			for (const auto node : tile.nodes.getSortedById())
+			{
+				NodeRecord nodeRecord;
+				nodeRecord.id = node->first;
+				nodeRecord.coords = node->second.coords;
+				nodeRecord.height = node->second.height;
+				nodeRecord.texCoords = node->second.texCoords;
+				nodeRecord.tileBoundNode = node->second.tileBoundNode ? 1 : 0;
+				nodeRecord.padding = 0;
+				writer.nodes.push_back(nodeRecord);
+			}
+
+			record.ways[TileWays::Area] = writer.addWays(tile.areaWays);
+			record.ways[TileWays::Road] = writer.addWays(tile.roadWays);
+			record.ways[TileWays::Parking] = writer.addWays(tile.parkingWays);
+			record.ways[TileWays::Build] = writer.addWays(tile.buildWays);
+			record.ways[TileWays::Inner] = writer.addWays(tile.innerWays);
+			for (uint32_t lod = 0; lod < GeometryLOD::Count - 1; ++lod)
+			{
+				const Tile::SimplifiedWays& simplifiedWays = tile.simplifiedWays[lod];
+				record.simplifiedWays[lod][TileWays::Area] = writer.addWays(simplifiedWays.areaWays);
+				record.simplifiedWays[lod][TileWays::Road] = writer.addWays(simplifiedWays.roadWays);
+				record.simplifiedWays[lod][TileWays::Parking] = writer.addWays(simplifiedWays.parkingWays);
+				record.simplifiedWays[lod][TileWays::Build] = writer.addWays(simplifiedWays.buildWays);
+				record.simplifiedWays[lod][TileWays::Inner] = writer.addWays(simplifiedWays.innerWays);
+			}
+			record.areaOutlineIds = writer.addNodeIds(tile.areaOutlineIds);
+			record.polygonOutlineIds = writer.addNodeIds(tile.polygonOutlineIds);
+
+			for (uint32_t lod = 0; lod < LOD::Count; ++lod)
+			{
+				record.labels[lod].first = static_cast<uint32_t>(writer.labels.size());
+				record.labels[lod].count = static_cast<uint32_t>(tile.labels[lod].size());
+				for (const LabelData& label : tile.labels[lod])
+				{
+					writer.labels.push_back(writer.makeLabel(label));
+				}
+				record.icons[lod].first = static_cast<uint32_t>(writer.icons.size());
+				record.icons[lod].count = static_cast<uint32_t>(tile.icons[lod].size());
+				for (const IconData& icon : tile.icons[lod])
+				{
+					writer.icons.push_back(ProcessedDataWriter::makeIcon(icon));
+				}
+				record.amenityLabels[lod].first = static_cast<uint32_t>(writer.amenityLabels.size());
+				record.amenityLabels[lod].count = static_cast<uint32_t>(tile.amenityLabels[lod].size());
+				for (const AmenityLabelData& amenityLabel : tile.amenityLabels[lod])
+				{
+					AmenityLabelRecord amenityLabelRecord;
+					amenityLabelRecord.label = writer.makeLabel(amenityLabel);
+					amenityLabelRecord.icon = ProcessedDataWriter::makeIcon(amenityLabel.iconData);
+					writer.amenityLabels.push_back(amenityLabelRecord);
+				}
+			}
+			writer.tiles.push_back(record);
+		}
+	}
+	for (const RouteData& routeData : _osm.route)
+	{
+		RouteRecord record;
+		record.point = routeData.point;
+		record.rotation = routeData.rotation;
+		record.dir = routeData.dir;
+		record.distanceToNext = routeData.distanceToNext;
+		record.name = writer.addString(routeData.name);
+		record.padding = 0;
+		writer.route.push_back(record);
+	}
+	for (const std::string& name : _roadGraph.getNames())
+	{
+		writer.roadNames.push_back(writer.addString(name));
+	}
+
+	ProcessedDataHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, ProcessedDataMagic, sizeof(header.magic));
+	header.version = ProcessedDataVersion;
+	header.headerSize = sizeof(header);
+	header.sourceKey = calculateSourceKey();
+	header.numCols = _osm.numCols;
+	header.numRows = _osm.numRows;
+	header.boundsMin = _osm.bounds.min;
+	header.boundsMax = _osm.bounds.max;
+	header.minLonLat = _osm.minLonLat;
+	header.maxLonLat = _osm.maxLonLat;
+
+	try
+	{
+		pvr::FileStream stream(_processedDataPath, "wb");
+		stream.open();
+		// Write a placeholder header, the sections, then the header again with the offsets of the sections.
+		stream.writeExact(sizeof(header), 1, &header);
+		uint64_t offset = sizeof(header);
+		ProcessedDataWriter::writeSection(stream, header.tiles, writer.tiles, offset);
+		ProcessedDataWriter::writeSection(stream, header.nodes, writer.nodes, offset);
+		ProcessedDataWriter::writeSection(stream, header.ways, writer.ways, offset);
+		ProcessedDataWriter::writeSection(stream, header.nodeIds, writer.nodeIds, offset);
+		ProcessedDataWriter::writeSection(stream, header.labels, writer.labels, offset);
+		ProcessedDataWriter::writeSection(stream, header.icons, writer.icons, offset);
+		ProcessedDataWriter::writeSection(stream, header.amenityLabels, writer.amenityLabels, offset);
+		ProcessedDataWriter::writeSection(stream, header.route, writer.route, offset);
+		ProcessedDataWriter::writeSection(stream, header.roadNodes, _roadGraph.getNodeCoords(), offset);
+		ProcessedDataWriter::writeSection(stream, header.roadOffsets, _roadGraph.getOffsets(), offset);
+		ProcessedDataWriter::writeSection(stream, header.roadEdges, _roadGraph.getEdges(), offset);
+		ProcessedDataWriter::writeSection(stream, header.roadNames, writer.roadNames, offset);
+		ProcessedDataWriter::writeSection(stream, header.strings, writer.strings, offset);
+		stream.seek(0, pvr::Stream::SeekOriginFromStart);
+		stream.writeExact(sizeof(header), 1, &header);
+		stream.close();
+		Log(LogLevel::Information, "Saved the processed map to '%s' (%llu bytes)", _processedDataPath.c_str(), static_cast<unsigned long long>(offset));
+	}
+	catch (const std::exception& e)
+	{
+		Log(LogLevel::Warning, "Failed to save the processed map to '%s' (%s)", _processedDataPath.c_str(), e.what());
+	}
+}
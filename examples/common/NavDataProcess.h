@@ -1,7 +1,19 @@
 #pragma once
 #include "PVRAssets/PVRAssets.h"
+#include "OSMStreamReader.h"
+#include "PolygonTriangulator.h"
+#include "PolylineSimplifier.h"
+#include "SpatialIndex.h"
+#include "RoadGraph.h"
 #include <deque>
+#include <unordered_map>
 #include <set>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <exception>
 
 /***Road types - color uniforms***/
 const glm::vec4 ClearColorLinearSpace(0.65f, 0.65f, 0.65f, 1.0f);
@@ -114,6 +126,18 @@ enum Levels
 };
 }
 
+// Levels of detail of the geometry of the tiles. L0 is the full resolution geometry, each further level has its roads and
+// outlines simplified for a more distant view.
+namespace GeometryLOD {
+enum Levels
+{
+	L0,
+	L1,
+	L2,
+	Count
+};
+}
+
 // Stores the minimum and maximum latitude & longitude of the map.
 struct Bounds
 {
@@ -121,13 +145,6 @@ struct Bounds
 	glm::dvec2 max;
 };
 
-// Stores a key-value pair.
-struct Tag
-{
-	std::string key;
-	std::string value;
-};
-
 struct IntersectionData
 {
 	std::vector<uint64_t> nodes;
@@ -205,6 +222,127 @@ struct Vertex
 	{}
 };
 
+/* Stores nodes densely: the 64-bit OSM id of a node is remapped to a 32-bit index into a contiguous (chunked) array when the node is added,
+so that finding a node by id is a single hash lookup and the processing passes walk cache-friendly storage. The ids are only used at the
+boundary, when nodes are added or looked up. Provides the subset of the std::map interface used by the processing, iterating in insertion
+order. Where the order is observable (the vertices of the tile geometry and the processed map file), getSortedById gives the ascending id
+order a std::map would iterate in. Nodes are never removed, so references to nodes (and their indices) remain valid when more nodes are
+added. */
+class NodeMap
+{
+public:
+	typedef std::pair<uint64_t, Vertex> value_type;
+	typedef std::deque<value_type>::iterator iterator;
+	typedef std::deque<value_type>::const_iterator const_iterator;
+
+	static const uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+	NodeMap() : _maxId(0) {}
+
+	// Return the node with the given id, adding a default constructed node if there is none.
+	Vertex& operator[](uint64_t id)
+	{
+		auto result = _indices.emplace(id, static_cast<uint32_t>(_nodes.size()));
+		if (result.second)
+		{
+			_nodes.emplace_back(id, Vertex());
+			_maxId = std::max(_maxId, id);
+		}
+		return _nodes[result.first->second].second;
+	}
+	iterator find(uint64_t id)
+	{
+		const uint32_t index = getIndex(id);
+		return index == InvalidIndex ? _nodes.end() : _nodes.begin() + index;
+	}
+	const_iterator find(uint64_t id) const
+	{
+		const uint32_t index = getIndex(id);
+		return index == InvalidIndex ? _nodes.end() : _nodes.begin() + index;
+	}
+	// Return the dense index of the node with the given id, or InvalidIndex.
+	uint32_t getIndex(uint64_t id) const
+	{
+		auto it = _indices.find(id);
+		return it == _indices.end() ? InvalidIndex : it->second;
+	}
+	Vertex& getByIndex(uint32_t index)
+	{
+		return _nodes[index].second;
+	}
+	const Vertex& getByIndex(uint32_t index) const
+	{
+		return _nodes[index].second;
+	}
+	// Return iterators to all nodes in ascending id order.
+	std::vector<iterator> getSortedById()
+	{
+		std::vector<iterator> sorted;
+		sorted.reserve(_nodes.size());
+		for (auto it = _nodes.begin(); it != _nodes.end(); ++it)
+		{
+			sorted.push_back(it);
+		}
+		std::sort(sorted.begin(), sorted.end(), [](const iterator& lhs, const iterator& rhs) { return lhs->first < rhs->first; });
+		return sorted;
+	}
+	std::vector<const_iterator> getSortedById() const
+	{
+		std::vector<const_iterator> sorted;
+		sorted.reserve(_nodes.size());
+		for (auto it = _nodes.begin(); it != _nodes.end(); ++it)
+		{
+			sorted.push_back(it);
+		}
+		std::sort(sorted.begin(), sorted.end(), [](const const_iterator& lhs, const const_iterator& rhs) { return lhs->first < rhs->first; });
+		return sorted;
+	}
+	// Return the largest id of any node, used to generate the ids of new nodes.
+	uint64_t getMaxId() const
+	{
+		return _maxId;
+	}
+	void reserve(size_t count)
+	{
+		_indices.reserve(count);
+	}
+	iterator begin()
+	{
+		return _nodes.begin();
+	}
+	iterator end()
+	{
+		return _nodes.end();
+	}
+	const_iterator begin() const
+	{
+		return _nodes.begin();
+	}
+	const_iterator end() const
+	{
+		return _nodes.end();
+	}
+	size_t size() const
+	{
+		return _nodes.size();
+	}
+	bool empty() const
+	{
+		return _nodes.empty();
+	}
+	void clear()
+	{
+		_nodes.clear();
+		_indices.clear();
+		_maxId = 0;
+	}
+
+private:
+	std::deque<value_type> _nodes;
+	std::unordered_map<uint64_t, uint32_t> _indices;
+	uint64_t _maxId;
+};
+
 struct LabelData
 {
 	std::string name;
@@ -265,6 +403,7 @@ class ConvertedWay : public Way
 {
 public:
 	std::vector<std::array<uint64_t, 3> > triangulatedIds;
+	std::vector<std::array<uint64_t, 3> > simplifiedTriangulatedIds[GeometryLOD::Count - 1]; // GeometryLOD::L1 onwards
 
 	ConvertedWay(uint64_t userId = 0, bool userArea = false, const std::vector<Tag>& userTags = std::vector<Tag>{}, RoadTypes::RoadTypes type = RoadTypes::None,
 		double roadWidth = 0, bool intersection = false, bool roundabout = false, bool fork = false)
@@ -288,7 +427,7 @@ struct Tile
 	glm::vec2 screenMin;
 	glm::vec2 screenMax;
 
-	std::map<uint64_t, Vertex> nodes;
+	NodeMap nodes;
 	std::vector<Way> areaWays;
 	std::vector<Way> roadWays;
 	std::vector<Way> parkingWays;
@@ -300,6 +439,17 @@ struct Tile
 	std::vector<uint64_t> areaOutlineIds;
 	std::vector<uint64_t> polygonOutlineIds;
 
+	// The ways of the simplified levels of detail, from GeometryLOD::L1 onwards. The ways above are GeometryLOD::L0.
+	struct SimplifiedWays
+	{
+		std::vector<Way> areaWays;
+		std::vector<Way> roadWays;
+		std::vector<Way> parkingWays;
+		std::vector<Way> buildWays;
+		std::vector<Way> innerWays;
+	};
+	SimplifiedWays simplifiedWays[GeometryLOD::Count - 1];
+
 	struct VertexData
 	{
 		glm::vec3 pos;
@@ -324,7 +474,7 @@ struct OSM
 	glm::dvec2 maxLonLat;
 
 	Bounds bounds;
-	std::map<uint64_t, Vertex> nodes;
+	NodeMap nodes;
 	std::vector<uint64_t> original_intersections;
 	std::vector<std::vector<std::map<uint64_t, BoundaryData> > > boundaryNodes;
 	std::map<uint64_t, IntersectionData> intersectionNodes;
@@ -339,6 +489,8 @@ struct OSM
 	std::map<uint64_t, Way> buildWays;
 	std::map<uint64_t, Way> triangulatedRoads; // tempRoads;
 	std::vector<uint64_t> areaOutlines;
+	std::map<uint64_t, std::vector<uint64_t> > wayHoles; // Outer parking / building way id -> the inner ways cut out of it
+	std::set<uint64_t> holeWays; // The inner ways cut out of an outer way
 
 	std::vector<RouteData> route;
 
@@ -409,6 +561,61 @@ inline float cameraRotationTimeInMs(float angleDeg, float ms360)
 	return glm::abs(angleDeg / 360.f * ms360);
 }
 
+/*!*********************************************************************************************************************
+\brief  Call a function for every index in [0, count) on all the hardware threads, the calling thread included.
+\param  count The number of indices.
+\param  function The function to call with each index. Calls for different indices may run concurrently, so they
+		must only write data that belongs to their own index.
+\details Indices are handed out one at a time, so uneven amounts of work per index are balanced across the threads. If a
+		 call throws, no further indices are started and the first exception is rethrown once all the threads have stopped.
+***********************************************************************************************************************/
+template<typename Function>
+inline void parallelFor(uint32_t count, const Function& function)
+{
+	if (!count)
+	{
+		return;
+	}
+	const uint32_t numThreads = std::min(std::max(std::thread::hardware_concurrency(), 1u), count);
+
+	std::atomic<uint32_t> nextIndex(0);
+	std::vector<std::exception_ptr> errors(numThreads);
+	auto worker = [&](uint32_t threadIndex) {
+		try
+		{
+			for (uint32_t i = nextIndex++; i < count; i = nextIndex++)
+			{
+				function(i);
+			}
+		}
+		catch (...)
+		{
+			errors[threadIndex] = std::current_exception();
+			// Make the other threads stop picking up work
+			nextIndex = count;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(numThreads - 1);
+	for (uint32_t i = 1; i < numThreads; ++i)
+	{
+		threads.emplace_back(worker, i);
+	}
+	worker(0);
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	for (const std::exception_ptr& error : errors)
+	{
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+}
+
 /*!*****************************************************************************
 Class NavDataProcess This class handles the loading of OSM data from an XML file
 and pre-processing (i.e. triangulation) the raw data into usable rendering data.
@@ -419,7 +626,6 @@ public:
 	struct RoadParams
 	{
 		WayTypes::WayTypes wayType;
-		uint64_t wayId;
 		std::vector<Tag> wayTags;
 		bool area;
 		RoadTypes::RoadTypes roadType;
@@ -428,29 +634,44 @@ public:
 		bool isRoundabout;
 	};
 
+	// A piece of a triangle that lies completely inside a single tile.
+	struct ClippedTriangle
+	{
+		glm::uvec2 tileCoords;
+		uint32_t sourceIndex;
+		Vertex vertices[3];
+	};
+
 	// Constructor takes a stream which the class uses to read the XML file.
 	NavDataProcess(std::unique_ptr<pvr::Stream> stream, const glm::ivec2& screenDimensions)
 	{
 		_assetStream = std::move(stream);
 		_windowsDim = screenDimensions;
+		_isProcessedDataLoaded = false;
+		_numTriangulatedPolygons = 0;
+		_numTriangulatedVertices = 0;
+		_maxTriangulatedVertices = 0;
+		_triangulationTime = std::chrono::steady_clock::duration::zero();
 	}
 
-	void clipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, const glm::uvec2& minTileIndex, const glm::uvec2& maxTileIndex, const RoadParams& roadParams);
+	// The clipping functions only read the map, so that different triangles can be clipped concurrently. The pieces are appended to clippedTriangles.
+	void clipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, const glm::uvec2& minTileIndex, const glm::uvec2& maxTileIndex, uint32_t sourceIndex,
+		std::vector<ClippedTriangle>& clippedTriangles) const;
 
-	void clipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, uint64_t wayId, const std::vector<Tag>& wayTags, WayTypes::WayTypes wayType, bool area,
-		RoadTypes::RoadTypes roadType, double roadWidth, bool isIntersection, bool isRoundabout);
+	void clipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, uint32_t sourceIndex, std::vector<ClippedTriangle>& clippedTriangles) const;
 
 	void recurseClipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, const glm::uvec2& minTileIndex, const glm::uvec2& maxTileIndex,
-		const RoadParams& roadParams, bool isPlaneVertical);
+		uint32_t sourceIndex, bool isPlaneVertical, std::vector<ClippedTriangle>& clippedTriangles) const;
 
 	// These functions should be called before accessing the tile data to make
-	// sure the tiles have been initialised.
-	pvr::Result loadAndProcessData();
+	// sure the tiles have been initialised. If a path is given, the processed map is loaded from that file if it was written for the same map, in which case
+	// no processing is done at all, otherwise initTiles writes the processed map to it for the next run.
+	pvr::Result loadAndProcessData(const std::string& processedDataPath = std::string());
 	void initTiles(); // Call after window width / height is known
 
 	// Public accessor function to tiles.
 	void clipAgainst(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, glm::vec2 planeOrigin, const glm::vec2& planeNorm, Vertex* triFront, Vertex* triBack,
-		uint32_t& numTriFront, uint32_t& numTriBack);
+		uint32_t& numTriFront, uint32_t& numTriBack) const;
 
 	std::vector<std::vector<Tile> >& getTiles()
 	{
@@ -482,6 +703,9 @@ public:
 	}
 	void processLabelBoundary(LabelData& label, glm::uvec2& tileCoords);
 
+	// Route query, in map co-ordinates (the co-ordinates of the tile bounds). It can be used once loadAndProcessData has built the road graph.
+	bool findRoute(const glm::dvec2& start, const glm::dvec2& end, std::vector<RouteData>& route) const;
+
 	/*!*********************************************************************************************************************
 	\brief  Converts pre-computed route into the appropriate co-ordinate space and
 	calculates the routes total true distance
@@ -495,14 +719,48 @@ private:
 	OSM _osm;
 	glm::ivec2 _windowsDim;
 	std::unique_ptr<pvr::Stream> _assetStream;
+	std::string _processedDataPath;
+	bool _isProcessedDataLoaded;
+
+	// Polygon triangulation scratch data, kept to avoid allocations per polygon
+	PolygonTriangulator _triangulator;
+	std::vector<glm::dvec2> _triangulationCoords;
+	std::vector<uint64_t> _triangulationIds;
+	std::vector<uint32_t> _triangulationHoleStarts;
+	std::vector<uint32_t> _triangulationIndices;
+	std::vector<const std::vector<uint64_t>*> _triangulationHoles;
+	// Polygon triangulation statistics, logged once the tiles have been processed
+	uint32_t _numTriangulatedPolygons;
+	uint64_t _numTriangulatedVertices;
+	uint32_t _maxTriangulatedVertices;
+	std::chrono::steady_clock::duration _triangulationTime;
+	PolylineSimplifier _simplifier;
+	std::vector<uint32_t> _simplifiedIndices;
+
+	// The grid used to find the tile of a point
+	UniformGrid _tileGrid;
+
+	// The road network used for routing, and an R-tree of its nodes to find the node closest to a point, built on first use
+	RoadGraph _roadGraph;
+	mutable std::once_flag _isRoadNodeIndexBuilt;
+	mutable PackedRTree _roadNodeIndex;
 
 	// Raw data handling fuctions
 	pvr::Result loadOSMData();
 	glm::dvec2 lonLatToMetres(const glm::dvec2 origin, const glm::dvec2 point) const;
 	void generateIcon(const uint64_t* nodeIds, size_t numNodeIds, const Tag* tags, size_t numTags, uint64_t id);
+	void markInnerWays(const RelationMember* members, size_t numMembers, const Tag* tags, size_t numTags);
+	void addHole(const RelationMember* members, size_t numMembers, const std::map<uint64_t, Way>& ways, const Way& innerWay);
+
+	// Processed map file functions
+	uint64_t calculateSourceKey() const;
+	bool loadProcessedData();
+	void saveProcessedData() const;
 	void processLabels(const glm::dvec2& mapWorldDim);
 	void cleanData();
 	void calculateRoute();
+	void buildRoadGraph(std::unordered_map<uint64_t, uint32_t>& outNodeIndices);
+	void fillRouteData(uint32_t start, const std::vector<uint32_t>& edges, std::vector<RouteData>& route) const;
 
 	// General utility functions
 	std::string getAttributeRef(const std::vector<Tag>& tags) const;
@@ -555,12 +813,20 @@ private:
 	// Polygon triangulation functions
 
 	/*!*********************************************************************************************************************
-			\return std::vector<std::vector<uint64_t>> A vector of triangle ways.
-			\param  nodeIds A vector of node IDs for a closed way (anti-clockwise
-	   wound).
-			\brief  Triangluates an anti-clockwise wound closed way.
-			***********************************************************************************************************************/
-	void triangulate(std::vector<uint64_t>& nodeIds, std::vector<std::array<uint64_t, 3> >& outTriangulates) const;
+	\param  nodeIds A vector of node IDs for a closed way.
+	\param  holes The node IDs of the closed ways to cut out of it.
+	\param  outTriangulates Receives the triangles, wound anti-clockwise.
+	\brief  Triangulates a closed way, optionally with holes.
+	***********************************************************************************************************************/
+	void triangulate(const std::vector<uint64_t>& nodeIds, const std::vector<const std::vector<uint64_t>*>& holes, std::vector<std::array<uint64_t, 3> >& outTriangulates);
+	void triangulate(const std::vector<uint64_t>& nodeIds, std::vector<std::array<uint64_t, 3> >& outTriangulates)
+	{
+		triangulate(nodeIds, std::vector<const std::vector<uint64_t>*>(), outTriangulates);
+	}
+	void logTriangulationStatistics() const;
+	const std::vector<const std::vector<uint64_t>*>& getHoles(const Way& way, const std::map<uint64_t, Way>& ways);
+	void simplifyRing(const std::vector<uint64_t>& nodeIds, double tolerance, std::vector<uint64_t>& outNodeIds);
+	void simplifyRoadStrip(const std::vector<uint64_t>& nodeIds, double tolerance, std::vector<uint64_t>& outNodeIds);
 
 	pvr::PolygonWindingOrder checkWinding(const std::vector<uint64_t>& nodeIds) const;
 	pvr::PolygonWindingOrder checkWinding(const std::vector<glm::dvec2>& points) const;
@@ -568,6 +834,8 @@ private:
 
 	// Map tiling functions
 	void initialiseTiles();
+	void initialiseTileGrid();
+	void buildRoadNodeIndex() const;
 	void sortTiles();
 	void fillTiles(Vertex startNode, Vertex endNode, const uint64_t wayId, const std::vector<Tag> wayTags, const WayTypes::WayTypes wayType, double height = 0,
 		const bool addEnd = false, const bool area = false, RoadTypes::RoadTypes type = RoadTypes::None, double width = 0.0, bool isIntersection = false, bool isRoundabout = false,
@@ -594,12 +862,13 @@ private:
 	\brief	Insert a way (or a node ID) into a given array of ways.
 	***********************************************************************************************************************/
 	void insertWay(std::vector<Way>& insertIn, Way& way);
-	void insert(const glm::uvec2& tileCoords, WayTypes::WayTypes type, Way* w = nullptr, uint64_t id = 0);
+	void insert(const glm::uvec2& tileCoords, WayTypes::WayTypes type, Way* w = nullptr, uint64_t id = 0, uint32_t geometryLod = GeometryLOD::L0);
 
 	glm::ivec2 findTile(const glm::dvec2& point) const;
 	glm::ivec2 findTile2(glm::dvec2& point) const;
 	bool isOutOfBounds(const glm::dvec2& point) const;
 	bool isTooCloseToBoundary(const glm::dvec2& point) const;
+	bool isExcludedFromRoute(const glm::dvec2& point) const;
 	bool findMapIntersect(glm::dvec2& point1, glm::dvec2& point2) const;
 	void addCornerPoints(Tile& tile, std::vector<Way>& way);
 
@@ -807,6 +1076,17 @@ inline double getRoadWidth(RoadTypes::RoadTypes type)
 	return roadWidths[type];
 }
 
+/*!*********************************************************************************************************************
+\return The typical speed on the road in km/h, used to find the fastest route.
+\type The RoadType enum describing the type of the road
+\brief  Use the type of a road to determine how fast it can be driven along.
+***********************************************************************************************************************/
+inline double getRoadSpeed(RoadTypes::RoadTypes type)
+{
+	static const double roadSpeeds[] = { 110.0, 90.0, 70.0, 50.0, 40.0, 20.0, 30.0 };
+	return roadSpeeds[type];
+}
+
 /*!*********************************************************************************************************************
 \return bool True if the road is a roundabout otherwise false.
 \param  tags Tags for the road.
@@ -1206,6 +1486,7 @@ inline void NavDataProcess::initialiseTiles()
 		}
 		_osm.tiles.push_back(tempCol);
 	}
+	initialiseTileGrid();
 }
 
 /*!*********************************************************************************************************************
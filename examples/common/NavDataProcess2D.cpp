@@ -1,6 +1,5 @@
 #include "NavDataProcess.h"
 #include "../external/glm/gtx/intersect.hpp"
-#include "../external/pugixml/pugixml.hpp"
 
 const float TexUVLeft = -1.f;
 const float TexUVRight = 1.f;
@@ -8,15 +7,24 @@ const float TexUVUp = .25f;
 const float TexUVCenter = (TexUVLeft + TexUVRight) * .5f;
 
 /*!*********************************************************************************************************************
+\param  processedDataPath The path of the processed map file to load or to write. Optional.
 \return Return pvr::Result::Success if no error occurred
-\brief  Initialisation of data, calls functions to load data from XML file and triangulate geometry.
+\brief  Initialisation of data, calls functions to load data from XML file and triangulate geometry, or to load
+		the processed map if it was written for the same data by a previous run.
 ***********************************************************************************************************************/
-pvr::Result NavDataProcess::loadAndProcessData()
+pvr::Result NavDataProcess::loadAndProcessData(const std::string& processedDataPath)
 {
 	// Set tile scaling parameters
 	_osm.lonTileScale = 0.005;
 	_osm.latTileScale = 0.005;
 
+	_processedDataPath = processedDataPath;
+	_isProcessedDataLoaded = loadProcessedData();
+	if (_isProcessedDataLoaded)
+	{
+		return pvr::Result::Success;
+	}
+
 	pvr::Result result = loadOSMData();
 
 	if (result != pvr::Result::Success)
@@ -40,9 +48,14 @@ This function fills the tiles with data which has been processed.
 ***********************************************************************************************************************/
 void NavDataProcess::initTiles()
 {
-	processLabels(_osm.bounds.max - _osm.bounds.min);
-	sortTiles();
-	_osm.cleanData();
+	if (!_isProcessedDataLoaded) // Otherwise the tiles were loaded fully initialised
+	{
+		processLabels(_osm.bounds.max - _osm.bounds.min);
+		sortTiles();
+		logTriangulationStatistics();
+		_osm.cleanData();
+		saveProcessedData();
+	}
 }
 
 void NavDataProcess::convertRoute(const glm::dvec2& mapWorldDim, uint32_t numCols, uint32_t numRows, float& totalRouteDistance)
@@ -68,7 +81,8 @@ void NavDataProcess::convertRoute(const glm::dvec2& mapWorldDim, uint32_t numCol
 
 /*!*********************************************************************************************************************
 \return Return Result::Success if no error occurred
-\brief  Get map data and load into OSM object.
+\brief  Get map data and load into OSM object. The map is streamed in a single pass: every node, way and relation is added
+		to the OSM object as soon as it has been read, so the memory used by the parse does not depend on the size of the map.
 ***********************************************************************************************************************/
 pvr::Result NavDataProcess::loadOSMData()
 {
@@ -76,44 +90,19 @@ pvr::Result NavDataProcess::loadOSMData()
 	// Enable memory-leak reports
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
-	pugi::xml_document mapData;
-	std::vector<char> mapStream = _assetStream->readToEnd<char>();
-	pugi::xml_parse_result result = mapData.load_string(mapStream.data(), static_cast<uint32_t>(mapStream.size()));
-
-	Log(LogLevel::Debug, "XML parse result: %s", result.description());
-	if (!result)
-	{
-		return pvr::Result::UnknownError;
-	}
+	OSMStreamReader reader;
 
-	// Get the bounds of the map
-	_osm.maxLonLat =
-		glm::vec2(mapData.root().child("osm").child("bounds").attribute("maxlon").as_double(), mapData.root().child("osm").child("bounds").attribute("maxlat").as_double());
-	_osm.minLonLat =
-		glm::vec2(mapData.root().child("osm").child("bounds").attribute("minlon").as_double(), mapData.root().child("osm").child("bounds").attribute("minlat").as_double());
-	_osm.bounds.min = glm::dvec2(0, 0);
-	_osm.bounds.max = lonLatToMetres(_osm.minLonLat, _osm.maxLonLat);
+	// Get the bounds of the map. OSM files list the bounds first, then the nodes, then the ways, then the relations.
+	reader.setBoundsCallback([this](const glm::dvec2& minLonLat, const glm::dvec2& maxLonLat) {
+		_osm.minLonLat = glm::vec2(minLonLat);
+		_osm.maxLonLat = glm::vec2(maxLonLat);
+		_osm.bounds.min = glm::dvec2(0, 0);
+		_osm.bounds.max = lonLatToMetres(_osm.minLonLat, _osm.maxLonLat);
+	});
 
 	// Collect the nodes
-	pugi::xml_object_range<pugi::xml_named_node_iterator> nodes = mapData.root().child("osm").children("node");
-	std::array<Tag, 50> tempTags;
-	size_t numTags = 0;
-
-	for (pugi::xml_named_node_iterator currentNode = nodes.begin(); currentNode != nodes.end(); ++currentNode)
-	{
-		if (!currentNode->attribute("visible").empty() && !currentNode->attribute("visible").as_bool()) // Skip node if not visible
-		{
-			continue;
-		}
-
-		glm::dvec2 coords;
-
-		// Get ID, latitude and longitude
-		uint64_t node_id = currentNode->attribute("id").as_ullong();
-		Vertex& tempNode = _osm.createNode(node_id);
-
-		tempNode.id = currentNode->attribute("id").as_ullong();
-		coords = glm::dvec2(currentNode->attribute("lon").as_double(), currentNode->attribute("lat").as_double());
+	reader.setNodeCallback([this](uint64_t nodeId, const glm::dvec2& coords, const Tag* tags, size_t numTags) {
+		Vertex& tempNode = _osm.createNode(nodeId);
 		tempNode.coords = lonLatToMetres(_osm.minLonLat, coords);
 
 		if (coords.x < _osm.minLonLat.x)
@@ -125,52 +114,22 @@ pvr::Result NavDataProcess::loadOSMData()
 			tempNode.coords.y *= -1;
 		}
 
-		// Get tags from XML.
-		pugi::xml_object_range<pugi::xml_named_node_iterator> tags = currentNode->children("tag");
-		numTags = 0;
-
-		// Collect tags for this node.
-		for (pugi::xml_named_node_iterator currentTag = tags.begin(); currentTag != tags.end(); ++currentTag)
-		{
-			uint32_t tag = static_cast<uint32_t>(numTags++);
-			tempTags[tag].key = currentTag->attribute("k").as_string();
-			tempTags[tag].value = currentTag->attribute("v").as_string();
-		}
-
-		generateIcon(&tempNode.id, 1, tempTags.data(), numTags, tempNode.id);
+		generateIcon(&tempNode.id, 1, tags, numTags, tempNode.id);
 
 		debug_assertion(_osm.icons[LOD::IconLOD].size() >= _osm.amenityLabels[LOD::AmenityLabelLOD].size(), "There must be at least one amenity icon per amenity label");
-	}
-	if (_osm.nodes.empty())
-	{
-		return pvr::Result::UnknownError;
-	}
-	// Collect the ways
-	pugi::xml_object_range<pugi::xml_named_node_iterator> ways = mapData.root().child("osm").children("way");
-
-	for (pugi::xml_named_node_iterator currentWay = ways.begin(); currentWay != ways.end(); ++currentWay)
-	{
-		if (!currentWay->attribute("visible").empty() && !currentWay->attribute("visible").as_bool()) // Skip way if not visible
-		{
-			continue;
-		}
+	});
 
+	// Collect the ways
+	reader.setWayCallback([this](uint64_t tempWayId, const uint64_t* nodeIds, size_t numNodeIds, const Tag* tags, size_t numTags) {
 		bool isArea = false;
 
 		Way* tempWay = NULL;
 		WayTypes::WayTypes wayType = WayTypes::Default;
-		// Get ID
-		uint64_t tempWayId = currentWay->attribute("id").as_ullong();
-
-		// Get tags
-		pugi::xml_object_range<pugi::xml_named_node_iterator> tags = currentWay->children("tag");
 
-		for (pugi::xml_named_node_iterator currentTag = tags.begin(); currentTag != tags.end(); ++currentTag)
+		for (size_t i = 0; i < numTags; ++i)
 		{
-			Tag tempTag;
-
-			const char* key = currentTag->attribute("k").as_string();
-			const char* value = currentTag->attribute("v").as_string();
+			const char* key = tags[i].key.c_str();
+			const char* value = tags[i].value.c_str();
 
 			if ((strcmp(key, "highway") == 0) && (strcmp(value, "footway") != 0) && (strcmp(value, "bus_guideway") != 0) && (strcmp(value, "raceway") != 0) &&
 				(strcmp(value, "bridleway") != 0) && (strcmp(value, "steps") != 0) && (strcmp(value, "path") != 0) && (strcmp(value, "cycleway") != 0) &&
@@ -191,7 +150,6 @@ pvr::Result NavDataProcess::loadOSMData()
 				isArea = true;
 			}
 		}
-		Way tmp;
 
 		if (wayType == WayTypes::Road)
 		{
@@ -207,7 +165,7 @@ pvr::Result NavDataProcess::loadOSMData()
 		}
 		else
 		{
-			tempWay = &tmp;
+			return; // Ways of other types are not used
 		}
 
 		tempWay->inner = false;
@@ -215,29 +173,15 @@ pvr::Result NavDataProcess::loadOSMData()
 		tempWay->isIntersection = false;
 		tempWay->isRoundabout = false;
 		tempWay->width = 0.0;
-
-		// Get ID
 		tempWay->id = tempWayId;
+		tempWay->tags.assign(tags, tags + numTags);
+		tempWay->nodeIds.assign(nodeIds, nodeIds + numNodeIds);
 
-		for (pugi::xml_named_node_iterator currentTag = tags.begin(); currentTag != tags.end(); ++currentTag)
+		if ((wayType == WayTypes::Road) && !tempWay->area)
 		{
-			tempWay->tags.emplace_back();
-			Tag& tempTag = tempWay->tags.back();
-			tempTag.key = currentTag->attribute("k").as_string();
-			tempTag.value = currentTag->attribute("v").as_string();
-			tempWay->tags.push_back(tempTag);
-		}
-
-		// Get node IDs
-		pugi::xml_object_range<pugi::xml_named_node_iterator> nodeIds = currentWay->children("nd");
-
-		for (pugi::xml_named_node_iterator currentNodeId = nodeIds.begin(); currentNodeId != nodeIds.end(); ++currentNodeId)
-		{
-			tempWay->nodeIds.push_back(currentNodeId->attribute("ref").as_ullong());
-
-			if ((wayType == WayTypes::Road) && !tempWay->area)
+			for (size_t i = 0; i < numNodeIds; ++i)
 			{
-				Vertex& currentNode = _osm.getNodeById(tempWay->nodeIds.back());
+				Vertex& currentNode = _osm.getNodeById(nodeIds[i]);
 				currentNode.wayIds.push_back(tempWay->id);
 
 				if (currentNode.wayIds.size() == 2)
@@ -284,11 +228,6 @@ pvr::Result NavDataProcess::loadOSMData()
 			break;
 		}
 		case WayTypes::Parking:
-		{
-			generateIcon(tempWay->nodeIds.data(), tempWay->nodeIds.size(), tempWay->tags.data(), tempWay->tags.size(), tempWay->id);
-			debug_assertion(_osm.icons[LOD::IconLOD].size() >= _osm.amenityLabels[LOD::AmenityLabelLOD].size(), "There must be at least one amenity icon per amenity label");
-			break;
-		}
 		case WayTypes::Building:
 		{
 			generateIcon(tempWay->nodeIds.data(), tempWay->nodeIds.size(), tempWay->tags.data(), tempWay->tags.size(), tempWay->id);
@@ -298,226 +237,26 @@ pvr::Result NavDataProcess::loadOSMData()
 		default:
 			break;
 		}
-	}
-	if (_osm.originalRoadWays.empty() && _osm.buildWays.empty() && _osm.parkingWays.empty())
-	{
-		return pvr::Result::UnknownError;
-	}
+	});
 
-	// Use relation data to sort inner ways
-	pugi::xml_object_range<pugi::xml_named_node_iterator> relations = mapData.root().child("osm").children("relation");
+	// Use relation data to sort inner ways. All the ways have been read by the time the relations are.
+	reader.setRelationCallback([this](uint64_t, const RelationMember* members, size_t numMembers, const Tag* tags, size_t numTags) {
+		markInnerWays(members, numMembers, tags, numTags);
+	});
 
-	for (pugi::xml_named_node_iterator currentRelation = relations.begin(); currentRelation != relations.end(); ++currentRelation)
+	if (!reader.read(*_assetStream))
 	{
-		if (!currentRelation->attribute("visible").empty() && !currentRelation->attribute("visible").as_bool()) // Skip way if not visible
-		{
-			continue;
-		}
-
-		// Check tags to see if it describes a multipolygon
-		pugi::xml_object_range<pugi::xml_named_node_iterator> tags = currentRelation->children("tag");
-		bool multiPolygon = false;
-
-		for (pugi::xml_named_node_iterator currentTag = tags.begin(); currentTag != tags.end(); ++currentTag)
-		{
-			std::string key = currentTag->attribute("k").as_string();
-			std::string value = currentTag->attribute("v").as_string();
-
-			if ((key == "type") && (value == "multipolygon"))
-			{
-				multiPolygon = true;
-			}
-		}
-
-		if (!multiPolygon)
-		{
-			continue;
-		}
-
-		// Iterate through members to find outer way type
-		pugi::xml_object_range<pugi::xml_named_node_iterator> members = currentRelation->children("member");
-
-		WayTypes::WayTypes outerType = WayTypes::Default;
-		for (pugi::xml_named_node_iterator currentMember = members.begin(); currentMember != members.end(); ++currentMember)
-		{
-			std::string type = currentMember->attribute("type").as_string();
-			std::string role = currentMember->attribute("role").as_string();
-
-			if ((type == "way") && (role == "outer"))
-			{
-				uint64_t wayId = currentMember->attribute("ref").as_ullong();
-
-				if (_osm.parkingWays.find(wayId) != _osm.parkingWays.end())
-				{
-					outerType = WayTypes::Parking;
-				}
-				else if (_osm.buildWays.find(wayId) != _osm.buildWays.end())
-				{
-					outerType = WayTypes::Building;
-				}
-			}
-		}
-
-		// Iterate through members again to find inner ways
-		for (pugi::xml_named_node_iterator currentMember = members.begin(); currentMember != members.end(); ++currentMember)
-		{
-			std::string type = currentMember->attribute("type").as_string();
-			std::string role = currentMember->attribute("role").as_string();
-
-			if ((type == "way") && (role == "inner"))
-			{
-				uint64_t wayId = currentMember->attribute("ref").as_ullong();
-
-				const auto& parkingTemp = _osm.parkingWays.find(wayId);
-				const auto& buildTemp = _osm.buildWays.find(wayId);
-
-				if ((parkingTemp != _osm.parkingWays.end()) && (outerType == WayTypes::Parking))
-				{
-					parkingTemp->second.inner = true;
-				}
-				else if ((buildTemp != _osm.buildWays.end()) && (outerType == WayTypes::Building))
-				{
-					buildTemp->second.inner = true;
-				}
-			}
-		}
+		return pvr::Result::UnknownError;
 	}
-	return pvr::Result::Success;
-}
-
-/*!*********************************************************************************************************************
-\brief  Iterates over available intersections and calculates a 'random' route through the available data set,
-if no interesections are available no route will be calculated.
-***********************************************************************************************************************/
-void NavDataProcess::calculateRoute()
-{
-	Log(LogLevel::Information, "Calculating a simple route.");
-	if (_osm.original_intersections.size() == 0)
+	if (_osm.nodes.empty())
 	{
-		Log(LogLevel::Information, "No Route Calculated - No intersections.");
-		return;
+		return pvr::Result::UnknownError;
 	}
-
-	uint32_t count = 0;
-	// Hold previosuly visited IDs to prevent going back on ourselves.
-	std::set<uint64_t> previousIntersectIDs;
-	std::set<uint64_t> previousWayIDs;
-	uint64_t nextID = _osm.original_intersections[0];
-	uint64_t lastID = -1;
-	std::vector<std::pair<uint64_t, glm::dvec2> > tempCoords;
-
-	Log(LogLevel::Information, "Calculated intersections: %u", _osm.original_intersections.size());
-
-	while (count < _osm.original_intersections.size())
+	if (_osm.originalRoadWays.empty() && _osm.buildWays.empty() && _osm.parkingWays.empty())
 	{
-		bool nextJunctionFound = false;
-		const Vertex& node = _osm.getNodeById(nextID);
-
-		// Find the next way for the route.
-		for (uint32_t i = 0; i < node.wayIds.size(); ++i)
-		{
-			Way way = _osm.originalRoadWays.find(node.wayIds[i])->second;
-
-			// Make sure we have not visited this way in the past.
-			if (previousWayIDs.find(way.id) == previousWayIDs.end())
-			{
-				previousWayIDs.insert(way.id);
-
-				if (_osm.getNodeById(way.nodeIds.back()).wayIds.size() == 1 && _osm.getNodeById(way.nodeIds[0]).wayIds.size() == 1)
-				{
-					continue;
-				}
-
-				for (auto id : way.nodeIds)
-				{
-					glm::dvec2 coords = _osm.getNodeById(id).coords;
-
-					// Check the node is not outside the map boundary.
-					if (isOutOfBounds(coords) || isTooCloseToBoundary(coords))
-					{
-						if (tempCoords.size() > 0)
-						{
-							tempCoords.clear();
-						}
-
-						continue;
-					}
-
-					tempCoords.push_back(std::pair<uint64_t, glm::dvec2>(id, coords));
-
-					if (!nextJunctionFound)
-					{
-						// Find the next node that is an intersection.
-						for (uint32_t j = 0; j < _osm.original_intersections.size(); ++j)
-						{
-							if (id == _osm.original_intersections[j] && previousIntersectIDs.find(id) == previousIntersectIDs.end())
-							{
-								previousIntersectIDs.insert(id);
-								nextID = id;
-								nextJunctionFound = true;
-								break;
-							}
-						}
-					}
-
-					if (nextJunctionFound)
-					{
-						if (way.nodeIds[0] == nextID && way.nodeIds.back() == node.id && way.nodeIds.size() > 2)
-						{
-							glm::dvec2 p1 = _osm.getNodeById(node.id).coords;
-							glm::dvec2 p2 = _osm.getNodeById(way.nodeIds[0]).coords;
-							glm::dvec2 p3 = _osm.getNodeById(way.nodeIds[way.nodeIds.size() / 2]).coords;
-
-							float a1 = static_cast<float>(glm::atan(p1.y - p2.y, p1.x - p2.x));
-							float a2 = static_cast<float>(glm::atan(p1.y - p3.y, p1.x - p3.x));
-
-							if (glm::abs(a1 - a2) > 0.25f)
-							{
-								std::reverse(way.nodeIds.begin(), way.nodeIds.end());
-								tempCoords.clear();
-
-								for (uint32_t j = 0; j < way.nodeIds.size(); ++j)
-								{
-									tempCoords.push_back(std::pair<uint64_t, glm::dvec2>(way.nodeIds[j], _osm.getNodeById(way.nodeIds[j]).coords));
-								}
-							}
-						}
-						break;
-					}
-				}
-			}
-			// Add the found nodes to the route.
-			if (nextJunctionFound)
-			{
-				for (uint32_t j = 0; j < tempCoords.size(); ++j)
-				{
-					if (lastID == tempCoords[j].first)
-					{
-						continue;
-					}
-
-					RouteData data;
-					data.distanceToNext = 0.0f;
-					data.point = tempCoords[j].second;
-
-					_osm.route.push_back(data);
-				}
-
-				lastID = tempCoords.back().first;
-				tempCoords.clear();
-				break;
-			}
-			tempCoords.clear();
-		}
-
-		// If no junction was found end the route.
-		if (!nextJunctionFound)
-		{
-			break;
-		}
-
-		count++;
+		return pvr::Result::UnknownError;
 	}
+	return pvr::Result::Success;
 }
 
 /*!*********************************************************************************************************************
@@ -594,7 +333,7 @@ applied to the text based on the slope of the road segment i.e. the line between
 ***********************************************************************************************************************/
 void NavDataProcess::processLabels(const glm::dvec2& mapWorldDim)
 {
-	for (uint32_t lod = 0; lod <= LOD::Count; ++lod)
+	for (uint32_t lod = 0; lod < LOD::Count; ++lod)
 	{
 		auto& _osmlodlabels = _osm.labels[lod];
 		if (_osmlodlabels.size() == 0)
@@ -718,8 +457,8 @@ void createNewWayWithIntersection(OSM& _osm, Way& newLineStrip, Way& newTriStrip
 {
 	Vertex newNode0 = _osm.getNodeById(newTriStrip.nodeIds[0]); // Take copies to use for the new way
 	Vertex newNode1 = _osm.getNodeById(newTriStrip.nodeIds[1]);
-	newNode0.id = _osm.nodes.rbegin()->first + 1; // Generate new ids
-	newNode1.id = _osm.nodes.rbegin()->first + 2;
+	newNode0.id = _osm.nodes.getMaxId() + 1; // Generate new ids
+	newNode1.id = _osm.nodes.getMaxId() + 2;
 
 	_osm.insertOrOverwriteNode(std::move(newNode0)); // Add the new vertices
 	_osm.insertOrOverwriteNode(std::move(newNode1));
@@ -929,7 +668,7 @@ void processIntersection(OSM& _osm, uint64_t intersection_id)
 
 	// Sweep CCW to actually create the intersections:
 	Vertex tmpint = _osm.getNodeById(nonTriangulatedWays[0].nodeIds.front()); // Take (any) copy to use for the new intersection center
-	tmpint.id = _osm.nodes.rbegin()->first + 1; // Generate new ids
+	tmpint.id = _osm.nodes.getMaxId() + 1; // Generate new ids
 	tmpint.coords = centrePoint;
 	tmpint.texCoords = glm::vec2(TexUVCenter, TexUVUp);
 
@@ -1188,13 +927,31 @@ void NavDataProcess::calculateIntersections()
 	}
 }
 
+namespace {
+// How far, in map units (km), the simplified geometry of each level of detail may be from the full resolution geometry.
+// This is about a pixel at the scales that the 2D demo draws LOD::L3 and LOD::L4 at.
+const double GeometryLODTolerances[GeometryLOD::Count] = { 0.0, 0.0002, 0.0005 };
+
+// Convert a triangle strip into a triangle list, keeping the winding of the triangles consistent.
+void addStripTriangles(const std::vector<uint64_t>& strip, std::vector<std::array<uint64_t, 3> >& triangles)
+{
+	for (size_t i = 0; i + 2 < strip.size(); ++i)
+	{
+		triangles.push_back(i % 2 == 0 ? std::array<uint64_t, 3>{ strip[i], strip[i + 1], strip[i + 2] } : std::array<uint64_t, 3>{ strip[i + 1], strip[i], strip[i + 2] });
+	}
+}
+} // namespace
+
 /*!*********************************************************************************************************************
 \param  newRoads Reference to temporary data shared between TriangulateAllRoads, CalculateIntersections and ConvertToTriangleList.
-\brief  Convert triangles into an ordered triangle list.
+\brief  Convert triangles into an ordered triangle list. The roads and road areas are also simplified and triangulated for
+		every further level of detail. Intersections are not simplified, so the simplified roads still meet them.
 ***********************************************************************************************************************/
 void NavDataProcess::convertToTriangleList()
 {
 	std::vector<std::array<uint64_t, 3> > triangles;
+	std::vector<uint64_t> simplifiedIds;
+	std::vector<uint64_t> simplifiedStrips[GeometryLOD::Count - 1];
 	// Finally sort into triangle lists and get outlines ready for tiling
 	for (auto wayIterator = _osm.triangulatedRoads.begin(); wayIterator != _osm.triangulatedRoads.end(); ++wayIterator)
 	{
@@ -1214,11 +971,23 @@ void NavDataProcess::convertToTriangleList()
 			{
 				convertedRoad.triangulatedIds.push_back(triangles[i]);
 			}
+
+			for (uint32_t lod = GeometryLOD::L1; lod < GeometryLOD::Count; ++lod)
+			{
+				simplifyRing(wayIterator->second.nodeIds, GeometryLODTolerances[lod], simplifiedIds);
+				triangulate(simplifiedIds, convertedRoad.simplifiedTriangulatedIds[lod - 1]);
+			}
 		}
 		else
 		{
 			Way& way = _osm.originalRoadWays.find(wayIterator->first)->second;
 
+			// Simplify the road before the end caps are added, so that every level of detail gets the same end caps.
+			for (uint32_t lod = GeometryLOD::L1; lod < GeometryLOD::Count; ++lod)
+			{
+				simplifyRoadStrip(wayIterator->second.nodeIds, GeometryLODTolerances[lod], simplifiedStrips[lod - 1]);
+			}
+
 			// Calculate end caps for roads which are dead ends.
 			if (way.nodeIds.size() > 1)
 			{
@@ -1233,9 +1002,12 @@ void NavDataProcess::convertToTriangleList()
 					{
 						auto nodes = calculateEndCaps(n1, n2, wayIterator->second.width);
 
-						wayIterator->second.nodeIds.push_back(nodes[0]);
-						wayIterator->second.nodeIds.push_back(n2.id); // Need a repeated node to complete triangle list.
-						wayIterator->second.nodeIds.push_back(nodes[1]);
+						const uint64_t endCap[] = { nodes[0], n2.id, nodes[1] }; // Need a repeated node to complete triangle list.
+						wayIterator->second.nodeIds.insert(wayIterator->second.nodeIds.end(), endCap, endCap + 3);
+						for (auto& strip : simplifiedStrips)
+						{
+							strip.insert(strip.end(), endCap, endCap + 3);
+						}
 					}
 				}
 				// Start of road segment.
@@ -1249,66 +1021,83 @@ void NavDataProcess::convertToTriangleList()
 					{
 						auto nodes = calculateEndCaps(n1, n2, wayIterator->second.width);
 
-						wayIterator->second.nodeIds.insert(wayIterator->second.nodeIds.begin(), nodes[0]);
-						wayIterator->second.nodeIds.insert(wayIterator->second.nodeIds.begin(), n2.id); // Need a repeated node to complete triangle list.
-						wayIterator->second.nodeIds.insert(wayIterator->second.nodeIds.begin(), nodes[1]);
+						const uint64_t startCap[] = { nodes[1], n2.id, nodes[0] }; // Need a repeated node to complete triangle list.
+						wayIterator->second.nodeIds.insert(wayIterator->second.nodeIds.begin(), startCap, startCap + 3);
+						for (auto& strip : simplifiedStrips)
+						{
+							strip.insert(strip.begin(), startCap, startCap + 3);
+						}
 					}
 				}
 			}
 
-			for (uint32_t i = 0; i < (wayIterator->second.nodeIds.size() - 2); ++i)
+			addStripTriangles(wayIterator->second.nodeIds, convertedRoad.triangulatedIds);
+			for (uint32_t lod = GeometryLOD::L1; lod < GeometryLOD::Count; ++lod)
 			{
-				const Vertex& node0 = i % 2 == 0 ? _osm.getNodeById(wayIterator->second.nodeIds[i]) : _osm.getNodeById(wayIterator->second.nodeIds[i + 1]);
-				const Vertex& node1 = i % 2 == 0 ? _osm.getNodeById(wayIterator->second.nodeIds[i + 1]) : _osm.getNodeById(wayIterator->second.nodeIds[i]);
-				const Vertex& node2 = _osm.getNodeById(wayIterator->second.nodeIds[i + 2]);
-				convertedRoad.triangulatedIds.push_back(std::array<uint64_t, 3>{ node0.id, node1.id, node2.id });
+				addStripTriangles(simplifiedStrips[lod - 1], convertedRoad.simplifiedTriangulatedIds[lod - 1]);
 			}
 		}
 		_osm.convertedRoads[convertedRoad.id] = convertedRoad;
 	}
 }
 
+namespace {
+// A triangle to be clipped into the tiles, with the id that its pieces are inserted with, the index of the parameters of the way that it belongs to
+// and its level of detail.
+struct SourceTriangle
+{
+	std::array<uint64_t, 3> nodeIds;
+	uint64_t wayId;
+	uint32_t roadParamsIndex;
+	uint32_t geometryLod;
+};
+
+// A parking, building or inner way to triangulate again for the simplified levels of detail
+struct SourcePolygon
+{
+	const Way* way;
+	std::vector<const std::vector<uint64_t>*> holes;
+	uint32_t roadParamsIndex;
+};
+
+NavDataProcess::RoadParams createRoadParams(const Way& way, WayTypes::WayTypes wayType)
+{
+	NavDataProcess::RoadParams rp;
+	rp.wayType = wayType;
+	rp.wayTags = way.tags;
+	rp.area = way.area;
+	rp.roadType = way.roadType;
+	rp.width = way.width;
+	rp.isIntersection = way.isIntersection;
+	rp.isRoundabout = way.isRoundabout;
+	return rp;
+}
+
+// The number of source triangles that a thread clips at a time
+const uint32_t ClipBatchSize = 256;
+} // namespace
+
 /*!*********************************************************************************************************************
 \brief  Sort the ways into the tiles.
+\details The triangles of all the ways are gathered first, then they are clipped against the tiles in batches on all the
+		 threads and finally the pieces are inserted into their tiles, a tile per thread. The pieces are numbered in the
+		 order of the triangles that they were cut from, so the tiles do not depend on the number of threads.
 ***********************************************************************************************************************/
 void NavDataProcess::sortTiles()
 {
-	uint64_t id = 0;
+	std::vector<RoadParams> roadParams;
+	std::vector<SourceTriangle> sourceTriangles;
+	std::vector<SourcePolygon> sourcePolygons;
+
 	// Tile roads
+	uint64_t id = 0;
 	for (auto&& wayMapEntry : _osm.convertedRoads)
 	{
 		auto& way = wayMapEntry.second;
+		roadParams.push_back(createRoadParams(way, WayTypes::Road));
 		for (uint32_t i = 0; i < way.triangulatedIds.size(); ++i)
 		{
-			// pass all three of them in the fill tiles
-			// need a seaprate clippig function for roads only
-			const Vertex& vertex0 = _osm.getNodeById(way.triangulatedIds[i][0]);
-			const Vertex& vertex1 = _osm.getNodeById(way.triangulatedIds[i][1]);
-			const Vertex& vertex2 = _osm.getNodeById(way.triangulatedIds[i][2]);
-
-			clipRoad(vertex0, vertex1, vertex2, id, way.tags, WayTypes::Road, way.area, way.roadType, way.width, way.isIntersection, way.isRoundabout);
-			id++;
-		}
-	}
-
-	for (uint32_t lod = 0; lod < LOD::Count; ++lod)
-	{
-		// Labels
-		for (uint32_t i = 0; i < _osm.labels[lod].size(); ++i)
-		{
-			fillLabelTiles(_osm.labels[lod][i], lod);
-		}
-
-		// Icons
-		for (uint32_t i = 0; i < _osm.icons[lod].size(); ++i)
-		{
-			fillIconTiles(_osm.icons[lod][i], lod);
-		}
-
-		// Amenity Labels
-		for (uint32_t i = 0; i < _osm.amenityLabels[lod].size(); ++i)
-		{
-			fillAmenityTiles(_osm.amenityLabels[lod][i], lod);
+			sourceTriangles.push_back(SourceTriangle{ way.triangulatedIds[i], id++, static_cast<uint32_t>(roadParams.size() - 1), GeometryLOD::L0 });
 		}
 	}
 
@@ -1326,21 +1115,20 @@ void NavDataProcess::sortTiles()
 
 		if (way.inner)
 		{
-			innerWays.push_back(way);
+			if (_osm.holeWays.find(way.id) == _osm.holeWays.end()) // Holes are cut out of their outer way instead
+			{
+				innerWays.push_back(way);
+			}
 			continue;
 		}
 
-		triangulate(way.nodeIds, triangles);
+		triangulate(way.nodeIds, getHoles(way, _osm.parkingWays), triangles);
 
+		roadParams.push_back(createRoadParams(way, WayTypes::Parking));
+		sourcePolygons.push_back(SourcePolygon{ &way, getHoles(way, _osm.parkingWays), static_cast<uint32_t>(roadParams.size() - 1) });
 		for (uint32_t i = 0; i < triangles.size(); ++i)
 		{
-			const Vertex& vertex0 = _osm.getNodeById(triangles[i][0]);
-			const Vertex& vertex1 = _osm.getNodeById(triangles[i][1]);
-			const Vertex& vertex2 = _osm.getNodeById(triangles[i][2]);
-
-			clipRoad(vertex0, vertex1, vertex2, id, way.tags, WayTypes::Parking, way.area, way.roadType, way.width, way.isIntersection, way.isRoundabout);
-
-			id++;
+			sourceTriangles.push_back(SourceTriangle{ triangles[i], id++, static_cast<uint32_t>(roadParams.size() - 1), GeometryLOD::L0 });
 		}
 	}
 
@@ -1356,39 +1144,150 @@ void NavDataProcess::sortTiles()
 
 		if (way.inner)
 		{
-			innerWays.push_back(way);
+			if (_osm.holeWays.find(way.id) == _osm.holeWays.end()) // Holes are cut out of their outer way instead
+			{
+				innerWays.push_back(way);
+			}
 			continue;
 		}
 
-		triangulate(way.nodeIds, triangles);
+		triangulate(way.nodeIds, getHoles(way, _osm.buildWays), triangles);
 
+		roadParams.push_back(createRoadParams(way, WayTypes::Building));
+		sourcePolygons.push_back(SourcePolygon{ &way, getHoles(way, _osm.buildWays), static_cast<uint32_t>(roadParams.size() - 1) });
 		for (uint32_t i = 0; i < triangles.size(); ++i)
 		{
-			Vertex vertex0 = _osm.getNodeById(triangles[i][0]);
-			Vertex vertex1 = _osm.getNodeById(triangles[i][1]);
-			Vertex vertex2 = _osm.getNodeById(triangles[i][2]);
-
-			clipRoad(vertex0, vertex1, vertex2, id, way.tags, WayTypes::Building, way.area, way.roadType, way.width, way.isIntersection, way.isRoundabout);
-			id++;
+			sourceTriangles.push_back(SourceTriangle{ triangles[i], id++, static_cast<uint32_t>(roadParams.size() - 1), GeometryLOD::L0 });
 		}
 	}
 
 	// Tile inner ways
 	id = 0;
-	for (auto way : innerWays)
+	for (auto& way : innerWays)
 	{
 		triangulate(way.nodeIds, triangles);
 
+		roadParams.push_back(createRoadParams(way, WayTypes::Inner));
+		sourcePolygons.push_back(SourcePolygon{ &way, std::vector<const std::vector<uint64_t>*>(), static_cast<uint32_t>(roadParams.size() - 1) });
 		for (uint32_t i = 0; i < triangles.size(); ++i)
 		{
-			Vertex vertex0 = _osm.getNodeById(triangles[i][0]);
-			Vertex vertex1 = _osm.getNodeById(triangles[i][1]);
-			Vertex vertex2 = _osm.getNodeById(triangles[i][2]);
+			sourceTriangles.push_back(SourceTriangle{ triangles[i], id++, static_cast<uint32_t>(roadParams.size() - 1), GeometryLOD::L0 });
+		}
+	}
 
-			clipRoad(vertex0, vertex1, vertex2, id, way.tags, WayTypes::Inner, way.area, way.roadType, way.width, way.isIntersection, way.isRoundabout);
-			id++;
+	// The simplified levels of detail come after the full resolution geometry, so that the full resolution tiles are the same
+	// with or without them. Intersections are kept at full resolution, as the simplified roads still end on their outlines.
+	std::vector<uint64_t> outline;
+	std::vector<std::vector<uint64_t> > holes;
+	std::vector<const std::vector<uint64_t>*> holePointers;
+	for (uint32_t lod = GeometryLOD::L1; lod < GeometryLOD::Count; ++lod)
+	{
+		id = 0;
+		uint32_t roadParamsIndex = 0;
+		for (auto&& wayMapEntry : _osm.convertedRoads)
+		{
+			const ConvertedWay& way = wayMapEntry.second;
+			const auto& wayTriangles = way.isIntersection ? way.triangulatedIds : way.simplifiedTriangulatedIds[lod - 1];
+			for (uint32_t i = 0; i < wayTriangles.size(); ++i)
+			{
+				sourceTriangles.push_back(SourceTriangle{ wayTriangles[i], id++, roadParamsIndex, lod });
+			}
+			++roadParamsIndex;
+		}
+
+		for (const SourcePolygon& polygon : sourcePolygons)
+		{
+			simplifyRing(polygon.way->nodeIds, GeometryLODTolerances[lod], outline);
+			holes.resize(polygon.holes.size());
+			holePointers.clear();
+			for (size_t i = 0; i < polygon.holes.size(); ++i)
+			{
+				simplifyRing(*polygon.holes[i], GeometryLODTolerances[lod], holes[i]);
+				holePointers.push_back(&holes[i]);
+			}
+			triangulate(outline, holePointers, triangles);
+			for (uint32_t i = 0; i < triangles.size(); ++i)
+			{
+				sourceTriangles.push_back(SourceTriangle{ triangles[i], id++, polygon.roadParamsIndex, lod });
+			}
 		}
 	}
+
+	// Clip the triangles against the tiles. Each batch of triangles has its own output, so no locking is needed.
+	const uint32_t numBatches = static_cast<uint32_t>((sourceTriangles.size() + ClipBatchSize - 1) / ClipBatchSize);
+	std::vector<std::vector<ClippedTriangle> > clippedBatches(numBatches);
+	const OSM& osm = _osm;
+	parallelFor(numBatches, [&](uint32_t batch) {
+		const uint32_t end = std::min(static_cast<uint32_t>(sourceTriangles.size()), (batch + 1) * ClipBatchSize);
+		for (uint32_t i = batch * ClipBatchSize; i < end; ++i)
+		{
+			const std::array<uint64_t, 3>& nodeIds = sourceTriangles[i].nodeIds;
+			clipRoad(osm.getNodeById(nodeIds[0]), osm.getNodeById(nodeIds[1]), osm.getNodeById(nodeIds[2]), i, clippedBatches[batch]);
+		}
+	});
+
+	// Bin the pieces into their tiles, numbering their nodes in order from the first free node id.
+	std::vector<std::vector<std::pair<const ClippedTriangle*, uint64_t> > > tileTriangles(_osm.numCols * _osm.numRows);
+	uint64_t nodeId = _osm.nodes.getMaxId() + 1;
+	for (const auto& batch : clippedBatches)
+	{
+		for (const ClippedTriangle& triangle : batch)
+		{
+			tileTriangles[triangle.tileCoords.x * _osm.numRows + triangle.tileCoords.y].push_back(std::make_pair(&triangle, nodeId));
+			nodeId += 3;
+		}
+	}
+
+	// Insert the pieces into the tiles. Each tile is only written by one thread.
+	parallelFor(static_cast<uint32_t>(tileTriangles.size()), [&](uint32_t tileIndex) {
+		const glm::uvec2 tileCoords(tileIndex / _osm.numRows, tileIndex % _osm.numRows);
+		Tile& tile = _osm.getTile(tileCoords);
+		for (const auto& entry : tileTriangles[tileIndex])
+		{
+			const ClippedTriangle& triangle = *entry.first;
+			const SourceTriangle& source = sourceTriangles[triangle.sourceIndex];
+			const RoadParams& rp = roadParams[source.roadParamsIndex];
+
+			Way newWay;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				const uint64_t newNodeId = entry.second + i;
+				auto& tmp = tile.nodes[newNodeId] = triangle.vertices[i];
+				tmp.id = newNodeId;
+				newWay.nodeIds.push_back(newNodeId);
+			}
+
+			newWay.id = source.wayId;
+			newWay.tags = rp.wayTags;
+			newWay.roadType = rp.roadType;
+			newWay.area = rp.area;
+			newWay.width = rp.width;
+			newWay.isIntersection = rp.isIntersection;
+			newWay.isRoundabout = rp.isRoundabout;
+			insert(tileCoords, rp.wayType, &newWay, entry.second + 3, source.geometryLod);
+		}
+	});
+
+	// Labels, icons and amenity labels of each level of detail go into their own arrays, so the levels are filled concurrently.
+	parallelFor(LOD::Count, [&](uint32_t lod) {
+		// Labels
+		for (uint32_t i = 0; i < _osm.labels[lod].size(); ++i)
+		{
+			fillLabelTiles(_osm.labels[lod][i], lod);
+		}
+
+		// Icons
+		for (uint32_t i = 0; i < _osm.icons[lod].size(); ++i)
+		{
+			fillIconTiles(_osm.icons[lod][i], lod);
+		}
+
+		// Amenity Labels
+		for (uint32_t i = 0; i < _osm.amenityLabels[lod].size(); ++i)
+		{
+			fillAmenityTiles(_osm.amenityLabels[lod][i], lod);
+		}
+	});
 }
 
 /*!*********************************************************************************************************************
@@ -1497,7 +1396,7 @@ std::vector<uint64_t> NavDataProcess::tessellate(const std::vector<uint64_t>& ol
 				}
 				else // Create a new node
 				{
-					newNode.id = _osm.nodes.rbegin()->first + 1;
+					newNode.id = _osm.nodes.getMaxId() + 1;
 				}
 
 				newNode.coords = lastPointOnCurve = newCoords;
@@ -1526,7 +1425,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 
 	if (nodeIds.size() == 2)
 	{
-		uint64_t id = _osm.nodes.rbegin()->first + 1;
+		uint64_t id = _osm.nodes.getMaxId() + 1;
 		const Vertex& node0 = _osm.getNodeById(nodeIds[0]);
 		const Vertex& node1 = _osm.getNodeById(nodeIds[1]);
 
@@ -1554,7 +1453,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 	{
 		{
 			// Add first item
-			uint64_t id = _osm.nodes.rbegin()->first + 1;
+			uint64_t id = _osm.nodes.getMaxId() + 1;
 			std::array<glm::dvec2, 2> firstPerps = findPerpendicularPoints(_osm.getNodeById(nodeIds[0]).coords, _osm.getNodeById(nodeIds[1]).coords, width, 1);
 			Vertex newNode0(id, firstPerps[0], false, glm::vec2(TexUVLeft, TexUVUp));
 			Vertex newNode1(++id, firstPerps[1], false, glm::vec2(TexUVRight, TexUVUp));
@@ -1566,7 +1465,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 
 		for (uint32_t i = 1; i < (nodeIds.size() - 1); ++i)
 		{
-			uint64_t id = _osm.nodes.rbegin()->first + 1;
+			uint64_t id = _osm.nodes.getMaxId() + 1;
 			const Vertex& node0 = _osm.getNodeById(nodeIds[i - 1]);
 			const Vertex& node1 = _osm.getNodeById(nodeIds[i]);
 			const Vertex& node2 = _osm.getNodeById(nodeIds[i + 1]);
@@ -1586,7 +1485,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 
 		{
 			// Add last item
-			uint64_t id = _osm.nodes.rbegin()->first + 1;
+			uint64_t id = _osm.nodes.getMaxId() + 1;
 			std::array<glm::dvec2, 2> thirdPerps;
 			thirdPerps = findPerpendicularPoints(_osm.getNodeById(*(nodeIds.end() - 2)).coords, _osm.getNodeById(*(nodeIds.end() - 1)).coords, width, 2);
 
@@ -1631,13 +1530,13 @@ std::array<uint64_t, 2> NavDataProcess::calculateEndCaps(Vertex& first, Vertex&
 	// Setup new nodes used for end cap.
 	newNode1.coords -= v1;
 	newNode1.texCoords.y = 4 * TexUVUp;
-	newNode1.id = _osm.nodes.rbegin()->first + 1;
+	newNode1.id = _osm.nodes.getMaxId() + 1;
 	_osm.insertOrOverwriteNode(std::move(newNode1));
 	debug_assertion(newNode1.texCoords.x != -10000.f && newNode1.texCoords.y != -10000.f, "TexCoord DEFAULT");
 
 	newNode2.coords -= v1;
 	newNode2.texCoords.y = 4 * TexUVUp;
-	newNode2.id = _osm.nodes.rbegin()->first + 1;
+	newNode2.id = _osm.nodes.getMaxId() + 1;
 	_osm.insertOrOverwriteNode(std::move(newNode2));
 	debug_assertion(newNode2.texCoords.x != -10000.f && newNode2.texCoords.y != -10000.f, "TexCoord DEFAULT");
 
@@ -1710,7 +1609,7 @@ inline void debug_assert_vertices_less_than(const Vertex& vertex0, const Vertex&
 }
 
 void NavDataProcess::clipAgainst(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, glm::vec2 planeOrigin, const glm::vec2& planeNorm, Vertex* triFront,
-	Vertex* triBack, uint32_t& numTriFront, uint32_t& numTriBack)
+	Vertex* triBack, uint32_t& numTriFront, uint32_t& numTriBack) const
 {
 	numTriFront = 0, numTriBack = 0;
 	glm::vec2 vec0to1 = (glm::vec2)glm::normalize(vertex1.coords - vertex0.coords);
@@ -1848,7 +1747,7 @@ void NavDataProcess::clipAgainst(const Vertex& vertex0, const Vertex& vertex1, c
 }
 
 void NavDataProcess::recurseClipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, const glm::uvec2& minTileIndex, const glm::uvec2& maxTileIndex,
-	const RoadParams& roadParams, bool isPlaneVertical)
+	uint32_t sourceIndex, bool isPlaneVertical, std::vector<ClippedTriangle>& clippedTriangles) const
 {
 	// return if the triangle is degenerate
 	if (((glm::abs(vertex0.coords.x - vertex1.coords.x) < epsilon) && (glm::abs(vertex0.coords.y - vertex1.coords.y) < epsilon)) ||
@@ -1890,7 +1789,7 @@ void NavDataProcess::recurseClipRoad(const Vertex& vertex0, const Vertex& vertex
 		{
 			maxCoords.x = maxTileIndex.x;
 		}
-		clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], minTileIndex, maxCoords, roadParams);
+		clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], minTileIndex, maxCoords, sourceIndex, clippedTriangles);
 	}
 	if (numFrontTriangles > 1) // CLIPS THE SECOND FRONT TRIANGLE IF IT EXISTS
 							   // The triangle was clipped, and the "quad" part of it was in front (so two triangles are in front)
@@ -1908,7 +1807,7 @@ void NavDataProcess::recurseClipRoad(const Vertex& vertex0, const Vertex& vertex
 			maxCoords.x = maxTileIndex.x;
 		}
 
-		clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], minTileIndex, maxCoords, roadParams);
+		clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], minTileIndex, maxCoords, sourceIndex, clippedTriangles);
 	}
 	if (numBackTriangles > 0) // CLIPS THE FIRST BACK TRIANGLE IF IT EXISTS
 							  // Reverse of the 1st comment: whole triangle back, or was clipped. If false, whole tri front.
@@ -1926,7 +1825,7 @@ void NavDataProcess::recurseClipRoad(const Vertex& vertex0, const Vertex& vertex
 			minCoords.x = minTileIndex.x;
 		}
 
-		clipRoad(backVertex[0], backVertex[1], backVertex[2], minCoords, maxTileIndex, roadParams);
+		clipRoad(backVertex[0], backVertex[1], backVertex[2], minCoords, maxTileIndex, sourceIndex, clippedTriangles);
 	}
 	// Reverse of the 2st comment: Clipped, and quad was "back". If false, not clipped or tri back.
 	if (numBackTriangles > 1) // CLIPS THE SECOND BACK TRIANGLE IF IT EXISTS
@@ -1943,12 +1842,12 @@ void NavDataProcess::recurseClipRoad(const Vertex& vertex0, const Vertex& vertex
 			minCoords.y += 1;
 			minCoords.x = minTileIndex.x;
 		}
-		clipRoad(backVertex[3], backVertex[4], backVertex[5], minCoords, maxTileIndex, roadParams);
+		clipRoad(backVertex[3], backVertex[4], backVertex[5], minCoords, maxTileIndex, sourceIndex, clippedTriangles);
 	}
 }
 
-void NavDataProcess::clipRoad(
-	const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, const glm::uvec2& minTileIndex, const glm::uvec2& maxTileIndex, const RoadParams& roadParams)
+void NavDataProcess::clipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, const glm::uvec2& minTileIndex, const glm::uvec2& maxTileIndex,
+	uint32_t sourceIndex, std::vector<ClippedTriangle>& clippedTriangles) const
 {
 	if (((glm::abs(vertex0.coords.x - vertex1.coords.x) < epsilon) && (glm::abs(vertex0.coords.y - vertex1.coords.y) < epsilon)) ||
 		((glm::abs(vertex0.coords.x - vertex2.coords.x) < epsilon) && (glm::abs(vertex0.coords.y - vertex2.coords.y) < epsilon)) ||
@@ -1961,60 +1860,34 @@ void NavDataProcess::clipRoad(
 	{
 		if (minTileIndex.y == maxTileIndex.y) // We are in a single tile, so by definition there must be no more clipping : the triangle is completly inside a tile.
 		{
-			const auto& min = _osm.getTile(minTileIndex).min;
-			const auto& max = _osm.getTile(maxTileIndex).max;
+			const auto& min = _osm.tiles[minTileIndex.x][minTileIndex.y].min;
+			const auto& max = _osm.tiles[maxTileIndex.x][maxTileIndex.y].max;
 			assertion(vertex0.coords.x < max.x + epsilon && vertex0.coords.x > min.x - epsilon && vertex0.coords.y < max.y + epsilon && vertex0.coords.y > min.y - epsilon &&
 					vertex1.coords.x < max.x + epsilon && vertex1.coords.x > min.x - epsilon && vertex1.coords.y < max.y + epsilon && vertex1.coords.y > min.y - epsilon &&
 					vertex2.coords.x < max.x + epsilon && vertex2.coords.x > min.x - epsilon && vertex2.coords.y < max.y + epsilon && vertex2.coords.y > min.y - epsilon,
 				"vertices found outside tile boundaries");
 
-			// add the triangle into the tile
-			Way newWay;
-
-			uint64_t nodeId = (_osm.nodes.rbegin()->first + 1);
-			Tile& tile = _osm.tiles[minTileIndex.x][minTileIndex.y];
-			{
-				auto& tmp = tile.nodes[nodeId] = vertex0;
-				tmp.id = nodeId;
-				newWay.nodeIds.push_back(nodeId);
-				_osm.nodes[nodeId++] = vertex0;
-			}
-			{
-				auto& tmp = tile.nodes[nodeId] = vertex1;
-				tmp.id = nodeId;
-				newWay.nodeIds.push_back(nodeId);
-				_osm.nodes[nodeId++] = vertex1;
-			}
-			{
-				auto& tmp = tile.nodes[nodeId] = vertex2;
-				tmp.id = nodeId;
-				newWay.nodeIds.push_back(nodeId);
-				_osm.nodes[nodeId++] = vertex2;
-			}
-
-			newWay.id = roadParams.wayId;
-			newWay.tags = roadParams.wayTags;
-			newWay.roadType = roadParams.roadType;
-			newWay.area = roadParams.area;
-			newWay.width = roadParams.width;
-			newWay.isIntersection = roadParams.isIntersection;
-			newWay.isRoundabout = roadParams.isRoundabout;
-			// Add new node ID to way
-			insert(minTileIndex, roadParams.wayType, &newWay, nodeId);
+			// Output the triangle for its tile. Node ids are assigned when the pieces are inserted into the tiles.
+			clippedTriangles.emplace_back();
+			ClippedTriangle& triangle = clippedTriangles.back();
+			triangle.tileCoords = minTileIndex;
+			triangle.sourceIndex = sourceIndex;
+			triangle.vertices[0] = vertex0;
+			triangle.vertices[1] = vertex1;
+			triangle.vertices[2] = vertex2;
 		}
 		else // tileMin.y != tileMax.y : clip a single tile, and the rest of the row, from the column
 		{
-			recurseClipRoad(vertex0, vertex1, vertex2, minTileIndex, maxTileIndex, roadParams, false);
+			recurseClipRoad(vertex0, vertex1, vertex2, minTileIndex, maxTileIndex, sourceIndex, false, clippedTriangles);
 		}
 	}
 	else // tileMin.x != tileMax.x : Clip a column, and the rest of the field, from the grid
 	{
-		recurseClipRoad(vertex0, vertex1, vertex2, minTileIndex, maxTileIndex, roadParams, true);
+		recurseClipRoad(vertex0, vertex1, vertex2, minTileIndex, maxTileIndex, sourceIndex, true, clippedTriangles);
 	}
 }
 
-void NavDataProcess::clipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, uint64_t wayId, const std::vector<Tag>& wayTags, WayTypes::WayTypes wayType,
-	bool area, RoadTypes::RoadTypes roadType, double roadWidth, bool isIntersection, bool isRoundabout)
+void NavDataProcess::clipRoad(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2, uint32_t sourceIndex, std::vector<ClippedTriangle>& clippedTriangles) const
 {
 	if (((glm::abs(vertex0.coords.x - vertex1.coords.x) < epsilon) && (glm::abs(vertex0.coords.y - vertex1.coords.y) < epsilon)) ||
 		((glm::abs(vertex0.coords.x - vertex2.coords.x) < epsilon) && (glm::abs(vertex0.coords.y - vertex2.coords.y) < epsilon)) ||
@@ -2029,16 +1902,6 @@ void NavDataProcess::clipRoad(const Vertex& vertex0, const Vertex& vertex1, cons
 	glm::uvec2 minTileIndex = glm::max(glm::min(tile0, glm::min(tile1, tile2)), glm::ivec2(0, 0));
 	glm::uvec2 maxTileIndex = glm::min(glm::max(tile0, glm::max(tile1, tile2)), glm::ivec2(_osm.numCols - 1, _osm.numRows - 1));
 
-	RoadParams rp;
-	rp.wayType = wayType;
-	rp.wayId = wayId;
-	rp.wayTags = wayTags;
-	rp.area = area;
-	rp.roadType = roadType;
-	rp.width = roadWidth;
-	rp.isIntersection = isIntersection;
-	rp.isRoundabout = isRoundabout;
-
 	if (vertex0.coords.x < (_osm.bounds.min.x - epsilon) || vertex1.coords.x < (_osm.bounds.min.x - epsilon) || vertex2.coords.x < (_osm.bounds.min.x - epsilon))
 	{
 		Vertex frontVertex[6];
@@ -2050,11 +1913,11 @@ void NavDataProcess::clipRoad(const Vertex& vertex0, const Vertex& vertex1, cons
 		// Careful of the tile bounds: by using the same x in min and max, we are slicing off a column...
 		if (numFrontTriangles > 0)
 		{
-			clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], wayId, wayTags, wayType, area, roadType, roadWidth, isIntersection, isRoundabout);
+			clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], sourceIndex, clippedTriangles);
 		}
 		if (numFrontTriangles > 1)
 		{
-			clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], wayId, wayTags, wayType, area, roadType, roadWidth, isIntersection, isRoundabout);
+			clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], sourceIndex, clippedTriangles);
 		}
 	}
 	else if (vertex0.coords.x > (_osm.bounds.max.x + epsilon) || vertex1.coords.x > (_osm.bounds.max.x + epsilon) || vertex2.coords.x > (_osm.bounds.max.x + epsilon))
@@ -2068,11 +1931,11 @@ void NavDataProcess::clipRoad(const Vertex& vertex0, const Vertex& vertex1, cons
 		// Careful of the tile bounds: by using the same x in min and max, we are slicing off a column...
 		if (numFrontTriangles > 0)
 		{
-			clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], wayId, wayTags, wayType, area, roadType, roadWidth, isIntersection, isRoundabout);
+			clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], sourceIndex, clippedTriangles);
 		}
 		if (numFrontTriangles > 1)
 		{
-			clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], wayId, wayTags, wayType, area, roadType, roadWidth, isIntersection, isRoundabout);
+			clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], sourceIndex, clippedTriangles);
 		}
 	}
 	else if (vertex0.coords.y < (_osm.bounds.min.y - epsilon) || vertex1.coords.y < (_osm.bounds.min.y - epsilon) || vertex2.coords.y < (_osm.bounds.min.y - epsilon))
@@ -2086,11 +1949,11 @@ void NavDataProcess::clipRoad(const Vertex& vertex0, const Vertex& vertex1, cons
 		// Careful of the tile bounds: by using the same x in min and max, we are slicing off a column...
 		if (numFrontTriangles > 0)
 		{
-			clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], wayId, wayTags, wayType, area, roadType, roadWidth, isIntersection, isRoundabout);
+			clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], sourceIndex, clippedTriangles);
 		}
 		if (numFrontTriangles > 1)
 		{
-			clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], wayId, wayTags, wayType, area, roadType, roadWidth, isIntersection, isRoundabout);
+			clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], sourceIndex, clippedTriangles);
 		}
 	}
 	else if (vertex0.coords.y > (_osm.bounds.max.y + epsilon) || vertex1.coords.y > (_osm.bounds.max.y + epsilon) || vertex2.coords.y > (_osm.bounds.max.y + epsilon))
@@ -2104,16 +1967,16 @@ void NavDataProcess::clipRoad(const Vertex& vertex0, const Vertex& vertex1, cons
 		// Careful of the tile bounds: by using the same x in min and max, we are slicing off a column...
 		if (numFrontTriangles > 0)
 		{
-			clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], wayId, wayTags, wayType, area, roadType, roadWidth, isIntersection, isRoundabout);
+			clipRoad(frontVertex[0], frontVertex[1], frontVertex[2], sourceIndex, clippedTriangles);
 		}
 		if (numFrontTriangles > 1)
 		{
-			clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], wayId, wayTags, wayType, area, roadType, roadWidth, isIntersection, isRoundabout);
+			clipRoad(frontVertex[3], frontVertex[4], frontVertex[5], sourceIndex, clippedTriangles);
 		}
 	}
 	else
 	{
-		clipRoad(vertex0, vertex1, vertex2, minTileIndex, maxTileIndex, rp);
+		clipRoad(vertex0, vertex1, vertex2, minTileIndex, maxTileIndex, sourceIndex, clippedTriangles);
 	}
 }
 
@@ -2143,6 +2006,16 @@ bool NavDataProcess::isTooCloseToBoundary(const glm::dvec2& point) const
 		(point.y + boundaryBufferY > _osm.bounds.max.y));
 }
 
+/*!*********************************************************************************************************************
+eturn Return true if the route must not pass through the point.
+\param  point The point to test.
+rief  The 2D route keeps clear of the edges of the map as well as of everything outside of it.
+***********************************************************************************************************************/
+bool NavDataProcess::isExcludedFromRoute(const glm::dvec2& point) const
+{
+	return isOutOfBounds(point) || isTooCloseToBoundary(point);
+}
+
 /*!*********************************************************************************************************************
 \return Return a vector with the tile coordinates.
 \param  point Find the tile that this point belongs to.
@@ -2150,32 +2023,16 @@ bool NavDataProcess::isTooCloseToBoundary(const glm::dvec2& point) const
 ***********************************************************************************************************************/
 glm::ivec2 NavDataProcess::findTile2(glm::dvec2& point) const
 {
-	glm::uvec2 tileCoords;
+	const glm::uvec2 tileCoords = _tileGrid.findCell(point);
 
-	for (uint32_t i = 0; i < _osm.numCols; ++i)
+	// Move node off of tile border
+	if ((point.x == _osm.tiles[tileCoords.x][0].max.x) && (tileCoords.x != (_osm.numCols - 1)))
 	{
-		if (point.x <= _osm.tiles[i][0].max.x)
-		{
-			if ((point.x == _osm.tiles[i][0].max.x) && (i != (_osm.numCols - 1)))
-			{
-				point.x -= 0.0000001;
-			} // Move node off of tile border
-			tileCoords.x = i;
-			break;
-		}
+		point.x -= 0.0000001;
 	}
-
-	for (uint32_t i = 0; i < _osm.numRows; ++i)
+	if ((point.y == _osm.tiles[0][tileCoords.y].max.y) && (tileCoords.y != (_osm.numRows - 1)))
 	{
-		if (point.y <= _osm.tiles[0][i].max.y)
-		{
-			if ((point.y == _osm.tiles[0][i].max.y) && (i != (_osm.numRows - 1)))
-			{
-				point.y -= 0.0000001;
-			} // Move node off of tile border
-			tileCoords.y = i;
-			break;
-		}
+		point.y -= 0.0000001;
 	}
 	return tileCoords;
 }
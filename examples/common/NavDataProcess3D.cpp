@@ -1,16 +1,24 @@
 #include "NavDataProcess.h"
-#include "../../external/pugixml/pugixml.hpp"
 
 /*!*********************************************************************************************************************
+\param	processedDataPath The path of the processed map file to load or to write. Optional.
 \return	Return pvr::Result::Success if no error occurred
-\brief	Initialisation of data, calls functions to load data from XML file and triangulate geometry.
+\brief	Initialisation of data, calls functions to load data from XML file and triangulate geometry, or to load
+		the processed map if it was written for the same data by a previous run.
 ***********************************************************************************************************************/
-pvr::Result NavDataProcess::loadAndProcessData()
+pvr::Result NavDataProcess::loadAndProcessData(const std::string& processedDataPath)
 {
 	// Set tile scaling parameters
 	_osm.lonTileScale = 0.0015;
 	_osm.latTileScale = 0.0015;
 
+	_processedDataPath = processedDataPath;
+	_isProcessedDataLoaded = loadProcessedData();
+	if (_isProcessedDataLoaded)
+	{
+		return pvr::Result::Success;
+	}
+
 	pvr::Result result = loadOSMData();
 
 	if (result != pvr::Result::Success)
@@ -35,29 +43,35 @@ This function fills the tiles with data which has been processed.
 ***********************************************************************************************************************/
 void NavDataProcess::initTiles()
 {
-	sortTiles();
-
-	for (auto& tileCol : _osm.tiles)
+	if (!_isProcessedDataLoaded) // Otherwise the tiles were loaded fully initialised
 	{
-		for (auto& tile : tileCol)
+		sortTiles();
+		logTriangulationStatistics();
+
+		for (auto& tileCol : _osm.tiles)
 		{
-			addCornerPoints(tile, tile.areaWays);
-			addCornerPoints(tile, tile.buildWays);
-			addCornerPoints(tile, tile.innerWays);
-			addCornerPoints(tile, tile.parkingWays);
-			addCornerPoints(tile, tile.roadWays);
+			for (auto& tile : tileCol)
+			{
+				addCornerPoints(tile, tile.areaWays);
+				addCornerPoints(tile, tile.buildWays);
+				addCornerPoints(tile, tile.innerWays);
+				addCornerPoints(tile, tile.parkingWays);
+				addCornerPoints(tile, tile.roadWays);
+			}
 		}
-	}
 
-	calculateMapBoundaryTexCoords();
-	calculateJunctionTexCoords();
+		calculateMapBoundaryTexCoords();
+		calculateJunctionTexCoords();
 
-	cleanData();
+		cleanData();
+		saveProcessedData();
+	}
 }
 
 /*!*********************************************************************************************************************
 \return Return Result::Success if no error occurred
-\brief  Get map data and load into OSM object.
+\brief  Get map data and load into OSM object. The map is streamed in a single pass: every node, way and relation is added
+		to the OSM object as soon as it has been read, so the memory used by the parse does not depend on the size of the map.
 ***********************************************************************************************************************/
 pvr::Result NavDataProcess::loadOSMData()
 {
@@ -65,124 +79,105 @@ pvr::Result NavDataProcess::loadOSMData()
 	// Enable memory-leak reports
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
-	pugi::xml_document mapData;
-	std::vector<char> mapStream = _assetStream->readToEnd<char>();
-	pugi::xml_parse_result result = mapData.load_string(mapStream.data(), static_cast<uint32_t>(mapStream.size()));
-
-	Log(LogLevel::Debug, "XML parse result: %s", result.description());
-	if (!result)
-	{
-		return pvr::Result::UnknownError;
-	}
+	OSMStreamReader reader;
 
-	// Get the bounds of the map
-	_osm.maxLonLat =
-		glm::vec2(mapData.root().child("osm").child("bounds").attribute("maxlon").as_double(), mapData.root().child("osm").child("bounds").attribute("maxlat").as_double());
-	_osm.minLonLat =
-		glm::vec2(mapData.root().child("osm").child("bounds").attribute("minlon").as_double(), mapData.root().child("osm").child("bounds").attribute("minlat").as_double());
-	_osm.bounds.min = glm::dvec2(0, 0);
-	_osm.bounds.max = lonLatToMetres(_osm.minLonLat, _osm.maxLonLat);
+	// Get the bounds of the map. OSM files list the bounds first, then the nodes, then the ways, then the relations.
+	reader.setBoundsCallback([this](const glm::dvec2& minLonLat, const glm::dvec2& maxLonLat) {
+		_osm.minLonLat = glm::vec2(minLonLat);
+		_osm.maxLonLat = glm::vec2(maxLonLat);
+		_osm.bounds.min = glm::dvec2(0, 0);
+		_osm.bounds.max = lonLatToMetres(_osm.minLonLat, _osm.maxLonLat);
+	});
 
 	// Collect the nodes
-	pugi::xml_object_range<pugi::xml_named_node_iterator> nodes = mapData.root().child("osm").children("node");
-
-	for (pugi::xml_named_node_iterator currentNode = nodes.begin(); currentNode != nodes.end(); ++currentNode)
-	{
-		if (!currentNode->attribute("visible").empty() && !currentNode->attribute("visible").as_bool()) // Skip node if not visible
-			continue;
-
-		Vertex tempNode;
+	reader.setNodeCallback([this](uint64_t nodeId, const glm::dvec2& coords, const Tag* tags, size_t numTags) {
+		Vertex& tempNode = _osm.createNode(nodeId);
 		tempNode.height = 0.0;
-		glm::dvec2 coords;
-
-		// Get ID, latitude and longitude
-		tempNode.id = currentNode->attribute("id").as_ullong();
-		coords = glm::dvec2(currentNode->attribute("lon").as_double(), currentNode->attribute("lat").as_double());
 		tempNode.coords = lonLatToMetres(_osm.minLonLat, coords);
 
 		if (coords.x < _osm.minLonLat.x)
+		{
 			tempNode.coords.x *= -1;
+		}
 		if (coords.y < _osm.minLonLat.y)
-			tempNode.coords.y *= -1;
-
-		// Get tags from XML.
-		pugi::xml_object_range<pugi::xml_named_node_iterator> tags = currentNode->children("tag");
-		std::vector<Tag> tempTags;
-
-		// Collect tags for this node.
-		for (pugi::xml_named_node_iterator currentTag = tags.begin(); currentTag != tags.end(); ++currentTag)
 		{
-			Tag tempTag;
-			tempTag.key = currentTag->attribute("k").as_string();
-			tempTag.value = currentTag->attribute("v").as_string();
-			tempTags.push_back(tempTag);
+			tempNode.coords.y *= -1;
 		}
 
-		_osm.nodes[tempNode.id] = tempNode;
-		generateIcon(&tempNode.id, 1, tempTags.data(), tempTags.size(), tempNode.id);
-	}
-
-	if (_osm.nodes.empty())
-		return pvr::Result::UnknownError;
+		generateIcon(&tempNode.id, 1, tags, numTags, tempNode.id);
+	});
 
 	// Collect the ways
-	pugi::xml_object_range<pugi::xml_named_node_iterator> ways = mapData.root().child("osm").children("way");
-
-	for (pugi::xml_named_node_iterator currentWay = ways.begin(); currentWay != ways.end(); ++currentWay)
-	{
-		if (!currentWay->attribute("visible").empty() && !currentWay->attribute("visible").as_bool()) // Skip way if not visible
-			continue;
+	reader.setWayCallback([this](uint64_t tempWayId, const uint64_t* nodeIds, size_t numNodeIds, const Tag* tags, size_t numTags) {
+		bool isArea = false;
 
-		Way tempWay;
+		Way* tempWay = NULL;
 		WayTypes::WayTypes wayType = WayTypes::Default;
-		tempWay.inner = false;
-		tempWay.tileBoundWay = false;
-		tempWay.area = false;
-		tempWay.isFork = false;
-		tempWay.isIntersection = false;
-		tempWay.isRoundabout = false;
-		tempWay.width = 0.0;
-
-		// Get ID
-		tempWay.id = currentWay->attribute("id").as_ullong();
-
-		// Get tags
-		pugi::xml_object_range<pugi::xml_named_node_iterator> tags = currentWay->children("tag");
 
-		for (pugi::xml_named_node_iterator currentTag = tags.begin(); currentTag != tags.end(); ++currentTag)
+		for (size_t i = 0; i < numTags; ++i)
 		{
-			Tag tempTag;
+			const char* key = tags[i].key.c_str();
+			const char* value = tags[i].value.c_str();
 
-			tempTag.key = currentTag->attribute("k").as_string();
-			tempTag.value = currentTag->attribute("v").as_string();
-			tempWay.tags.push_back(tempTag);
-
-			if ((tempTag.key == "highway") && (tempTag.value != "footway") && (tempTag.value != "bus_guideway") && (tempTag.value != "raceway") && (tempTag.value != "bridleway") &&
-				(tempTag.value != "steps") && (tempTag.value != "path") && (tempTag.value != "cycleway") && (tempTag.value != "proposed") && (tempTag.value != "construction") &&
-				(tempTag.value != "track") && (tempTag.value != "pedestrian"))
+			if ((strcmp(key, "highway") == 0) && (strcmp(value, "footway") != 0) && (strcmp(value, "bus_guideway") != 0) && (strcmp(value, "raceway") != 0) &&
+				(strcmp(value, "bridleway") != 0) && (strcmp(value, "steps") != 0) && (strcmp(value, "path") != 0) && (strcmp(value, "cycleway") != 0) &&
+				(strcmp(value, "proposed") != 0) && (strcmp(value, "construction") != 0) && (strcmp(value, "track") != 0) && (strcmp(value, "pedestrian") != 0))
+			{
 				wayType = WayTypes::Road;
-			else if ((tempTag.key == "amenity") && (tempTag.value == "parking"))
+			}
+			else if ((strcmp(key, "amenity") == 0) && (strcmp(value, "parking") == 0))
+			{
 				wayType = WayTypes::Parking;
-			else if ((tempTag.key == "building") || (tempTag.key == "shop") || (tempTag.key == "landuse" && (tempTag.value == "retail")))
+			}
+			else if ((strcmp(key, "building") == 0) || (strcmp(key, "shop") == 0) || ((strcmp(key, "landuse") == 0) && (strcmp(value, "retail") == 0)))
+			{
 				wayType = WayTypes::Building;
-			else if ((tempTag.key == "area") && (tempTag.value == "yes"))
-				tempWay.area = true;
+			}
+			else if ((strcmp(key, "area") == 0) && (strcmp(value, "yes") == 0))
+			{
+				isArea = true;
+			}
 		}
 
-		// Get node IDs
-		pugi::xml_object_range<pugi::xml_named_node_iterator> nodeIds = currentWay->children("nd");
-
-		for (pugi::xml_named_node_iterator currentNodeId = nodeIds.begin(); currentNodeId != nodeIds.end(); ++currentNodeId)
+		if (wayType == WayTypes::Road)
+		{
+			tempWay = &_osm.originalRoadWays[tempWayId];
+		}
+		else if (wayType == WayTypes::Parking)
+		{
+			tempWay = &_osm.parkingWays[tempWayId];
+		}
+		else if (wayType == WayTypes::Building)
+		{
+			tempWay = &_osm.buildWays[tempWayId];
+		}
+		else
 		{
-			tempWay.nodeIds.push_back(currentNodeId->attribute("ref").as_ullong());
+			return; // Ways of other types are not used
+		}
 
-			if ((wayType == WayTypes::Road) && !tempWay.area)
+		tempWay->inner = false;
+		tempWay->tileBoundWay = false;
+		tempWay->area = isArea;
+		tempWay->isFork = false;
+		tempWay->isIntersection = false;
+		tempWay->isRoundabout = false;
+		tempWay->width = 0.0;
+		tempWay->id = tempWayId;
+		tempWay->tags.assign(tags, tags + numTags);
+		tempWay->nodeIds.assign(nodeIds, nodeIds + numNodeIds);
+
+		if ((wayType == WayTypes::Road) && !tempWay->area)
+		{
+			for (size_t i = 0; i < numNodeIds; ++i)
 			{
-				Vertex& currentNode = _osm.nodes.find(tempWay.nodeIds.back())->second;
-				currentNode.wayIds.push_back(tempWay.id);
+				Vertex& currentNode = _osm.getNodeById(nodeIds[i]);
+				currentNode.wayIds.push_back(tempWay->id);
 
 				if (currentNode.wayIds.size() == 2)
+				{
 					_osm.original_intersections.push_back(currentNode.id);
+				}
 			}
 		}
 
@@ -192,11 +187,11 @@ pvr::Result NavDataProcess::loadOSMData()
 		case WayTypes::Road:
 		{
 			RoadTypes::RoadTypes type;
-			tempWay.width = getRoadWidth(tempWay.tags, type);
-			tempWay.roadType = type;
-			tempWay.isRoundabout = isRoadRoundabout(tempWay.tags);
+			tempWay->width = getRoadWidth(tempWay->tags, type);
+			tempWay->roadType = type;
+			tempWay->isRoundabout = isRoadRoundabout(tempWay->tags);
 
-			std::string roadName = getAttributeName(tempWay.tags.data(), tempWay.tags.size());
+			std::string roadName = getAttributeName(tempWay->tags.data(), tempWay->tags.size());
 
 			// Add a road name if none was available from the XML.
 			if (roadName.empty())
@@ -205,128 +200,65 @@ pvr::Result NavDataProcess::loadOSMData()
 				Tag name;
 				name.key = "name";
 				name.value = pvr::strings::createFormatted("%dth Street", uid);
-				tempWay.tags.push_back(name);
+				tempWay->tags.push_back(name);
 				uid++;
 			}
-			else if (!roadName.empty() && !tempWay.isRoundabout)
+			else if (!roadName.empty() && !tempWay->isRoundabout)
 			{
 				LabelData label;
-				for (uint32_t i = 0; i < tempWay.nodeIds.size(); ++i)
+				for (uint32_t i = 0; i < tempWay->nodeIds.size(); ++i)
 				{
-					label.coords = _osm.nodes.find(tempWay.nodeIds[i])->second.coords;
+					label.coords = _osm.getNodeById(tempWay->nodeIds[i]).coords;
 					label.name = roadName;
-					label.scale = static_cast<float>(tempWay.width + tempWay.width / 2.0);
-					label.id = tempWay.id;
+					label.scale = static_cast<float>(tempWay->width + tempWay->width / 2.0);
+					label.id = tempWay->id;
 					label.isAmenityLabel = false;
 					_osm.labels[LOD::LabelLOD].push_back(label);
 				}
 			}
-			_osm.originalRoadWays[tempWay.id] = tempWay;
 			break;
 		}
 		case WayTypes::Parking:
-		{
-			generateIcon(tempWay.nodeIds.data(), tempWay.nodeIds.size(), tempWay.tags.data(), tempWay.tags.size(), tempWay.id);
-			_osm.parkingWays[tempWay.id] = tempWay;
-			break;
-		}
 		case WayTypes::Building:
 		{
-			generateIcon(tempWay.nodeIds.data(), tempWay.nodeIds.size(), tempWay.tags.data(), tempWay.tags.size(), tempWay.id);
-			_osm.buildWays[tempWay.id] = tempWay;
+			generateIcon(tempWay->nodeIds.data(), tempWay->nodeIds.size(), tempWay->tags.data(), tempWay->tags.size(), tempWay->id);
 			break;
 		}
 		default:
 			break;
 		}
-	}
+	});
 
-	if (_osm.originalRoadWays.empty() && _osm.buildWays.empty() && _osm.parkingWays.empty())
+	// Use relation data to sort inner ways. All the ways have been read by the time the relations are.
+	reader.setRelationCallback([this](uint64_t, const RelationMember* members, size_t numMembers, const Tag* tags, size_t numTags) {
+		markInnerWays(members, numMembers, tags, numTags);
+	});
+
+	if (!reader.read(*_assetStream))
 	{
 		return pvr::Result::UnknownError;
 	}
-
-	// Use relation data to sort inner ways
-	pugi::xml_object_range<pugi::xml_named_node_iterator> relations = mapData.root().child("osm").children("relation");
-
-	for (pugi::xml_named_node_iterator currentRelation = relations.begin(); currentRelation != relations.end(); ++currentRelation)
+	if (_osm.nodes.empty())
 	{
-		if (!currentRelation->attribute("visible").empty() && !currentRelation->attribute("visible").as_bool()) // Skip way if not visible
-		{
-			continue;
-		}
-
-		// Check tags to see if it describes a multipolygon
-		pugi::xml_object_range<pugi::xml_named_node_iterator> tags = currentRelation->children("tag");
-		bool multiPolygon = false;
-
-		for (pugi::xml_named_node_iterator currentTag = tags.begin(); currentTag != tags.end(); ++currentTag)
-		{
-			std::string key = currentTag->attribute("k").as_string();
-			std::string value = currentTag->attribute("v").as_string();
-
-			if ((key == "type") && (value == "multipolygon"))
-			{
-				multiPolygon = true;
-			}
-		}
-
-		if (!multiPolygon)
-		{
-			continue;
-		}
-
-		// Iterate through members to find outer way type
-		pugi::xml_object_range<pugi::xml_named_node_iterator> members = currentRelation->children("member");
-
-		WayTypes::WayTypes outerType = WayTypes::Default;
-		for (pugi::xml_named_node_iterator currentMember = members.begin(); currentMember != members.end(); ++currentMember)
-		{
-			std::string type = currentMember->attribute("type").as_string();
-			std::string role = currentMember->attribute("role").as_string();
-
-			if ((type == "way") && (role == "outer"))
-			{
-				uint64_t wayId = currentMember->attribute("ref").as_ullong();
-
-				if (_osm.parkingWays.find(wayId) != _osm.parkingWays.end())
-				{
-					outerType = WayTypes::Parking;
-				}
-				else if (_osm.buildWays.find(wayId) != _osm.buildWays.end())
-				{
-					outerType = WayTypes::Building;
-				}
-			}
-		}
-
-		// Iterate through members again to find inner ways
-		for (pugi::xml_named_node_iterator currentMember = members.begin(); currentMember != members.end(); ++currentMember)
-		{
-			std::string type = currentMember->attribute("type").as_string();
-			std::string role = currentMember->attribute("role").as_string();
-
-			if ((type == "way") && (role == "inner"))
-			{
-				uint64_t wayId = currentMember->attribute("ref").as_ullong();
-
-				const auto& parkingTemp = _osm.parkingWays.find(wayId);
-				const auto& buildTemp = _osm.buildWays.find(wayId);
-
-				if ((parkingTemp != _osm.parkingWays.end()) && (outerType == WayTypes::Parking))
-				{
-					parkingTemp->second.inner = true;
-				}
-				else if ((buildTemp != _osm.buildWays.end()) && (outerType == WayTypes::Building))
-				{
-					buildTemp->second.inner = true;
-				}
-			}
-		}
+		return pvr::Result::UnknownError;
+	}
+	if (_osm.originalRoadWays.empty() && _osm.buildWays.empty() && _osm.parkingWays.empty())
+	{
+		return pvr::Result::UnknownError;
 	}
 	return pvr::Result::Success;
 }
 
+/*!*********************************************************************************************************************
+\return Return true if the route must not pass through the point.
+\param  point The point to test.
+\brief  The 3D route may go anywhere within the map bounds.
+***********************************************************************************************************************/
+bool NavDataProcess::isExcludedFromRoute(const glm::dvec2& point) const
+{
+	return isOutOfBounds(point);
+}
+
 void NavDataProcess::convertRoute(const glm::dvec2& mapWorldDim, uint32_t numCols, uint32_t numRows, float& totalRouteDistance)
 {
 	for (uint32_t i = 0; i < getRouteData().size(); ++i)
@@ -353,127 +285,6 @@ void NavDataProcess::convertRoute(const glm::dvec2& mapWorldDim, uint32_t numCol
 	}
 }
 
-/*!*********************************************************************************************************************
-\brief	Iterates over available intersections and calculates a 'random' route through the available data set,
-if no interesections are available no route will be calculated.
-***********************************************************************************************************************/
-void NavDataProcess::calculateRoute()
-{
-	if (_osm.original_intersections.size() == 0)
-	{
-		Log(LogLevel::Information, "No Route Calculated - No intersections.");
-		return;
-	}
-
-	uint32_t count = 0;
-	// Hold previosuly visited IDs to prevent going back on ourselves.
-	std::set<uint64_t> previousIntersectIDs;
-	std::set<uint64_t> previousWayIDs;
-	uint64_t nextID = _osm.original_intersections[0];
-	uint64_t lastID = 0;
-	std::vector<std::pair<uint64_t, glm::dvec2> > tempCoords;
-
-	while (previousIntersectIDs.size() < _osm.original_intersections.size())
-	{
-		bool nextJunctionFound = false;
-		Vertex node = _osm.nodes.find(nextID)->second;
-
-		// Find the next way for the route.
-		for (uint32_t i = 0; i < node.wayIds.size(); ++i)
-		{
-			Way way = _osm.originalRoadWays.find(node.wayIds[i])->second;
-
-			// Make sure we have not visited this way in the past.
-			if (previousWayIDs.find(way.id) == previousWayIDs.end())
-			{
-				previousWayIDs.insert(way.id);
-
-				for (auto id : way.nodeIds)
-				{
-					glm::dvec2 coords = _osm.nodes.find(id)->second.coords;
-
-					// Check the node is not outside the map boundary.
-					if (isOutOfBounds(coords))
-					{
-						if (tempCoords.size() > 0)
-							tempCoords.clear();
-
-						continue;
-					}
-
-					tempCoords.push_back(std::pair<uint64_t, glm::dvec2>(id, coords));
-
-					if (!nextJunctionFound)
-					{
-						// Find the next node that is an intersection.
-						for (uint32_t j = 0; j < _osm.original_intersections.size(); ++j)
-						{
-							if (id == _osm.original_intersections[j] && previousIntersectIDs.find(id) == previousIntersectIDs.end())
-							{
-								previousIntersectIDs.insert(id);
-								nextID = id;
-								nextJunctionFound = true;
-								break;
-							}
-						}
-					}
-
-					if (nextJunctionFound)
-					{
-						if (way.nodeIds[0] == nextID && way.nodeIds.back() == node.id && way.nodeIds.size() > 2)
-						{
-							glm::dvec2 p1 = _osm.nodes.find(node.id)->second.coords;
-							glm::dvec2 p2 = _osm.nodes.find(way.nodeIds[0])->second.coords;
-							glm::dvec2 p3 = _osm.nodes.find(way.nodeIds[way.nodeIds.size() / 2])->second.coords;
-
-							float a1 = static_cast<float>(glm::atan(p1.y - p2.y, p1.x - p2.x));
-							float a2 = static_cast<float>(glm::atan(p1.y - p3.y, p1.x - p3.x));
-
-							if (glm::abs(a1 - a2) > 0.25f)
-							{
-								std::reverse(way.nodeIds.begin(), way.nodeIds.end());
-								tempCoords.clear();
-
-								for (uint32_t j = 0; j < way.nodeIds.size(); ++j)
-									tempCoords.push_back(std::pair<uint64_t, glm::dvec2>(way.nodeIds[j], _osm.nodes.find(way.nodeIds[j])->second.coords));
-							}
-						}
-						break;
-					}
-				}
-			}
-			// Add the found nodes to the route.
-			if (nextJunctionFound)
-			{
-				for (uint32_t j = 0; j < tempCoords.size(); ++j)
-				{
-					if (lastID == tempCoords[j].first)
-					{
-						continue;
-					}
-
-					RouteData data;
-					data.distanceToNext = 0.0f;
-					data.point = tempCoords[j].second;
-					data.name = getAttributeName(way.tags.data(), way.tags.size());
-					_osm.route.push_back(data);
-				}
-
-				lastID = tempCoords.back().first;
-				tempCoords.clear();
-				break;
-			}
-			tempCoords.clear();
-		}
-
-		// If no junction was found end the route.
-		if (!nextJunctionFound)
-			break;
-
-		count++;
-	}
-}
-
 /*!*********************************************************************************************************************
 \param	nodeIds The nodes IDs that make up this entity.
 \param	tags The tags associated with this entity, which may contain the type of amenity / service and name.
@@ -545,7 +356,7 @@ applied to the text based on the slope of the road segment i.e. the line between
 ***********************************************************************************************************************/
 void NavDataProcess::processLabels(const glm::dvec2& mapWorldDim)
 {
-	for (int lod = 0; lod <= LOD::Count; ++lod)
+	for (int lod = 0; lod < LOD::Count; ++lod)
 	{
 		auto& osmlodlabels = _osm.labels[lod];
 		if (osmlodlabels.size() == 0)
@@ -851,9 +662,9 @@ void NavDataProcess::calculateIntersections()
 			Vertex newNode0 = _osm.nodes.find(newTriStrip.nodeIds[0])->second;
 			Vertex newNode1 = _osm.nodes.find(newTriStrip.nodeIds[1])->second;
 			Vertex newNode2 = _osm.nodes.find(newTriStrip.nodeIds[2])->second;
-			newNode0.id = _osm.nodes.rbegin()->first + 1;
-			newNode1.id = _osm.nodes.rbegin()->first + 2;
-			newNode2.id = _osm.nodes.rbegin()->first + 3;
+			newNode0.id = _osm.nodes.getMaxId() + 1;
+			newNode1.id = _osm.nodes.getMaxId() + 2;
+			newNode2.id = _osm.nodes.getMaxId() + 3;
 
 			_osm.nodes[newNode0.id] = newNode0;
 			_osm.nodes[newNode1.id] = newNode1;
@@ -1192,8 +1003,8 @@ void NavDataProcess::sortTiles()
 		multiJunct = false;
 	}
 
-	for (uint32_t lod = 0; lod < LOD::Count; ++lod)
-	{
+	// Labels, icons and amenity labels of each level of detail go into their own arrays, so the levels are filled concurrently.
+	parallelFor(LOD::Count, [&](uint32_t lod) {
 		// Labels
 		for (uint32_t i = 0; i < _osm.labels[lod].size(); ++i)
 		{
@@ -1211,7 +1022,11 @@ void NavDataProcess::sortTiles()
 		{
 			fillAmenityTiles(_osm.amenityLabels[lod][i], lod);
 		}
+	});
 
+	// Area outlines share the intersection and boundary node data of the whole map, so they are tiled on this thread.
+	for (uint32_t lod = 0; lod < LOD::Count; ++lod)
+	{
 		// Tile area outlines
 		if (!_osm.areaOutlines.empty())
 		{
@@ -1243,12 +1058,15 @@ void NavDataProcess::sortTiles()
 
 		if (wayIterator->second.inner)
 		{
-			innerWays.push_back(wayIterator->second);
+			if (_osm.holeWays.find(wayIterator->second.id) == _osm.holeWays.end()) // Holes are cut out of their outer way instead
+			{
+				innerWays.push_back(wayIterator->second);
+			}
 			continue;
 		}
 
 		std::vector<std::array<uint64_t, 3> > triangles;
-		triangulate(wayIterator->second.nodeIds, triangles);
+		triangulate(wayIterator->second.nodeIds, getHoles(wayIterator->second, _osm.parkingWays), triangles);
 
 		for (uint32_t i = 0; i < triangles.size(); ++i)
 		{
@@ -1283,12 +1101,15 @@ void NavDataProcess::sortTiles()
 
 		if (wayIterator->second.inner)
 		{
-			innerWays.push_back(wayIterator->second);
+			if (_osm.holeWays.find(wayIterator->second.id) == _osm.holeWays.end()) // Holes are cut out of their outer way instead
+			{
+				innerWays.push_back(wayIterator->second);
+			}
 			continue;
 		}
 
 		std::vector<std::array<uint64_t, 3> > triangles;
-		triangulate(wayIterator->second.nodeIds, triangles);
+		triangulate(wayIterator->second.nodeIds, getHoles(wayIterator->second, _osm.buildWays), triangles);
 
 		avgPos /= (wayIterator->second.nodeIds.size() - 1);
 		// Deterministic height based on average position
@@ -1304,17 +1125,17 @@ void NavDataProcess::sortTiles()
 
 			Vertex _node0 = node0;
 			_node0.height = buildingHeight;
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
 
 			Vertex _node1 = node1;
 			_node1.height = buildingHeight;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
 
 			Vertex _node2 = node2;
 			_node2.height = buildingHeight;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			/******* Cuboid Faces ***********/
@@ -1323,18 +1144,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(_node2, _node0, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node0, _node0, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1342,18 +1163,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(node1, node0, id, wayIterator->second.tags, WayTypes::Building);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node1, _node0, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1361,18 +1182,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(_node1, node1, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node2, _node2, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1380,18 +1201,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(node0, node2, id, wayIterator->second.tags, WayTypes::Building);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node0, _node2, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1399,18 +1220,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(_node0, node0, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node1, _node2, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1418,18 +1239,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(node2, node1, id, wayIterator->second.tags, WayTypes::Building);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node1, _node1, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1487,30 +1308,7 @@ void NavDataProcess::insertWay(std::vector<Way>& insertIn, Way& way)
 ***********************************************************************************************************************/
 glm::ivec2 NavDataProcess::findTile2(glm::dvec2& point) const
 {
-	glm::uvec2 tileCoords;
-	glm::dvec2 tmpPoint = point;
-	for (uint32_t i = 0; i < _osm.numCols; ++i)
-	{
-		if (tmpPoint.x <= _osm.tiles[i][0].max.x)
-		{
-			if ((tmpPoint.x == _osm.tiles[i][0].max.x) && (i != (_osm.numCols - 1)))
-				tmpPoint.x -= 0.0000001; // Move node off of tile border
-			tileCoords.x = i;
-			break;
-		}
-	}
-
-	for (uint32_t i = 0; i < _osm.numRows; ++i)
-	{
-		if (tmpPoint.y <= _osm.tiles[0][i].max.y)
-		{
-			if ((tmpPoint.y == _osm.tiles[0][i].max.y) && (i != (_osm.numRows - 1)))
-				tmpPoint.y -= 0.0000001; // Move node off of tile border
-			tileCoords.y = i;
-			break;
-		}
-	}
-	return tileCoords;
+	return _tileGrid.findCell(point);
 }
 
 // The range of angles at which a bend should be tessellated - no need to tessellate almost flat road segments.
@@ -1554,7 +1352,7 @@ void NavDataProcess::fillTiles(Vertex startNode, Vertex endNode, const uint64_t
 			startNode.coords = glm::dvec2(result.x, result.y);
 		}
 
-		startNode.id = _osm.nodes.rbegin()->first + 1;
+		startNode.id = _osm.nodes.getMaxId() + 1;
 		startNode.tileBoundNode = true;
 		_osm.nodes[startNode.id] = startNode;
 	}
@@ -1562,7 +1360,7 @@ void NavDataProcess::fillTiles(Vertex startNode, Vertex endNode, const uint64_t
 	{
 		glm::dvec3 result = findIntersect(_osm.bounds.min, _osm.bounds.max, startNode.coords, endNode.coords);
 		endNode.coords = glm::dvec2(result.x, result.y);
-		endNode.id = _osm.nodes.rbegin()->first + 1;
+		endNode.id = _osm.nodes.getMaxId() + 1;
 		endNode.tileBoundNode = true;
 		_osm.nodes[endNode.id] = endNode;
 	}
@@ -1618,7 +1416,7 @@ void NavDataProcess::fillTiles(Vertex startNode, Vertex endNode, const uint64_t
 		glm::dvec3 result = findIntersect(_osm.tiles[currentTile.x][currentTile.y].min, _osm.tiles[currentTile.x][currentTile.y].max, currentNode.coords, endNode.coords);
 
 		// Find the node on the tile boundary
-		Vertex newNode = Vertex(_osm.nodes.rbegin()->first + 1, glm::dvec2(result.x, result.y), true);
+		Vertex newNode = Vertex(_osm.nodes.getMaxId() + 1, glm::dvec2(result.x, result.y), true);
 
 		double weight = glm::distance(startNode.coords, newNode.coords) / t_dist;
 		glm::vec2 weightedTexCoord = glm::mix(currentNode.texCoords, endNode.texCoords, weight);
@@ -1729,7 +1527,7 @@ void NavDataProcess::addCornerPoints(Tile& tile, std::vector<Way>& way)
 				glm::dvec2 point0 = tile.nodes.find(nodeIds[0])->second.coords;
 				glm::dvec2 point1 = tile.nodes.find(nodeIds[1])->second.coords;
 
-				Vertex newNode(_osm.nodes.rbegin()->first + 1);
+				Vertex newNode(_osm.nodes.getMaxId() + 1);
 				newNode.coords.x = ((point0.x == tile.min.x) || (point0.x == tile.max.x)) ? point0.x : point1.x;
 				newNode.coords.y = ((point0.y == tile.min.y) || (point0.y == tile.max.y)) ? point0.y : point1.y;
 
@@ -1757,7 +1555,7 @@ void NavDataProcess::addCornerPoints(Tile& tile, std::vector<Way>& way)
 						newPoint.x = ((currentNode.coords.x == tile.min.x) || (currentNode.coords.x == tile.max.x)) ? currentNode.coords.x : nextNode.coords.x;
 						newPoint.y = ((currentNode.coords.y == tile.min.y) || (currentNode.coords.y == tile.max.y)) ? currentNode.coords.y : nextNode.coords.y;
 
-						Vertex newNode(_osm.nodes.rbegin()->first + 1, newPoint);
+						Vertex newNode(_osm.nodes.getMaxId() + 1, newPoint);
 
 						_osm.nodes[newNode.id] = newNode;
 						tile.nodes[newNode.id] = newNode;
@@ -1858,7 +1656,7 @@ std::vector<uint64_t> NavDataProcess::tessellate(const std::vector<uint64_t>& ol
 					offset = newCoords - node1.coords;
 				}
 				else // Create a new node
-					newNode.id = _osm.nodes.rbegin()->first + 1;
+					newNode.id = _osm.nodes.getMaxId() + 1;
 
 				newNode.coords = lastPointOnCurve = newCoords;
 				_osm.nodes[newNode.id] = newNode;
@@ -1898,7 +1696,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 
 	if (nodeIds.size() == 2)
 	{
-		uint64_t id = _osm.nodes.rbegin()->first + 1;
+		uint64_t id = _osm.nodes.getMaxId() + 1;
 		Vertex node0 = _osm.nodes.find(nodeIds[0])->second;
 		Vertex node1 = _osm.nodes.find(nodeIds[1])->second;
 
@@ -1926,7 +1724,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 	{
 		for (uint32_t i = 1; i < (nodeIds.size() - 1); ++i)
 		{
-			uint64_t id = _osm.nodes.rbegin()->first + 1;
+			uint64_t id = _osm.nodes.getMaxId() + 1;
 			Vertex node0 = _osm.nodes.find(nodeIds[i - 1])->second;
 			Vertex node1 = _osm.nodes.find(nodeIds[i])->second;
 			Vertex node2 = _osm.nodes.find(nodeIds[i + 1])->second;
@@ -2305,7 +2103,7 @@ void NavDataProcess::calculateJunctionTexCoords()
 			{
 				Tile& myTile = _osm.tiles[currentTile.x][currentTile.y];
 
-				std::map<uint64_t, Vertex>::iterator it = myTile.nodes.find(itr->second.nodes[j]);
+				NodeMap::iterator it = myTile.nodes.find(itr->second.nodes[j]);
 				if (it == myTile.nodes.end())
 				{
 					continue;
@@ -2385,21 +2183,21 @@ void NavDataProcess::calculateJunctionTexCoords()
 				way->nodeIds.clear();
 
 				Vertex newNode0 = *foundNodes[index_1].first;
-				newNode0.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+				newNode0.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 				_osm.tiles[currentTile.x][currentTile.y].nodes[newNode0.id] = newNode0;
 
 				Vertex newNode1 = *foundNodes[index_3].first;
-				newNode1.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+				newNode1.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 				_osm.tiles[currentTile.x][currentTile.y].nodes[newNode1.id] = newNode1;
 
 				Vertex newNode2 = *foundNodes[index_2].first;
-				newNode2.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+				newNode2.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 				newNode2.texCoords = foundNodes[index_2].second->texCoords;
 				_osm.tiles[currentTile.x][currentTile.y].nodes[newNode2.id] = newNode2;
 
 				// Extra point used to cover gaps and prevent artefacts in junction.
 				Vertex newNode3 = newNode2;
-				newNode3.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+				newNode3.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 				newNode3.coords = calculateMidPoint(foundNodes[index_2].first->coords, foundNodes[index_1].first->coords, foundNodes[index_3].first->coords);
 				newNode3.texCoords = glm::vec2(glm::mix(-0.05f, 0.55f, 0.5f), 0.245f);
 				_osm.tiles[currentTile.x][currentTile.y].nodes[newNode3.id] = newNode3;
@@ -2420,7 +2218,7 @@ void NavDataProcess::calculateJunctionTexCoords()
 					(texCoordFlippedEdgeCase && compareReal(foundNodes[index_3].first->texCoords.x, foundNodes[index_1].second->texCoords.x)))
 				{
 					Vertex newNode = newNode0;
-					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 
 					if (texCoordFlippedEdgeCase || roundAboutEdgeCase1)
 						newNode.texCoords = foundNodes[index_2].second->texCoords;
@@ -2438,7 +2236,7 @@ void NavDataProcess::calculateJunctionTexCoords()
 					(texCoordFlippedEdgeCase && compareReal(foundNodes[index_3].first->texCoords.x, foundNodes[index_2].first->texCoords.x)))
 				{
 					Vertex newNode = newNode2;
-					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 
 					if (texCoordFlippedEdgeCase || roundAboutEdgeCase2)
 						newNode.texCoords = foundNodes[index_1].first->texCoords;
@@ -2455,7 +2253,7 @@ void NavDataProcess::calculateJunctionTexCoords()
 				else
 				{
 					Vertex newNode = newNode2;
-					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 
 					if (compareReal(newNode.texCoords.x, -0.05f))
 						_osm.tiles[currentTile.x][currentTile.y].nodes[newNode2.id].texCoords = glm::vec2(0.55f, 0.245f);
@@ -2539,7 +2337,7 @@ void NavDataProcess::calculateCrossRoadJunctionTexCoords(std::vector<std::pair<V
 
 		// Mid point node.
 		Vertex newNode;
-		newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		newNode.coords = foundNodes[indices[0]].first->coords - (v1 * (len / 2.0));
 		newNode.texCoords = glm::vec2(glm::mix(-0.05f, 0.55f, 0.5f), 0.245f);
 		newNode.height = 0.000075f;
@@ -2549,50 +2347,50 @@ void NavDataProcess::calculateCrossRoadJunctionTexCoords(std::vector<std::pair<V
 		Vertex newNode0 = *foundNodes[indices[0]].first;
 		newNode0.texCoords = glm::vec2(-0.05f, 0.245f);
 		newNode0.height = 0.00005f;
-		newNode0.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode0.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode0.id] = newNode0;
 
 		Vertex newNode1 = *foundNodes[indices[1]].first;
 		newNode1.texCoords = glm::vec2(-0.05f, 0.245f);
 		newNode1.height = 0.000075f;
-		newNode1.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode1.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode1.id] = newNode1;
 
 		Vertex newNode2 = *foundNodes[indices[2]].first;
 		newNode2.texCoords = glm::vec2(0.55f, 0.245f);
 		newNode2.height = 0.00005f;
-		newNode2.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode2.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode2.id] = newNode2;
 
 		Vertex newNode3 = *foundNodes[indices[3]].first;
 		newNode3.texCoords = glm::vec2(0.55f, 0.245f);
 		newNode3.height = 0.000075f;
-		newNode3.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode3.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode3.id] = newNode3;
 
 		/* Nodes to create quad (2 triangles) to fill gaps in the junction. */
 		Vertex newNode4 = *foundNodes[indices[0]].second;
 		newNode4.texCoords = glm::vec2(-0.05f, 0.245f);
 		newNode4.height = 0.00005f;
-		newNode4.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode4.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode4.id] = newNode4;
 
 		Vertex newNode5 = *foundNodes[indices[1]].first;
 		newNode5.texCoords = glm::vec2(0.55f, 0.245f);
 		newNode5.height = 0.000075f;
-		newNode5.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode5.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode5.id] = newNode5;
 
 		Vertex newNode6 = *foundNodes[indices[2]].first;
 		newNode6.texCoords = glm::vec2(-0.05f, 0.245f);
 		newNode6.height = 0.00005f;
-		newNode6.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode6.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode6.id] = newNode6;
 
 		Vertex newNode7 = *foundNodes[indices[3]].second;
 		newNode7.texCoords = glm::vec2(0.55f, 0.245f);
 		newNode7.height = 0.000075f;
-		newNode7.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode7.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode7.id] = newNode7;
 
 		/* Quad to fill holes in junction. */
@@ -2762,12 +2560,12 @@ std::array<uint64_t, 2> NavDataProcess::calculateEndCaps(Vertex& first, Vertex&
 	// Setup new nodes used for end cap.
 	newNode1.coords -= v1;
 	newNode1.texCoords.y = 1.0f;
-	newNode1.id = _osm.nodes.rbegin()->first + 1;
+	newNode1.id = _osm.nodes.getMaxId() + 1;
 	_osm.nodes[newNode1.id] = newNode1;
 
 	newNode2.coords -= v1;
 	newNode2.texCoords.y = 1.0f;
-	newNode2.id = _osm.nodes.rbegin()->first + 1;
+	newNode2.id = _osm.nodes.getMaxId() + 1;
 	_osm.nodes[newNode2.id] = newNode2;
 
 	std::array<uint64_t, 2> retval;
@@ -0,0 +1,461 @@
+#pragma once
+#include "PVRCore/stream/Stream.h"
+#include "PVRCore/Log.h"
+#include "PVRCore/glm.h"
+#include <functional>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+// Stores a key-value pair.
+struct Tag
+{
+	std::string key;
+	std::string value;
+};
+
+// A member of an OSM relation.
+struct RelationMember
+{
+	std::string type;
+	std::string role;
+	uint64_t ref;
+};
+
+/*!*****************************************************************************
+Class OSMStreamReader Reads OSM XML data in a single streaming pass, without
+building a document tree. The stream is read in fixed size chunks and every
+complete element (bounds, node, way, relation) is handed to a callback as soon
+as its closing tag has been read, so memory use is independent of the size of
+the file and the processing of the data overlaps with the parse. The tags, node
+references and members passed to the callbacks are only valid during the call;
+their storage is reused for the next element. Elements with visible="false" are
+skipped.
+********************************************************************************/
+class OSMStreamReader
+{
+public:
+	typedef std::function<void(const glm::dvec2& minLonLat, const glm::dvec2& maxLonLat)> BoundsCallback;
+	typedef std::function<void(uint64_t id, const glm::dvec2& lonLat, const Tag* tags, size_t numTags)> NodeCallback;
+	typedef std::function<void(uint64_t id, const uint64_t* nodeIds, size_t numNodeIds, const Tag* tags, size_t numTags)> WayCallback;
+	typedef std::function<void(uint64_t id, const RelationMember* members, size_t numMembers, const Tag* tags, size_t numTags)> RelationCallback;
+
+	enum
+	{
+		DefaultChunkSize = 256 * 1024
+	};
+
+	OSMStreamReader(size_t chunkSize = DefaultChunkSize) : _chunkSize(chunkSize < 1024 ? 1024 : chunkSize), _numTags(0), _numMembers(0), _element(None), _visible(true), _id(0)
+	{}
+
+	void setBoundsCallback(const BoundsCallback& callback)
+	{
+		_boundsCallback = callback;
+	}
+	void setNodeCallback(const NodeCallback& callback)
+	{
+		_nodeCallback = callback;
+	}
+	void setWayCallback(const WayCallback& callback)
+	{
+		_wayCallback = callback;
+	}
+	void setRelationCallback(const RelationCallback& callback)
+	{
+		_relationCallback = callback;
+	}
+
+	/*!*********************************************************************************************************************
+	\return Return true if the whole stream was read, false if the XML was malformed or the stream could not be read.
+	\param  stream The stream to read, from its current position to its end.
+	\brief  Read the stream, calling the callbacks for every element.
+	***********************************************************************************************************************/
+	bool read(const pvr::Stream& stream)
+	{
+		stream.open();
+		size_t remaining = stream.getSize() - stream.getPosition();
+		std::vector<char> buffer(_chunkSize + 1);
+		size_t begin = 0; // The start of the unprocessed data
+		size_t end = 0; // The end of the data read so far
+		_element = None;
+
+		for (;;)
+		{
+			// Find the next markup. Character data between elements is not used by OSM and is skipped.
+			char* tagStart = static_cast<char*>(memchr(buffer.data() + begin, '<', end - begin));
+			char* tagEnd = tagStart ? findTagEnd(tagStart, buffer.data() + end) : nullptr;
+			if (tagEnd)
+			{
+				processTag(tagStart + 1, tagEnd);
+				begin = tagEnd + 1 - buffer.data();
+				continue;
+			}
+			if (!remaining)
+			{
+				if (tagStart)
+				{
+					Log(LogLevel::Error, "OSMStreamReader: Unexpected end of stream inside an XML tag");
+					return false;
+				}
+				return true;
+			}
+
+			// Keep the incomplete tag (if any) and read the next chunk after it. A tag longer than the buffer grows the buffer.
+			begin = tagStart ? tagStart - buffer.data() : end;
+			memmove(buffer.data(), buffer.data() + begin, end - begin);
+			end -= begin;
+			begin = 0;
+			if (buffer.size() - 1 - end < _chunkSize / 2)
+			{
+				buffer.resize(buffer.size() + _chunkSize);
+			}
+			size_t toRead = std::min(remaining, buffer.size() - 1 - end);
+			size_t dataRead = 0;
+			stream.read(1, toRead, buffer.data() + end, dataRead);
+			if (!dataRead)
+			{
+				Log(LogLevel::Error, "OSMStreamReader: Failed to read from the stream with %llu bytes remaining", static_cast<unsigned long long>(remaining));
+				return false;
+			}
+			end += dataRead;
+			remaining -= dataRead;
+		}
+	}
+
+private:
+	enum Element
+	{
+		None,
+		Node,
+		Way,
+		Relation
+	};
+
+	struct Attribute
+	{
+		const char* name;
+		const char* value;
+	};
+
+	// Return a pointer to the '>' ending the markup starting at tagStart, or nullptr if it has not been read yet.
+	static char* findTagEnd(char* tagStart, char* end)
+	{
+		const char* terminator = ">";
+		if (end - tagStart >= 4 && strncmp(tagStart, "<!--", 4) == 0)
+		{
+			terminator = "-->";
+		}
+		else if (end - tagStart >= 2 && tagStart[1] == '?')
+		{
+			terminator = "?>";
+		}
+		else if (end - tagStart < 4 && (tagStart[1] == '!' || end - tagStart < 2))
+		{
+			return nullptr; // Cannot tell whether this is a comment yet
+		}
+		const size_t terminatorLength = strlen(terminator);
+		char quote = 0;
+		for (char* c = tagStart + 1; c + terminatorLength <= end; ++c)
+		{
+			if (terminatorLength == 1 && (*c == '"' || *c == '\''))
+			{
+				// Attribute values may contain '>'
+				quote = quote == *c ? 0 : (quote ? quote : *c);
+			}
+			else if (!quote && strncmp(c, terminator, terminatorLength) == 0)
+			{
+				return c + terminatorLength - 1;
+			}
+		}
+		return nullptr;
+	}
+
+	static bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	static void appendUtf8(char*& out, uint32_t codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			*out++ = static_cast<char>(codePoint);
+		}
+		else if (codePoint < 0x800)
+		{
+			*out++ = static_cast<char>(0xC0 | (codePoint >> 6));
+			*out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else if (codePoint < 0x10000)
+		{
+			*out++ = static_cast<char>(0xE0 | (codePoint >> 12));
+			*out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			*out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else
+		{
+			*out++ = static_cast<char>(0xF0 | (codePoint >> 18));
+			*out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+			*out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			*out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+	}
+
+	// Decode the XML escapes and normalise the whitespace of an attribute value in place (the decoded value is never longer) and null-terminate it.
+	static void decodeValue(char* value, char* valueEnd)
+	{
+		char* out = value;
+		for (char* in = value; in < valueEnd;)
+		{
+			if (*in == '&')
+			{
+				char* semicolon = static_cast<char*>(memchr(in, ';', valueEnd - in));
+				if (semicolon)
+				{
+					const size_t length = semicolon - in + 1;
+					if (length == 5 && strncmp(in, "&amp;", 5) == 0)
+					{
+						*out++ = '&';
+					}
+					else if (length == 4 && strncmp(in, "&lt;", 4) == 0)
+					{
+						*out++ = '<';
+					}
+					else if (length == 4 && strncmp(in, "&gt;", 4) == 0)
+					{
+						*out++ = '>';
+					}
+					else if (length == 6 && strncmp(in, "&quot;", 6) == 0)
+					{
+						*out++ = '"';
+					}
+					else if (length == 6 && strncmp(in, "&apos;", 6) == 0)
+					{
+						*out++ = '\'';
+					}
+					else if (length > 3 && in[1] == '#')
+					{
+						const bool hex = in[2] == 'x';
+						appendUtf8(out, static_cast<uint32_t>(strtoul(in + (hex ? 3 : 2), nullptr, hex ? 16 : 10)));
+					}
+					else
+					{
+						memmove(out, in, length); // Unknown entity: keep it verbatim
+						out += length;
+					}
+					in = semicolon + 1;
+					continue;
+				}
+			}
+			*out++ = isSpace(*in) ? ' ' : *in;
+			++in;
+		}
+		*out = 0;
+	}
+
+	const char* findAttribute(const char* name) const
+	{
+		for (const Attribute& attribute : _attributes)
+		{
+			if (strcmp(attribute.name, name) == 0)
+			{
+				return attribute.value;
+			}
+		}
+		return "";
+	}
+
+	uint64_t getIdAttribute(const char* name) const
+	{
+		return strtoull(findAttribute(name), nullptr, 10);
+	}
+
+	double getDoubleAttribute(const char* name) const
+	{
+		return strtod(findAttribute(name), nullptr);
+	}
+
+	// Same rules as pugixml's as_bool: an empty or missing attribute is the default, otherwise the first character decides.
+	bool isVisible() const
+	{
+		const char* visible = findAttribute("visible");
+		return !*visible || *visible == '1' || *visible == 't' || *visible == 'T' || *visible == 'y' || *visible == 'Y';
+	}
+
+	// Process the markup between '<' (exclusive) and '>' (tagEnd).
+	void processTag(char* tag, char* tagEnd)
+	{
+		if (*tag == '?' || *tag == '!')
+		{
+			return; // Declarations, processing instructions and comments
+		}
+		if (*tag == '/')
+		{
+			char* name = tag + 1;
+			char* nameEnd = name;
+			while (nameEnd < tagEnd && !isSpace(*nameEnd))
+			{
+				++nameEnd;
+			}
+			*nameEnd = 0;
+			endElement(name);
+			return;
+		}
+
+		const bool selfClosing = tagEnd[-1] == '/';
+		char* end = selfClosing ? tagEnd - 1 : tagEnd;
+		char* name = tag;
+		char* c = name;
+		while (c < end && !isSpace(*c))
+		{
+			++c;
+		}
+		char* nameEnd = c;
+
+		_attributes.clear();
+		for (;;)
+		{
+			while (c < end && isSpace(*c))
+			{
+				++c;
+			}
+			if (c >= end)
+			{
+				break;
+			}
+			Attribute attribute;
+			attribute.name = c;
+			while (c < end && *c != '=' && !isSpace(*c))
+			{
+				++c;
+			}
+			char* attributeNameEnd = c;
+			while (c < end && (isSpace(*c) || *c == '='))
+			{
+				++c;
+			}
+			if (c >= end || (*c != '"' && *c != '\''))
+			{
+				break; // Malformed attribute: ignore the rest of the tag
+			}
+			const char quote = *c++;
+			char* value = c;
+			while (c < end && *c != quote)
+			{
+				++c;
+			}
+			*attributeNameEnd = 0;
+			decodeValue(value, c);
+			attribute.value = value;
+			_attributes.push_back(attribute);
+			++c;
+		}
+		*nameEnd = 0;
+
+		startElement(name);
+		if (selfClosing)
+		{
+			endElement(name);
+		}
+	}
+
+	void startElement(const char* name)
+	{
+		if (strcmp(name, "tag") == 0)
+		{
+			if (_element != None)
+			{
+				if (_numTags == _tags.size())
+				{
+					_tags.emplace_back();
+				}
+				_tags[_numTags].key = findAttribute("k");
+				_tags[_numTags].value = findAttribute("v");
+				++_numTags;
+			}
+		}
+		else if (strcmp(name, "nd") == 0)
+		{
+			if (_element == Way)
+			{
+				_nodeIds.push_back(getIdAttribute("ref"));
+			}
+		}
+		else if (strcmp(name, "member") == 0)
+		{
+			if (_element == Relation)
+			{
+				if (_numMembers == _members.size())
+				{
+					_members.emplace_back();
+				}
+				_members[_numMembers].type = findAttribute("type");
+				_members[_numMembers].role = findAttribute("role");
+				_members[_numMembers].ref = getIdAttribute("ref");
+				++_numMembers;
+			}
+		}
+		else if (strcmp(name, "node") == 0 || strcmp(name, "way") == 0 || strcmp(name, "relation") == 0)
+		{
+			_element = name[0] == 'n' ? Node : name[0] == 'w' ? Way : Relation;
+			_visible = isVisible();
+			_id = getIdAttribute("id");
+			_lonLat = glm::dvec2(getDoubleAttribute("lon"), getDoubleAttribute("lat"));
+			_numTags = 0;
+			_numMembers = 0;
+			_nodeIds.clear();
+		}
+		else if (strcmp(name, "bounds") == 0)
+		{
+			if (_boundsCallback)
+			{
+				_boundsCallback(glm::dvec2(getDoubleAttribute("minlon"), getDoubleAttribute("minlat")), glm::dvec2(getDoubleAttribute("maxlon"), getDoubleAttribute("maxlat")));
+			}
+		}
+	}
+
+	void endElement(const char* name)
+	{
+		const Element element = _element;
+		if (element == None || strcmp(name, element == Node ? "node" : element == Way ? "way" : "relation") != 0)
+		{
+			return;
+		}
+		_element = None;
+		if (!_visible)
+		{
+			return;
+		}
+		if (element == Node && _nodeCallback)
+		{
+			_nodeCallback(_id, _lonLat, _tags.data(), _numTags);
+		}
+		else if (element == Way && _wayCallback)
+		{
+			_wayCallback(_id, _nodeIds.data(), _nodeIds.size(), _tags.data(), _numTags);
+		}
+		else if (element == Relation && _relationCallback)
+		{
+			_relationCallback(_id, _members.data(), _numMembers, _tags.data(), _numTags);
+		}
+	}
+
+	size_t _chunkSize;
+	BoundsCallback _boundsCallback;
+	NodeCallback _nodeCallback;
+	WayCallback _wayCallback;
+	RelationCallback _relationCallback;
+
+	// The element being read. The storage of the tags, node ids and members is reused between elements.
+	std::vector<Attribute> _attributes;
+	std::vector<Tag> _tags;
+	size_t _numTags;
+	std::vector<uint64_t> _nodeIds;
+	std::vector<RelationMember> _members;
+	size_t _numMembers;
+	Element _element;
+	bool _visible;
+	uint64_t _id;
+	glm::dvec2 _lonLat;
+};
@@ -0,0 +1,778 @@
+#pragma once
+#include "PVRCore/glm.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+/*!*****************************************************************************
+Class PolygonTriangulator Triangulates simple polygons, optionally with holes,
+by ear clipping. The polygon is given as a flat array of x, y coordinates: the
+outer ring first, followed by the rings of the holes, each ring without a closing
+duplicate vertex and in either winding order. Every hole is joined to the outer
+ring by a bridge edge, turning the polygon into a single ring which is then
+clipped one ear at a time.
+
+Large polygons (more than LargePolygonSize vertices) are indexed along a z-order
+curve, so the test of whether an ear contains another vertex only visits the
+vertices within the bounding box of the ear instead of the whole ring, which
+brings the triangulation of typical map footprints close to O(n log n).
+Degenerate input (collinear or duplicate vertices, self touching rings) is
+handled by filtering the degenerate vertices, curing local self intersections
+and, as a last resort, splitting the polygon along a valid diagonal.
+
+The ring storage is kept between calls, so once the triangulator has grown to
+the size of the largest polygon it does not allocate memory. It is not thread
+safe: use one triangulator per thread.
+********************************************************************************/
+class PolygonTriangulator
+{
+public:
+	enum
+	{
+		LargePolygonSize = 80
+	};
+
+	/*!*********************************************************************************************************************
+	\param  coords The x, y coordinates of the vertices: the outer ring followed by the holes.
+	\param  numVertices The total number of vertices (half the number of coordinates).
+	\param  holeStarts The index of the first vertex of every hole, in increasing order. May be null if there are no holes.
+	\param  numHoles The number of holes.
+	\param  outIndices Receives three vertex indices per triangle. Triangles are appended, and wound anti-clockwise (positive area).
+	\brief  Triangulate a polygon.
+	***********************************************************************************************************************/
+	void triangulate(const double* coords, uint32_t numVertices, const uint32_t* holeStarts, uint32_t numHoles, std::vector<uint32_t>& outIndices)
+	{
+		_nodes.clear();
+		_coords = coords;
+		_indices = &outIndices;
+		_invSize = 0.0;
+
+		const uint32_t outerSize = numHoles ? holeStarts[0] : numVertices;
+		_nodes.reserve(numVertices + numHoles * 2 + 8);
+
+		uint32_t outerNode = linkRing(0, outerSize, true);
+		if (outerNode == Null || _nodes[outerNode].next == _nodes[outerNode].prev)
+		{
+			return;
+		}
+
+		if (numHoles)
+		{
+			outerNode = eliminateHoles(holeStarts, numHoles, numVertices, outerNode);
+		}
+
+		// Index large polygons along a z-order curve covering the bounding box of the outer ring
+		if (numVertices > LargePolygonSize)
+		{
+			double maxX = _minX = coords[0];
+			double maxY = _minY = coords[1];
+			for (uint32_t i = 1; i < outerSize; ++i)
+			{
+				_minX = std::min(_minX, coords[i * 2]);
+				_minY = std::min(_minY, coords[i * 2 + 1]);
+				maxX = std::max(maxX, coords[i * 2]);
+				maxY = std::max(maxY, coords[i * 2 + 1]);
+			}
+			const double size = std::max(maxX - _minX, maxY - _minY);
+			_invSize = size != 0.0 ? 32767.0 / size : 0.0;
+		}
+
+		clipEars(outerNode, 0);
+	}
+
+	/*!*********************************************************************************************************************
+	\param  coords The x, y coordinates of the vertices: the outer ring followed by the holes.
+	\param  holeStarts The index of the first vertex of every hole, in increasing order.
+	\param  outIndices Receives three vertex indices per triangle.
+	\brief  Triangulate a polygon.
+	***********************************************************************************************************************/
+	void triangulate(const std::vector<glm::dvec2>& coords, const std::vector<uint32_t>& holeStarts, std::vector<uint32_t>& outIndices)
+	{
+		triangulate(coords.empty() ? nullptr : &coords[0].x, static_cast<uint32_t>(coords.size()), holeStarts.empty() ? nullptr : holeStarts.data(),
+			static_cast<uint32_t>(holeStarts.size()), outIndices);
+	}
+
+private:
+	static const uint32_t Null = 0xFFFFFFFF;
+
+	// A vertex of a ring, linked to its neighbours in the ring and, for large polygons, in z-order.
+	struct Node
+	{
+		uint32_t i; // Index of the vertex
+		double x;
+		double y;
+		uint32_t prev;
+		uint32_t next;
+		uint32_t prevZ;
+		uint32_t nextZ;
+		int32_t z;
+		bool steiner; // A hole consisting of a single point, which must not be filtered
+	};
+
+	std::vector<Node> _nodes;
+	std::vector<uint32_t> _holeQueue;
+	const double* _coords;
+	std::vector<uint32_t>* _indices;
+	double _minX, _minY, _invSize;
+
+	Node& n(uint32_t node)
+	{
+		return _nodes[node];
+	}
+
+	// Twice the signed area of the triangle p, q, r: negative if the triangle is wound anti-clockwise (positive area) - i.e. the vertex q is convex.
+	double area(uint32_t p, uint32_t q, uint32_t r) const
+	{
+		const Node& a = _nodes[p];
+		const Node& b = _nodes[q];
+		const Node& c = _nodes[r];
+		return (b.y - a.y) * (c.x - b.x) - (b.x - a.x) * (c.y - b.y);
+	}
+
+	bool equals(uint32_t p, uint32_t q) const
+	{
+		return _nodes[p].x == _nodes[q].x && _nodes[p].y == _nodes[q].y;
+	}
+
+	static bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+	{
+		return (cx - px) * (ay - py) >= (ax - px) * (cy - py) && (ax - px) * (by - py) >= (bx - px) * (ay - py) && (bx - px) * (cy - py) >= (cx - px) * (by - py);
+	}
+
+	uint32_t insertNode(uint32_t i, uint32_t last)
+	{
+		Node node;
+		node.i = i;
+		node.x = _coords[i * 2];
+		node.y = _coords[i * 2 + 1];
+		node.prevZ = node.nextZ = Null;
+		node.z = 0;
+		node.steiner = false;
+
+		const uint32_t index = static_cast<uint32_t>(_nodes.size());
+		if (last == Null)
+		{
+			node.prev = node.next = index;
+			_nodes.push_back(node);
+		}
+		else
+		{
+			node.next = _nodes[last].next;
+			node.prev = last;
+			_nodes.push_back(node);
+			n(n(last).next).prev = index;
+			n(last).next = index;
+		}
+		return index;
+	}
+
+	void removeNode(uint32_t p)
+	{
+		Node& node = n(p);
+		n(node.next).prev = node.prev;
+		n(node.prev).next = node.next;
+		if (node.prevZ != Null)
+		{
+			n(node.prevZ).nextZ = node.nextZ;
+		}
+		if (node.nextZ != Null)
+		{
+			n(node.nextZ).prevZ = node.prevZ;
+		}
+	}
+
+	// Create a circular linked list from the vertices [start, end), with the requested winding
+	uint32_t linkRing(uint32_t start, uint32_t end, bool antiClockwise)
+	{
+		if (end <= start)
+		{
+			return Null;
+		}
+
+		double signedArea = 0.0;
+		for (uint32_t i = start, j = end - 1; i < end; j = i++)
+		{
+			signedArea += (_coords[j * 2] - _coords[i * 2]) * (_coords[i * 2 + 1] + _coords[j * 2 + 1]);
+		}
+
+		uint32_t last = Null;
+		if (antiClockwise == (signedArea > 0.0))
+		{
+			for (uint32_t i = start; i < end; ++i)
+			{
+				last = insertNode(i, last);
+			}
+		}
+		else
+		{
+			for (uint32_t i = end; i-- > start;)
+			{
+				last = insertNode(i, last);
+			}
+		}
+
+		if (last != Null && equals(last, n(last).next))
+		{
+			const uint32_t next = n(last).next;
+			removeNode(last);
+			last = next;
+		}
+		return last;
+	}
+
+	// Remove duplicate and collinear vertices
+	uint32_t filterPoints(uint32_t start, uint32_t end = Null)
+	{
+		if (start == Null)
+		{
+			return start;
+		}
+		if (end == Null)
+		{
+			end = start;
+		}
+
+		uint32_t p = start;
+		bool again;
+		do
+		{
+			again = false;
+			if (!n(p).steiner && (equals(p, n(p).next) || area(n(p).prev, p, n(p).next) == 0.0))
+			{
+				removeNode(p);
+				p = end = n(p).prev;
+				if (p == n(p).next)
+				{
+					break;
+				}
+				again = true;
+			}
+			else
+			{
+				p = n(p).next;
+			}
+		} while (again || p != end);
+
+		return end;
+	}
+
+	// The main ear clipping loop. Passes 1 and 2 are fallbacks for rings on which no ear can be found.
+	void clipEars(uint32_t ear, int pass)
+	{
+		if (ear == Null)
+		{
+			return;
+		}
+		if (!pass && _invSize != 0.0)
+		{
+			indexCurve(ear);
+		}
+
+		uint32_t stop = ear;
+		while (n(ear).prev != n(ear).next)
+		{
+			const uint32_t prev = n(ear).prev;
+			const uint32_t next = n(ear).next;
+
+			if (_invSize != 0.0 ? isEarHashed(ear) : isEar(ear))
+			{
+				_indices->push_back(n(prev).i);
+				_indices->push_back(n(ear).i);
+				_indices->push_back(n(next).i);
+				removeNode(ear);
+
+				// Skipping the next vertex leads to fewer sliver triangles
+				ear = stop = n(next).next;
+				continue;
+			}
+
+			ear = next;
+			if (ear == stop)
+			{
+				if (pass == 0)
+				{
+					clipEars(filterPoints(ear), 1);
+				}
+				else if (pass == 1)
+				{
+					clipEars(cureLocalIntersections(filterPoints(ear)), 2);
+				}
+				else
+				{
+					splitClip(ear);
+				}
+				break;
+			}
+		}
+	}
+
+	bool isEar(uint32_t ear) const
+	{
+		const Node& a = _nodes[_nodes[ear].prev];
+		const Node& b = _nodes[ear];
+		const Node& c = _nodes[_nodes[ear].next];
+		if (area(b.prev, ear, b.next) >= 0.0)
+		{
+			return false; // Reflex
+		}
+
+		// No vertex of the ring may lie in the ear
+		for (uint32_t p = c.next; p != b.prev; p = _nodes[p].next)
+		{
+			const Node& node = _nodes[p];
+			if (pointInTriangle(a.x, a.y, b.x, b.y, c.x, c.y, node.x, node.y) && area(node.prev, p, node.next) >= 0.0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool isEarHashed(uint32_t ear) const
+	{
+		const Node& a = _nodes[_nodes[ear].prev];
+		const Node& b = _nodes[ear];
+		const Node& c = _nodes[_nodes[ear].next];
+		if (area(b.prev, ear, b.next) >= 0.0)
+		{
+			return false; // Reflex
+		}
+
+		// Only the vertices within the z-order range of the bounding box of the ear can lie in it
+		const int32_t minZ = zOrder(std::min(a.x, std::min(b.x, c.x)), std::min(a.y, std::min(b.y, c.y)));
+		const int32_t maxZ = zOrder(std::max(a.x, std::max(b.x, c.x)), std::max(a.y, std::max(b.y, c.y)));
+
+		uint32_t p = b.prevZ;
+		uint32_t q = b.nextZ;
+		while (p != Null && _nodes[p].z >= minZ && q != Null && _nodes[q].z <= maxZ)
+		{
+			if (isInEar(p, ear, a, b, c))
+			{
+				return false;
+			}
+			p = _nodes[p].prevZ;
+			if (isInEar(q, ear, a, b, c))
+			{
+				return false;
+			}
+			q = _nodes[q].nextZ;
+		}
+		for (; p != Null && _nodes[p].z >= minZ; p = _nodes[p].prevZ)
+		{
+			if (isInEar(p, ear, a, b, c))
+			{
+				return false;
+			}
+		}
+		for (; q != Null && _nodes[q].z <= maxZ; q = _nodes[q].nextZ)
+		{
+			if (isInEar(q, ear, a, b, c))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool isInEar(uint32_t p, uint32_t ear, const Node& a, const Node& b, const Node& c) const
+	{
+		const Node& node = _nodes[p];
+		return p != b.prev && p != b.next && pointInTriangle(a.x, a.y, b.x, b.y, c.x, c.y, node.x, node.y) && area(node.prev, p, node.next) >= 0.0;
+	}
+
+	// Clip the ears formed by local self intersections (a - p - p.next - b where a-p and p.next-b cross)
+	uint32_t cureLocalIntersections(uint32_t start)
+	{
+		if (start == Null)
+		{
+			return start;
+		}
+		uint32_t p = start;
+		do
+		{
+			const uint32_t a = n(p).prev;
+			const uint32_t b = n(n(p).next).next;
+
+			if (!equals(a, b) && intersects(a, p, n(p).next, b) && locallyInside(a, b) && locallyInside(b, a))
+			{
+				_indices->push_back(n(a).i);
+				_indices->push_back(n(p).i);
+				_indices->push_back(n(b).i);
+				removeNode(n(p).next);
+				removeNode(p);
+				p = start = b;
+			}
+			p = n(p).next;
+		} while (p != start);
+
+		return filterPoints(p);
+	}
+
+	// Split the polygon in two along a valid diagonal and triangulate both halves
+	void splitClip(uint32_t start)
+	{
+		uint32_t a = start;
+		do
+		{
+			for (uint32_t b = n(n(a).next).next; b != n(a).prev; b = n(b).next)
+			{
+				if (n(a).i != n(b).i && isValidDiagonal(a, b))
+				{
+					uint32_t c = splitPolygon(a, b);
+					a = filterPoints(a, n(a).next);
+					c = filterPoints(c, n(c).next);
+					clipEars(a, 0);
+					clipEars(c, 0);
+					return;
+				}
+			}
+			a = n(a).next;
+		} while (a != start);
+	}
+
+	// Join every hole to the outer ring, from the leftmost hole to the rightmost
+	uint32_t eliminateHoles(const uint32_t* holeStarts, uint32_t numHoles, uint32_t numVertices, uint32_t outerNode)
+	{
+		_holeQueue.clear();
+		for (uint32_t h = 0; h < numHoles; ++h)
+		{
+			const uint32_t start = holeStarts[h];
+			const uint32_t end = h + 1 < numHoles ? holeStarts[h + 1] : numVertices;
+			const uint32_t list = linkRing(start, end, false);
+			if (list == Null)
+			{
+				continue;
+			}
+			if (list == n(list).next)
+			{
+				n(list).steiner = true;
+			}
+			_holeQueue.push_back(getLeftmost(list));
+		}
+
+		std::sort(_holeQueue.begin(), _holeQueue.end(), [this](uint32_t lhs, uint32_t rhs) { return _nodes[lhs].x < _nodes[rhs].x; });
+
+		for (uint32_t hole : _holeQueue)
+		{
+			outerNode = eliminateHole(hole, outerNode);
+		}
+		return outerNode;
+	}
+
+	uint32_t eliminateHole(uint32_t hole, uint32_t outerNode)
+	{
+		const uint32_t bridge = findHoleBridge(hole, outerNode);
+		if (bridge == Null)
+		{
+			return outerNode;
+		}
+
+		const uint32_t bridgeReverse = splitPolygon(bridge, hole);
+
+		// Filter the collinear points around the cuts
+		const uint32_t filteredBridge = filterPoints(bridge, n(bridge).next);
+		filterPoints(bridgeReverse, n(bridgeReverse).next);
+
+		// The outer node may have been removed by the filtering
+		return outerNode == bridge ? filteredBridge : outerNode;
+	}
+
+	// Find the vertex of the outer ring a hole can be connected to without crossing any edge (David Eberly's algorithm)
+	uint32_t findHoleBridge(uint32_t hole, uint32_t outerNode)
+	{
+		const double hx = n(hole).x;
+		const double hy = n(hole).y;
+		double qx = -std::numeric_limits<double>::infinity();
+		uint32_t m = Null;
+
+		// Find the segment of the outer ring to the left of the hole vertex which is the closest to it along a horizontal ray
+		uint32_t p = outerNode;
+		do
+		{
+			const Node& node = n(p);
+			const Node& next = n(node.next);
+			if (hy <= node.y && hy >= next.y && next.y != node.y)
+			{
+				const double x = node.x + (hy - node.y) * (next.x - node.x) / (next.y - node.y);
+				if (x <= hx && x > qx)
+				{
+					qx = x;
+					m = node.x < next.x ? p : node.next;
+					if (x == hx)
+					{
+						return m; // The hole touches the outer segment: pick its leftmost end
+					}
+				}
+			}
+			p = node.next;
+		} while (p != outerNode);
+
+		if (m == Null)
+		{
+			return Null;
+		}
+
+		// Look for vertices inside the triangle of the hole vertex, the segment intersection and the endpoint of the segment. If there are any, connect to
+		// the one with the smallest angle to the ray instead (the closest one if the angles are equal).
+		const uint32_t stop = m;
+		const double mx = n(m).x;
+		const double my = n(m).y;
+		double tanMin = std::numeric_limits<double>::infinity();
+
+		p = m;
+		do
+		{
+			const Node& node = n(p);
+			if (hx >= node.x && node.x >= mx && hx != node.x && pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, node.x, node.y))
+			{
+				const double tan = std::abs(hy - node.y) / (hx - node.x);
+				if (locallyInside(p, hole) && (tan < tanMin || (tan == tanMin && (node.x > n(m).x || (node.x == n(m).x && sectorContainsSector(m, p))))))
+				{
+					m = p;
+					tanMin = tan;
+				}
+			}
+			p = node.next;
+		} while (p != stop);
+
+		return m;
+	}
+
+	// Whether the sector of vertex m contains the sector of vertex p (both having the same coordinates)
+	bool sectorContainsSector(uint32_t m, uint32_t p) const
+	{
+		return area(_nodes[m].prev, m, _nodes[p].prev) < 0.0 && area(_nodes[p].next, m, _nodes[m].next) < 0.0;
+	}
+
+	uint32_t getLeftmost(uint32_t start) const
+	{
+		uint32_t p = start;
+		uint32_t leftmost = start;
+		do
+		{
+			if (_nodes[p].x < _nodes[leftmost].x || (_nodes[p].x == _nodes[leftmost].x && _nodes[p].y < _nodes[leftmost].y))
+			{
+				leftmost = p;
+			}
+			p = _nodes[p].next;
+		} while (p != start);
+		return leftmost;
+	}
+
+	// Whether a diagonal between a and b lies inside the polygon and does not cross any edge
+	bool isValidDiagonal(uint32_t a, uint32_t b) const
+	{
+		const Node& na = _nodes[a];
+		const Node& nb = _nodes[b];
+		return _nodes[na.next].i != nb.i && _nodes[na.prev].i != nb.i && !intersectsPolygon(a, b) &&
+			((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b) && (area(na.prev, a, nb.prev) != 0.0 || area(a, nb.prev, b) != 0.0)) ||
+				(equals(a, b) && area(na.prev, a, na.next) > 0.0 && area(nb.prev, b, nb.next) > 0.0));
+	}
+
+	static int sign(double value)
+	{
+		return value > 0.0 ? 1 : value < 0.0 ? -1 : 0;
+	}
+
+	// Whether q lies on the segment p-r, given that the three points are collinear
+	bool onSegment(uint32_t p, uint32_t q, uint32_t r) const
+	{
+		const Node& a = _nodes[p];
+		const Node& b = _nodes[q];
+		const Node& c = _nodes[r];
+		return b.x <= std::max(a.x, c.x) && b.x >= std::min(a.x, c.x) && b.y <= std::max(a.y, c.y) && b.y >= std::min(a.y, c.y);
+	}
+
+	// Whether the segments p1-q1 and p2-q2 intersect
+	bool intersects(uint32_t p1, uint32_t q1, uint32_t p2, uint32_t q2) const
+	{
+		const int o1 = sign(area(p1, q1, p2));
+		const int o2 = sign(area(p1, q1, q2));
+		const int o3 = sign(area(p2, q2, p1));
+		const int o4 = sign(area(p2, q2, q1));
+
+		return (o1 != o2 && o3 != o4) || (o1 == 0 && onSegment(p1, p2, q1)) || (o2 == 0 && onSegment(p1, q2, q1)) || (o3 == 0 && onSegment(p2, p1, q2)) ||
+			(o4 == 0 && onSegment(p2, q1, q2));
+	}
+
+	bool intersectsPolygon(uint32_t a, uint32_t b) const
+	{
+		const uint32_t ai = _nodes[a].i;
+		const uint32_t bi = _nodes[b].i;
+		uint32_t p = a;
+		do
+		{
+			const Node& node = _nodes[p];
+			const uint32_t nextI = _nodes[node.next].i;
+			if (node.i != ai && nextI != ai && node.i != bi && nextI != bi && intersects(p, node.next, a, b))
+			{
+				return true;
+			}
+			p = node.next;
+		} while (p != a);
+		return false;
+	}
+
+	// Whether the diagonal a-b starts into the inside of the polygon at a
+	bool locallyInside(uint32_t a, uint32_t b) const
+	{
+		const Node& na = _nodes[a];
+		return area(na.prev, a, na.next) < 0.0 ? area(a, b, na.next) >= 0.0 && area(a, na.prev, b) >= 0.0 : area(a, b, na.prev) < 0.0 || area(a, na.next, b) < 0.0;
+	}
+
+	// Whether the middle of the diagonal a-b is inside the polygon
+	bool middleInside(uint32_t a, uint32_t b) const
+	{
+		const double px = (_nodes[a].x + _nodes[b].x) / 2.0;
+		const double py = (_nodes[a].y + _nodes[b].y) / 2.0;
+		bool inside = false;
+		uint32_t p = a;
+		do
+		{
+			const Node& node = _nodes[p];
+			const Node& next = _nodes[node.next];
+			if (((node.y > py) != (next.y > py)) && next.y != node.y && (px < (next.x - node.x) * (py - node.y) / (next.y - node.y) + node.x))
+			{
+				inside = !inside;
+			}
+			p = node.next;
+		} while (p != a);
+		return inside;
+	}
+
+	// Link a and b with a diagonal, splitting the ring in two. If a and b are in different rings, they are merged into one instead.
+	// Returns the copy of b, which is in the ring that does not contain a.
+	uint32_t splitPolygon(uint32_t a, uint32_t b)
+	{
+		const uint32_t a2 = static_cast<uint32_t>(_nodes.size());
+		const uint32_t b2 = a2 + 1;
+		Node nodeA2 = n(a);
+		Node nodeB2 = n(b);
+		nodeA2.prevZ = nodeA2.nextZ = nodeB2.prevZ = nodeB2.nextZ = Null;
+		nodeA2.steiner = nodeB2.steiner = false;
+		_nodes.push_back(nodeA2);
+		_nodes.push_back(nodeB2);
+
+		const uint32_t an = n(a).next;
+		const uint32_t bp = n(b).prev;
+
+		n(a).next = b;
+		n(b).prev = a;
+
+		n(a2).next = an;
+		n(an).prev = a2;
+
+		n(a2).prev = b2;
+		n(b2).next = a2;
+
+		n(b2).prev = bp;
+		n(bp).next = b2;
+
+		return b2;
+	}
+
+	// Interleave the bits of the coordinates, relative to the bounding box of the outer ring, into a 30 bit z-order value. Vertices of holes sticking out
+	// of the box are clamped to it.
+	int32_t zOrder(double px, double py) const
+	{
+		uint32_t x = static_cast<uint32_t>(std::min(std::max((px - _minX) * _invSize, 0.0), 32767.0));
+		uint32_t y = static_cast<uint32_t>(std::min(std::max((py - _minY) * _invSize, 0.0), 32767.0));
+
+		x = (x | (x << 8)) & 0x00FF00FF;
+		x = (x | (x << 4)) & 0x0F0F0F0F;
+		x = (x | (x << 2)) & 0x33333333;
+		x = (x | (x << 1)) & 0x55555555;
+
+		y = (y | (y << 8)) & 0x00FF00FF;
+		y = (y | (y << 4)) & 0x0F0F0F0F;
+		y = (y | (y << 2)) & 0x33333333;
+		y = (y | (y << 1)) & 0x55555555;
+
+		return static_cast<int32_t>(x | (y << 1));
+	}
+
+	// Compute the z-order of every vertex of the ring and sort them into a separate linked list
+	void indexCurve(uint32_t start)
+	{
+		uint32_t p = start;
+		do
+		{
+			Node& node = n(p);
+			node.z = zOrder(node.x, node.y);
+			node.prevZ = node.prev;
+			node.nextZ = node.next;
+			p = node.next;
+		} while (p != start);
+
+		n(n(p).prevZ).nextZ = Null;
+		n(p).prevZ = Null;
+
+		sortLinked(p);
+	}
+
+	// Simon Tatham's linked list merge sort, on the z-order links
+	uint32_t sortLinked(uint32_t list)
+	{
+		uint32_t inSize = 1;
+		uint32_t numMerges;
+		do
+		{
+			uint32_t p = list;
+			uint32_t tail = Null;
+			list = Null;
+			numMerges = 0;
+
+			while (p != Null)
+			{
+				++numMerges;
+				uint32_t q = p;
+				uint32_t pSize = 0;
+				for (uint32_t i = 0; i < inSize; ++i)
+				{
+					++pSize;
+					q = n(q).nextZ;
+					if (q == Null)
+					{
+						break;
+					}
+				}
+				uint32_t qSize = inSize;
+
+				while (pSize > 0 || (qSize > 0 && q != Null))
+				{
+					uint32_t e;
+					if (pSize != 0 && (qSize == 0 || q == Null || n(p).z <= n(q).z))
+					{
+						e = p;
+						p = n(p).nextZ;
+						--pSize;
+					}
+					else
+					{
+						e = q;
+						q = n(q).nextZ;
+						--qSize;
+					}
+
+					if (tail != Null)
+					{
+						n(tail).nextZ = e;
+					}
+					else
+					{
+						list = e;
+					}
+					n(e).prevZ = tail;
+					tail = e;
+				}
+				p = q;
+			}
+			n(tail).nextZ = Null;
+			inSize *= 2;
+		} while (numMerges > 1);
+
+		return list;
+	}
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include "PVRCore/glm.h"
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+/*!*****************************************************************************
+Class PolylineSimplifier Simplifies polylines and rings with the Douglas-Peucker
+algorithm: a point is only kept if leaving it out would move the line by more
+than the tolerance. The points are read through a function, so that the caller
+can simplify ways without copying their co-ordinates, and the result is the
+indices of the points that are kept, in order.
+
+The recursion of the algorithm is replaced by an explicit stack, and the
+scratch memory is kept between calls, so a simplifier should be reused for all
+the ways of a map.
+********************************************************************************/
+class PolylineSimplifier
+{
+public:
+	/*!*********************************************************************************************************************
+	\param  numPoints The number of points of the polyline.
+	\param  getPoint A function returning the point at an index.
+	\param  tolerance The largest distance that the simplified polyline may be from the original one.
+	\param  outIndices Receives the indices of the points kept. The first and last points are always kept.
+	\brief  Simplify an open polyline.
+	***********************************************************************************************************************/
+	template<typename GetPoint>
+	void simplify(uint32_t numPoints, const GetPoint& getPoint, double tolerance, std::vector<uint32_t>& outIndices)
+	{
+		outIndices.clear();
+		if (numPoints < 3)
+		{
+			for (uint32_t i = 0; i < numPoints; ++i)
+			{
+				outIndices.push_back(i);
+			}
+			return;
+		}
+		_keep.assign(numPoints, 0);
+		_keep[0] = _keep[numPoints - 1] = 1;
+		simplifyRange(0, numPoints - 1, getPoint, tolerance * tolerance);
+		collect(numPoints, outIndices);
+	}
+
+	/*!*********************************************************************************************************************
+	\param  numPoints The number of points of the ring, without repeating the first point at the end.
+	\param  getPoint A function returning the point at an index.
+	\param  tolerance The largest distance that the simplified ring may be from the original one.
+	\param  outIndices Receives the indices of the points kept. Fewer than three indices are returned if the ring
+			collapses, which happens when it is no larger than the tolerance.
+	\brief  Simplify a closed ring. The first point and the point furthest from it are always kept.
+	***********************************************************************************************************************/
+	template<typename GetPoint>
+	void simplifyRing(uint32_t numPoints, const GetPoint& getPoint, double tolerance, std::vector<uint32_t>& outIndices)
+	{
+		outIndices.clear();
+		if (numPoints < 3)
+		{
+			return;
+		}
+
+		// Split the ring in two polylines between the first point and the point furthest from it
+		const glm::dvec2 first = getPoint(0);
+		uint32_t furthest = 0;
+		double furthestDistanceSquared = 0.0;
+		for (uint32_t i = 1; i < numPoints; ++i)
+		{
+			const glm::dvec2 offset = getPoint(i) - first;
+			const double distanceSquared = glm::dot(offset, offset);
+			if (distanceSquared > furthestDistanceSquared)
+			{
+				furthest = i;
+				furthestDistanceSquared = distanceSquared;
+			}
+		}
+		if (furthestDistanceSquared <= tolerance * tolerance)
+		{
+			return;
+		}
+
+		// Point numPoints is the first point again, closing the ring
+		auto getRingPoint = [&](uint32_t index) { return getPoint(index == numPoints ? 0 : index); };
+		_keep.assign(numPoints + 1, 0);
+		_keep[0] = _keep[furthest] = _keep[numPoints] = 1;
+		simplifyRange(0, furthest, getRingPoint, tolerance * tolerance);
+		simplifyRange(furthest, numPoints, getRingPoint, tolerance * tolerance);
+		collect(numPoints, outIndices);
+	}
+
+private:
+	// Mark the points between first and last that are kept
+	template<typename GetPoint>
+	void simplifyRange(uint32_t first, uint32_t last, const GetPoint& getPoint, double toleranceSquared)
+	{
+		_stack.clear();
+		_stack.push_back(std::make_pair(first, last));
+		while (!_stack.empty())
+		{
+			const std::pair<uint32_t, uint32_t> range = _stack.back();
+			_stack.pop_back();
+
+			const glm::dvec2 start = getPoint(range.first);
+			const glm::dvec2 segment = getPoint(range.second) - start;
+			const double segmentLengthSquared = glm::dot(segment, segment);
+			uint32_t furthest = range.first;
+			double furthestDistanceSquared = toleranceSquared;
+			for (uint32_t i = range.first + 1; i < range.second; ++i)
+			{
+				// Distance from the point to the segment between the ends of the range
+				const glm::dvec2 offset = getPoint(i) - start;
+				const double t = segmentLengthSquared > 0.0 ? glm::clamp(glm::dot(offset, segment) / segmentLengthSquared, 0.0, 1.0) : 0.0;
+				const glm::dvec2 distance = offset - segment * t;
+				const double distanceSquared = glm::dot(distance, distance);
+				if (distanceSquared > furthestDistanceSquared)
+				{
+					furthest = i;
+					furthestDistanceSquared = distanceSquared;
+				}
+			}
+
+			if (furthest != range.first)
+			{
+				_keep[furthest] = 1;
+				_stack.push_back(std::make_pair(range.first, furthest));
+				_stack.push_back(std::make_pair(furthest, range.second));
+			}
+		}
+	}
+
+	void collect(uint32_t numPoints, std::vector<uint32_t>& outIndices) const
+	{
+		for (uint32_t i = 0; i < numPoints; ++i)
+		{
+			if (_keep[i])
+			{
+				outIndices.push_back(i);
+			}
+		}
+	}
+
+	std::vector<uint8_t> _keep;
+	std::vector<std::pair<uint32_t, uint32_t> > _stack;
+};
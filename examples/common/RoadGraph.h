@@ -0,0 +1,300 @@
+#pragma once
+#include "PVRCore/glm.h"
+#include "PVRCore/Log.h"
+#include <vector>
+#include <queue>
+#include <map>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+/*!*****************************************************************************
+Class RoadGraph A directed graph of the road network, stored in compressed sparse
+row form: the edges leaving a node are contiguous, and the edges of node i are
+edges[offsets[i]] to edges[offsets[i + 1] - 1]. Edges are added one at a time and
+sorted into place when the graph is built, after which it is read-only and can be
+queried from several threads.
+
+Every edge has a length and a cost, which is the time it takes to travel along
+it. Routes minimise the cost with an A* search whose heuristic is the straight
+line distance to the goal at the highest speed of any edge, so the route found is
+always the fastest one.
+********************************************************************************/
+class RoadGraph
+{
+public:
+	struct Edge
+	{
+		uint32_t target;
+		uint32_t name;
+		float length;
+		float cost;
+	};
+	static const uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+	RoadGraph() : _maxSpeed(0.0) {}
+
+	void clear()
+	{
+		_coords.clear();
+		_offsets.clear();
+		_edges.clear();
+		_names.clear();
+		_nameIndices.clear();
+		_sources.clear();
+		_maxSpeed = 0.0;
+	}
+
+	uint32_t getNumNodes() const
+	{
+		return static_cast<uint32_t>(_coords.size());
+	}
+
+	uint32_t getNumEdges() const
+	{
+		return static_cast<uint32_t>(_edges.size());
+	}
+
+	const glm::dvec2& getCoords(uint32_t node) const
+	{
+		return _coords[node];
+	}
+
+	const Edge& getEdge(uint32_t edge) const
+	{
+		return _edges[edge];
+	}
+
+	const std::string& getName(uint32_t name) const
+	{
+		return _names[name];
+	}
+
+	const std::vector<glm::dvec2>& getNodeCoords() const
+	{
+		return _coords;
+	}
+
+	const std::vector<uint32_t>& getOffsets() const
+	{
+		return _offsets;
+	}
+
+	const std::vector<Edge>& getEdges() const
+	{
+		return _edges;
+	}
+
+	const std::vector<std::string>& getNames() const
+	{
+		return _names;
+	}
+
+	/*!*********************************************************************************************************************
+	\param  coords The position of the node.
+	\return The index of the node.
+	\brief  Add a node. All the nodes and edges must be added before the graph is built.
+	***********************************************************************************************************************/
+	uint32_t addNode(const glm::dvec2& coords)
+	{
+		debug_assertion(_offsets.empty(), "RoadGraph: Nodes cannot be added to a graph that has been built");
+		_coords.push_back(coords);
+		return static_cast<uint32_t>(_coords.size() - 1);
+	}
+
+	/*!*********************************************************************************************************************
+	\param  name The name of a road.
+	\return The index of the name. Roads with the same name share the same index.
+	\brief  Add the name of a road, for the edges of the road to refer to.
+	***********************************************************************************************************************/
+	uint32_t addName(const std::string& name)
+	{
+		auto it = _nameIndices.find(name);
+		if (it == _nameIndices.end())
+		{
+			it = _nameIndices.insert(std::make_pair(name, static_cast<uint32_t>(_names.size()))).first;
+			_names.push_back(name);
+		}
+		return it->second;
+	}
+
+	/*!*********************************************************************************************************************
+	\param  source The node the edge leaves.
+	\param  target The node the edge arrives at.
+	\param  speed The speed at which the edge is travelled, which must be greater than zero.
+	\param  name The index of the name of the road the edge belongs to.
+	\brief  Add an edge. Two way roads need an edge in each direction.
+	***********************************************************************************************************************/
+	void addEdge(uint32_t source, uint32_t target, double speed, uint32_t name)
+	{
+		debug_assertion(_offsets.empty(), "RoadGraph: Edges cannot be added to a graph that has been built");
+		debug_assertion(speed > 0.0, "RoadGraph: The speed of an edge must be greater than zero");
+		const double length = glm::distance(_coords[source], _coords[target]);
+		_sources.push_back(source);
+		_edges.push_back(Edge{ target, name, static_cast<float>(length), static_cast<float>(length / speed) });
+	}
+
+	/*!*********************************************************************************************************************
+	\brief  Sort the edges by the node they leave. The edges of each node keep the order in which they were added.
+	***********************************************************************************************************************/
+	void build()
+	{
+		if (!_offsets.empty())
+		{
+			return;
+		}
+		_offsets.assign(_coords.size() + 1, 0);
+		for (uint32_t source : _sources)
+		{
+			++_offsets[source + 1];
+		}
+		for (size_t i = 1; i < _offsets.size(); ++i)
+		{
+			_offsets[i] += _offsets[i - 1];
+		}
+
+		std::vector<Edge> edges(_edges.size());
+		std::vector<uint32_t> next(_offsets.begin(), _offsets.end() - 1);
+		for (size_t i = 0; i < _edges.size(); ++i)
+		{
+			edges[next[_sources[i]]++] = _edges[i];
+		}
+		_edges.swap(edges);
+		_sources.clear();
+		_nameIndices.clear();
+		calculateMaxSpeed();
+	}
+
+	/*!*********************************************************************************************************************
+	\param  coords The position of every node.
+	\param  offsets The offset of the first edge of every node, followed by the number of edges.
+	\param  edges The edges, sorted by the node they leave.
+	\param  names The names of the roads.
+	\brief  Replace the graph with one that has already been built, checking that it is consistent.
+	***********************************************************************************************************************/
+	void assign(std::vector<glm::dvec2> coords, std::vector<uint32_t> offsets, std::vector<Edge> edges, std::vector<std::string> names)
+	{
+		if (offsets.size() != coords.size() + 1 || offsets.front() != 0 || offsets.back() != edges.size())
+		{
+			throw std::runtime_error("RoadGraph: The offsets do not match the nodes and edges");
+		}
+		for (size_t i = 1; i < offsets.size(); ++i)
+		{
+			if (offsets[i] < offsets[i - 1])
+			{
+				throw std::runtime_error("RoadGraph: The offsets are not sorted");
+			}
+		}
+		for (const Edge& edge : edges)
+		{
+			if (edge.target >= coords.size() || edge.name >= names.size() || !(edge.cost >= 0.0f))
+			{
+				throw std::runtime_error("RoadGraph: Invalid edge");
+			}
+		}
+		clear();
+		_coords.swap(coords);
+		_offsets.swap(offsets);
+		_edges.swap(edges);
+		_names.swap(names);
+		calculateMaxSpeed();
+	}
+
+	/*!*********************************************************************************************************************
+	\param  start The node the route starts at.
+	\param  goal The node the route ends at.
+	\param  outEdges Receives the edges of the route, in order.
+	\return True if the goal can be reached from the start.
+	\brief  Find the fastest route between two nodes.
+	***********************************************************************************************************************/
+	bool findRoute(uint32_t start, uint32_t goal, std::vector<uint32_t>& outEdges) const
+	{
+		outEdges.clear();
+		if (start >= getNumNodes() || goal >= getNumNodes() || _offsets.empty())
+		{
+			return false;
+		}
+		if (start == goal)
+		{
+			return true;
+		}
+
+		struct Entry
+		{
+			double estimate;
+			double cost;
+			uint32_t node;
+			bool operator<(const Entry& other) const
+			{
+				return estimate > other.estimate;
+			}
+		};
+		const double invMaxSpeed = 1.0 / _maxSpeed;
+		const glm::dvec2& goalCoords = _coords[goal];
+
+		std::vector<double> costs(_coords.size(), std::numeric_limits<double>::infinity());
+		std::vector<uint32_t> parentEdges(_coords.size(), InvalidIndex);
+		std::vector<uint32_t> parents(_coords.size(), InvalidIndex);
+		std::priority_queue<Entry> open;
+		costs[start] = 0.0;
+		open.push(Entry{ glm::distance(_coords[start], goalCoords) * invMaxSpeed, 0.0, start });
+
+		while (!open.empty())
+		{
+			const Entry entry = open.top();
+			open.pop();
+			if (entry.cost > costs[entry.node])
+			{
+				continue; // Reached the node again by a faster route since this entry was queued
+			}
+			if (entry.node == goal)
+			{
+				for (uint32_t node = goal; node != start; node = parents[node])
+				{
+					outEdges.push_back(parentEdges[node]);
+				}
+				std::reverse(outEdges.begin(), outEdges.end());
+				return true;
+			}
+
+			for (uint32_t i = _offsets[entry.node]; i < _offsets[entry.node + 1]; ++i)
+			{
+				const Edge& edge = _edges[i];
+				const double cost = entry.cost + edge.cost;
+				if (cost < costs[edge.target])
+				{
+					costs[edge.target] = cost;
+					parentEdges[edge.target] = i;
+					parents[edge.target] = entry.node;
+					open.push(Entry{ cost + glm::distance(_coords[edge.target], goalCoords) * invMaxSpeed, cost, edge.target });
+				}
+			}
+		}
+		return false;
+	}
+
+private:
+	void calculateMaxSpeed()
+	{
+		_maxSpeed = 0.0;
+		for (const Edge& edge : _edges)
+		{
+			if (edge.cost > 0.0f)
+			{
+				_maxSpeed = std::max(_maxSpeed, static_cast<double>(edge.length) / edge.cost);
+			}
+		}
+		// Scale the speed up slightly so that the heuristic never overestimates because of rounding
+		_maxSpeed = _maxSpeed > 0.0 ? _maxSpeed * 1.0001 : 1.0;
+	}
+
+	std::vector<glm::dvec2> _coords;
+	std::vector<uint32_t> _offsets;
+	std::vector<Edge> _edges;
+	std::vector<std::string> _names;
+	std::map<std::string, uint32_t> _nameIndices;
+	std::vector<uint32_t> _sources;
+	double _maxSpeed;
+};
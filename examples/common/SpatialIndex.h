@@ -0,0 +1,400 @@
+#pragma once
+#include "PVRCore/glm.h"
+#include "PVRCore/Log.h"
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+/*!*****************************************************************************
+Class UniformGrid Finds the cell of a regular grid that a point lies in, in
+constant time. The grid is described by its minimum corner and the maximum edge
+of every column and row, so that the lookup agrees exactly with the bounds stored
+in the cells: a point on the edge between two cells belongs to the lower one, and
+points outside of the grid are clamped to the closest cell.
+********************************************************************************/
+class UniformGrid
+{
+public:
+	UniformGrid() : _min(0.0), _invCellSize(0.0) {}
+
+	/*!*********************************************************************************************************************
+	\param  min The minimum corner of the grid.
+	\param  columnMax The maximum x coordinate of every column, in increasing order.
+	\param  rowMax The maximum y coordinate of every row, in increasing order.
+	\brief  Initialise the grid.
+	***********************************************************************************************************************/
+	void init(const glm::dvec2& min, const std::vector<double>& columnMax, const std::vector<double>& rowMax)
+	{
+		_min = min;
+		_columnMax = columnMax;
+		_rowMax = rowMax;
+		_invCellSize.x = columnMax.empty() || columnMax.back() <= min.x ? 0.0 : columnMax.size() / (columnMax.back() - min.x);
+		_invCellSize.y = rowMax.empty() || rowMax.back() <= min.y ? 0.0 : rowMax.size() / (rowMax.back() - min.y);
+	}
+
+	uint32_t getNumCols() const
+	{
+		return static_cast<uint32_t>(_columnMax.size());
+	}
+
+	uint32_t getNumRows() const
+	{
+		return static_cast<uint32_t>(_rowMax.size());
+	}
+
+	/*!*********************************************************************************************************************
+	\param  point The point to look up.
+	\return The column and row of the cell that contains the point.
+	***********************************************************************************************************************/
+	glm::uvec2 findCell(const glm::dvec2& point) const
+	{
+		return glm::uvec2(findSlot(point.x, _min.x, _invCellSize.x, _columnMax), findSlot(point.y, _min.y, _invCellSize.y, _rowMax));
+	}
+
+	/*!*********************************************************************************************************************
+	\param  min The minimum corner of the box.
+	\param  max The maximum corner of the box.
+	\param  outMinCell Receives the column and row of the first cell that the box overlaps.
+	\param  outMaxCell Receives the column and row of the last cell that the box overlaps.
+	\brief  Find the range of cells overlapped by a box.
+	***********************************************************************************************************************/
+	void findCells(const glm::dvec2& min, const glm::dvec2& max, glm::uvec2& outMinCell, glm::uvec2& outMaxCell) const
+	{
+		outMinCell = findCell(min);
+		outMaxCell = findCell(max);
+	}
+
+	glm::dvec2 getCellMin(const glm::uvec2& cell) const
+	{
+		return glm::dvec2(cell.x ? _columnMax[cell.x - 1] : _min.x, cell.y ? _rowMax[cell.y - 1] : _min.y);
+	}
+
+	glm::dvec2 getCellMax(const glm::uvec2& cell) const
+	{
+		return glm::dvec2(_columnMax[cell.x], _rowMax[cell.y]);
+	}
+
+private:
+	static uint32_t findSlot(double value, double origin, double invCellSize, const std::vector<double>& edges)
+	{
+		if (edges.empty())
+		{
+			return 0;
+		}
+		const uint32_t last = static_cast<uint32_t>(edges.size() - 1);
+		const double estimate = std::floor((value - origin) * invCellSize);
+		uint32_t slot = !(estimate > 0.0) ? 0u : estimate >= last ? last : static_cast<uint32_t>(estimate);
+
+		// The cells are only uniform up to rounding, so settle on the first cell whose maximum edge is not below the value
+		while (slot > 0 && value <= edges[slot - 1])
+		{
+			--slot;
+		}
+		while (slot < last && value > edges[slot])
+		{
+			++slot;
+		}
+		return slot;
+	}
+
+	glm::dvec2 _min;
+	glm::dvec2 _invCellSize;
+	std::vector<double> _columnMax;
+	std::vector<double> _rowMax;
+};
+
+/*!*****************************************************************************
+Class PackedRTree A static R-tree over axis aligned boxes, built in one pass once
+all the boxes have been added. The boxes are sorted along a Hilbert curve through
+the centres of the boxes and packed NodeSize at a time into the nodes of each
+level, so the tree is balanced, every node but the last of a level is full and
+the whole tree lives in two flat arrays.
+
+Box queries visit only the nodes that overlap the query box, and nearest
+queries visit the nodes in order of their distance to the query point, so both
+take O(log n) for the small results that picking and label placement ask for.
+Items are identified by the order in which they were added. The tree is
+read-only once built, so it can be queried from several threads.
+********************************************************************************/
+class PackedRTree
+{
+public:
+	enum
+	{
+		NodeSize = 16
+	};
+	static const uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+	PackedRTree() : _numItems(0) {}
+
+	void clear()
+	{
+		_boxes.clear();
+		_indices.clear();
+		_levelEnds.clear();
+		_numItems = 0;
+	}
+
+	void reserve(uint32_t numItems)
+	{
+		_boxes.reserve(numItems + numItems / (NodeSize - 1) + 1);
+		_indices.reserve(numItems + numItems / (NodeSize - 1) + 1);
+	}
+
+	uint32_t size() const
+	{
+		return _numItems;
+	}
+
+	bool empty() const
+	{
+		return _numItems == 0;
+	}
+
+	/*!*********************************************************************************************************************
+	\param  min The minimum corner of the box of the item.
+	\param  max The maximum corner of the box of the item.
+	\return The index of the item.
+	\brief  Add an item. All the items must be added before the tree is built.
+	***********************************************************************************************************************/
+	uint32_t add(const glm::dvec2& min, const glm::dvec2& max)
+	{
+		debug_assertion(_levelEnds.empty(), "PackedRTree: Items cannot be added to a tree that has been built");
+		_boxes.push_back(Box{ min, max });
+		_indices.push_back(_numItems);
+		return _numItems++;
+	}
+
+	/*!*********************************************************************************************************************
+	\brief  Sort the items and build the levels of the tree above them.
+	***********************************************************************************************************************/
+	void build()
+	{
+		if (!_numItems || !_levelEnds.empty())
+		{
+			return;
+		}
+
+		if (_numItems > NodeSize)
+		{
+			Box bounds = _boxes[0];
+			for (uint32_t i = 1; i < _numItems; ++i)
+			{
+				bounds.expand(_boxes[i]);
+			}
+			const glm::dvec2 extent = bounds.max - bounds.min;
+			const glm::dvec2 scale(extent.x > 0.0 ? 65535.0 / extent.x : 0.0, extent.y > 0.0 ? 65535.0 / extent.y : 0.0);
+
+			std::vector<std::pair<uint32_t, uint32_t> > order(_numItems);
+			for (uint32_t i = 0; i < _numItems; ++i)
+			{
+				const glm::dvec2 centre = ((_boxes[i].min + _boxes[i].max) * 0.5 - bounds.min) * scale;
+				order[i] = std::make_pair(hilbertIndex(static_cast<uint32_t>(centre.x), static_cast<uint32_t>(centre.y)), i);
+			}
+			std::sort(order.begin(), order.end());
+
+			std::vector<Box> sortedBoxes(_numItems);
+			for (uint32_t i = 0; i < _numItems; ++i)
+			{
+				sortedBoxes[i] = _boxes[order[i].second];
+				_indices[i] = order[i].second;
+			}
+			_boxes.swap(sortedBoxes);
+		}
+
+		// Every node stores the position of its first child, the children of a node are the next NodeSize entries of the level below
+		uint32_t levelStart = 0;
+		uint32_t levelEnd = _numItems;
+		_levelEnds.push_back(levelEnd);
+		do
+		{
+			for (uint32_t i = levelStart; i < levelEnd; i += NodeSize)
+			{
+				Box node = _boxes[i];
+				for (uint32_t j = i + 1; j < std::min(i + NodeSize, levelEnd); ++j)
+				{
+					node.expand(_boxes[j]);
+				}
+				_boxes.push_back(node);
+				_indices.push_back(i);
+			}
+			levelStart = levelEnd;
+			levelEnd = static_cast<uint32_t>(_boxes.size());
+			_levelEnds.push_back(levelEnd);
+		} while (levelEnd - levelStart > 1);
+	}
+
+	/*!*********************************************************************************************************************
+	\param  min The minimum corner of the query box.
+	\param  max The maximum corner of the query box.
+	\param  visitor Called with the index of every item whose box overlaps the query box, in no particular order.
+	\brief  Find the items overlapping a box.
+	***********************************************************************************************************************/
+	template<typename Visitor>
+	void query(const glm::dvec2& min, const glm::dvec2& max, const Visitor& visitor) const
+	{
+		if (_levelEnds.empty())
+		{
+			return;
+		}
+		const Box queryBox = { min, max };
+		std::vector<std::pair<uint32_t, uint32_t> > stack;
+		stack.push_back(std::make_pair(static_cast<uint32_t>(_boxes.size() - 1), static_cast<uint32_t>(_levelEnds.size() - 1)));
+		while (!stack.empty())
+		{
+			const uint32_t node = stack.back().first;
+			const uint32_t level = stack.back().second;
+			stack.pop_back();
+
+			const uint32_t end = std::min(_indices[node] + NodeSize, _levelEnds[level - 1]);
+			for (uint32_t child = _indices[node]; child < end; ++child)
+			{
+				if (!_boxes[child].overlaps(queryBox))
+				{
+					continue;
+				}
+				if (level == 1)
+				{
+					visitor(_indices[child]);
+				}
+				else
+				{
+					stack.push_back(std::make_pair(child, level - 1));
+				}
+			}
+		}
+	}
+
+	/*!*********************************************************************************************************************
+	\param  min The minimum corner of the query box.
+	\param  max The maximum corner of the query box.
+	\param  outItems Receives the indices of the items whose boxes overlap the query box. Items are appended.
+	\brief  Find the items overlapping a box.
+	***********************************************************************************************************************/
+	void query(const glm::dvec2& min, const glm::dvec2& max, std::vector<uint32_t>& outItems) const
+	{
+		query(min, max, [&](uint32_t item) { outItems.push_back(item); });
+	}
+
+	/*!*********************************************************************************************************************
+	\param  point The query point.
+	\param  maxDistance Items further away than this are ignored.
+	\param  itemDistanceSquared Returns the squared distance from the query point to the item with the given index. It
+			must not be less than the squared distance to the box of the item.
+	\param  outDistance Optionally receives the distance to the nearest item.
+	\return The index of the nearest item, or InvalidIndex if there is no item within maxDistance.
+	\brief  Find the item nearest to a point.
+	***********************************************************************************************************************/
+	template<typename DistanceFunction>
+	uint32_t nearest(const glm::dvec2& point, double maxDistance, const DistanceFunction& itemDistanceSquared, double* outDistance = nullptr) const
+	{
+		if (_levelEnds.empty())
+		{
+			return InvalidIndex;
+		}
+		const double maxDistanceSquared = maxDistance * maxDistance;
+
+		// Entries of level 0 are items with their exact distance, the others are nodes with the distance to their box
+		struct Entry
+		{
+			double distanceSquared;
+			uint32_t position;
+			uint32_t level;
+			bool operator<(const Entry& rhs) const
+			{
+				return distanceSquared > rhs.distanceSquared;
+			}
+		};
+		std::priority_queue<Entry> queue;
+		const uint32_t root = static_cast<uint32_t>(_boxes.size() - 1);
+		queue.push(Entry{ _boxes[root].distanceSquared(point), root, static_cast<uint32_t>(_levelEnds.size() - 1) });
+
+		while (!queue.empty() && queue.top().distanceSquared <= maxDistanceSquared)
+		{
+			const Entry entry = queue.top();
+			queue.pop();
+			if (entry.level == 0)
+			{
+				if (outDistance)
+				{
+					*outDistance = std::sqrt(entry.distanceSquared);
+				}
+				return entry.position;
+			}
+
+			const uint32_t end = std::min(_indices[entry.position] + NodeSize, _levelEnds[entry.level - 1]);
+			for (uint32_t child = _indices[entry.position]; child < end; ++child)
+			{
+				if (_boxes[child].distanceSquared(point) > maxDistanceSquared)
+				{
+					continue;
+				}
+				if (entry.level == 1)
+				{
+					const double distanceSquared = itemDistanceSquared(_indices[child]);
+					if (distanceSquared <= maxDistanceSquared)
+					{
+						queue.push(Entry{ distanceSquared, _indices[child], 0 });
+					}
+				}
+				else
+				{
+					queue.push(Entry{ _boxes[child].distanceSquared(point), child, entry.level - 1 });
+				}
+			}
+		}
+		return InvalidIndex;
+	}
+
+private:
+	struct Box
+	{
+		glm::dvec2 min;
+		glm::dvec2 max;
+
+		void expand(const Box& box)
+		{
+			min = glm::min(min, box.min);
+			max = glm::max(max, box.max);
+		}
+		bool overlaps(const Box& box) const
+		{
+			return min.x <= box.max.x && min.y <= box.max.y && max.x >= box.min.x && max.y >= box.min.y;
+		}
+		double distanceSquared(const glm::dvec2& point) const
+		{
+			const glm::dvec2 offset = glm::max(glm::max(min - point, point - max), glm::dvec2(0.0));
+			return glm::dot(offset, offset);
+		}
+	};
+
+	// The position of (x, y) along a Hilbert curve filling a 65536 x 65536 grid
+	static uint32_t hilbertIndex(uint32_t x, uint32_t y)
+	{
+		uint32_t index = 0;
+		for (uint32_t s = 1u << 15; s > 0; s >>= 1)
+		{
+			const uint32_t rx = (x & s) ? 1u : 0u;
+			const uint32_t ry = (y & s) ? 1u : 0u;
+			index += s * s * ((3u * rx) ^ ry);
+			if (ry == 0)
+			{
+				if (rx == 1)
+				{
+					x = 65535u - x;
+					y = 65535u - y;
+				}
+				std::swap(x, y);
+			}
+		}
+		return index;
+	}
+
+	std::vector<Box> _boxes; // The items, followed by the nodes of every level up to the root
+	std::vector<uint32_t> _indices; // The item index of every item, and the position of the first child of every node
+	std::vector<uint32_t> _levelEnds; // The end of every level in _boxes
+	uint32_t _numItems;
+};
@@ -0,0 +1,197 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+/*!*****************************************************************************
+Class TileResidency Decides which tiles of a map are kept in GPU memory. Every
+frame the renderer requests the tiles it needs: the visible tiles, and the tiles
+around them so that they are loaded before the camera reaches them. Requested
+tiles that are not resident are loaded a few per frame, most urgent first, and
+when the resident and loading tiles use more memory than the budget the tiles
+that were requested least recently are evicted. A tile counts against the budget
+from the frame it starts loading, so loads that take several frames to complete
+cannot overshoot it.
+
+Tiles requested by any of the frames in flight are never evicted, and tiles that
+are not visible are not loaded unless they fit in the budget, so the visible
+tiles are always loaded even if they do not fit in the budget. The renderer
+creates and releases the resources of the tiles and sets the size of each tile;
+this class only tracks their state.
+********************************************************************************/
+class TileResidency
+{
+public:
+	enum class State : uint8_t
+	{
+		Unloaded,
+		Loading,
+		Resident
+	};
+
+	TileResidency() : _budget(0), _usedSize(0), _numFramesInFlight(1), _maxLoadsPerFrame(1), _frame(0) {}
+
+	/*!*********************************************************************************************************************
+	\param  numTiles The number of tiles of the map.
+	\param  budget The number of bytes the resident and loading tiles may use before the least recently requested ones are evicted.
+	\param  numFramesInFlight The number of frames that may be using the resources of a tile after it was last requested.
+	\param  maxLoadsPerFrame The largest number of tiles that start loading in a frame.
+	\brief  Forget the state and the size of all the tiles, which all start unloaded.
+	***********************************************************************************************************************/
+	void init(uint32_t numTiles, uint64_t budget, uint32_t numFramesInFlight, uint32_t maxLoadsPerFrame)
+	{
+		_tiles.assign(numTiles, TileEntry());
+		_requests.clear();
+		_budget = budget;
+		_usedSize = 0;
+		_numFramesInFlight = std::max(numFramesInFlight, 1u);
+		_maxLoadsPerFrame = std::max(maxLoadsPerFrame, 1u);
+		_frame = _numFramesInFlight;
+	}
+
+	/*!*********************************************************************************************************************
+	\param  tile The index of an unloaded tile.
+	\param  size The number of bytes the resources of the tile use once it is loaded.
+	\brief  Set the size of a tile, which is counted against the budget while the tile is loading or resident.
+	***********************************************************************************************************************/
+	void setSize(uint32_t tile, uint64_t size)
+	{
+		_tiles[tile].size = size;
+	}
+
+	/*!*********************************************************************************************************************
+	\brief  Start a new frame. Call before requesting the tiles of the frame.
+	***********************************************************************************************************************/
+	void beginFrame()
+	{
+		++_frame;
+		_requests.clear();
+	}
+
+	/*!*********************************************************************************************************************
+	\param  tile The index of the tile.
+	\param  priority Tiles with lower values are loaded first.
+	\param  isVisible Whether the tile is drawn this frame. Tiles that are not visible are only loaded if they fit in the budget.
+	\brief  Request a tile for the current frame, which also keeps it from being evicted while the frame is in flight.
+	***********************************************************************************************************************/
+	void request(uint32_t tile, float priority, bool isVisible)
+	{
+		TileEntry& entry = _tiles[tile];
+		if (entry.lastRequestedFrame != _frame)
+		{
+			entry.lastRequestedFrame = _frame;
+			_requests.push_back(Request{ priority, tile, isVisible });
+		}
+	}
+
+	/*!*********************************************************************************************************************
+	\param  outLoads Receives the tiles whose resources the renderer must start loading. They are now loading.
+	\param  outEvictions Receives the tiles whose resources the renderer must release. They are now unloaded.
+	\brief  Decide which tiles to load and evict this frame. Call once per frame, after all the tiles have been requested.
+	***********************************************************************************************************************/
+	void update(std::vector<uint32_t>& outLoads, std::vector<uint32_t>& outEvictions)
+	{
+		outLoads.clear();
+		outEvictions.clear();
+
+		// Evict the least recently requested tiles until the resident and loading tiles fit in the budget. Loading tiles are
+		// still being written, so only resident tiles can be evicted.
+		while (_usedSize > _budget)
+		{
+			uint32_t oldest = static_cast<uint32_t>(_tiles.size());
+			for (uint32_t i = 0; i < _tiles.size(); ++i)
+			{
+				const TileEntry& entry = _tiles[i];
+				if (entry.state == State::Resident && entry.lastRequestedFrame + _numFramesInFlight <= _frame &&
+					(oldest == _tiles.size() || entry.lastRequestedFrame < _tiles[oldest].lastRequestedFrame))
+				{
+					oldest = i;
+				}
+			}
+			if (oldest == _tiles.size())
+			{
+				break; // Every resident tile is still in use
+			}
+			TileEntry& entry = _tiles[oldest];
+			entry.state = State::Unloaded;
+			_usedSize -= entry.size;
+			outEvictions.push_back(oldest);
+		}
+
+		std::stable_sort(_requests.begin(), _requests.end(), [](const Request& a, const Request& b) {
+			return a.isVisible != b.isVisible ? a.isVisible : a.priority < b.priority;
+		});
+		for (const Request& request : _requests)
+		{
+			if (outLoads.size() == _maxLoadsPerFrame)
+			{
+				break;
+			}
+			TileEntry& entry = _tiles[request.tile];
+			if (entry.state == State::Unloaded)
+			{
+				if (!request.isVisible && _usedSize + entry.size > _budget)
+				{
+					break;
+				}
+				entry.state = State::Loading;
+				_usedSize += entry.size;
+				outLoads.push_back(request.tile);
+			}
+		}
+	}
+
+	/*!*********************************************************************************************************************
+	\param  tile The index of a loading tile.
+	\brief  Record that the resources of a tile have finished loading.
+	***********************************************************************************************************************/
+	void setResident(uint32_t tile)
+	{
+		_tiles[tile].state = State::Resident;
+	}
+
+	State getState(uint32_t tile) const
+	{
+		return _tiles[tile].state;
+	}
+
+	uint64_t getSize(uint32_t tile) const
+	{
+		return _tiles[tile].size;
+	}
+
+	// Return the number of bytes used by the resident and loading tiles.
+	uint64_t getUsedSize() const
+	{
+		return _usedSize;
+	}
+
+	uint64_t getBudget() const
+	{
+		return _budget;
+	}
+
+private:
+	struct TileEntry
+	{
+		State state;
+		uint64_t size;
+		uint64_t lastRequestedFrame;
+		TileEntry() : state(State::Unloaded), size(0), lastRequestedFrame(0) {}
+	};
+
+	struct Request
+	{
+		float priority;
+		uint32_t tile;
+		bool isVisible;
+	};
+
+	std::vector<TileEntry> _tiles;
+	std::vector<Request> _requests;
+	uint64_t _budget;
+	uint64_t _usedSize;
+	uint32_t _numFramesInFlight;
+	uint32_t _maxLoadsPerFrame;
+	uint64_t _frame;
+};
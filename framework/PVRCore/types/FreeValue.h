@@ -22,7 +22,7 @@ template<>
 struct Metadata<char*>
 {
 	typedef std::array<char, 64> storagetype;
-	static const GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Float;
 	}
@@ -35,7 +35,7 @@ template<>
 struct Metadata<unsigned char*>
 {
 	typedef std::array<char, 64> storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Float;
 	}
@@ -48,7 +48,7 @@ template<>
 struct Metadata<const char*>
 {
 	typedef std::array<char, 64> storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Float;
 	}
@@ -61,7 +61,7 @@ template<>
 struct Metadata<const unsigned char*>
 {
 	typedef std::array<char, 64> storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Float;
 	}
@@ -74,7 +74,7 @@ template<>
 struct Metadata<double>
 {
 	typedef float storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Float;
 	}
@@ -87,7 +87,7 @@ template<>
 struct Metadata<float>
 {
 	typedef float storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Float;
 	}
@@ -100,7 +100,7 @@ template<>
 struct Metadata<int64_t>
 {
 	typedef int32_t storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Integer;
 	}
@@ -113,7 +113,7 @@ template<>
 struct Metadata<int32_t>
 {
 	typedef int32_t storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Integer;
 	}
@@ -126,7 +126,7 @@ template<>
 struct Metadata<int16_t>
 {
 	typedef int32_t storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Integer;
 	}
@@ -139,7 +139,7 @@ template<>
 struct Metadata<int8_t>
 {
 	typedef int32_t storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::Integer;
 	}
@@ -152,7 +152,7 @@ template<>
 struct Metadata<uint64_t>
 {
 	typedef uint32_t storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::uinteger;
 	}
@@ -165,7 +165,7 @@ template<>
 struct Metadata<uint32_t>
 {
 	typedef uint32_t storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::uinteger;
 	}
@@ -178,7 +178,7 @@ template<>
 struct Metadata<uint16_t>
 {
 	typedef uint32_t storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::uinteger;
 	}
@@ -191,7 +191,7 @@ template<>
 struct Metadata<uint8_t>
 {
 	typedef uint32_t storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::uinteger;
 	}
@@ -204,7 +204,7 @@ template<>
 struct Metadata<glm::vec2>
 {
 	typedef glm::vec2 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::vec2;
 	}
@@ -217,7 +217,7 @@ template<>
 struct Metadata<glm::vec3>
 {
 	typedef glm::vec3 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::vec3;
 	}
@@ -230,7 +230,7 @@ template<>
 struct Metadata<glm::vec4>
 {
 	typedef glm::vec4 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::vec4;
 	}
@@ -243,7 +243,7 @@ template<>
 struct Metadata<glm::ivec2>
 {
 	typedef glm::ivec2 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::ivec2;
 	}
@@ -256,7 +256,7 @@ template<>
 struct Metadata<glm::ivec3>
 {
 	typedef glm::ivec3 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::ivec3;
 	}
@@ -269,7 +269,7 @@ template<>
 struct Metadata<glm::ivec4>
 {
 	typedef glm::ivec4 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::ivec4;
 	}
@@ -282,7 +282,7 @@ template<>
 struct Metadata<glm::uvec2>
 {
 	typedef glm::uvec2 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::uvec2;
 	}
@@ -295,7 +295,7 @@ template<>
 struct Metadata<glm::uvec3>
 {
 	typedef glm::uvec3 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::uvec3;
 	}
@@ -308,7 +308,7 @@ template<>
 struct Metadata<glm::uvec4>
 {
 	typedef glm::uvec4 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::uvec4;
 	}
@@ -321,7 +321,7 @@ template<>
 struct Metadata<glm::bvec2>
 {
 	typedef glm::bvec2 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::bvec2;
 	}
@@ -334,7 +334,7 @@ template<>
 struct Metadata<glm::bvec3>
 {
 	typedef glm::bvec3 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::bvec3;
 	}
@@ -347,7 +347,7 @@ template<>
 struct Metadata<glm::bvec4>
 {
 	typedef glm::bvec4 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::bvec4;
 	}
@@ -360,7 +360,7 @@ template<>
 struct Metadata<glm::mat2x2>
 {
 	typedef glm::mat2x2 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat2x2;
 	}
@@ -373,7 +373,7 @@ template<>
 struct Metadata<glm::mat2x3>
 {
 	typedef glm::mat2x3 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat2x3;
 	}
@@ -386,7 +386,7 @@ template<>
 struct Metadata<glm::mat2x4>
 {
 	typedef glm::mat2x4 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat2x4;
 	}
@@ -399,7 +399,7 @@ template<>
 struct Metadata<glm::mat3x2>
 {
 	typedef glm::mat3x2 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat3x2;
 	}
@@ -412,7 +412,7 @@ template<>
 struct Metadata<glm::mat3x3>
 {
 	typedef glm::mat3x3 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat3x3;
 	}
@@ -425,7 +425,7 @@ template<>
 struct Metadata<glm::mat3x4>
 {
 	typedef glm::mat3x4 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat3x4;
 	}
@@ -438,7 +438,7 @@ template<>
 struct Metadata<glm::mat4x2>
 {
 	typedef glm::mat4x2 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat4x2;
 	}
@@ -451,7 +451,7 @@ template<>
 struct Metadata<glm::mat4x3>
 {
 	typedef glm::mat4x3 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat4x3;
 	}
@@ -464,7 +464,7 @@ template<>
 struct Metadata<glm::mat4x4>
 {
 	typedef glm::mat4x4 storagetype;
-	static GpuDatatypes dataTypeOf()
+	static constexpr GpuDatatypes dataTypeOf()
 	{
 		return GpuDatatypes::mat4x4;
 	}
@@ -127,7 +127,7 @@ enum class GpuDatatypes : uint32_t
 /// <param name="lhs">Left hand side</param>
 /// <param name="rhs">Right hand side</param>
 /// <returns>lhs AND rhs</returns>
-inline GpuDatatypes operator&(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
+constexpr GpuDatatypes operator&(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
 {
 	return static_cast<GpuDatatypes>(static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs));
 }
@@ -136,7 +136,7 @@ inline GpuDatatypes operator&(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
 /// <param name="lhs">Left hand side</param>
 /// <param name="rhs">Right hand side</param>
 /// <returns>lhs RIGHT SHIFT rhs</returns>
-inline GpuDatatypes operator>>(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
+constexpr GpuDatatypes operator>>(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
 {
 	return static_cast<GpuDatatypes>(static_cast<uint32_t>(lhs) >> static_cast<uint32_t>(rhs));
 }
@@ -145,7 +145,7 @@ inline GpuDatatypes operator>>(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
 /// <param name="lhs">Left hand side</param>
 /// <param name="rhs">Right hand side</param>
 /// <returns>lhs LEFT SHIFT rhs</returns>
-inline GpuDatatypes operator<<(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
+constexpr GpuDatatypes operator<<(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
 {
 	return static_cast<GpuDatatypes>(static_cast<uint32_t>(lhs) << static_cast<uint32_t>(rhs));
 }
@@ -153,7 +153,7 @@ inline GpuDatatypes operator<<(GpuDatatypes lhs, GpuDatatypesHelper::Bits rhs)
 /// <summary>Get the number of colums (1..4) of the type</summary>
 /// <param name="type">The datatype to test</param>
 /// <returns>The number of matrix colums (1..4) of the type. 1 implies not a matrix</returns>
-inline uint32_t getNumMatrixColumns(GpuDatatypes type)
+constexpr uint32_t getNumMatrixColumns(GpuDatatypes type)
 {
 	return static_cast<uint32_t>(GpuDatatypesHelper::MatrixColumns(static_cast<uint32_t>((type & GpuDatatypesHelper::Bits::MaskCols) >> GpuDatatypesHelper::Bits::ShiftCols) + 1));
 }
@@ -161,7 +161,7 @@ inline uint32_t getNumMatrixColumns(GpuDatatypes type)
 /// <summary>Get required alignment of this type as demanded by std140 rules</summary>
 /// <param name="type">The datatype to test</param>
 /// <returns>The required alignment of the type based on std140 (see the GLSL spec)</returns>
-inline uint32_t getAlignment(GpuDatatypes type)
+constexpr uint32_t getAlignment(GpuDatatypes type)
 {
 	uint32_t vectype = static_cast<uint32_t>(type & GpuDatatypesHelper::Bits::MaskVec);
 	return (vectype == static_cast<uint32_t>(GpuDatatypesHelper::Bits::BitScalar) ? 4 : vectype == static_cast<uint32_t>(GpuDatatypesHelper::Bits::BitVec2) ? 8 : 16);
@@ -170,7 +170,7 @@ inline uint32_t getAlignment(GpuDatatypes type)
 /// <summary>Get the size of a type, including padding, assuming the next item is of the same type</summary>
 /// <param name="type">The datatype to test</param>
 /// <returns>The size plus padding of this type</returns>
-inline uint32_t getVectorSelfAlignedSize(GpuDatatypes type)
+constexpr uint32_t getVectorSelfAlignedSize(GpuDatatypes type)
 {
 	return getAlignment(type);
 }
@@ -178,7 +178,7 @@ inline uint32_t getVectorSelfAlignedSize(GpuDatatypes type)
 /// <summary>Get the number of vector elements (i.e. Rows) of a type. (e.g. vec2=>2)</summary>
 /// <param name="type">The datatype to test</param>
 /// <returns>The number of vector elements.</returns>
-inline uint32_t getNumVecElements(GpuDatatypes type)
+constexpr uint32_t getNumVecElements(GpuDatatypes type)
 {
 	return static_cast<uint32_t>(GpuDatatypesHelper::VectorWidth(static_cast<uint32_t>((type & GpuDatatypesHelper::Bits::MaskVec) >> GpuDatatypesHelper::Bits::ShiftVec) + 1));
 }
@@ -186,7 +186,7 @@ inline uint32_t getNumVecElements(GpuDatatypes type)
 /// <summary>Get the cpu-packed size of each vector element a type (disregarding matrix columns if they exist)</summary>
 /// <param name="type">The datatype to test</param>
 /// <returns>The size that a single column of <paramRef name="type"/> would take on the CPU</returns>
-inline uint32_t getVectorUnalignedSize(GpuDatatypes type)
+constexpr uint32_t getVectorUnalignedSize(GpuDatatypes type)
 {
 	return 4 * getNumVecElements(type);
 }
@@ -232,7 +232,7 @@ inline GpuDatatypes mergeDatatypesSmaller(GpuDatatypes type1, GpuDatatypes type2
 /// <summary>Returns "how many bytes will an object of this type take", if not an array.</summary>
 /// <param name="type">The datatype to test</param>
 /// <returns>The size of this type, aligned to its own alignment restrictions</returns>
-inline uint32_t getSelfAlignedSize(GpuDatatypes type)
+constexpr uint32_t getSelfAlignedSize(GpuDatatypes type)
 {
 	uint32_t isMatrix = (getNumMatrixColumns(type) > 1);
 
@@ -242,7 +242,7 @@ inline uint32_t getSelfAlignedSize(GpuDatatypes type)
 /// <summary>Returns "how many bytes will an object of this type take", if it is an array member (arrays have potentially stricter requirements).</summary>
 /// <param name="type">The datatype to test</param>
 /// <returns>The size of this type, aligned to max array alignment restrictions</returns>
-inline uint32_t getSelfAlignedArraySize(GpuDatatypes type)
+constexpr uint32_t getSelfAlignedArraySize(GpuDatatypes type)
 {
 	return (::std::max)(getVectorSelfAlignedSize(type), static_cast<uint32_t>(16)) * getNumMatrixColumns(type);
 }
@@ -252,7 +252,7 @@ inline uint32_t getSelfAlignedArraySize(GpuDatatypes type)
 /// <param name="type">The datatype to test</param>
 /// <param name="arrayElements">The number of array elements. 1 is NOT considered an array.</param>
 /// <returns>The size of X elements takes</returns>
-inline uint64_t getSize(GpuDatatypes type, uint32_t arrayElements = 1)
+constexpr uint64_t getSize(GpuDatatypes type, uint32_t arrayElements = 1)
 {
 	uint64_t numElements = getNumMatrixColumns(type) * arrayElements;
 
@@ -187,7 +187,7 @@ inline bool isDescriptorTypeDynamic(DescriptorType descType)
 /// <param name="alignment">The value to which the numberToAlign will be aligned</param>
 /// <returns>An aligned value</returns>
 template<typename t1, typename t2>
-inline t1 align(t1 numberToAlign, t2 alignment)
+constexpr t1 align(t1 numberToAlign, t2 alignment)
 {
 	if (alignment)
 	{
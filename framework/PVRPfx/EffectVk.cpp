@@ -1230,8 +1230,11 @@ void Effect_::buildRenderObjects(CommandBuffer& texUploadCmdBuffer, IAssetProvid
 	std::map<StringHash, std::map<StringHash, TextureInfo> /**/> samplersIndexedByPipeAndTexture;
 	createLayouts(*this, pipeLayoutsIndexed);
 	createSamplers(*this, samplersIndexedByPipeAndTexture);
-	// Create the pipeline cache
-	_pipelineCache = _device->createPipelineCache();
+	// Create the pipeline cache, unless one was provided
+	if (_pipelineCache.isNull())
+	{
+		_pipelineCache = _device->createPipelineCache();
+	}
 	createPasses(*this, _passes, pipeLayoutsIndexed, _pipelineDefinitions, samplersIndexedByPipeAndTexture, _swapchain->getSwapchainLength());
 	createTextures(*this, _textures, texUploadCmdBuffer, assetProvider);
 	createBuffers(*this, _pipelineDefinitions, _bufferDefinitions, _swapchain->getSwapchainLength());
@@ -1250,7 +1253,7 @@ void Effect_::buildRenderObjects(CommandBuffer& texUploadCmdBuffer, IAssetProvid
 Effect_::Effect_(const DeviceWeakPtr& device) : _device(device) {}
 
 void Effect_::init(const effect::Effect& effect, Swapchain& swapchain, CommandBuffer& cmdBuffer, IAssetProvider& assetProvider, pvr::utils::vma::Allocator& bufferAllocator,
-	pvr::utils::vma::Allocator& imageAllocator)
+	pvr::utils::vma::Allocator& imageAllocator, const PipelineCache& pipelineCache)
 {
 	// bypass the warning
 	static bool firsttime = initializeStringLists();
@@ -1259,6 +1262,7 @@ void Effect_::init(const effect::Effect& effect, Swapchain& swapchain, CommandBu
 	_assetEffect = effect;
 	_bufferAllocator = bufferAllocator;
 	_imageAllocator = imageAllocator;
+	_pipelineCache = pipelineCache;
 
 	_apiString = findMatchingApiString(_assetEffect, Api::Vulkan);
 
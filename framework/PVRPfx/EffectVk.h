@@ -229,8 +229,10 @@ public:
 	/// through PVRShell), used to load textures from the filesystem/assetsystem</param>
 	/// <param name="bufferAllocator">A VMA allocator used to allocate memory for the created buffers</param>
 	/// <param name="imageAllocator">A VMA allocator used to allocate memory for the created images</param>
+	/// <param name="pipelineCache">Optional. A pipeline cache to create the pipelines with, for example one loaded with pvr::utils::loadPipelineCache so that
+	/// the pipelines do not need to be recompiled on every run. If null, an empty pipeline cache is created.</param>
 	void init(const effect::Effect& effect, pvrvk::Swapchain& swapchain, pvrvk::CommandBuffer& cmdBuffer, IAssetProvider& assetProvider, utils::vma::Allocator& bufferAllocator,
-		utils::vma::Allocator& imageAllocator);
+		utils::vma::Allocator& imageAllocator, const pvrvk::PipelineCache& pipelineCache = pvrvk::PipelineCache());
 
 	/// <summary>Get the exact string that the Effect object is using to define its API.</summary>
 	/// <returns>The exact string that the Effect object is using to define its API.</returns>
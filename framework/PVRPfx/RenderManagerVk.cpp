@@ -668,6 +668,9 @@ inline void createPipelines(RenderManager& renderman, const std::map<StringHash,
 	for (auto&& renderman_effect : renderstruct.effects)
 	{
 		auto&& effect = renderman_effect.effect;
+		// Collect the create infos of all the pipelines of the effect first, so that they can all be created in parallel
+		std::vector<StringHash> pipelineNames;
+		std::vector<GraphicsPipelineCreateInfo> pipelineCreateInfos;
 		// Here we fix the input assembly based on the collected data.
 		for (auto pipeline = vertexConfigs.begin(); pipeline != vertexConfigs.end(); ++pipeline)
 		{
@@ -717,11 +720,18 @@ inline void createPipelines(RenderManager& renderman, const std::map<StringHash,
 				pipecp.viewport.setViewportAndScissor(0, Viewport(0, 0, static_cast<float>(screendDim.getWidth()), static_cast<float>(screendDim.getHeight())),
 					pvrvk::Rect2D(pvrvk::Offset2D(0, 0), pvrvk::Extent2D(screendDim.getWidth(), screendDim.getHeight())));
 			}
-			GraphicsPipeline pipelineApi = effect->getDevice()->createGraphicsPipeline(pipecp, effect->getPipelineCache());
-
 			assertion(pipelineApis.find(pipeline->first) == pipelineApis.end() || pipelineApis.find(pipeline->first)->second.isNull());
+			pipelineNames.push_back(pipeline->first);
+			pipelineCreateInfos.push_back(pipecp);
+		}
 
-			pipelineApis[pipeline->first] = pipelineApi;
+		std::vector<GraphicsPipeline> effectPipelines(pipelineCreateInfos.size());
+		pvrvk::Device device = effect->getDevice()->getReference();
+		pvr::utils::createGraphicsPipelinesParallel(
+			device, pipelineCreateInfos.data(), static_cast<uint32_t>(pipelineCreateInfos.size()), effect->getPipelineCache(), effectPipelines.data());
+		for (size_t i = 0; i < effectPipelines.size(); ++i)
+		{
+			pipelineApis[pipelineNames[i]] = effectPipelines[i];
 		}
 	}
 
@@ -1692,6 +1692,7 @@ private:
 	std::map<assets::Mesh*, std::vector<AttributeLayout>*> meshAttributeLayout; // points to finalPipeAttributeLayouts
 	IAssetProvider* _assetProvider;
 	pvr::utils::vma::Allocator _vmaAllocator;
+	pvrvk::PipelineCache _pipelineCache;
 
 	/// <summary>Generate the RenderManager, create the structure, add all rendering effects, create the API objects, and
 	/// in general, cook everything. Call AFTER any calls to addEffect(...) and addModel...(...). Call BEFORE any
@@ -1737,6 +1738,21 @@ public:
 		return true;
 	}
 
+	/// <summary>Set the pipeline cache that the pipelines of effects added afterwards will be created with, for example one loaded with
+	/// pvr::utils::loadPipelineCache. If not set, each effect creates its own empty pipeline cache.</summary>
+	/// <param name="pipelineCache">The pipeline cache to use</param>
+	void setPipelineCache(const pvrvk::PipelineCache& pipelineCache)
+	{
+		_pipelineCache = pipelineCache;
+	}
+
+	/// <summary>Get the pipeline cache set with setPipelineCache</summary>
+	/// <returns>The pipeline cache, or a null pipeline cache if none was set</returns>
+	const pvrvk::PipelineCache& getPipelineCache() const
+	{
+		return _pipelineCache;
+	}
+
 	/// <summary>Get the swapchain object with which this render manager was initialized</summary>
 	/// <returns>The swapchain object with which this render manager was initialized</returns>
 	const pvrvk::Swapchain& getSwapchain() const
@@ -2046,7 +2062,7 @@ public:
 		this->_device = device;
 		effectvk::EffectApi effectapi;
 		effectapi.construct(device);
-		effectapi->init(effect, _swapchain, cmdBuffer, getAssetProvider(), _vmaAllocator, _vmaAllocator);
+		effectapi->init(effect, _swapchain, cmdBuffer, getAssetProvider(), _vmaAllocator, _vmaAllocator, _pipelineCache);
 
 		_renderStructure.effects.resize(_renderStructure.effects.size() + 1);
 		auto& new_effect = _renderStructure.effects.back();
@@ -12,6 +12,12 @@
 #include "PVRUtils/Vulkan/UIRendererVk.h"
 #include "PVRUtils/Vulkan/HelperVk.h"
 #include "PVRUtils/Vulkan/AsynchronousVk.h"
+#include "PVRUtils/Vulkan/TransientBufferAllocatorVk.h"
+#include "PVRUtils/Vulkan/StreamingUploaderVk.h"
+#include "PVRUtils/Vulkan/DescriptorAllocatorVk.h"
+#include "PVRUtils/Vulkan/GpuProfilerVk.h"
+#include "PVRUtils/Vulkan/MemoryBudgetManagerVk.h"
+#include "PVRUtils/Vulkan/IndirectDrawCullerVk.h"
 #include "PVRUtils/StructuredMemory.h"
 
 /*****************************************************************************/
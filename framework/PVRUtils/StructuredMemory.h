@@ -12,6 +12,7 @@
 #include "PVRCore/strings/StringHash.h"
 #include <sstream>
 #include <iomanip>
+#include <tuple>
 
 /// <summary>Main PowerVR Namespace</summary>
 namespace pvr {
@@ -609,18 +610,131 @@ class StructuredBufferView;
 class StructuredBufferView;
 //!\endcond
 
+/// <summary>A range of bytes of a buffer, relative to the start of the buffer. Returned by the bulk write functions of StructuredBufferView
+/// so that the written memory can be flushed if the underlying memory is not host coherent.</summary>
+struct StructuredBufferRange
+{
+	uint64_t offset; //!< The offset of the range from the start of the buffer (not from the start of the mapped memory)
+	uint64_t size; //!< The size of the range
+
+	/// <summary>Constructor. Creates an empty range.</summary>
+	StructuredBufferRange() : offset(0), size(0) {}
+
+	/// <summary>Constructor.</summary>
+	/// <param name="offset">The offset of the range from the start of the buffer</param>
+	/// <param name="size">The size of the range</param>
+	StructuredBufferRange(uint64_t offset, uint64_t size) : offset(offset), size(size) {}
+};
+
+//!\cond NO_DOXYGEN
+namespace impl {
+template<size_t Size>
+inline void stridedCopyFixedSize(char* dst, size_t dstStride, const char* src, size_t srcStride, uint32_t count)
+{
+	// The size is a compile time constant, so each copy becomes a few (vectorised) loads and stores
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		memcpy(dst + dstStride * i, src + srcStride * i, Size);
+	}
+}
+
+// Copies count items of size bytes from src (spaced srcStride bytes apart) to dst (spaced dstStride bytes apart)
+inline void stridedCopy(void* dst, size_t dstStride, const void* src, size_t srcStride, size_t size, uint32_t count)
+{
+	char* dstBytes = static_cast<char*>(dst);
+	const char* srcBytes = static_cast<const char*>(src);
+	if (dstStride == size && srcStride == size)
+	{
+		memcpy(dstBytes, srcBytes, size * count);
+		return;
+	}
+	switch (size)
+	{
+	case 4: stridedCopyFixedSize<4>(dstBytes, dstStride, srcBytes, srcStride, count); break;
+	case 8: stridedCopyFixedSize<8>(dstBytes, dstStride, srcBytes, srcStride, count); break;
+	case 12: stridedCopyFixedSize<12>(dstBytes, dstStride, srcBytes, srcStride, count); break;
+	case 16: stridedCopyFixedSize<16>(dstBytes, dstStride, srcBytes, srcStride, count); break;
+	case 32: stridedCopyFixedSize<32>(dstBytes, dstStride, srcBytes, srcStride, count); break;
+	case 48: stridedCopyFixedSize<48>(dstBytes, dstStride, srcBytes, srcStride, count); break;
+	case 64: stridedCopyFixedSize<64>(dstBytes, dstStride, srcBytes, srcStride, count); break;
+	default:
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			memcpy(dstBytes + dstStride * i, srcBytes + srcStride * i, size);
+		}
+	}
+}
+
+// Returns true if a value of the type has the same representation on the host and in std140 (i.e. does not need its columns padded)
+constexpr bool isStd140Packed(GpuDatatypes type)
+{
+	return getNumMatrixColumns(type) == 1 || getNumVecElements(type) == 4;
+}
+
+template<typename T>
+inline void storeStd140Value(char* dst, const T& value)
+{
+	memcpy(dst, &value, sizeof(T));
+}
+
+// Matrix columns are always padded to a vec4 in std140
+inline void storeStd140Value(char* dst, const glm::mat2x2& value)
+{
+	storeStd140Value(dst, glm::mat2x4(value));
+}
+inline void storeStd140Value(char* dst, const glm::mat2x3& value)
+{
+	storeStd140Value(dst, glm::mat2x4(value));
+}
+inline void storeStd140Value(char* dst, const glm::mat3x2& value)
+{
+	storeStd140Value(dst, glm::mat3x4(value));
+}
+inline void storeStd140Value(char* dst, const glm::mat3x3& value)
+{
+	storeStd140Value(dst, glm::mat3x4(value));
+}
+inline void storeStd140Value(char* dst, const glm::mat4x2& value)
+{
+	storeStd140Value(dst, glm::mat4x4(value));
+}
+inline void storeStd140Value(char* dst, const glm::mat4x3& value)
+{
+	storeStd140Value(dst, glm::mat4x4(value));
+}
+
+// Stores count values of a host type, read every srcStride bytes, every dstStride bytes
+template<typename T>
+inline void storeStd140Values(char* dst, size_t dstStride, const T* values, size_t srcStride, uint32_t count)
+{
+	if (isStd140Packed(GpuDatatypesHelper::Metadata<T>::dataTypeOf()))
+	{
+		stridedCopy(dst, dstStride, values, srcStride, sizeof(T), count);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			storeStd140Value(dst + dstStride * i, *reinterpret_cast<const T*>(reinterpret_cast<const char*>(values) + srcStride * i));
+		}
+	}
+}
+} // namespace impl
+//!\endcond
+
 /// <summary>Defines a StructuredBufferViewElement. A StructuredBufferViewElement handles the public interface used for working with a StructuredMemoryEntry.</summary>
 class StructuredBufferViewElement
 {
 private:
 	friend class StructuredBufferView;
 	uint32_t _offset;
+	uint32_t _mappedMemoryOffset; // The offset of the mapped memory (i.e. of the mapped dynamic slice) from the start of the buffer
 	void* _mappedMemory;
 	uint32_t _level;
 	uint32_t _indices[5]; // This, is the array index of each ancestor item up the chain. Is carried to children elements to enable offset calcs.
 	const StructuredMemoryEntry& _prototype;
 	StructuredBufferViewElement(const StructuredMemoryEntry& entry, uint32_t level, uint32_t elementArrayIndex, const uint32_t* parentIndices, uint32_t dynamicSlice = 0)
-		: _mappedMemory(nullptr), _level(level), _prototype(entry)
+		: _mappedMemoryOffset(0), _mappedMemory(nullptr), _level(level), _prototype(entry)
 	{
 		_indices[0] = elementArrayIndex;
 		if (parentIndices)
@@ -650,7 +764,8 @@ private:
 
 		// at this point dynamicSliceSize matches the root size
 		debug_assertion(dynamicSlice >= mappedDynamicSlice, "StructuredBufferViewElement: Mapped dynamic slice must be greater than or equal to the current dynamic slice");
-		uint32_t sliceOffset = (dynamicSlice * static_cast<uint32_t>(dynamicSliceSize)) - (mappedDynamicSlice * static_cast<uint32_t>(dynamicSliceSize));
+		_mappedMemoryOffset = mappedDynamicSlice * static_cast<uint32_t>(dynamicSliceSize);
+		uint32_t sliceOffset = (dynamicSlice * static_cast<uint32_t>(dynamicSliceSize)) - _mappedMemoryOffset;
 		_offset += sliceOffset;
 	}
 
@@ -788,6 +903,20 @@ public:
 	{
 		return _prototype._arrayMemberSize;
 	}
+
+	/// <summary>Gets the primitive type of the underlying structure memory entry</summary>
+	/// <returns>Return the primitive type of the underlying structure memory entry (GpuDatatypes::none for structures).</returns>
+	GpuDatatypes getPrimitiveType() const
+	{
+		return _prototype.getPrimitiveType();
+	}
+
+	/// <summary>Gets the number of array elements of the underlying structure memory entry</summary>
+	/// <returns>Return the number of array elements of the underlying structure memory entry.</returns>
+	uint32_t getNumArrayElements() const
+	{
+		return _prototype.getNumArrayElements();
+	}
 //!\cond NO_DOXYGEN
 // clang-format off
 #define DEFINE_SETVALUE_FOR_TYPE(ParamType)\
@@ -966,9 +1095,27 @@ public:
 		}
 	}
 
+	/// <summary>Sets a number of consecutive array elements in a single call, starting from this element, from an array of host values.
+	/// The values may be interleaved with other data on the host (e.g. a member of an array of host structs) by specifying valueStride.
+	/// Values are copied with strided copies, padding matrix columns where std140 requires it.</summary>
+	/// <typeparam name="T">The host type of the values (float, glm::vec3, glm::mat4 etc.)</typeparam>
+	/// <param name="values">Pointer to the first value to set</param>
+	/// <param name="count">The number of array elements to set</param>
+	/// <param name="valueStride">The distance in bytes between consecutive values on the host</param>
+	/// <returns>The range of the buffer that was written. Like the ranges returned by StructuredBufferView, its offset is from the start of
+	/// the buffer rather than from the mapped memory, so that it can be flushed directly.</returns>
+	template<typename T>
+	StructuredBufferRange setArrayValues(const T* values, uint32_t count, size_t valueStride = sizeof(T))
+	{
+		debug_assertion(_prototype.getPrimitiveType() == GpuDatatypesHelper::Metadata<T>::dataTypeOf(), "StructuredBufferViewElement: Mismatched host datatype");
+		debug_assertion(_indices[0] + count <= std::max(_prototype.getNumArrayElements(), 1u), "StructuredBufferViewElement: Attempted out-of-bounds access in setArrayValues");
+		impl::storeStd140Values(static_cast<char*>(getMappedMemory()) + getOffset(), _prototype._arrayMemberSize, values, valueStride, count);
+		return StructuredBufferRange(_mappedMemoryOffset + getOffset(), count ? _prototype._arrayMemberSize * (count - 1) + getSize(GpuDatatypesHelper::Metadata<T>::dataTypeOf()) : 0);
+	}
+
 	/// <summary>Gets the number of elements for a particular level of the structured buffer view</summary>
 	/// <returns>Return the number of elements for a particular level of the structured buffer view.</returns>
-	uint32_t getNumElements()
+	uint32_t getNumElements() const
 	{
 		if (_prototype.isStructure())
 		{
@@ -1001,6 +1148,13 @@ private:
 	StructuredMemoryEntry _root;
 	uint32_t _numDynamicSlices;
 
+	void* getDynamicSliceAddress(uint32_t dynamicSlice)
+	{
+		debug_assertion(_root.getMappedMemory() != nullptr, "StructuredBufferView: Before setting values the mapped memory must be set.");
+		debug_assertion(dynamicSlice >= getMappedDynamicSlice(), "StructuredBufferView: Mapped dynamic slice must be greater than or equal to the current dynamic slice");
+		return static_cast<char*>(_root.getMappedMemory()) + getDynamicSliceOffset(dynamicSlice - getMappedDynamicSlice());
+	}
+
 public:
 	/// <summary>Constructor. Creates an empty StructuredBufferView.</summary>
 	StructuredBufferView() : _numDynamicSlices(1) {}
@@ -1175,11 +1329,58 @@ public:
 
 	/// <summary>Gets the number of elements for a particular level of the structured buffer view</summary>
 	/// <returns>Return the number of elements for a particular level of the structured buffer view.</returns>
-	uint32_t getNumElements()
+	uint32_t getNumElements() const
 	{
 		return StructuredBufferViewElement(_root, 0, 0, nullptr).getNumElements();
 	}
 
+	/// <summary>Get the range of the buffer covered by a number of consecutive dynamic slices, e.g. to flush it after a bulk update.</summary>
+	/// <param name="firstDynamicSlice">The first dynamic slice of the range</param>
+	/// <param name="numDynamicSlices">The number of dynamic slices in the range</param>
+	/// <returns>The range of the buffer covered by the dynamic slices, from the start of the buffer regardless of the mapped dynamic slice.</returns>
+	StructuredBufferRange getDynamicSlicesRange(uint32_t firstDynamicSlice, uint32_t numDynamicSlices) const
+	{
+		return StructuredBufferRange(getDynamicSliceOffset(firstDynamicSlice), getDynamicSliceSize() * numDynamicSlices);
+	}
+
+	/// <summary>Copies an array of host structs into consecutive dynamic slices, one struct per dynamic slice. The host struct must have the same
+	/// memory layout as the start of each dynamic slice (e.g. a struct containing only glm::mat4 and glm::vec4 members).
+	/// If the host structs are exactly one dynamic slice in size the whole update is a single memcpy.</summary>
+	/// <typeparam name="T">The host struct type</typeparam>
+	/// <param name="values">Pointer to the first host struct</param>
+	/// <param name="firstDynamicSlice">The dynamic slice to copy the first struct into</param>
+	/// <param name="numDynamicSlices">The number of structs/dynamic slices to copy</param>
+	/// <returns>The range of the buffer that was written.</returns>
+	template<typename T>
+	StructuredBufferRange setDynamicSlices(const T* values, uint32_t firstDynamicSlice, uint32_t numDynamicSlices)
+	{
+		debug_assertion(sizeof(T) <= getDynamicSliceSize(), "StructuredBufferView: The host struct is larger than a dynamic slice");
+		debug_assertion(firstDynamicSlice + numDynamicSlices <= _numDynamicSlices, "StructuredBufferView: Attempted out-of-bounds access in setDynamicSlices");
+		impl::stridedCopy(getDynamicSliceAddress(firstDynamicSlice), static_cast<size_t>(getDynamicSliceSize()), values, sizeof(T), sizeof(T), numDynamicSlices);
+		return getDynamicSlicesRange(firstDynamicSlice, numDynamicSlices);
+	}
+
+	/// <summary>Sets the value of an element in a number of consecutive dynamic slices in a single call, from an array of host values.
+	/// The values may be interleaved with other data on the host (e.g. a member of an array of host structs) by specifying valueStride.</summary>
+	/// <typeparam name="T">The host type of the values (float, glm::vec3, glm::mat4 etc.)</typeparam>
+	/// <param name="elementIndex">The index of the element to set</param>
+	/// <param name="values">Pointer to the value to set in the first dynamic slice</param>
+	/// <param name="firstDynamicSlice">The first dynamic slice to set the element in</param>
+	/// <param name="numDynamicSlices">The number of dynamic slices to set the element in</param>
+	/// <param name="valueStride">The distance in bytes between consecutive values on the host</param>
+	/// <param name="elementArrayIndex">The element array index to set</param>
+	/// <returns>The range of the buffer that was written.</returns>
+	template<typename T>
+	StructuredBufferRange setElementForDynamicSlices(
+		uint32_t elementIndex, const T* values, uint32_t firstDynamicSlice, uint32_t numDynamicSlices, size_t valueStride = sizeof(T), uint32_t elementArrayIndex = 0)
+	{
+		debug_assertion(firstDynamicSlice + numDynamicSlices <= _numDynamicSlices, "StructuredBufferView: Attempted out-of-bounds access in setElementForDynamicSlices");
+		const StructuredBufferViewElement element = getElement(elementIndex, elementArrayIndex, firstDynamicSlice);
+		debug_assertion(element.getPrimitiveType() == GpuDatatypesHelper::Metadata<T>::dataTypeOf(), "StructuredBufferView: Mismatched host datatype");
+		impl::storeStd140Values(static_cast<char*>(_root.getMappedMemory()) + element.getOffset(), static_cast<size_t>(getDynamicSliceSize()), values, valueStride, numDynamicSlices);
+		return getDynamicSlicesRange(firstDynamicSlice, numDynamicSlices);
+	}
+
 	/// <summary>Sets the element array size for the last entry in the StructuredBufferViewElement.
 	/// Only the last element in the StructuredBufferViewElement may have its size set from the api</summary>
 	/// <param name="arraySize">The size of the array</param>
@@ -1222,5 +1423,269 @@ public:
 	}
 	//!\endcond
 };
+
+/// <summary>Describes a single member of a compile-time StructuredMemoryLayout using its host type (float, glm::vec3,
+/// glm::mat4 etc.) and an array size. As with StructuredMemoryDescription, an array size of 1 is NOT considered an array.</summary>
+/// <typeparam name="T">The host type of the member. Must have a GpuDatatypesHelper::Metadata specialisation.</typeparam>
+/// <typeparam name="ArraySize">The number of array elements of the member.</typeparam>
+template<typename T, uint32_t ArraySize = 1>
+struct StructuredMemoryMember
+{
+	/// <summary>The host type of the member.</summary>
+	typedef T HostType;
+
+	/// <summary>Get the GpuDatatypes corresponding to the host type of the member.</summary>
+	/// <returns>The GpuDatatypes of the member.</returns>
+	static constexpr GpuDatatypes getDataType()
+	{
+		return GpuDatatypesHelper::Metadata<T>::dataTypeOf();
+	}
+
+	/// <summary>Get the number of array elements of the member.</summary>
+	/// <returns>The number of array elements of the member.</returns>
+	static constexpr uint32_t getNumArrayElements()
+	{
+		return ArraySize;
+	}
+
+	static_assert(ArraySize > 0, "StructuredMemoryMember: The array size must be at least 1");
+	static_assert(sizeof(T) == getVectorUnalignedSize(GpuDatatypesHelper::Metadata<T>::dataTypeOf()) * getNumMatrixColumns(GpuDatatypesHelper::Metadata<T>::dataTypeOf()),
+		"StructuredMemoryMember: The host type must be a tightly packed 32 bit scalar, vector or matrix type");
+};
+
+/// <summary>A compile-time equivalent of a flat (single level) StructuredMemoryDescription. The offsets, array strides and sizes of
+/// each member are calculated as constant expressions using exactly the same rules as StructuredMemoryEntry, so they can be used
+/// to write into mapped memory without any name lookups or type switches, and validated against a runtime StructuredBufferView.
+/// Example usage for the following buffer:
+/// layout(std140, binding = 0) uniform PerObject
+/// {
+///   highp mat4 modelMatrix;
+///   highp mat3 modelMatrixIT;
+/// };
+/// typedef StructuredMemoryLayout<StructuredMemoryMember<glm::mat4>, StructuredMemoryMember<glm::mat3>> PerObjectLayout;
+/// static_assert(PerObjectLayout::getOffset(1) == 64, "");
+/// view.initDynamic(PerObjectLayout::createDescription({ "modelMatrix", "modelMatrixIT" }), numSlices, BufferUsageFlags::UniformBuffer, minUboAlignment);
+/// </summary>
+/// <typeparam name="Members">A list of StructuredMemoryMember types, one for each member of the block.</typeparam>
+template<typename... Members>
+class StructuredMemoryLayout
+{
+	static_assert(sizeof...(Members) > 0, "StructuredMemoryLayout: At least one member is required");
+
+	static constexpr uint32_t getMemberBaseAlignment(uint32_t index)
+	{
+		return getNumArrayElements(index) > 1 ? (::std::max)(getAlignment(getDataType(index)), getAlignment(GpuDatatypes::vec4)) : getAlignment(getDataType(index));
+	}
+
+	// The last member is considered a (potentially) variable sized array, so it always contains its own padding.
+	static constexpr uint64_t getMemberSize(uint32_t index)
+	{
+		return index + 1 == getNumElements() ? static_cast<uint64_t>(getArrayMemberSize(index)) * getNumArrayElements(index)
+											 : pvr::getSize(getDataType(index), getNumArrayElements(index));
+	}
+
+public:
+	/// <summary>The StructuredMemoryMember type of the member at the given index.</summary>
+	template<uint32_t Index>
+	using MemberType = typename std::tuple_element<Index, std::tuple<Members...>>::type;
+
+	/// <summary>Get the number of members of the layout.</summary>
+	/// <returns>The number of members of the layout.</returns>
+	static constexpr uint32_t getNumElements()
+	{
+		return static_cast<uint32_t>(sizeof...(Members));
+	}
+
+	/// <summary>Get the GpuDatatypes of a member.</summary>
+	/// <param name="index">The index of the member</param>
+	/// <returns>The GpuDatatypes of the member.</returns>
+	static constexpr GpuDatatypes getDataType(uint32_t index)
+	{
+		const GpuDatatypes types[] = { Members::getDataType()... };
+		return types[index];
+	}
+
+	/// <summary>Get the number of array elements of a member.</summary>
+	/// <param name="index">The index of the member</param>
+	/// <returns>The number of array elements of the member.</returns>
+	static constexpr uint32_t getNumArrayElements(uint32_t index)
+	{
+		const uint32_t arraySizes[] = { Members::getNumArrayElements()... };
+		return arraySizes[index];
+	}
+
+	/// <summary>Get the size of each array element of a member, including its padding (the array stride).
+	/// Matches StructuredBufferViewElement::getValueSize.</summary>
+	/// <param name="index">The index of the member</param>
+	/// <returns>The array stride of the member.</returns>
+	static constexpr uint32_t getArrayMemberSize(uint32_t index)
+	{
+		return getSelfAlignedArraySize(getDataType(index));
+	}
+
+	/// <summary>Get the offset of a member from the start of a dynamic slice.</summary>
+	/// <param name="index">The index of the member</param>
+	/// <returns>The offset of the member.</returns>
+	static constexpr uint32_t getOffset(uint32_t index)
+	{
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < index; ++i)
+		{
+			offset = align(offset, getMemberBaseAlignment(i)) + static_cast<uint32_t>(getMemberSize(i));
+		}
+		return align(offset, getMemberBaseAlignment(index));
+	}
+
+	/// <summary>Get the base alignment of the whole block as defined by std140.</summary>
+	/// <returns>The base alignment of the block.</returns>
+	static constexpr uint32_t getBaseAlignment()
+	{
+		uint32_t baseAlignment = getAlignment(GpuDatatypes::vec4);
+		for (uint32_t i = 0; i < getNumElements(); ++i)
+		{
+			baseAlignment = (::std::max)(baseAlignment, getMemberBaseAlignment(i));
+		}
+		return baseAlignment;
+	}
+
+	/// <summary>Get the size of a single dynamic slice of the block. Matches StructuredBufferView::getDynamicSliceSize when the view was
+	/// initialised with the same minimum dynamic alignment.</summary>
+	/// <param name="minDynamicAlignment">The minimum dynamic alignment (e.g. minUniformBufferOffsetAlignment) or 0 for non-dynamic buffers</param>
+	/// <returns>The size of a dynamic slice.</returns>
+	static constexpr uint64_t getDynamicSliceSize(uint64_t minDynamicAlignment = 0)
+	{
+		return align(align(static_cast<uint64_t>(getOffset(getNumElements() - 1)) + getMemberSize(getNumElements() - 1), getBaseAlignment()), minDynamicAlignment);
+	}
+
+	/// <summary>Create a runtime StructuredMemoryDescription equivalent to this layout, using the provided member names.</summary>
+	/// <param name="names">The names of the members, in order. Must contain exactly getNumElements() entries.</param>
+	/// <returns>A StructuredMemoryDescription which can be used to initialise a StructuredBufferView.</returns>
+	static StructuredMemoryDescription createDescription(std::initializer_list<const char*> names)
+	{
+		if (names.size() != getNumElements())
+		{
+			throw std::runtime_error("StructuredMemoryLayout: Mismatched number of member names");
+		}
+		StructuredMemoryDescription desc;
+		uint32_t index = 0;
+		for (const char* name : names)
+		{
+			desc.addElement(name, getDataType(index), getNumArrayElements(index));
+			++index;
+		}
+		return desc;
+	}
+
+	/// <summary>Validate that a runtime StructuredBufferView has exactly the layout described by this class.</summary>
+	/// <param name="view">The StructuredBufferView to validate</param>
+	/// <param name="minDynamicAlignment">The minimum dynamic alignment the view was initialised with, or 0 for non-dynamic buffers</param>
+	/// <returns>True if every member's type, array size, offset and stride and the dynamic slice size match, otherwise false.</returns>
+	static bool isCompatible(const StructuredBufferView& view, uint64_t minDynamicAlignment = 0)
+	{
+		if (view.getNumElements() != getNumElements() || view.getDynamicSliceSize() != getDynamicSliceSize(minDynamicAlignment))
+		{
+			return false;
+		}
+		for (uint32_t i = 0; i < getNumElements(); ++i)
+		{
+			const StructuredBufferViewElement element = view.getElement(i, 0, view.getMappedDynamicSlice());
+			if (element.getPrimitiveType() != getDataType(i) || element.getNumArrayElements() != getNumArrayElements(i) || element.getOffset() != getOffset(i) ||
+				element.getValueSize() != getArrayMemberSize(i))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+/// <summary>Writes values into mapped memory laid out according to a compile-time StructuredMemoryLayout. Member offsets are
+/// constant expressions, so each setValue compiles down to a store at a fixed offset from the start of the dynamic slice.</summary>
+/// <typeparam name="Layout">The StructuredMemoryLayout describing the memory.</typeparam>
+template<typename Layout>
+class StructuredBufferWriter
+{
+private:
+	char* _mappedMemory;
+	uint64_t _dynamicSliceSize;
+	uint32_t _mappedDynamicSlice;
+
+public:
+	/// <summary>Constructor. Creates a StructuredBufferWriter pointing to no memory.</summary>
+	StructuredBufferWriter() : _mappedMemory(nullptr), _dynamicSliceSize(Layout::getDynamicSliceSize()), _mappedDynamicSlice(0) {}
+
+	/// <summary>Constructor. Creates a StructuredBufferWriter pointing to mapped memory.</summary>
+	/// <param name="mappedMemory">The mapped memory to write to</param>
+	/// <param name="minDynamicAlignment">The minimum dynamic alignment used for the dynamic slices, or 0 for non-dynamic buffers</param>
+	/// <param name="mappedDynamicSlice">The dynamic slice used when mapping the mapped memory.</param>
+	StructuredBufferWriter(void* mappedMemory, uint64_t minDynamicAlignment = 0, uint32_t mappedDynamicSlice = 0)
+		: _mappedMemory(static_cast<char*>(mappedMemory)), _dynamicSliceSize(Layout::getDynamicSliceSize(minDynamicAlignment)), _mappedDynamicSlice(mappedDynamicSlice)
+	{}
+
+	/// <summary>Constructor. Creates a StructuredBufferWriter writing to the same mapped memory and dynamic slices as a StructuredBufferView.
+	/// The view must have been initialised with a description equivalent to the Layout.</summary>
+	/// <param name="view">A StructuredBufferView which has been initialised and pointed to mapped memory</param>
+	explicit StructuredBufferWriter(const StructuredBufferView& view)
+		: _mappedMemory(static_cast<char*>(const_cast<void*>(view.getMappedMemory()))), _dynamicSliceSize(view.getDynamicSliceSize()),
+		  _mappedDynamicSlice(view.getMappedDynamicSlice())
+	{
+		// Aligning the unpadded slice size to the actual slice size yields the actual slice size, so this only validates the members
+		debug_assertion(Layout::isCompatible(view, view.getDynamicSliceSize()), "StructuredBufferWriter: The StructuredBufferView does not match the Layout");
+	}
+
+	/// <summary>Get the size of a single dynamic slice.</summary>
+	/// <returns>The size of a dynamic slice.</returns>
+	uint64_t getDynamicSliceSize() const
+	{
+		return _dynamicSliceSize;
+	}
+
+	/// <summary>Get the offset of a dynamic slice from the start of the buffer.</summary>
+	/// <param name="dynamicSlice">The dynamic slice to retrieve the offset for</param>
+	/// <returns>The offset of the dynamic slice.</returns>
+	uint64_t getDynamicSliceOffset(uint32_t dynamicSlice) const
+	{
+		return dynamicSlice * _dynamicSliceSize;
+	}
+
+	/// <summary>Get the address of an array element of a member in mapped memory.</summary>
+	/// <typeparam name="Index">The index of the member</typeparam>
+	/// <param name="arrayIndex">The array element of the member</param>
+	/// <param name="dynamicSlice">The dynamic slice</param>
+	/// <returns>A pointer into the mapped memory.</returns>
+	template<uint32_t Index>
+	void* getAddress(uint32_t arrayIndex = 0, uint32_t dynamicSlice = 0) const
+	{
+		static constexpr uint32_t offset = Layout::getOffset(Index);
+		static constexpr uint32_t stride = Layout::getArrayMemberSize(Index);
+		debug_assertion(_mappedMemory != nullptr, "StructuredBufferWriter: Before writing values the mapped memory must be set.");
+		debug_assertion(arrayIndex < Layout::getNumArrayElements(Index), "StructuredBufferWriter: Attempted out-of-bounds access");
+		debug_assertion(dynamicSlice >= _mappedDynamicSlice, "StructuredBufferWriter: Mapped dynamic slice must be greater than or equal to the current dynamic slice");
+		return _mappedMemory + static_cast<size_t>((dynamicSlice - _mappedDynamicSlice) * _dynamicSliceSize) + offset + stride * arrayIndex;
+	}
+
+	/// <summary>Sets the value of an array element of a member.</summary>
+	/// <typeparam name="Index">The index of the member</typeparam>
+	/// <param name="value">The value to set</param>
+	/// <param name="arrayIndex">The array element of the member</param>
+	/// <param name="dynamicSlice">The dynamic slice</param>
+	template<uint32_t Index>
+	void setValue(const typename Layout::template MemberType<Index>::HostType& value, uint32_t arrayIndex = 0, uint32_t dynamicSlice = 0)
+	{
+		impl::storeStd140Value(static_cast<char*>(getAddress<Index>(arrayIndex, dynamicSlice)), value);
+	}
+
+	/// <summary>Sets the values of a number of consecutive array elements of a member.</summary>
+	/// <typeparam name="Index">The index of the member</typeparam>
+	/// <param name="values">Pointer to the values to set</param>
+	/// <param name="count">The number of values to set</param>
+	/// <param name="firstArrayIndex">The array element to start from</param>
+	/// <param name="dynamicSlice">The dynamic slice</param>
+	template<uint32_t Index>
+	void setArrayValues(const typename Layout::template MemberType<Index>::HostType* values, uint32_t count, uint32_t firstArrayIndex = 0, uint32_t dynamicSlice = 0)
+	{
+		impl::storeStd140Values(static_cast<char*>(getAddress<Index>(firstArrayIndex, dynamicSlice)), Layout::getArrayMemberSize(Index), values, sizeof(*values), count);
+	}
+};
 } // namespace utils
 } // namespace pvr
@@ -0,0 +1,320 @@
+/*!
+\brief Implementation of the DescriptorAllocator.
+\file PVRUtils/Vulkan/DescriptorAllocatorVk.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+//!\cond NO_DOXYGEN
+#include "DescriptorAllocatorVk.h"
+#include "PVRVk/BufferVk.h"
+#include <algorithm>
+#include <iterator>
+
+namespace pvr {
+namespace utils {
+namespace {
+inline void hashCombine(size_t& seed, size_t value)
+{
+	seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+inline size_t hashPointer(const void* ptr)
+{
+	return std::hash<const void*>()(ptr);
+}
+} // namespace
+
+size_t DescriptorSetBindings::getHash() const
+{
+	size_t hash = _bindings.size();
+	for (const Binding& entry : _bindings)
+	{
+		hashCombine(hash, (static_cast<size_t>(entry.binding) << 16) | entry.arrayElement);
+		hashCombine(hash, static_cast<size_t>(entry.descriptorType));
+		hashCombine(hash, hashPointer(entry.buffer.get()));
+		hashCombine(hash, static_cast<size_t>(entry.offset));
+		hashCombine(hash, static_cast<size_t>(entry.range));
+		hashCombine(hash, hashPointer(entry.imageView.get()));
+		hashCombine(hash, hashPointer(entry.sampler.get()));
+		hashCombine(hash, static_cast<size_t>(entry.imageLayout));
+		hashCombine(hash, hashPointer(entry.texelBufferView.get()));
+	}
+	return hash;
+}
+
+bool DescriptorSetBindings::operator==(const DescriptorSetBindings& rhs) const
+{
+	if (_bindings.size() != rhs._bindings.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < _bindings.size(); ++i)
+	{
+		const Binding& a = _bindings[i];
+		const Binding& b = rhs._bindings[i];
+		if (a.binding != b.binding || a.arrayElement != b.arrayElement || a.descriptorType != b.descriptorType || a.buffer.get() != b.buffer.get() || a.offset != b.offset ||
+			a.range != b.range || a.imageView.get() != b.imageView.get() || a.sampler.get() != b.sampler.get() || a.imageLayout != b.imageLayout ||
+			a.texelBufferView.get() != b.texelBufferView.get())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void DescriptorSetBindings::appendWrites(const pvrvk::DescriptorSet& descriptorSet, std::vector<pvrvk::WriteDescriptorSet>& outWrites) const
+{
+	for (const Binding& entry : _bindings)
+	{
+		outWrites.push_back(pvrvk::WriteDescriptorSet(entry.descriptorType, descriptorSet, entry.binding, entry.arrayElement));
+		pvrvk::WriteDescriptorSet& write = outWrites.back();
+		if (entry.buffer.isValid())
+		{
+			write.setBufferInfo(0, pvrvk::DescriptorBufferInfo(entry.buffer, entry.offset, entry.range));
+		}
+		else if (entry.texelBufferView.isValid())
+		{
+			write.setTexelBufferInfo(0, entry.texelBufferView);
+		}
+		else if (entry.imageView.isValid())
+		{
+			write.setImageInfo(0, pvrvk::DescriptorImageInfo(entry.imageView, entry.sampler, entry.imageLayout));
+		}
+		else
+		{
+			write.setImageInfo(0, pvrvk::DescriptorImageInfo(entry.sampler));
+		}
+	}
+}
+
+void DescriptorAllocator::init(pvrvk::Device& device, uint32_t numFramesInFlight, const pvrvk::DescriptorPoolCreateInfo& poolTemplate)
+{
+	release();
+	_device = device;
+	_poolTemplate = poolTemplate;
+	_frames.resize(std::max(numFramesInFlight, 1u));
+	_currentFrame = 0;
+	_frameCounter = 0;
+}
+
+void DescriptorAllocator::release()
+{
+	_pendingWrites.clear();
+	_cache.clear();
+	_cachedPools = PoolChain();
+	_frames.clear();
+	_device.reset();
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frameIndex)
+{
+	debug_assertion(frameIndex < _frames.size(), "DescriptorAllocator: frame index out of range");
+	debug_assertion(_pendingWrites.empty(), "DescriptorAllocator: beginFrame called with descriptor writes that were never flushed");
+	_pendingWrites.clear();
+	++_frameCounter;
+	_currentFrame = frameIndex;
+
+	// Recycle all transient descriptor sets of the frame by resetting its pools as a whole. The pools are reset before the cached transient sets
+	// are released, so that releasing them does not free each set individually.
+	Frame& frame = _frames[frameIndex];
+	for (Pool& pool : frame.pools.pools)
+	{
+		if (pool.remainingSets != pool.maxSets)
+		{
+			pool.pool->reset();
+			pool.remainingSets = pool.maxSets;
+			std::copy(pool.capacity, pool.capacity + NumDescriptorTypes, pool.remaining);
+		}
+	}
+	frame.pools.current = 0;
+	frame.cache.clear();
+
+	evictUnusedCacheEntries();
+}
+
+pvrvk::DescriptorSet DescriptorAllocator::allocateTransient(const pvrvk::DescriptorSetLayout& layout)
+{
+	return allocateFromChain(_frames[_currentFrame].pools, layout);
+}
+
+pvrvk::DescriptorSet DescriptorAllocator::getTransientDescriptorSet(const pvrvk::DescriptorSetLayout& layout, const DescriptorSetBindings& bindings)
+{
+	Frame& frame = _frames[_currentFrame];
+	return getOrAllocate(frame.cache, frame.pools, layout, bindings);
+}
+
+pvrvk::DescriptorSet DescriptorAllocator::getDescriptorSet(const pvrvk::DescriptorSetLayout& layout, const DescriptorSetBindings& bindings)
+{
+	return getOrAllocate(_cache, _cachedPools, layout, bindings);
+}
+
+pvrvk::DescriptorSet DescriptorAllocator::getOrAllocate(Cache& cache, PoolChain& chain, const pvrvk::DescriptorSetLayout& layout, const DescriptorSetBindings& bindings)
+{
+	size_t hash = bindings.getHash();
+	hashCombine(hash, hashPointer(layout.get()));
+	std::vector<CacheEntry>& bucket = cache[hash];
+	for (CacheEntry& entry : bucket)
+	{
+		if (entry.layout == layout.get() && entry.bindings == bindings)
+		{
+			entry.lastUsedFrame = _frameCounter;
+			return entry.descriptorSet;
+		}
+	}
+
+	CacheEntry entry;
+	entry.layout = layout.get();
+	entry.bindings = bindings;
+	entry.descriptorSet = allocateFromChain(chain, layout);
+	entry.lastUsedFrame = _frameCounter;
+	bindings.appendWrites(entry.descriptorSet, _pendingWrites);
+	bucket.push_back(entry);
+	return entry.descriptorSet;
+}
+
+void DescriptorAllocator::flushWrites()
+{
+	if (!_pendingWrites.empty())
+	{
+		_device->updateDescriptorSets(_pendingWrites.data(), static_cast<uint32_t>(_pendingWrites.size()), nullptr, 0);
+		_pendingWrites.clear();
+	}
+}
+
+pvrvk::DescriptorSet DescriptorAllocator::allocateFromChain(PoolChain& chain, const pvrvk::DescriptorSetLayout& layout)
+{
+	debug_assertion(_device.isValid(), "DescriptorAllocator: Not initialised");
+	uint32_t required[NumDescriptorTypes] = {};
+	const pvrvk::DescriptorSetLayoutCreateInfo& layoutInfo = layout->getCreateInfo();
+	for (uint32_t i = 0; i < layoutInfo.getNumBindings(); ++i)
+	{
+		required[static_cast<uint32_t>(layoutInfo.getAllBindings()[i].descriptorType)] += layoutInfo.getAllBindings()[i].descriptorCount;
+	}
+
+	for (;;)
+	{
+		if (chain.current == chain.pools.size())
+		{
+			createPool(chain, required);
+		}
+		Pool& pool = chain.pools[chain.current];
+		bool fits = pool.remainingSets != 0;
+		for (uint32_t type = 0; fits && type < NumDescriptorTypes; ++type)
+		{
+			fits = required[type] <= pool.remaining[type];
+		}
+		if (fits)
+		{
+			try
+			{
+				pvrvk::DescriptorSet descriptorSet = pool.pool->allocateDescriptorSet(layout);
+				--pool.remainingSets;
+				for (uint32_t type = 0; type < NumDescriptorTypes; ++type)
+				{
+					pool.remaining[type] -= required[type];
+				}
+				return descriptorSet;
+			}
+			catch (const pvrvk::ErrorFragmentedPool&)
+			{
+				// Cached pools that had sets freed individually can be fragmented even though the counts fit. Treat the pool as full.
+				pool.remainingSets = 0;
+			}
+		}
+		++chain.current;
+	}
+}
+
+void DescriptorAllocator::createPool(PoolChain& chain, const uint32_t (&required)[NumDescriptorTypes])
+{
+	Pool pool;
+	pool.maxSets = std::max<uint32_t>(_poolTemplate.getMaxDescriptorSets(), 1);
+	pvrvk::DescriptorPoolCreateInfo poolInfo;
+	poolInfo.setMaxDescriptorSets(static_cast<uint16_t>(pool.maxSets));
+	for (uint32_t type = 0; type < NumDescriptorTypes; ++type)
+	{
+		pool.capacity[type] = std::min<uint32_t>(std::max<uint32_t>(_poolTemplate.getNumDescriptorTypes(pvrvk::DescriptorType(type)), required[type]), 0xFFFF);
+		pool.remaining[type] = pool.capacity[type];
+		if (pool.capacity[type])
+		{
+			poolInfo.addDescriptorInfo(pvrvk::DescriptorType(type), static_cast<uint16_t>(pool.capacity[type]));
+		}
+	}
+	pool.remainingSets = pool.maxSets;
+	pool.pool = _device->createDescriptorPool(poolInfo);
+	chain.pools.push_back(pool);
+}
+
+void DescriptorAllocator::evictUnusedCacheEntries()
+{
+	// A set unused for at least as many frames as there are frames in flight is no longer referenced by any command buffer in flight. Sets still
+	// referenced outside the cache are kept, so that evicting an entry always frees its set and returns its descriptors to the pool.
+	const uint64_t evictionFrames = std::max<uint64_t>(_cacheEvictionFrames, _frames.size());
+	if (_frameCounter <= evictionFrames)
+	{
+		return;
+	}
+	const uint64_t oldestKept = _frameCounter - evictionFrames;
+	bool evicted = false;
+	for (Cache::iterator bucket = _cache.begin(); bucket != _cache.end();)
+	{
+		std::vector<CacheEntry>& entries = bucket->second;
+		for (size_t i = 0; i < entries.size();)
+		{
+			if (entries[i].lastUsedFrame < oldestKept && entries[i].descriptorSet.refcount() == 1)
+			{
+				// Return the descriptors to the pool's budget. The set is freed when the entry is removed below.
+				const pvrvk::DescriptorPool& descriptorPool = entries[i].descriptorSet->getDescriptorPool();
+				for (Pool& pool : _cachedPools.pools)
+				{
+					if (pool.pool.get() == descriptorPool.get())
+					{
+						const pvrvk::DescriptorSetLayoutCreateInfo& layoutInfo = entries[i].descriptorSet->getDescriptorSetLayout()->getCreateInfo();
+						for (uint32_t j = 0; j < layoutInfo.getNumBindings(); ++j)
+						{
+							pool.remaining[static_cast<uint32_t>(layoutInfo.getAllBindings()[j].descriptorType)] += layoutInfo.getAllBindings()[j].descriptorCount;
+						}
+						pool.remainingSets = std::min(pool.remainingSets + 1, pool.maxSets);
+						break;
+					}
+				}
+				entries[i] = std::move(entries.back());
+				entries.pop_back();
+				evicted = true;
+			}
+			else
+			{
+				++i;
+			}
+		}
+		bucket = entries.empty() ? _cache.erase(bucket) : std::next(bucket);
+	}
+	if (evicted)
+	{
+		_cachedPools.current = 0;
+	}
+}
+
+uint32_t DescriptorAllocator::getNumCachedDescriptorSets() const
+{
+	uint32_t count = 0;
+	for (const Cache::value_type& bucket : _cache)
+	{
+		count += static_cast<uint32_t>(bucket.second.size());
+	}
+	return count;
+}
+
+uint32_t DescriptorAllocator::getNumDescriptorPools() const
+{
+	size_t count = _cachedPools.pools.size();
+	for (const Frame& frame : _frames)
+	{
+		count += frame.pools.pools.size();
+	}
+	return static_cast<uint32_t>(count);
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,270 @@
+/*!
+\brief Contains a descriptor set allocator with growable per-frame pools and a cache of descriptor sets keyed by their bound resources.
+\file PVRUtils/Vulkan/DescriptorAllocatorVk.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+#pragma once
+#include "PVRVk/DeviceVk.h"
+#include "PVRVk/DescriptorSetVk.h"
+#include "PVRVk/ImageVk.h"
+#include "PVRVk/SamplerVk.h"
+#include <unordered_map>
+
+namespace pvr {
+namespace utils {
+/// <summary>Describes the resources bound to a descriptor set. Used as the key of the descriptor set cache of the DescriptorAllocator:
+/// descriptor sets with the same layout and the same DescriptorSetBindings (same resources, in the same order) are shared.</summary>
+class DescriptorSetBindings
+{
+public:
+	/// <summary>Bind a (uniform, storage, dynamic uniform or dynamic storage) buffer.</summary>
+	/// <param name="binding">The binding index</param>
+	/// <param name="descriptorType">The descriptor type of the binding</param>
+	/// <param name="buffer">The buffer</param>
+	/// <param name="offset">The offset into the buffer</param>
+	/// <param name="range">The range of the buffer</param>
+	/// <param name="arrayElement">If the binding is an array, the array element</param>
+	/// <returns>This object (allows chaining of calls)</returns>
+	DescriptorSetBindings& addBuffer(uint16_t binding, pvrvk::DescriptorType descriptorType, const pvrvk::Buffer& buffer, pvrvk::DeviceSize offset, pvrvk::DeviceSize range,
+		uint16_t arrayElement = 0)
+	{
+		Binding entry(binding, arrayElement, descriptorType);
+		entry.buffer = buffer;
+		entry.offset = offset;
+		entry.range = range;
+		_bindings.push_back(entry);
+		return *this;
+	}
+
+	/// <summary>Bind an image (combined image sampler, sampled image, storage image or input attachment) or a sampler.</summary>
+	/// <param name="binding">The binding index</param>
+	/// <param name="descriptorType">The descriptor type of the binding</param>
+	/// <param name="imageView">The image view. May be null for e_SAMPLER bindings.</param>
+	/// <param name="sampler">The sampler. May be null for bindings which do not use a sampler or use an immutable sampler.</param>
+	/// <param name="imageLayout">The layout the image will be in when accessed</param>
+	/// <param name="arrayElement">If the binding is an array, the array element</param>
+	/// <returns>This object (allows chaining of calls)</returns>
+	DescriptorSetBindings& addImage(uint16_t binding, pvrvk::DescriptorType descriptorType, const pvrvk::ImageView& imageView, const pvrvk::Sampler& sampler = pvrvk::Sampler(),
+		pvrvk::ImageLayout imageLayout = pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL, uint16_t arrayElement = 0)
+	{
+		Binding entry(binding, arrayElement, descriptorType);
+		entry.imageView = imageView;
+		entry.sampler = sampler;
+		entry.imageLayout = imageLayout;
+		_bindings.push_back(entry);
+		return *this;
+	}
+
+	/// <summary>Bind a uniform or storage texel buffer.</summary>
+	/// <param name="binding">The binding index</param>
+	/// <param name="descriptorType">The descriptor type of the binding</param>
+	/// <param name="bufferView">The buffer view</param>
+	/// <param name="arrayElement">If the binding is an array, the array element</param>
+	/// <returns>This object (allows chaining of calls)</returns>
+	DescriptorSetBindings& addTexelBuffer(uint16_t binding, pvrvk::DescriptorType descriptorType, const pvrvk::BufferView& bufferView, uint16_t arrayElement = 0)
+	{
+		Binding entry(binding, arrayElement, descriptorType);
+		entry.texelBufferView = bufferView;
+		_bindings.push_back(entry);
+		return *this;
+	}
+
+	/// <summary>Remove all bindings.</summary>
+	/// <returns>This object (allows chaining of calls)</returns>
+	DescriptorSetBindings& clear()
+	{
+		_bindings.clear();
+		return *this;
+	}
+
+	/// <summary>Get the number of bindings.</summary>
+	/// <returns>The number of bindings.</returns>
+	uint32_t getNumBindings() const
+	{
+		return static_cast<uint32_t>(_bindings.size());
+	}
+
+	/// <summary>Calculate a hash of the bound resources.</summary>
+	/// <returns>The hash.</returns>
+	size_t getHash() const;
+
+	/// <summary>Equality operator. Bindings are equal if they bind the same resources, in the same order.</summary>
+	/// <param name="rhs">The right-hand side argument of the operator.</param>
+	/// <returns>True if the bindings are equal.</returns>
+	bool operator==(const DescriptorSetBindings& rhs) const;
+
+	/// <summary>Append the descriptor writes required to write the bindings to a descriptor set.</summary>
+	/// <param name="descriptorSet">The descriptor set to write to</param>
+	/// <param name="outWrites">The writes are appended to this vector</param>
+	void appendWrites(const pvrvk::DescriptorSet& descriptorSet, std::vector<pvrvk::WriteDescriptorSet>& outWrites) const;
+
+private:
+	struct Binding
+	{
+		uint16_t binding;
+		uint16_t arrayElement;
+		pvrvk::DescriptorType descriptorType;
+		pvrvk::Buffer buffer;
+		pvrvk::DeviceSize offset;
+		pvrvk::DeviceSize range;
+		pvrvk::ImageView imageView;
+		pvrvk::Sampler sampler;
+		pvrvk::ImageLayout imageLayout;
+		pvrvk::BufferView texelBufferView;
+		Binding(uint16_t binding, uint16_t arrayElement, pvrvk::DescriptorType descriptorType)
+			: binding(binding), arrayElement(arrayElement), descriptorType(descriptorType), offset(0), range(0), imageLayout(pvrvk::ImageLayout::e_UNDEFINED)
+		{}
+	};
+	std::vector<Binding> _bindings;
+};
+
+/// <summary>Allocates descriptor sets without the application having to size descriptor pools by hand, and without per-set frees in the frame.
+/// Two kinds of descriptor sets are handed out:
+/// - Transient sets (allocateTransient / getTransientDescriptorSet) are allocated from pools belonging to the current frame in flight. When the same
+///   frame index begins again, its pools are reset as a whole, recycling all of its sets at once.
+/// - Cached sets (getDescriptorSet) are looked up by (layout, bound resources). Identical bindings return the same descriptor set every frame, so
+///   descriptor sets are only allocated and written when the bound resources change. Cached sets which have not been used for a number of frames,
+///   and which are not referenced outside the allocator, are freed.
+/// Pools of either kind are created on demand, sized from a template DescriptorPoolCreateInfo (grown if a layout needs more), so running out of
+/// descriptors never fails. Descriptor writes are not performed immediately but queued, and all of them are performed with a single call to
+/// Device::updateDescriptorSets by flushWrites, which must be called before the returned sets are bound.
+///
+/// The allocator is not thread safe.</summary>
+class DescriptorAllocator
+{
+public:
+	/// <summary>The default number of frames a cached descriptor set may remain unused before it is freed.</summary>
+	enum
+	{
+		DefaultCacheEvictionFrames = 120
+	};
+
+	/// <summary>Constructor. Creates an uninitialised DescriptorAllocator.</summary>
+	DescriptorAllocator() : _currentFrame(0), _frameCounter(0), _cacheEvictionFrames(DefaultCacheEvictionFrames) {}
+
+	/// <summary>Destructor.</summary>
+	~DescriptorAllocator()
+	{
+		release();
+	}
+
+	/// <summary>Initialise the allocator.</summary>
+	/// <param name="device">The device used to create the descriptor pools</param>
+	/// <param name="numFramesInFlight">The number of frames in flight (typically the number of swapchain images)</param>
+	/// <param name="poolTemplate">The descriptor counts and maximum number of sets of every pool created. If a single descriptor set layout
+	/// requires more descriptors of a type than the template provides, the pool is enlarged accordingly.</param>
+	void init(pvrvk::Device& device, uint32_t numFramesInFlight, const pvrvk::DescriptorPoolCreateInfo& poolTemplate = getDefaultPoolTemplate());
+
+	/// <summary>Release all descriptor sets and pools. None of the descriptor sets may still be in use by the GPU.</summary>
+	void release();
+
+	/// <summary>Begin a frame. The transient descriptor sets of the previous use of the frame index are recycled (so the GPU must have finished with
+	/// them, typically because the frame's fence has been waited on), and cached descriptor sets which have not been used recently are freed.</summary>
+	/// <param name="frameIndex">The index of the frame in flight (typically the swapchain index)</param>
+	void beginFrame(uint32_t frameIndex);
+
+	/// <summary>Allocate a descriptor set which is only valid for the current frame. The descriptor set is not written.</summary>
+	/// <param name="layout">The layout of the descriptor set</param>
+	/// <returns>The descriptor set.</returns>
+	pvrvk::DescriptorSet allocateTransient(const pvrvk::DescriptorSetLayout& layout);
+
+	/// <summary>Get a descriptor set, valid only for the current frame, with the specified resources bound. Within the frame, identical bindings
+	/// return the same descriptor set.</summary>
+	/// <param name="layout">The layout of the descriptor set</param>
+	/// <param name="bindings">The resources to bind</param>
+	/// <returns>The descriptor set. Its writes are queued and performed by flushWrites.</returns>
+	pvrvk::DescriptorSet getTransientDescriptorSet(const pvrvk::DescriptorSetLayout& layout, const DescriptorSetBindings& bindings);
+
+	/// <summary>Get a descriptor set with the specified resources bound from the cache, allocating (and queueing the writes of) a new one only if no
+	/// descriptor set with the same layout and bindings exists. The descriptor set and the bound resources are kept alive while the set is cached.</summary>
+	/// <param name="layout">The layout of the descriptor set</param>
+	/// <param name="bindings">The resources to bind</param>
+	/// <returns>The descriptor set. If newly allocated, its writes are queued and performed by flushWrites.</returns>
+	pvrvk::DescriptorSet getDescriptorSet(const pvrvk::DescriptorSetLayout& layout, const DescriptorSetBindings& bindings);
+
+	/// <summary>Perform all queued descriptor writes with a single call to Device::updateDescriptorSets. Must be called after the descriptor sets
+	/// of a frame have been requested and before they are bound in a command buffer.</summary>
+	void flushWrites();
+
+	/// <summary>Set the number of frames a cached descriptor set may remain unused before it is freed. Values lower than the number of frames in
+	/// flight are raised to it.</summary>
+	/// <param name="numFrames">The number of frames</param>
+	void setCacheEvictionFrames(uint32_t numFrames)
+	{
+		_cacheEvictionFrames = numFrames;
+	}
+
+	/// <summary>Get the number of descriptor sets currently cached.</summary>
+	/// <returns>The number of cached descriptor sets.</returns>
+	uint32_t getNumCachedDescriptorSets() const;
+
+	/// <summary>Get the number of descriptor pools currently allocated (transient and cached).</summary>
+	/// <returns>The number of descriptor pools.</returns>
+	uint32_t getNumDescriptorPools() const;
+
+	/// <summary>Get the pool template used if none is passed to init: 256 sets and a generous number of the commonly used descriptor types.</summary>
+	/// <returns>The default pool template.</returns>
+	static pvrvk::DescriptorPoolCreateInfo getDefaultPoolTemplate()
+	{
+		pvrvk::DescriptorPoolCreateInfo poolInfo(256, 256, 32, 256, 256, 64, 32);
+		poolInfo.addDescriptorInfo(pvrvk::DescriptorType::e_STORAGE_IMAGE, 32);
+		return poolInfo;
+	}
+
+private:
+	enum
+	{
+		NumDescriptorTypes = static_cast<uint32_t>(pvrvk::DescriptorType::e_RANGE_SIZE)
+	};
+
+	struct Pool
+	{
+		pvrvk::DescriptorPool pool;
+		uint32_t maxSets;
+		uint32_t remainingSets;
+		uint32_t capacity[NumDescriptorTypes];
+		uint32_t remaining[NumDescriptorTypes];
+	};
+
+	// A list of pools allocated from in order. Only the pools from 'current' onwards are still tried for new allocations.
+	struct PoolChain
+	{
+		std::vector<Pool> pools;
+		size_t current;
+		PoolChain() : current(0) {}
+	};
+
+	struct CacheEntry
+	{
+		const void* layout;
+		DescriptorSetBindings bindings;
+		pvrvk::DescriptorSet descriptorSet;
+		uint64_t lastUsedFrame;
+	};
+	typedef std::unordered_map<size_t, std::vector<CacheEntry> /**/> Cache;
+
+	struct Frame
+	{
+		PoolChain pools;
+		Cache cache;
+	};
+
+	pvrvk::DescriptorSet allocateFromChain(PoolChain& chain, const pvrvk::DescriptorSetLayout& layout);
+	pvrvk::DescriptorSet getOrAllocate(Cache& cache, PoolChain& chain, const pvrvk::DescriptorSetLayout& layout, const DescriptorSetBindings& bindings);
+	void createPool(PoolChain& chain, const uint32_t (&required)[NumDescriptorTypes]);
+	void evictUnusedCacheEntries();
+
+	pvrvk::Device _device;
+	pvrvk::DescriptorPoolCreateInfo _poolTemplate;
+	std::vector<Frame> _frames;
+	PoolChain _cachedPools;
+	Cache _cache;
+	std::vector<pvrvk::WriteDescriptorSet> _pendingWrites;
+	uint32_t _currentFrame;
+	uint64_t _frameCounter;
+	uint32_t _cacheEvictionFrames;
+};
+} // namespace utils
+} // namespace pvr
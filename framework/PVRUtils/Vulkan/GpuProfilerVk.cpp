@@ -0,0 +1,210 @@
+/*!
+\brief Implementation of the GpuProfiler.
+\file PVRUtils/Vulkan/GpuProfilerVk.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+//!\cond NO_DOXYGEN
+#include "GpuProfilerVk.h"
+#include "PVRVk/PhysicalDeviceVk.h"
+#include "PVRCore/strings/StringFunctions.h"
+#include <algorithm>
+
+namespace pvr {
+namespace utils {
+namespace {
+const uint32_t InvalidZone = static_cast<uint32_t>(-1);
+}
+
+void GpuProfiler::init(pvrvk::Device& device, const pvrvk::Queue& queue, uint32_t numFramesInFlight, uint32_t maxZonesPerFrame, uint32_t historyFrames)
+{
+	release();
+	_device = device;
+	_maxZonesPerFrame = std::max(maxZonesPerFrame, 1u);
+	_historyFrames = std::max(historyFrames, 1u);
+	_frames.resize(std::max(numFramesInFlight, 1u));
+
+	const uint32_t validBits = device->getPhysicalDevice()->getQueueFamilyProperties()[queue->getFamilyIndex()].getTimestampValidBits();
+	if (validBits == 0)
+	{
+		Log(LogLevel::Warning, "GpuProfiler: Queue family %u does not support timestamps. GPU profiling is disabled.", queue->getFamilyIndex());
+		return;
+	}
+	_timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+	_timestampPeriodMs = static_cast<double>(device->getPhysicalDevice()->getProperties().getLimits().getTimestampPeriod()) * 1e-6;
+	_queryPool = device->createQueryPool(pvrvk::QueryPoolCreateInfo(pvrvk::QueryType::e_TIMESTAMP, static_cast<uint32_t>(_frames.size()) * _maxZonesPerFrame * 2));
+	_queryPool->setObjectName("PVRUtilsVk::GpuProfiler::QueryPool");
+}
+
+void GpuProfiler::release()
+{
+	_queryPool.reset();
+	_device.reset();
+	_frames.clear();
+	_zoneIds.clear();
+	_histories.clear();
+	_stats.clear();
+	_frameActive = false;
+}
+
+void GpuProfiler::beginFrame(pvrvk::CommandBufferBase commandBuffer, uint32_t frameIndex)
+{
+	if (!isSupported())
+	{
+		return;
+	}
+	debug_assertion(frameIndex < _frames.size(), "GpuProfiler: frame index out of range");
+	readBack(frameIndex);
+
+	_currentFrame = frameIndex;
+	_frameActive = true;
+	FrameQueries& frame = _frames[frameIndex];
+	frame.zoneIds.clear();
+	frame.pending = true;
+	commandBuffer->resetQueryPool(_queryPool, frameIndex * _maxZonesPerFrame * 2, _maxZonesPerFrame * 2);
+}
+
+uint32_t GpuProfiler::beginZone(pvrvk::CommandBufferBase commandBuffer, const char* name, pvrvk::PipelineStageFlags pipelineStage)
+{
+	if (_emitDebugMarkers)
+	{
+		commandBuffer->debugMarkerBeginEXT(name);
+	}
+	if (!_frameActive)
+	{
+		return InvalidZone;
+	}
+	FrameQueries& frame = _frames[_currentFrame];
+	if (frame.zoneIds.size() == _maxZonesPerFrame)
+	{
+		return InvalidZone;
+	}
+	const uint32_t zone = static_cast<uint32_t>(frame.zoneIds.size());
+	frame.zoneIds.push_back(getZoneId(name));
+	commandBuffer->writeTimestamp(_queryPool, (_currentFrame * _maxZonesPerFrame + zone) * 2, pipelineStage);
+	return zone;
+}
+
+void GpuProfiler::endZone(pvrvk::CommandBufferBase commandBuffer, uint32_t zone, pvrvk::PipelineStageFlags pipelineStage)
+{
+	if (zone != InvalidZone)
+	{
+		commandBuffer->writeTimestamp(_queryPool, (_currentFrame * _maxZonesPerFrame + zone) * 2 + 1, pipelineStage);
+	}
+	if (_emitDebugMarkers)
+	{
+		commandBuffer->debugMarkerEndEXT();
+	}
+}
+
+uint32_t GpuProfiler::getZoneId(const char* name)
+{
+	std::map<std::string, uint32_t>::iterator it = _zoneIds.find(name);
+	if (it != _zoneIds.end())
+	{
+		return it->second;
+	}
+	const uint32_t id = static_cast<uint32_t>(_stats.size());
+	_zoneIds[name] = id;
+	_stats.push_back(ZoneStats());
+	_stats.back().name = name;
+	_histories.push_back(ZoneHistory());
+	return id;
+}
+
+void GpuProfiler::readBack(uint32_t frameIndex)
+{
+	FrameQueries& frame = _frames[frameIndex];
+	if (!frame.pending || frame.zoneIds.empty())
+	{
+		frame.pending = false;
+		return;
+	}
+	frame.pending = false;
+
+	// The frame has completed, so the results are normally available. If not (e.g. a zone was never ended), the frame is dropped rather than waited for.
+	const uint32_t numQueries = static_cast<uint32_t>(frame.zoneIds.size()) * 2;
+	_results.resize(numQueries);
+	if (!_queryPool->getResults(frameIndex * _maxZonesPerFrame * 2, numQueries, numQueries * sizeof(uint64_t), _results.data(), sizeof(uint64_t), pvrvk::QueryResultFlags::e_64_BIT))
+	{
+		return;
+	}
+
+	for (ZoneHistory& history : _histories)
+	{
+		history.currentFrameMs = 0;
+		history.measuredThisFrame = false;
+	}
+	for (size_t i = 0; i < frame.zoneIds.size(); ++i)
+	{
+		ZoneHistory& history = _histories[frame.zoneIds[i]];
+		const uint64_t ticks = (_results[i * 2 + 1] - _results[i * 2]) & _timestampMask;
+		history.currentFrameMs += static_cast<double>(ticks) * _timestampPeriodMs;
+		history.measuredThisFrame = true;
+	}
+
+	for (size_t id = 0; id < _histories.size(); ++id)
+	{
+		ZoneHistory& history = _histories[id];
+		if (!history.measuredThisFrame)
+		{
+			continue;
+		}
+		if (history.samples.size() < _historyFrames)
+		{
+			history.samples.push_back(history.currentFrameMs);
+		}
+		else
+		{
+			history.samples[history.next] = history.currentFrameMs;
+		}
+		history.next = (history.next + 1) % _historyFrames;
+
+		ZoneStats& stats = _stats[id];
+		stats.lastMs = history.currentFrameMs;
+		stats.numSamples = static_cast<uint32_t>(history.samples.size());
+		stats.minMs = *std::min_element(history.samples.begin(), history.samples.end());
+		stats.maxMs = *std::max_element(history.samples.begin(), history.samples.end());
+		double total = 0;
+		for (double sample : history.samples)
+		{
+			total += sample;
+		}
+		stats.avgMs = total / history.samples.size();
+	}
+}
+
+const GpuProfiler::ZoneStats* GpuProfiler::getZoneStats(const std::string& name) const
+{
+	std::map<std::string, uint32_t>::const_iterator it = _zoneIds.find(name);
+	return it == _zoneIds.end() ? nullptr : &_stats[it->second];
+}
+
+std::string GpuProfiler::getSummary() const
+{
+	std::string summary;
+	for (const ZoneStats& stats : _stats)
+	{
+		if (stats.numSamples)
+		{
+			summary += strings::createFormatted("%s: %.3fms (min %.3f avg %.3f max %.3f)\n", stats.name.c_str(), stats.lastMs, stats.minMs, stats.avgMs, stats.maxMs);
+		}
+	}
+	return summary;
+}
+
+void GpuProfiler::logSummary(LogLevel severity) const
+{
+	for (const ZoneStats& stats : _stats)
+	{
+		if (stats.numSamples)
+		{
+			Log(severity, "GpuProfiler: %s: %.3fms (min %.3f avg %.3f max %.3f over %u frames)", stats.name.c_str(), stats.lastMs, stats.minMs, stats.avgMs, stats.maxMs,
+				stats.numSamples);
+		}
+	}
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,180 @@
+/*!
+\brief Contains a GPU profiler measuring named zones of command buffers with timestamp queries.
+\file PVRUtils/Vulkan/GpuProfilerVk.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+#pragma once
+#include "PVRVk/DeviceVk.h"
+#include "PVRVk/QueueVk.h"
+#include "PVRVk/QueryPoolVk.h"
+#include "PVRVk/CommandBufferVk.h"
+#include <map>
+
+namespace pvr {
+namespace utils {
+/// <summary>Measures the GPU time of named zones of command buffers using timestamp queries.
+/// Each frame in flight owns a range of queries in a single query pool. The results of a frame are read back (without waiting) when the same frame
+/// index begins again, at which point the GPU has finished with it, so profiling never stalls the CPU or the GPU. The durations of every zone are
+/// aggregated into min/avg/max over a configurable number of frames, and zones are also emitted as debug marker regions, so that they show up with the
+/// same names in graphics debuggers.
+///
+/// Usage: call beginFrame at the start of (outside of any render pass of) the first command buffer recorded for a frame, then wrap the work to measure
+/// in beginZone/endZone pairs (or ScopedZone objects). Zones may be nested and may be recorded in any command buffer submitted after the one passed
+/// to beginFrame in the same frame. The profiler is not thread safe.</summary>
+class GpuProfiler
+{
+public:
+	/// <summary>The default values of the init parameters.</summary>
+	enum
+	{
+		DefaultMaxZonesPerFrame = 64,
+		DefaultHistoryFrames = 60
+	};
+
+	/// <summary>The aggregated statistics of a zone.</summary>
+	struct ZoneStats
+	{
+		std::string name; //!< The name of the zone
+		double lastMs; //!< The duration of the zone in the last frame it was measured in, in milliseconds
+		double minMs; //!< The minimum duration of the zone over the history, in milliseconds
+		double avgMs; //!< The average duration of the zone over the history, in milliseconds
+		double maxMs; //!< The maximum duration of the zone over the history, in milliseconds
+		uint32_t numSamples; //!< The number of frames in the history the zone was measured in
+		ZoneStats() : lastMs(0), minMs(0), avgMs(0), maxMs(0), numSamples(0) {}
+	};
+
+	/// <summary>Measures a zone for the lifetime of the object.</summary>
+	class ScopedZone
+	{
+	public:
+		/// <summary>Constructor. Begins a zone.</summary>
+		/// <param name="profiler">The profiler</param>
+		/// <param name="commandBuffer">The command buffer the zone is recorded in</param>
+		/// <param name="name">The name of the zone</param>
+		ScopedZone(GpuProfiler& profiler, pvrvk::CommandBufferBase commandBuffer, const char* name)
+			: _profiler(profiler), _commandBuffer(commandBuffer), _zone(profiler.beginZone(commandBuffer, name))
+		{}
+
+		/// <summary>Destructor. Ends the zone.</summary>
+		~ScopedZone()
+		{
+			_profiler.endZone(_commandBuffer, _zone);
+		}
+
+	private:
+		ScopedZone& operator=(const ScopedZone&);
+		GpuProfiler& _profiler;
+		pvrvk::CommandBufferBase _commandBuffer;
+		uint32_t _zone;
+	};
+
+	/// <summary>Constructor. Creates an uninitialised profiler.</summary>
+	GpuProfiler()
+		: _timestampPeriodMs(0), _timestampMask(0), _maxZonesPerFrame(0), _historyFrames(0), _currentFrame(0), _frameActive(false), _emitDebugMarkers(true)
+	{}
+
+	/// <summary>Initialise the profiler.</summary>
+	/// <param name="device">The device used to create the query pool</param>
+	/// <param name="queue">The queue the profiled command buffers are submitted to. If its queue family does not support timestamps, profiling is
+	/// disabled and all functions become no-ops.</param>
+	/// <param name="numFramesInFlight">The number of frames in flight (typically the number of swapchain images)</param>
+	/// <param name="maxZonesPerFrame">The maximum number of zones per frame. Further zones are ignored.</param>
+	/// <param name="historyFrames">The number of frames statistics are aggregated over</param>
+	void init(pvrvk::Device& device, const pvrvk::Queue& queue, uint32_t numFramesInFlight, uint32_t maxZonesPerFrame = DefaultMaxZonesPerFrame,
+		uint32_t historyFrames = DefaultHistoryFrames);
+
+	/// <summary>Release the query pool. The GPU must have finished all profiled command buffers.</summary>
+	void release();
+
+	/// <summary>Begin profiling a frame. Reads back the results of the previous use of the frame index, which must have completed on the GPU
+	/// (typically because the frame's fence has been waited on), and resets the frame's queries.</summary>
+	/// <param name="commandBuffer">A command buffer in the recording state, outside of any render pass, submitted before any of the frame's zones</param>
+	/// <param name="frameIndex">The index of the frame in flight (typically the swapchain index)</param>
+	void beginFrame(pvrvk::CommandBufferBase commandBuffer, uint32_t frameIndex);
+
+	/// <summary>Begin a zone. Records a timestamp after all previously submitted work has completed.</summary>
+	/// <param name="commandBuffer">The command buffer to record the zone in</param>
+	/// <param name="name">The name of the zone. All zones with the same name in a frame are accumulated.</param>
+	/// <param name="pipelineStage">The pipeline stage of the timestamp</param>
+	/// <returns>The zone handle to pass to endZone.</returns>
+	uint32_t beginZone(pvrvk::CommandBufferBase commandBuffer, const char* name, pvrvk::PipelineStageFlags pipelineStage = pvrvk::PipelineStageFlags::e_TOP_OF_PIPE_BIT);
+
+	/// <summary>End a zone.</summary>
+	/// <param name="commandBuffer">The command buffer to record the end of the zone in</param>
+	/// <param name="zone">The zone handle returned by beginZone</param>
+	/// <param name="pipelineStage">The pipeline stage of the timestamp</param>
+	void endZone(pvrvk::CommandBufferBase commandBuffer, uint32_t zone, pvrvk::PipelineStageFlags pipelineStage = pvrvk::PipelineStageFlags::e_BOTTOM_OF_PIPE_BIT);
+
+	/// <summary>Get the statistics of all zones measured so far, in the order they were first encountered.</summary>
+	/// <returns>The zone statistics.</returns>
+	const std::vector<ZoneStats>& getZoneStats() const
+	{
+		return _stats;
+	}
+
+	/// <summary>Get the statistics of a zone.</summary>
+	/// <param name="name">The name of the zone</param>
+	/// <returns>The zone statistics, or nullptr if the zone has not been measured.</returns>
+	const ZoneStats* getZoneStats(const std::string& name) const;
+
+	/// <summary>Format the statistics of all zones, one zone per line, e.g. for display with the UIRenderer or for logging.</summary>
+	/// <returns>The formatted statistics.</returns>
+	std::string getSummary() const;
+
+	/// <summary>Log the statistics of all zones.</summary>
+	/// <param name="severity">The severity to log with</param>
+	void logSummary(LogLevel severity = LogLevel::Information) const;
+
+	/// <summary>Set whether zones are also emitted as debug marker regions (if VK_EXT_debug_marker is enabled).</summary>
+	/// <param name="emitDebugMarkers">True to emit debug marker regions</param>
+	void setEmitDebugMarkers(bool emitDebugMarkers)
+	{
+		_emitDebugMarkers = emitDebugMarkers;
+	}
+
+	/// <summary>Check whether profiling is supported on the queue the profiler was initialised with.</summary>
+	/// <returns>True if timestamps are supported.</returns>
+	bool isSupported() const
+	{
+		return _queryPool.isValid();
+	}
+
+private:
+	struct FrameQueries
+	{
+		std::vector<uint32_t> zoneIds; // The zone id of each pair of queries
+		bool pending;
+		FrameQueries() : pending(false) {}
+	};
+
+	struct ZoneHistory
+	{
+		std::vector<double> samples; // Ring of the per-frame durations
+		uint32_t next;
+		double currentFrameMs;
+		bool measuredThisFrame;
+		ZoneHistory() : next(0), currentFrameMs(0), measuredThisFrame(false) {}
+	};
+
+	void readBack(uint32_t frameIndex);
+	uint32_t getZoneId(const char* name);
+
+	pvrvk::Device _device;
+	pvrvk::QueryPool _queryPool;
+	double _timestampPeriodMs;
+	uint64_t _timestampMask;
+	uint32_t _maxZonesPerFrame;
+	uint32_t _historyFrames;
+	uint32_t _currentFrame;
+	bool _frameActive;
+	bool _emitDebugMarkers;
+	std::vector<FrameQueries> _frames;
+	std::vector<uint64_t> _results;
+	std::map<std::string, uint32_t> _zoneIds;
+	std::vector<ZoneHistory> _histories;
+	std::vector<ZoneStats> _stats;
+};
+} // namespace utils
+} // namespace pvr
@@ -19,7 +19,10 @@
 #include "PVRVk/MemoryBarrierVk.h"
 #include "PVRVk/DisplayVk.h"
 #include "PVRVk/DisplayModeVk.h"
+#include "PVRVk/PipelineCacheVk.h"
 #include "pvr_openlib.h"
+#include <atomic>
+#include <thread>
 
 namespace pvr {
 namespace utils {
@@ -844,7 +847,7 @@ const Texture* decompressIfRequired(const Texture& texture, Texture& decompresse
 
 pvrvk::Image uploadImageHelper(pvrvk::Device& device, const Texture& texture, bool allowDecompress, pvrvk::CommandBufferBase commandBuffer, pvrvk::ImageUsageFlags usageFlags,
 	pvrvk::ImageLayout finalLayout, vma::Allocator* bufferAllocator = nullptr, vma::Allocator* imageAllocator = nullptr,
-	vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE)
+	vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE, TransientBufferAllocator* stagingRing = nullptr)
 {
 	// Check that the texture is valid.
 	if (!texture.getDataSize())
@@ -941,7 +944,14 @@ pvrvk::Image uploadImageHelper(pvrvk::Device& device, const Texture& texture, bo
 			} // next arrayslice
 		} // next miplevel
 
-		updateImage(device, commandBuffer, imageUpdates.data(), static_cast<uint32_t>(imageUpdates.size()), format, finalLayout, texFaces > 1, image, bufferAllocator);
+		if (stagingRing)
+		{
+			updateImage(device, commandBuffer, imageUpdates.data(), static_cast<uint32_t>(imageUpdates.size()), format, finalLayout, texFaces > 1, image, *stagingRing);
+		}
+		else
+		{
+			updateImage(device, commandBuffer, imageUpdates.data(), static_cast<uint32_t>(imageUpdates.size()), format, finalLayout, texFaces > 1, image, bufferAllocator);
+		}
 	}
 	commandBuffer->debugMarkerEndEXT();
 	return image;
@@ -949,7 +959,7 @@ pvrvk::Image uploadImageHelper(pvrvk::Device& device, const Texture& texture, bo
 
 pvrvk::ImageView uploadImageAndViewHelper(pvrvk::Device& device, const Texture& texture, bool allowDecompress, pvrvk::CommandBufferBase commandBuffer,
 	pvrvk::ImageUsageFlags usageFlags, pvrvk::ImageLayout finalLayout, vma::Allocator* bufferAllocator = nullptr, vma::Allocator* imageAllocator = nullptr,
-	vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE)
+	vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE, TransientBufferAllocator* stagingRing = nullptr)
 {
 	pvrvk::ComponentMapping components = {
 		pvrvk::ComponentSwizzle::e_IDENTITY,
@@ -982,7 +992,8 @@ pvrvk::ImageView uploadImageAndViewHelper(pvrvk::Device& device, const Texture&
 		components.setA(pvrvk::ComponentSwizzle::e_R);
 	}
 	return device->createImageView(pvrvk::ImageViewCreateInfo(
-		uploadImageHelper(device, texture, allowDecompress, commandBuffer, usageFlags, finalLayout, bufferAllocator, imageAllocator, imageAllocationCreateFlags), components));
+		uploadImageHelper(device, texture, allowDecompress, commandBuffer, usageFlags, finalLayout, bufferAllocator, imageAllocator, imageAllocationCreateFlags, stagingRing),
+		components));
 }
 
 inline pvrvk::ImageView loadAndUploadImageAndViewHelper(pvrvk::Device& device, const char* fileName, bool allowDecompress, pvrvk::CommandBufferBase commandBuffer,
@@ -1068,6 +1079,14 @@ pvrvk::ImageView uploadImageAndView(pvrvk::Device& device, const Texture& textur
 		device, texture, allowDecompress, pvrvk::CommandBufferBase(commandBuffer), usageFlags, finalLayout, stagingBufferAllocator, imageAllocator, imageAllocationCreateFlags);
 }
 
+pvrvk::ImageView uploadImageAndView(pvrvk::Device& device, const Texture& texture, bool allowDecompress, pvrvk::CommandBuffer& commandBuffer,
+	TransientBufferAllocator& stagingRing, pvrvk::ImageUsageFlags usageFlags, pvrvk::ImageLayout finalLayout, vma::Allocator* imageAllocator,
+	vma::AllocationCreateFlags imageAllocationCreateFlags)
+{
+	return uploadImageAndViewHelper(
+		device, texture, allowDecompress, pvrvk::CommandBufferBase(commandBuffer), usageFlags, finalLayout, nullptr, imageAllocator, imageAllocationCreateFlags, &stagingRing);
+}
+
 void generateTextureAtlas(pvrvk::Device& device, const pvrvk::Image* inputImages, pvrvk::Rect2Df* outUVs, uint32_t numImages, pvrvk::ImageLayout inputImageLayout,
 	pvrvk::ImageView* outImageView, TextureHeader* outDescriptor, pvrvk::CommandBufferBase cmdBuffer, pvrvk::ImageLayout finalLayout, vma::Allocator* imageAllocator,
 	vma::AllocationCreateFlags imageAllocationCreateFlags)
@@ -1646,68 +1665,175 @@ void saveImage(pvrvk::Image image, const pvrvk::ImageLayout imageInitialLayout,
 	writeTGA(filename.c_str(), dim.width, dim.height, reinterpret_cast<const unsigned char*>(buffer.data()), stride, screenshotScale);
 }
 
-void updateImage(pvrvk::Device& device, pvrvk::CommandBufferBase cbuffTransfer, ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, pvrvk::Format format,
-	pvrvk::ImageLayout layout, bool isCubeMap, pvrvk::Image& image, vma::Allocator* bufferAllocator)
+namespace {
+// Offsets of copyBufferToImage regions must be multiples of 4 and of the texel (or compressed block) size. 48 is a multiple of every texel size in use
+// (1, 2, 3, 4, 6, 8, 12 and 16 bytes), so regions packed at multiples of it are valid for any format.
+const pvrvk::DeviceSize ImageUpdateRegionAlignment = 48;
+
+// Calculates the offset of each region relative to the (suitably aligned) start of the staging data and returns the total size required.
+pvrvk::DeviceSize packImageUpdateRegions(const ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, std::vector<pvrvk::DeviceSize>& outOffsets)
 {
-	using namespace vma;
-	if (!(cbuffTransfer.isValid() && cbuffTransfer->isRecording()))
+	outOffsets.resize(numUpdateInfos);
+	pvrvk::DeviceSize size = 0;
+	for (uint32_t i = 0; i < numUpdateInfos; ++i)
 	{
-		throw pvrvk::ErrorValidationFailedEXT("updateImage - Commandbuffer must be valid and in recording state");
+		assertion(updateInfos[i].data && updateInfos[i].dataSize, "Data and Data size must be valid");
+		outOffsets[i] = size;
+		size = align(size + updateInfos[i].dataSize, ImageUpdateRegionAlignment);
 	}
+	return size;
+}
 
-	uint32_t numFace = (isCubeMap ? 6 : 1);
+// Adds the barriers transitioning every subresource touched by the updates. If the updates cover a complete box of mip levels x array layers,
+// a single barrier is used, otherwise one barrier per distinct subresource. Either way, the caller records them with a single pipelineBarrier.
+void addImageUpdateBarriers(pvrvk::MemoryBarrierSet& barriers, const ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, uint32_t numFace, pvrvk::Image& image,
+	pvrvk::ImageAspectFlags aspect, pvrvk::ImageLayout oldLayout, pvrvk::ImageLayout newLayout)
+{
+	std::vector<std::pair<uint32_t, uint32_t>> subresources; // (mip level, array layer)
+	subresources.reserve(numUpdateInfos);
+	uint32_t minMip = static_cast<uint32_t>(-1), maxMip = 0, minLayer = static_cast<uint32_t>(-1), maxLayer = 0;
+	for (uint32_t i = 0; i < numUpdateInfos; ++i)
+	{
+		const uint32_t mip = updateInfos[i].mipLevel;
+		const uint32_t layer = updateInfos[i].arrayIndex * numFace + updateInfos[i].cubeFace;
+		subresources.emplace_back(mip, layer);
+		minMip = std::min(minMip, mip);
+		maxMip = std::max(maxMip, mip);
+		minLayer = std::min(minLayer, layer);
+		maxLayer = std::max(maxLayer, layer);
+	}
+	std::sort(subresources.begin(), subresources.end());
+	subresources.erase(std::unique(subresources.begin(), subresources.end()), subresources.end());
+
+	const pvrvk::AccessFlags srcAccess = getAccesFlagsFromLayout(oldLayout);
+	const pvrvk::AccessFlags dstAccess = getAccesFlagsFromLayout(newLayout);
+	if (subresources.size() == static_cast<size_t>(maxMip - minMip + 1) * (maxLayer - minLayer + 1))
+	{
+		barriers.addBarrier(pvrvk::ImageMemoryBarrier(srcAccess, dstAccess, image,
+			pvrvk::ImageSubresourceRange(aspect, minMip, maxMip - minMip + 1, minLayer, maxLayer - minLayer + 1), oldLayout, newLayout, static_cast<uint32_t>(-1),
+			static_cast<uint32_t>(-1)));
+		return;
+	}
+	for (const std::pair<uint32_t, uint32_t>& subresource : subresources)
+	{
+		barriers.addBarrier(pvrvk::ImageMemoryBarrier(srcAccess, dstAccess, image, pvrvk::ImageSubresourceRange(aspect, subresource.first, 1, subresource.second, 1),
+			oldLayout, newLayout, static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)));
+	}
+}
 
-	uint32_t hwSlice;
-	std::vector<pvrvk::Buffer> stagingBuffers;
+// Records the upload of all regions of an image, whose data has already been written to stagingBuffer at stagingOffset + regionOffsets[i]:
+// one barrier batch to e_TRANSFER_DST_OPTIMAL, one copyBufferToImage for all regions and one barrier batch to the final layout.
+void recordImageUpdate(pvrvk::CommandBufferBase& cbuffTransfer, const ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, pvrvk::Format format, pvrvk::ImageLayout layout,
+	bool isCubeMap, pvrvk::Image& image, const pvrvk::Buffer& stagingBuffer, pvrvk::DeviceSize stagingOffset, const std::vector<pvrvk::DeviceSize>& regionOffsets)
+{
+	const uint32_t numFace = (isCubeMap ? 6 : 1);
+	const pvrvk::ImageAspectFlags aspect = inferAspectFromFormat(format);
 
+	std::vector<pvrvk::BufferImageCopy> regions(numUpdateInfos);
+	for (uint32_t i = 0; i < numUpdateInfos; ++i)
 	{
-		cbuffTransfer->debugMarkerBeginEXT("PVRUtilsVk::updateImage");
+		const ImageUpdateInfo& mipLevelUpdate = updateInfos[i];
+		pvrvk::BufferImageCopy& imgcp = regions[i];
+		imgcp.setBufferOffset(stagingOffset + regionOffsets[i]);
+		imgcp.setImageOffset(pvrvk::Offset3D(mipLevelUpdate.offsetX, mipLevelUpdate.offsetY, mipLevelUpdate.offsetZ));
+		imgcp.setImageExtent(pvrvk::Extent3D(mipLevelUpdate.imageWidth, mipLevelUpdate.imageHeight, mipLevelUpdate.depth));
+		imgcp.setImageSubresource(pvrvk::ImageSubresourceLayers(aspect, mipLevelUpdate.mipLevel, mipLevelUpdate.arrayIndex * numFace + mipLevelUpdate.cubeFace, 1));
+		imgcp.setBufferRowLength(mipLevelUpdate.dataWidth);
+		imgcp.setBufferImageHeight(mipLevelUpdate.dataHeight);
+	}
 
-		stagingBuffers.resize(numUpdateInfos);
-		pvrvk::BufferImageCopy imgcp = {};
+	pvrvk::MemoryBarrierSet barriers;
+	addImageUpdateBarriers(barriers, updateInfos, numUpdateInfos, numFace, image, aspect, pvrvk::ImageLayout::e_UNDEFINED, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL);
+	cbuffTransfer->pipelineBarrier(pvrvk::PipelineStageFlags::e_ALL_COMMANDS_BIT, pvrvk::PipelineStageFlags::e_TRANSFER_BIT, barriers, true);
 
-		for (uint32_t i = 0; i < numUpdateInfos; ++i)
-		{
-			const ImageUpdateInfo& mipLevelUpdate = updateInfos[i];
-			assertion(mipLevelUpdate.data && mipLevelUpdate.dataSize, "Data and Data size must be valid");
+	cbuffTransfer->copyBufferToImage(stagingBuffer, image, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, numUpdateInfos, regions.data());
 
-			hwSlice = mipLevelUpdate.arrayIndex * numFace + mipLevelUpdate.cubeFace;
+	if (layout != pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL)
+	{
+		barriers.clearAllBarriers();
+		addImageUpdateBarriers(barriers, updateInfos, numUpdateInfos, numFace, image, aspect, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, layout);
+		cbuffTransfer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_ALL_COMMANDS_BIT, barriers, true);
+	}
+}
 
-			// Will write the switch layout commands from the universal queue to the transfer queue to both the
-			// transfer command buffer and the universal command buffer
-			setImageLayoutAndQueueFamilyOwnership(pvrvk::CommandBufferBase(), cbuffTransfer, static_cast<uint32_t>(-1), static_cast<uint32_t>(-1), pvrvk::ImageLayout::e_UNDEFINED,
-				pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, image, mipLevelUpdate.mipLevel, 1, hwSlice, 1, inferAspectFromFormat(format));
+void copyImageUpdateData(const ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, char* dst, const std::vector<pvrvk::DeviceSize>& regionOffsets)
+{
+	for (uint32_t i = 0; i < numUpdateInfos; ++i)
+	{
+		memcpy(dst + regionOffsets[i], updateInfos[i].data, updateInfos[i].dataSize);
+	}
+}
 
-			// Create a staging buffer to use as the source of a copyBufferToImage
-			stagingBuffers[i] = createBuffer(device, mipLevelUpdate.dataSize, pvrvk::BufferUsageFlags::e_TRANSFER_SRC_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
-				pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT, bufferAllocator, vma::AllocationCreateFlags::e_MAPPED_BIT);
+void checkImageUpdateCommandBuffer(pvrvk::CommandBufferBase& cbuffTransfer)
+{
+	if (!(cbuffTransfer.isValid() && cbuffTransfer->isRecording()))
+	{
+		throw pvrvk::ErrorValidationFailedEXT("updateImage - Commandbuffer must be valid and in recording state");
+	}
+}
+} // namespace
 
-			stagingBuffers[i]->setObjectName("PVRUtilsVk::updateImage::Temporary Image Upload Buffer");
-			imgcp.setImageOffset(pvrvk::Offset3D(mipLevelUpdate.offsetX, mipLevelUpdate.offsetY, mipLevelUpdate.offsetZ));
-			imgcp.setImageExtent(pvrvk::Extent3D(mipLevelUpdate.imageWidth, mipLevelUpdate.imageHeight, 1));
+void updateImage(pvrvk::Device& device, pvrvk::CommandBufferBase cbuffTransfer, ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, pvrvk::Format format,
+	pvrvk::ImageLayout layout, bool isCubeMap, pvrvk::Image& image, vma::Allocator* bufferAllocator)
+{
+	checkImageUpdateCommandBuffer(cbuffTransfer);
+	if (!numUpdateInfos)
+	{
+		return;
+	}
+	cbuffTransfer->debugMarkerBeginEXT("PVRUtilsVk::updateImage");
 
-			imgcp.setImageSubresource(pvrvk::ImageSubresourceLayers(inferAspectFromFormat(format), updateInfos[i].mipLevel, hwSlice, 1));
-			imgcp.setBufferRowLength(mipLevelUpdate.dataWidth);
-			imgcp.setBufferImageHeight(mipLevelUpdate.dataHeight);
+	// A single staging buffer holds the data of all regions. It is kept alive by the command buffer until it is reset.
+	debug_assertion(cbuffTransfer->getRetainObjectReferences(), "updateImage: The command buffer must retain its object references to keep the staging buffer alive");
+	std::vector<pvrvk::DeviceSize> regionOffsets;
+	const pvrvk::DeviceSize stagingSize = packImageUpdateRegions(updateInfos, numUpdateInfos, regionOffsets);
+	pvrvk::Buffer stagingBuffer = createBuffer(device, stagingSize, pvrvk::BufferUsageFlags::e_TRANSFER_SRC_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
+		pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT, bufferAllocator, vma::AllocationCreateFlags::e_MAPPED_BIT);
+	stagingBuffer->setObjectName("PVRUtilsVk::updateImage::Temporary Image Upload Buffer");
 
-			const uint8_t* srcData;
-			uint32_t srcDataSize;
-			srcData = static_cast<const uint8_t*>(mipLevelUpdate.data);
-			srcDataSize = mipLevelUpdate.dataSize;
+	pvrvk::DeviceMemory memory = stagingBuffer->getDeviceMemory();
+	const bool wasMapped = memory->isMapped();
+	char* mappedData = static_cast<char*>(wasMapped ? memory->getMappedData() : memory->map(0, VK_WHOLE_SIZE));
+	copyImageUpdateData(updateInfos, numUpdateInfos, mappedData, regionOffsets);
+	if ((memory->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == pvrvk::MemoryPropertyFlags(0))
+	{
+		memory->flushRange(0, VK_WHOLE_SIZE);
+	}
+	if (!wasMapped)
+	{
+		memory->unmap();
+	}
 
-			updateHostVisibleBuffer(stagingBuffers[i], srcData, 0, srcDataSize, true);
+	recordImageUpdate(cbuffTransfer, updateInfos, numUpdateInfos, format, layout, isCubeMap, image, stagingBuffer, 0, regionOffsets);
+	cbuffTransfer->debugMarkerEndEXT();
+}
 
-			cbuffTransfer->copyBufferToImage(stagingBuffers[i], image, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, 1, &imgcp);
+void updateImage(pvrvk::Device& device, pvrvk::CommandBufferBase cbuffTransfer, ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, pvrvk::Format format,
+	pvrvk::ImageLayout layout, bool isCubeMap, pvrvk::Image& image, TransientBufferAllocator& stagingRing)
+{
+	checkImageUpdateCommandBuffer(cbuffTransfer);
+	if (!numUpdateInfos)
+	{
+		return;
+	}
+	std::vector<pvrvk::DeviceSize> regionOffsets;
+	const pvrvk::DeviceSize stagingSize = packImageUpdateRegions(updateInfos, numUpdateInfos, regionOffsets);
 
-			// CAUTION: We swapped src and dst queue families as, if there was no ownership transfer, no problem - queue families
-			// will be ignored.
-			// Will write the switch layout commands from the transfer queue to the universal queue to both the
-			// transfer command buffer and the universal command buffer
-			setImageLayoutAndQueueFamilyOwnership(cbuffTransfer, pvrvk::CommandBufferBase(), static_cast<uint32_t>(-1), static_cast<uint32_t>(-1),
-				pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, layout, image, mipLevelUpdate.mipLevel, 1, hwSlice, 1, inferAspectFromFormat(format));
-		}
-		cbuffTransfer->debugMarkerEndEXT();
+	// The ring aligns to its own default alignment, which is not necessarily a multiple of the texel size, so over-allocate and align inside the allocation.
+	TransientBufferAllocation allocation = stagingRing.allocate(stagingSize + ImageUpdateRegionAlignment);
+	if (!allocation.isValid())
+	{
+		Log(LogLevel::Warning, "updateImage: Staging ring could not fit %llu bytes. Falling back to a dedicated staging buffer.", static_cast<unsigned long long>(stagingSize));
+		updateImage(device, cbuffTransfer, updateInfos, numUpdateInfos, format, layout, isCubeMap, image, nullptr);
+		return;
 	}
+	cbuffTransfer->debugMarkerBeginEXT("PVRUtilsVk::updateImage");
+	const pvrvk::DeviceSize stagingOffset = align(allocation.offset, ImageUpdateRegionAlignment);
+	copyImageUpdateData(updateInfos, numUpdateInfos, static_cast<char*>(allocation.mappedData) + (stagingOffset - allocation.offset), regionOffsets);
+	stagingRing.flush();
+
+	recordImageUpdate(cbuffTransfer, updateInfos, numUpdateInfos, format, layout, isCubeMap, image, allocation.buffer, stagingOffset, regionOffsets);
+	cbuffTransfer->debugMarkerEndEXT();
 }
 
 void create3dPlaneMesh(uint32_t width, uint32_t depth, bool generateTexCoords, bool generateNormalCoords, assets::Mesh& outMesh)
@@ -2253,6 +2379,308 @@ pvrvk::Image uploadImage(pvrvk::Device& device, const Texture& texture, bool all
 	return uploadImageHelper(device, texture, allowDecompress, commandBuffer, usageFlags, finalLayout, stagingBufferAllocator, imageAllocator, imageAllocationCreateFlags);
 }
 
+pvrvk::Image uploadImage(pvrvk::Device& device, const Texture& texture, bool allowDecompress, pvrvk::CommandBuffer& commandBuffer, TransientBufferAllocator& stagingRing,
+	pvrvk::ImageUsageFlags usageFlags, pvrvk::ImageLayout finalLayout, vma::Allocator* imageAllocator, vma::AllocationCreateFlags imageAllocationCreateFlags)
+{
+	return uploadImageHelper(device, texture, allowDecompress, commandBuffer, usageFlags, finalLayout, nullptr, imageAllocator, imageAllocationCreateFlags, &stagingRing);
+}
+
+namespace {
+// The header written in front of the data returned by vkGetPipelineCacheData. The data itself also starts with a header identifying the device, but
+// not the driver version, so the driver version (and the rest of the identity, for robustness against truncated data) is recorded separately.
+struct PipelineCacheFileHeader
+{
+	char magic[4];
+	uint32_t fileVersion;
+	uint32_t vendorID;
+	uint32_t deviceID;
+	uint32_t driverVersion;
+	uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+	uint64_t dataSize;
+};
+const char PipelineCacheFileMagic[4] = { 'P', 'V', 'R', 'C' };
+const uint32_t PipelineCacheFileVersion = 1;
+
+void fillPipelineCacheFileHeader(pvrvk::Device& device, PipelineCacheFileHeader& header)
+{
+	const pvrvk::PhysicalDeviceProperties& properties = device->getPhysicalDevice()->getProperties();
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PipelineCacheFileMagic, sizeof(header.magic));
+	header.fileVersion = PipelineCacheFileVersion;
+	header.vendorID = properties.getVendorID();
+	header.deviceID = properties.getDeviceID();
+	header.driverVersion = properties.getDriverVersion();
+	memcpy(header.pipelineCacheUUID, properties.getPipelineCacheUUID(), VK_UUID_SIZE);
+}
+
+// Checks the file header and the VkPipelineCacheHeaderVersionOne at the start of the Vulkan data against the current device
+bool isPipelineCacheDataCompatible(pvrvk::Device& device, const std::vector<char>& fileData, const char*& outData, size_t& outDataSize)
+{
+	PipelineCacheFileHeader expected;
+	fillPipelineCacheFileHeader(device, expected);
+	if (fileData.size() < sizeof(PipelineCacheFileHeader))
+	{
+		return false;
+	}
+	PipelineCacheFileHeader header;
+	memcpy(&header, fileData.data(), sizeof(header));
+	if (memcmp(header.magic, expected.magic, sizeof(header.magic)) || header.fileVersion != expected.fileVersion || header.vendorID != expected.vendorID ||
+		header.deviceID != expected.deviceID || header.driverVersion != expected.driverVersion || memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) ||
+		header.dataSize != fileData.size() - sizeof(PipelineCacheFileHeader))
+	{
+		return false;
+	}
+
+	outData = fileData.data() + sizeof(PipelineCacheFileHeader);
+	outDataSize = static_cast<size_t>(header.dataSize);
+	// headerSize, headerVersion, vendorID, deviceID, pipelineCacheUUID
+	const size_t vkHeaderSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+	if (outDataSize < vkHeaderSize)
+	{
+		return false;
+	}
+	uint32_t vkHeader[4];
+	memcpy(vkHeader, outData, sizeof(vkHeader));
+	return vkHeader[0] >= vkHeaderSize && vkHeader[1] == static_cast<uint32_t>(VK_PIPELINE_CACHE_HEADER_VERSION_ONE) && vkHeader[2] == expected.vendorID &&
+		vkHeader[3] == expected.deviceID && !memcmp(outData + sizeof(vkHeader), expected.pipelineCacheUUID, VK_UUID_SIZE);
+}
+} // namespace
+
+pvrvk::PipelineCache loadPipelineCache(pvrvk::Device& device, const std::string& filePath)
+{
+	std::vector<char> fileData;
+	try
+	{
+		FileStream stream(filePath, "rb", false);
+		stream.open();
+		if (stream.isopen())
+		{
+			fileData = stream.readToEnd<char>();
+		}
+	}
+	catch (const std::exception& e)
+	{
+		Log(LogLevel::Warning, "loadPipelineCache: Could not read pipeline cache file '%s' (%s). Creating an empty pipeline cache.", filePath.c_str(), e.what());
+		fileData.clear();
+	}
+	if (fileData.empty())
+	{
+		Log(LogLevel::Information, "loadPipelineCache: No pipeline cache file found at '%s'. Creating an empty pipeline cache.", filePath.c_str());
+		return device->createPipelineCache();
+	}
+
+	const char* data = nullptr;
+	size_t dataSize = 0;
+	if (!isPipelineCacheDataCompatible(device, fileData, data, dataSize))
+	{
+		Log(LogLevel::Information, "loadPipelineCache: Pipeline cache file '%s' was created by a different device or driver, or is corrupt. Creating an empty pipeline cache.",
+			filePath.c_str());
+		return device->createPipelineCache();
+	}
+	Log(LogLevel::Information, "loadPipelineCache: Loaded %llu bytes of pipeline cache data from '%s'.", static_cast<unsigned long long>(dataSize), filePath.c_str());
+	return device->createPipelineCache(pvrvk::PipelineCacheCreateInfo(dataSize, data));
+}
+
+bool savePipelineCache(pvrvk::Device& device, const pvrvk::PipelineCache& pipelineCache, const std::string& filePath)
+{
+	std::vector<char> fileData(sizeof(PipelineCacheFileHeader) + pipelineCache->getCacheMaxDataSize());
+	size_t dataSize = fileData.size() - sizeof(PipelineCacheFileHeader);
+	if (dataSize)
+	{
+		dataSize = pipelineCache->getCacheData(dataSize, fileData.data() + sizeof(PipelineCacheFileHeader));
+	}
+	PipelineCacheFileHeader header;
+	fillPipelineCacheFileHeader(device, header);
+	header.dataSize = dataSize;
+	memcpy(fileData.data(), &header, sizeof(header));
+
+	// Write to a temporary file and replace the old file only once complete, so that an interrupted save never leaves a truncated cache behind.
+	const std::string tempFilePath = filePath + ".tmp";
+	try
+	{
+		FileStream stream(tempFilePath, "wb");
+		stream.open();
+		stream.writeExact(1, sizeof(PipelineCacheFileHeader) + dataSize, fileData.data());
+		stream.close();
+	}
+	catch (const std::exception& e)
+	{
+		Log(LogLevel::Error, "savePipelineCache: Could not write pipeline cache file '%s' (%s).", tempFilePath.c_str(), e.what());
+		std::remove(tempFilePath.c_str());
+		return false;
+	}
+	std::remove(filePath.c_str());
+	if (std::rename(tempFilePath.c_str(), filePath.c_str()) != 0)
+	{
+		Log(LogLevel::Error, "savePipelineCache: Could not rename '%s' to '%s'.", tempFilePath.c_str(), filePath.c_str());
+		return false;
+	}
+	return true;
+}
+
+void createGraphicsPipelinesParallel(pvrvk::Device& device, const pvrvk::GraphicsPipelineCreateInfo* createInfos, uint32_t numCreateInfos,
+	const pvrvk::PipelineCache& pipelineCache, pvrvk::GraphicsPipeline* outPipelines, uint32_t maxThreads)
+{
+	if (!numCreateInfos)
+	{
+		return;
+	}
+	uint32_t numThreads = maxThreads ? maxThreads : std::max(std::thread::hardware_concurrency(), 1u);
+	numThreads = std::min(numThreads, numCreateInfos);
+
+	// Seed every thread cache with the existing contents, so that warm-started pipelines are still cache hits
+	std::vector<char> seedData;
+	if (pipelineCache.isValid())
+	{
+		seedData.resize(pipelineCache->getCacheMaxDataSize());
+		seedData.resize(seedData.empty() ? 0 : pipelineCache->getCacheData(seedData.size(), seedData.data()));
+	}
+	std::vector<pvrvk::PipelineCache> threadCaches(numThreads);
+	for (uint32_t i = 0; i < numThreads; ++i)
+	{
+		threadCaches[i] = device->createPipelineCache(pvrvk::PipelineCacheCreateInfo(seedData.size(), seedData.empty() ? nullptr : seedData.data()));
+	}
+
+	std::atomic<uint32_t> nextPipeline(0);
+	std::vector<std::exception_ptr> errors(numThreads);
+	auto worker = [&](uint32_t threadIndex) {
+		try
+		{
+			for (uint32_t i = nextPipeline++; i < numCreateInfos; i = nextPipeline++)
+			{
+				outPipelines[i] = device->createGraphicsPipeline(createInfos[i], threadCaches[threadIndex]);
+			}
+		}
+		catch (...)
+		{
+			errors[threadIndex] = std::current_exception();
+			// Make the other threads stop picking up work
+			nextPipeline = numCreateInfos;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(numThreads - 1);
+	for (uint32_t i = 1; i < numThreads; ++i)
+	{
+		threads.emplace_back(worker, i);
+	}
+	worker(0);
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	for (const std::exception_ptr& error : errors)
+	{
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+	if (pipelineCache.isValid())
+	{
+		device->mergePipelineCache(threadCaches.data(), numThreads, pipelineCache);
+	}
+}
+
+namespace {
+pvrvk::DeviceSize alignUp(pvrvk::DeviceSize value, pvrvk::DeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+void uploadSharedBuffer(pvrvk::Device& device, pvrvk::Buffer& buffer, const std::vector<char>& data, pvrvk::CommandBuffer& uploadCmdBuffer,
+	bool& requiresCommandBufferSubmission, vma::Allocator* bufferAllocator)
+{
+	if ((buffer->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT) != 0)
+	{
+		updateHostVisibleBuffer(buffer, data.data(), 0, data.size(), true);
+	}
+	else
+	{
+		updateBufferUsingStagingBuffer(device, buffer, pvrvk::CommandBufferBase(uploadCmdBuffer), data.data(), 0, data.size(), bufferAllocator);
+		requiresCommandBufferSubmission = true;
+	}
+}
+} // namespace
+
+void createSharedBuffersFromMeshes(pvrvk::Device& device, const assets::Mesh* const* meshes, uint32_t numMeshes, SharedMeshBuffers& outBuffers,
+	pvrvk::CommandBuffer& uploadCmdBuffer, bool& requiresCommandBufferSubmission, vma::Allocator* bufferAllocator, vma::AllocationCreateFlags vmaAllocationCreateFlags,
+	pvrvk::DeviceSize maxBufferSize)
+{
+	requiresCommandBufferSubmission = false;
+	outBuffers.vbos.clear();
+	outBuffers.ibos.clear();
+	outBuffers.meshes.clear();
+	outBuffers.meshes.resize(numMeshes);
+
+	// Lay out all the data on the CPU first, so that every buffer is created with its final size and uploaded with a single copy
+	std::vector<std::vector<char> > vertexData;
+	std::vector<std::vector<char> > indexData;
+	for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+	{
+		const assets::Mesh& mesh = *meshes[meshIndex];
+		SharedMeshRange& range = outBuffers.meshes[meshIndex];
+		range.numVertices = mesh.getNumVertices();
+
+		// Every data element starts at a multiple of its stride, so that it can be addressed by vertex index from the start of the buffer
+		pvrvk::DeviceSize vertexOffset = vertexData.empty() ? 0 : vertexData.back().size();
+		pvrvk::DeviceSize vertexEnd = vertexOffset;
+		for (uint32_t i = 0; i < mesh.getNumDataElements(); ++i)
+		{
+			vertexEnd = alignUp(vertexEnd, std::max(mesh.getStride(i), 1u)) + mesh.getDataSize(i);
+		}
+		if (vertexData.empty() || (vertexEnd > maxBufferSize && vertexOffset != 0))
+		{
+			vertexData.push_back(std::vector<char>());
+		}
+		std::vector<char>& vbo = vertexData.back();
+		range.vboIndex = static_cast<uint32_t>(vertexData.size() - 1);
+		range.vertexDataOffsets.resize(mesh.getNumDataElements());
+		for (uint32_t i = 0; i < mesh.getNumDataElements(); ++i)
+		{
+			const uint32_t stride = std::max(mesh.getStride(i), 1u);
+			const pvrvk::DeviceSize offset = alignUp(vbo.size(), stride);
+			vbo.resize(static_cast<size_t>(offset + mesh.getDataSize(i)));
+			memcpy(vbo.data() + offset, mesh.getData(i), mesh.getDataSize(i));
+			range.vertexDataOffsets[i] = offset;
+		}
+		range.baseVertex = mesh.getNumDataElements() == 1 ? static_cast<int32_t>(range.vertexDataOffsets[0] / std::max(mesh.getStride(0), 1u)) : 0;
+
+		if (mesh.getNumFaces())
+		{
+			const assets::Mesh::FaceData& faces = mesh.getFaces();
+			const uint32_t indexSize = faces.getDataTypeSize() / 8;
+			const pvrvk::DeviceSize indexOffset = indexData.empty() ? 0 : alignUp(indexData.back().size(), indexSize);
+			if (indexData.empty() || (indexOffset + faces.getDataSize() > maxBufferSize && indexOffset != 0))
+			{
+				indexData.push_back(std::vector<char>());
+			}
+			std::vector<char>& ibo = indexData.back();
+			const pvrvk::DeviceSize offset = alignUp(ibo.size(), indexSize);
+			ibo.resize(static_cast<size_t>(offset + faces.getDataSize()));
+			memcpy(ibo.data() + offset, faces.getData(), faces.getDataSize());
+			range.iboIndex = static_cast<uint32_t>(indexData.size() - 1);
+			range.firstIndex = static_cast<uint32_t>(offset / indexSize);
+			range.numIndices = static_cast<uint32_t>(faces.getDataSize() / indexSize);
+			range.indexType = convertToPVRVk(faces.getDataType());
+		}
+	}
+
+	for (size_t i = 0; i < vertexData.size(); ++i)
+	{
+		outBuffers.vbos.push_back(createBuffer(device, vertexData[i].size(), pvrvk::BufferUsageFlags::e_VERTEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT,
+			pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, bufferAllocator, vmaAllocationCreateFlags));
+		uploadSharedBuffer(device, outBuffers.vbos.back(), vertexData[i], uploadCmdBuffer, requiresCommandBufferSubmission, bufferAllocator);
+	}
+	for (size_t i = 0; i < indexData.size(); ++i)
+	{
+		outBuffers.ibos.push_back(createBuffer(device, indexData[i].size(), pvrvk::BufferUsageFlags::e_INDEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT,
+			pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, bufferAllocator, vmaAllocationCreateFlags));
+		uploadSharedBuffer(device, outBuffers.ibos.back(), indexData[i], uploadCmdBuffer, requiresCommandBufferSubmission, bufferAllocator);
+	}
+}
+
 } // namespace utils
 } // namespace pvr
   //!\endcond
@@ -24,6 +24,7 @@
 #include "PVRVk/FramebufferVk.h"
 #include "PVRVk/SwapchainVk.h"
 #include "PVRUtils/Vulkan/MemoryAllocator.h"
+#include "PVRUtils/Vulkan/TransientBufferAllocatorVk.h"
 #include "PVRUtils/MultiObject.h"
 
 namespace pvr {
@@ -195,6 +196,23 @@ pvrvk::ImageView uploadImageAndView(pvrvk::Device& device, const Texture& textur
 	vma::Allocator* stagingBufferAllocator = nullptr, vma::Allocator* imageAllocator = nullptr,
 	vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE);
 
+/// <summary>Upload image to gpu and create a view for it, staging the data in a persistent staging ring. The upload commands are recorded in the
+/// commandbuffer. The fence of the ring's current frame must not signal before the command buffer has completed (see updateImage).</summary>
+/// <param name="device">The device to use to create the image and image view.</param>
+/// <param name="texture">The source pvr::Texture object from which to take the texture data.</param>
+/// <param name="allowDecompress">Specifies whether the texture can be decompressed as part of the image upload.</param>
+/// <param name="commandBuffer">A command buffer to which the upload operations should be added.</param>
+/// <param name="stagingRing">A TransientBufferAllocator created with e_TRANSFER_SRC_BIT usage from which the staging memory is allocated.</param>
+/// <param name="usageFlags">Specifies the usage flags for the image being created.</param>
+/// <param name="finalLayout">The final image layout the image will be transitioned to.</param>
+/// <param name="imageAllocator">A VMA allocator used to allocate memory for the created image.</param>
+/// <param name="imageAllocationCreateFlags">VMA Allocation creation flags for the image.</param>
+/// <returns>The image view.</returns>
+pvrvk::ImageView uploadImageAndView(pvrvk::Device& device, const Texture& texture, bool allowDecompress, pvrvk::CommandBuffer& commandBuffer,
+	TransientBufferAllocator& stagingRing, pvrvk::ImageUsageFlags usageFlags = pvrvk::ImageUsageFlags::e_SAMPLED_BIT,
+	pvrvk::ImageLayout finalLayout = pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL, vma::Allocator* imageAllocator = nullptr,
+	vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE);
+
 /// <summary>Upload image to gpu. The upload command and staging buffers are recorded in the commandbuffer.</summary>
 /// <param name="device">The device to use to create the image.</param>
 /// <param name="texture">The source pvr::Texture object from which to take the texture data.</param>
@@ -214,6 +232,22 @@ pvrvk::Image uploadImage(pvrvk::Device& device, const Texture& texture, bool all
 	vma::Allocator* stagingBufferAllocator = nullptr, vma::Allocator* imageAllocator = nullptr,
 	vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE);
 
+/// <summary>Upload image to gpu, staging the data in a persistent staging ring. The upload commands are recorded in the commandbuffer.
+/// The fence of the ring's current frame must not signal before the command buffer has completed (see updateImage).</summary>
+/// <param name="device">The device to use to create the image.</param>
+/// <param name="texture">The source pvr::Texture object from which to take the texture data.</param>
+/// <param name="allowDecompress">Specifies whether the texture can be decompressed as part of the image upload.</param>
+/// <param name="commandBuffer">A command buffer to which the upload operations should be added.</param>
+/// <param name="stagingRing">A TransientBufferAllocator created with e_TRANSFER_SRC_BIT usage from which the staging memory is allocated.</param>
+/// <param name="usageFlags">Specifies the usage flags for the image being created.</param>
+/// <param name="finalLayout">The final image layout the image will be transitioned to.</param>
+/// <param name="imageAllocator">A VMA allocator used to allocate memory for the created image.</param>
+/// <param name="imageAllocationCreateFlags">VMA Allocation creation flags for the image.</param>
+/// <returns>The image object.</returns>
+pvrvk::Image uploadImage(pvrvk::Device& device, const Texture& texture, bool allowDecompress, pvrvk::CommandBuffer& commandBuffer, TransientBufferAllocator& stagingRing,
+	pvrvk::ImageUsageFlags usageFlags = pvrvk::ImageUsageFlags::e_SAMPLED_BIT, pvrvk::ImageLayout finalLayout = pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL,
+	vma::Allocator* imageAllocator = nullptr, vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE);
+
 /// <summary>Load and upload image to gpu. The upload command and staging buffers are recorded in the commandbuffer.</summary>
 /// <param name="device">The device to use to create the image and image view.</param>
 /// <param name="fileName">The filename of a source texture from which to take the texture data.</param>
@@ -330,9 +364,8 @@ struct ImageUpdateInfo
 /// image in the supplied command buffer but NOT submit the command buffer, hence allowing the user
 /// to submit it at his own time.
 /// IMPORTANT. Assumes image layout is pvrvk::ImageLayout::e_DST_OPTIMAL
-/// IMPORTANT. The cleanup object that is the return value of the function
-/// must be kept alive as long until the moment that the relevant command buffer submission is finished.
-/// Then it can be destroyed (or the cleanup function be called) to free any relevant resources.</summary>
+/// IMPORTANT. The staging buffer is only kept alive by the command buffer, which must retain its object references
+/// (see CommandBufferBase_::setRetainObjectReferences) until the submission has finished.</summary>
 /// <param name="device">The device used to create the image</param>
 /// <param name="transferCommandBuffer">The command buffer into which the image update operations will be added.</param>
 /// <param name="updateInfos">This object is a c-style array of areas and the data to upload.</param>
@@ -346,6 +379,24 @@ struct ImageUpdateInfo
 void updateImage(pvrvk::Device& device, pvrvk::CommandBufferBase transferCommandBuffer, ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, pvrvk::Format format,
 	pvrvk::ImageLayout layout, bool isCubeMap, pvrvk::Image& image, vma::Allocator* bufferAllocator = nullptr);
 
+/// <summary>Utility function to update an image's data, staging the data in a persistent staging ring rather than in a newly created buffer.
+/// All regions are packed into a single allocation of the ring and copied with a single copyBufferToImage, and the layout transitions of all regions
+/// are recorded as one barrier batch before and one after the copy. The command buffer is recorded but NOT submitted.
+/// IMPORTANT. The staging ring must be between beginFrame calls, and the fence passed to the ring's beginFrame (or the next beginFrame with the same
+/// index) must signal only after the command buffer has completed, so that the staging space is not reused while the copy is still pending.
+/// If the ring cannot fit the data, a dedicated staging buffer is used instead.</summary>
+/// <param name="device">The device used to create the image</param>
+/// <param name="transferCommandBuffer">The command buffer into which the image update operations will be added.</param>
+/// <param name="updateInfos">This object is a c-style array of areas and the data to upload.</param>
+/// <param name="numUpdateInfos">The number of ImageUpdateInfo objects in updateInfos</param>
+/// <param name="format">The format of the image.</param>
+/// <param name="layout">The final image layout for the image being updated.</param>
+/// <param name="isCubeMap">Is the image a cubemap</param>
+/// <param name="image">The image to update</param>
+/// <param name="stagingRing">A TransientBufferAllocator created with e_TRANSFER_SRC_BIT usage from which the staging memory is allocated.</param>
+void updateImage(pvrvk::Device& device, pvrvk::CommandBufferBase transferCommandBuffer, ImageUpdateInfo* updateInfos, uint32_t numUpdateInfos, pvrvk::Format format,
+	pvrvk::ImageLayout layout, bool isCubeMap, pvrvk::Image& image, TransientBufferAllocator& stagingRing);
+
 /// <summary>Utility function to update a buffer's data. This function maps and unmap the buffer only if the buffer is not already mapped.</summary>
 /// <param name="buffer">The buffer to map -> update -> unmap.</param>
 /// <param name="data">The data to use in the update</param>
@@ -392,9 +443,14 @@ inline void updateHostVisibleBuffer(pvrvk::Buffer& buffer, const void* data, VkD
 /// <param name="offset">The offset to use for the map -> update -> unmap</param>
 /// <param name="size">The size of the data to be updated</param>
 /// <param name="stagingBufferAllocator">A VMA allocator used to allocate memory for the created staging buffer.</param>
+/// <remarks>The staging buffer is only kept alive by uploadCmdBuffer, which must retain its object references (see
+/// CommandBufferBase_::setRetainObjectReferences) until the submission has finished.</remarks>
 inline void updateBufferUsingStagingBuffer(pvrvk::Device& device, pvrvk::Buffer& buffer, pvrvk::CommandBufferBase uploadCmdBuffer, const void* data, VkDeviceSize offset = 0,
 	VkDeviceSize size = VK_WHOLE_SIZE, vma::Allocator* stagingBufferAllocator = nullptr)
 {
+	debug_assertion(uploadCmdBuffer->getRetainObjectReferences(),
+		"updateBufferUsingStagingBuffer: The command buffer must retain its object references to keep the staging buffer alive");
+
 	// Updating memory via the use of staging buffers is necessary when memory is not host visible. In this case the buffer memory will be updated indirectly as follows:
 	//		1. Create a staging buffer
 	//		2. map the staging buffer memory, update the memory, then unmap the buffer memory
@@ -1189,6 +1245,74 @@ inline void appendSingleBuffersFromModel(pvrvk::Device& device, const assets::Mo
 		requiresCommandBufferSubmission, bufferAllocator, vmaAllocationCreateFlags);
 }
 
+/// <summary>The location of a mesh inside the shared buffers created by createSharedBuffersFromMeshes.</summary>
+struct SharedMeshRange
+{
+	uint32_t vboIndex; //!< The index of the VBO (in SharedMeshBuffers::vbos) containing the vertex data of the mesh
+	uint32_t iboIndex; //!< The index of the IBO (in SharedMeshBuffers::ibos) containing the index data of the mesh. Undefined if the mesh has no faces.
+	int32_t baseVertex; //!< The vertexOffset to draw the mesh with when the VBO is bound at offset 0. Only valid for meshes with a single data element, otherwise 0.
+	uint32_t numVertices; //!< The number of vertices of the mesh
+	uint32_t firstIndex; //!< The firstIndex to draw the mesh with when the IBO is bound at offset 0
+	uint32_t numIndices; //!< The number of indices of the mesh. 0 if the mesh has no faces.
+	pvrvk::IndexType indexType; //!< The index type to bind the IBO with when drawing the mesh
+	std::vector<pvrvk::DeviceSize> vertexDataOffsets; //!< The byte offset of each data element of the mesh in its VBO, for binding the data elements separately
+	SharedMeshRange() : vboIndex(0), iboIndex(0), baseVertex(0), numVertices(0), firstIndex(0), numIndices(0), indexType(pvrvk::IndexType::e_UINT16) {}
+};
+
+/// <summary>A small number of large VBOs and IBOs holding the vertex and index data of many meshes, and the location of every mesh in them.</summary>
+struct SharedMeshBuffers
+{
+	std::vector<pvrvk::Buffer> vbos; //!< The VBOs
+	std::vector<pvrvk::Buffer> ibos; //!< The IBOs
+	std::vector<SharedMeshRange> meshes; //!< The location of each mesh, in the order the meshes were passed
+};
+
+/// <summary>The default maximum size of each of the buffers created by createSharedBuffersFromMeshes.</summary>
+static const pvrvk::DeviceSize DefaultSharedMeshBufferSize = 64 * 1024 * 1024;
+
+/// <summary>Packs the vertex and index data of many meshes into a few shared VBOs and IBOs instead of creating a VBO/IBO pair per mesh. Draws of meshes
+/// sharing a buffer do not need to rebind it: bind the VBO and IBO once at offset 0, then draw every mesh with drawIndexed(range.firstIndex, range.numIndices,
+/// range.baseVertex), which also makes the meshes suitable for batching into indirect draws. The vertex data of every mesh is placed at an offset which is
+/// a multiple of its stride, so that baseVertex is exact for meshes with a single (interleaved) data element. 16 and 32 bit index data share the IBOs; only
+/// the index type needs to be rebound when it changes. The data of each buffer is uploaded with a single copy.</summary>
+/// <param name="device">The device where the buffers will be generated on</param>
+/// <param name="meshes">The meshes whose data will populate the buffers. Meshes from any number of models can be combined.</param>
+/// <param name="numMeshes">The number of meshes</param>
+/// <param name="outBuffers">The created buffers and the location of each mesh. Any previous contents are replaced.</param>
+/// <param name="uploadCmdBuffer">A command buffer into which commands may be recorded for uploading mesh data to the created buffers. This command buffer will only be used when
+/// memory without e_HOST_VISIBLE_BIT memory property flags was allocated for the buffers.</param>
+/// <param name="requiresCommandBufferSubmission">Indicates whether commands have been recorded into the given command buffer.</param>
+/// <param name="bufferAllocator">A VMA allocator used to allocate memory for the created buffers.</param>
+/// <param name="vmaAllocationCreateFlags">VMA Allocation creation flags.</param>
+/// <param name="maxBufferSize">The maximum size of each buffer. A new buffer is started when a mesh does not fit in the current one. A mesh larger
+/// than maxBufferSize gets a buffer of its own.</param>
+void createSharedBuffersFromMeshes(pvrvk::Device& device, const assets::Mesh* const* meshes, uint32_t numMeshes, SharedMeshBuffers& outBuffers,
+	pvrvk::CommandBuffer& uploadCmdBuffer, bool& requiresCommandBufferSubmission, vma::Allocator* bufferAllocator = nullptr,
+	vma::AllocationCreateFlags vmaAllocationCreateFlags = vma::AllocationCreateFlags::e_MAPPED_BIT, pvrvk::DeviceSize maxBufferSize = DefaultSharedMeshBufferSize);
+
+/// <summary>Packs the vertex and index data of all meshes of a model into a few shared VBOs and IBOs. See createSharedBuffersFromMeshes.</summary>
+/// <param name="device">The device where the buffers will be generated on</param>
+/// <param name="model">The model whose meshes will be used to generate the buffers. SharedMeshBuffers::meshes is indexed by mesh index.</param>
+/// <param name="outBuffers">The created buffers and the location of each mesh</param>
+/// <param name="uploadCmdBuffer">A command buffer into which commands may be recorded for uploading mesh data to the created buffers.</param>
+/// <param name="requiresCommandBufferSubmission">Indicates whether commands have been recorded into the given command buffer.</param>
+/// <param name="bufferAllocator">A VMA allocator used to allocate memory for the created buffers.</param>
+/// <param name="vmaAllocationCreateFlags">VMA Allocation creation flags.</param>
+/// <param name="maxBufferSize">The maximum size of each buffer</param>
+inline void createSharedBuffersFromModel(pvrvk::Device& device, const assets::Model& model, SharedMeshBuffers& outBuffers, pvrvk::CommandBuffer& uploadCmdBuffer,
+	bool& requiresCommandBufferSubmission, vma::Allocator* bufferAllocator = nullptr, vma::AllocationCreateFlags vmaAllocationCreateFlags = vma::AllocationCreateFlags::e_MAPPED_BIT,
+	pvrvk::DeviceSize maxBufferSize = DefaultSharedMeshBufferSize)
+{
+	std::vector<const assets::Mesh*> meshes;
+	meshes.reserve(model.getNumMeshes());
+	for (uint32_t i = 0; i < model.getNumMeshes(); ++i)
+	{
+		meshes.push_back(&model.getMesh(i));
+	}
+	createSharedBuffersFromMeshes(device, meshes.data(), static_cast<uint32_t>(meshes.size()), outBuffers, uploadCmdBuffer, requiresCommandBufferSubmission, bufferAllocator,
+		vmaAllocationCreateFlags, maxBufferSize);
+}
+
 /// <summary>Creates a 3d plane mesh based on the width and depth specified. Texture coordinates and normal coordinates can also
 /// optionally be generated based on the generateTexCoords and generateNormalCoords flags respectively. The generated mesh will be
 /// returned as a pvr::assets::Mesh.</summary>
@@ -1386,5 +1510,34 @@ inline bool isImageUsageSupportedBySurface(const pvrvk::SurfaceCapabilitiesKHR&
 {
 	return (static_cast<uint32_t>(surfaceCapabilities.getSupportedUsageFlags() & imageUsage) != 0);
 }
+
+/// <summary>Create a pipeline cache, warm-starting it with the data previously saved to a file with savePipelineCache. The saved data is only used
+/// if it was produced by the same physical device (vendor ID, device ID and pipeline cache UUID) and the same driver version, otherwise (or if the file
+/// does not exist or is corrupt) an empty pipeline cache is created.</summary>
+/// <param name="device">The device used to create the pipeline cache</param>
+/// <param name="filePath">The path of the pipeline cache file, typically in the application's write path.</param>
+/// <returns>The created pipeline cache.</returns>
+pvrvk::PipelineCache loadPipelineCache(pvrvk::Device& device, const std::string& filePath);
+
+/// <summary>Save the data of a pipeline cache to a file, together with the identity of the physical device and driver that produced it, so that it can
+/// be loaded with loadPipelineCache on subsequent runs. To save several pipeline caches (e.g. per-thread caches), merge them into one first with
+/// Device_::mergePipelineCache.</summary>
+/// <param name="device">The device the pipeline cache was created with</param>
+/// <param name="pipelineCache">The pipeline cache to save</param>
+/// <param name="filePath">The path of the pipeline cache file. The file is replaced only once the new data has been written completely.</param>
+/// <returns>True if the pipeline cache was saved, otherwise false.</returns>
+bool savePipelineCache(pvrvk::Device& device, const pvrvk::PipelineCache& pipelineCache, const std::string& filePath);
+
+/// <summary>Create a number of graphics pipelines in parallel on a number of worker threads. Each thread creates its pipelines with its own pipeline
+/// cache, seeded with the contents of pipelineCache so that previously compiled pipelines are still found, and the thread caches are merged into
+/// pipelineCache afterwards, so that the threads never contend on a single cache. The calling thread takes part in the work.</summary>
+/// <param name="device">The device used to create the pipelines</param>
+/// <param name="createInfos">A c-style array of numCreateInfos pipeline create infos</param>
+/// <param name="numCreateInfos">The number of pipelines to create</param>
+/// <param name="pipelineCache">Optional. A pipeline cache used to seed the thread caches and into which they are merged. May be null.</param>
+/// <param name="outPipelines">A c-style array of numCreateInfos pipelines which will be set to the created pipelines, in the order of createInfos</param>
+/// <param name="maxThreads">The maximum number of threads to use, including the calling thread. 0 uses the number of hardware threads.</param>
+void createGraphicsPipelinesParallel(pvrvk::Device& device, const pvrvk::GraphicsPipelineCreateInfo* createInfos, uint32_t numCreateInfos,
+	const pvrvk::PipelineCache& pipelineCache, pvrvk::GraphicsPipeline* outPipelines, uint32_t maxThreads = 0);
 } // namespace utils
 } // namespace pvr
@@ -0,0 +1,1298 @@
+#pragma once
+static uint32_t spv_IndirectDrawCullerCompShader[] = 
+{
+    0x7230203,
+    0x010000,
+    0x080007,
+    0x0000b9,
+    00000000,
+    0x020011,
+    0x000001,
+    0x06000b,
+    0x000001,
+    0x4c534c47,
+    0x6474732e,
+    0x3035342e,
+    00000000,
+    0x03000e,
+    00000000,
+    0x000001,
+    0x06000f,
+    0x000005,
+    0x000004,
+    0x6e69616d,
+    00000000,
+    0x00000b,
+    0x060010,
+    0x000004,
+    0x000011,
+    0x000040,
+    0x000001,
+    0x000001,
+    0x030003,
+    0x000001,
+    0x000140,
+    0x040005,
+    0x000004,
+    0x6e69616d,
+    00000000,
+    0x030005,
+    0x000008,
+    0x000069,
+    0x080005,
+    0x00000b,
+    0x475f6c67,
+    0x61626f6c,
+    0x766e496c,
+    0x7461636f,
+    0x496e6f69,
+    0x000044,
+    0x040005,
+    0x000015,
+    0x73757246,
+    0x6d7574,
+    0x050006,
+    0x000015,
+    00000000,
+    0x6e616c70,
+    0x007365,
+    0x070006,
+    0x000015,
+    0x000001,
+    0x496d756e,
+    0x6174736e,
+    0x7365636e,
+    00000000,
+    0x030005,
+    0x000017,
+    00000000,
+    0x040005,
+    0x000022,
+    0x65687073,
+    0x006572,
+    0x060005,
+    0x000023,
+    0x77617244,
+    0x74736e49,
+    0x65636e61,
+    00000000,
+    0x070006,
+    0x000023,
+    00000000,
+    0x6e756f62,
+    0x676e6964,
+    0x65687053,
+    0x006572,
+    0x060006,
+    0x000023,
+    0x000001,
+    0x65646e69,
+    0x756f4378,
+    0x00746e,
+    0x060006,
+    0x000023,
+    0x000002,
+    0x73726966,
+    0x646e4974,
+    0x007865,
+    0x070006,
+    0x000023,
+    0x000003,
+    0x74726576,
+    0x664f7865,
+    0x74657366,
+    00000000,
+    0x070006,
+    0x000023,
+    0x000004,
+    0x73726966,
+    0x736e4974,
+    0x636e6174,
+    0x000065,
+    0x050005,
+    0x000025,
+    0x74736e49,
+    0x65636e61,
+    0x000073,
+    0x060006,
+    0x000025,
+    00000000,
+    0x74736e69,
+    0x65636e61,
+    0x000073,
+    0x030005,
+    0x000027,
+    00000000,
+    0x040005,
+    0x00002f,
+    0x746e6563,
+    0x007265,
+    0x050005,
+    0x000033,
+    0x756e696d,
+    0x64615273,
+    0x737569,
+    0x040005,
+    0x000039,
+    0x69736976,
+    0x656c62,
+    0x040005,
+    0x000093,
+    0x746f6c73,
+    00000000,
+    0x040005,
+    0x000094,
+    0x6e756f43,
+    0x000074,
+    0x070006,
+    0x000094,
+    00000000,
+    0x69736976,
+    0x43656c62,
+    0x746e756f,
+    00000000,
+    0x030005,
+    0x000096,
+    00000000,
+    0x090005,
+    0x00009b,
+    0x77617244,
+    0x65646e49,
+    0x49646578,
+    0x7269646e,
+    0x43746365,
+    0x616d6d6f,
+    0x00646e,
+    0x060006,
+    0x00009b,
+    00000000,
+    0x65646e69,
+    0x756f4378,
+    0x00746e,
+    0x070006,
+    0x00009b,
+    0x000001,
+    0x74736e69,
+    0x65636e61,
+    0x6e756f43,
+    0x000074,
+    0x060006,
+    0x00009b,
+    0x000002,
+    0x73726966,
+    0x646e4974,
+    0x007865,
+    0x070006,
+    0x00009b,
+    0x000003,
+    0x74726576,
+    0x664f7865,
+    0x74657366,
+    00000000,
+    0x070006,
+    0x00009b,
+    0x000004,
+    0x73726966,
+    0x736e4974,
+    0x636e6174,
+    0x000065,
+    0x050005,
+    0x00009d,
+    0x6d6d6f43,
+    0x73646e61,
+    00000000,
+    0x060006,
+    0x00009d,
+    00000000,
+    0x6d6d6f63,
+    0x73646e61,
+    00000000,
+    0x030005,
+    0x00009f,
+    00000000,
+    0x040047,
+    0x00000b,
+    0x00000b,
+    0x00001c,
+    0x040047,
+    0x000014,
+    0x000006,
+    0x000010,
+    0x050048,
+    0x000015,
+    00000000,
+    0x000023,
+    00000000,
+    0x050048,
+    0x000015,
+    0x000001,
+    0x000023,
+    0x000060,
+    0x030047,
+    0x000015,
+    0x000002,
+    0x050048,
+    0x000023,
+    00000000,
+    0x000023,
+    00000000,
+    0x050048,
+    0x000023,
+    0x000001,
+    0x000023,
+    0x000010,
+    0x050048,
+    0x000023,
+    0x000002,
+    0x000023,
+    0x000014,
+    0x050048,
+    0x000023,
+    0x000003,
+    0x000023,
+    0x000018,
+    0x050048,
+    0x000023,
+    0x000004,
+    0x000023,
+    0x00001c,
+    0x040047,
+    0x000024,
+    0x000006,
+    0x000020,
+    0x040048,
+    0x000025,
+    00000000,
+    0x000018,
+    0x050048,
+    0x000025,
+    00000000,
+    0x000023,
+    00000000,
+    0x030047,
+    0x000025,
+    0x000003,
+    0x040047,
+    0x000027,
+    0x000022,
+    00000000,
+    0x040047,
+    0x000027,
+    0x000021,
+    00000000,
+    0x050048,
+    0x000094,
+    00000000,
+    0x000023,
+    00000000,
+    0x030047,
+    0x000094,
+    0x000003,
+    0x040047,
+    0x000096,
+    0x000022,
+    00000000,
+    0x040047,
+    0x000096,
+    0x000021,
+    0x000002,
+    0x050048,
+    0x00009b,
+    00000000,
+    0x000023,
+    00000000,
+    0x050048,
+    0x00009b,
+    0x000001,
+    0x000023,
+    0x000004,
+    0x050048,
+    0x00009b,
+    0x000002,
+    0x000023,
+    0x000008,
+    0x050048,
+    0x00009b,
+    0x000003,
+    0x000023,
+    0x00000c,
+    0x050048,
+    0x00009b,
+    0x000004,
+    0x000023,
+    0x000010,
+    0x040047,
+    0x00009c,
+    0x000006,
+    0x000014,
+    0x050048,
+    0x00009d,
+    00000000,
+    0x000023,
+    00000000,
+    0x030047,
+    0x00009d,
+    0x000003,
+    0x040047,
+    0x00009f,
+    0x000022,
+    00000000,
+    0x040047,
+    0x00009f,
+    0x000021,
+    0x000001,
+    0x040047,
+    0x0000b8,
+    0x00000b,
+    0x000019,
+    0x020013,
+    0x000002,
+    0x030021,
+    0x000003,
+    0x000002,
+    0x040015,
+    0x000006,
+    0x000020,
+    00000000,
+    0x040020,
+    0x000007,
+    0x000007,
+    0x000006,
+    0x040017,
+    0x000009,
+    0x000006,
+    0x000003,
+    0x040020,
+    0x00000a,
+    0x000001,
+    0x000009,
+    0x04003b,
+    0x00000a,
+    0x00000b,
+    0x000001,
+    0x04002b,
+    0x000006,
+    0x00000c,
+    00000000,
+    0x040020,
+    0x00000d,
+    0x000001,
+    0x000006,
+    0x030016,
+    0x000011,
+    0x000020,
+    0x040017,
+    0x000012,
+    0x000011,
+    0x000004,
+    0x04002b,
+    0x000006,
+    0x000013,
+    0x000006,
+    0x04001c,
+    0x000014,
+    0x000012,
+    0x000013,
+    0x04001e,
+    0x000015,
+    0x000014,
+    0x000006,
+    0x040020,
+    0x000016,
+    0x000009,
+    0x000015,
+    0x04003b,
+    0x000016,
+    0x000017,
+    0x000009,
+    0x040015,
+    0x000018,
+    0x000020,
+    0x000001,
+    0x04002b,
+    0x000018,
+    0x000019,
+    0x000001,
+    0x040020,
+    0x00001a,
+    0x000009,
+    0x000006,
+    0x020014,
+    0x00001d,
+    0x040020,
+    0x000021,
+    0x000007,
+    0x000012,
+    0x07001e,
+    0x000023,
+    0x000012,
+    0x000006,
+    0x000006,
+    0x000018,
+    0x000006,
+    0x03001d,
+    0x000024,
+    0x000023,
+    0x03001e,
+    0x000025,
+    0x000024,
+    0x040020,
+    0x000026,
+    0x000002,
+    0x000025,
+    0x04003b,
+    0x000026,
+    0x000027,
+    0x000002,
+    0x04002b,
+    0x000018,
+    0x000028,
+    00000000,
+    0x040020,
+    0x00002a,
+    0x000002,
+    0x000012,
+    0x040017,
+    0x00002d,
+    0x000011,
+    0x000003,
+    0x040020,
+    0x00002e,
+    0x000007,
+    0x00002d,
+    0x040020,
+    0x000032,
+    0x000007,
+    0x000011,
+    0x04002b,
+    0x000006,
+    0x000034,
+    0x000003,
+    0x040020,
+    0x000038,
+    0x000007,
+    0x00001d,
+    0x040020,
+    0x00003a,
+    0x000009,
+    0x000012,
+    0x040020,
+    0x000040,
+    0x000009,
+    0x000011,
+    0x04002b,
+    0x000018,
+    0x000057,
+    0x000002,
+    0x04002b,
+    0x000018,
+    0x000066,
+    0x000003,
+    0x04002b,
+    0x000018,
+    0x000075,
+    0x000004,
+    0x04002b,
+    0x000018,
+    0x000084,
+    0x000005,
+    0x03001e,
+    0x000094,
+    0x000006,
+    0x040020,
+    0x000095,
+    0x000002,
+    0x000094,
+    0x04003b,
+    0x000095,
+    0x000096,
+    0x000002,
+    0x040020,
+    0x000097,
+    0x000002,
+    0x000006,
+    0x04002b,
+    0x000006,
+    0x000099,
+    0x000001,
+    0x07001e,
+    0x00009b,
+    0x000006,
+    0x000006,
+    0x000006,
+    0x000018,
+    0x000006,
+    0x03001d,
+    0x00009c,
+    0x00009b,
+    0x03001e,
+    0x00009d,
+    0x00009c,
+    0x040020,
+    0x00009e,
+    0x000002,
+    0x00009d,
+    0x04003b,
+    0x00009e,
+    0x00009f,
+    0x000002,
+    0x040020,
+    0x0000ae,
+    0x000002,
+    0x000018,
+    0x04002b,
+    0x000006,
+    0x0000b7,
+    0x000040,
+    0x06002c,
+    0x000009,
+    0x0000b8,
+    0x0000b7,
+    0x000099,
+    0x000099,
+    0x050036,
+    0x000002,
+    0x000004,
+    00000000,
+    0x000003,
+    0x0200f8,
+    0x000005,
+    0x04003b,
+    0x000007,
+    0x000008,
+    0x000007,
+    0x04003b,
+    0x000021,
+    0x000022,
+    0x000007,
+    0x04003b,
+    0x00002e,
+    0x00002f,
+    0x000007,
+    0x04003b,
+    0x000032,
+    0x000033,
+    0x000007,
+    0x04003b,
+    0x000038,
+    0x000039,
+    0x000007,
+    0x04003b,
+    0x000007,
+    0x000093,
+    0x000007,
+    0x050041,
+    0x00000d,
+    0x00000e,
+    0x00000b,
+    0x00000c,
+    0x04003d,
+    0x000006,
+    0x00000f,
+    0x00000e,
+    0x03003e,
+    0x000008,
+    0x00000f,
+    0x04003d,
+    0x000006,
+    0x000010,
+    0x000008,
+    0x050041,
+    0x00001a,
+    0x00001b,
+    0x000017,
+    0x000019,
+    0x04003d,
+    0x000006,
+    0x00001c,
+    0x00001b,
+    0x0500b0,
+    0x00001d,
+    0x00001e,
+    0x000010,
+    0x00001c,
+    0x0300f7,
+    0x000020,
+    00000000,
+    0x0400fa,
+    0x00001e,
+    0x00001f,
+    0x000020,
+    0x0200f8,
+    0x00001f,
+    0x04003d,
+    0x000006,
+    0x000029,
+    0x000008,
+    0x070041,
+    0x00002a,
+    0x00002b,
+    0x000027,
+    0x000028,
+    0x000029,
+    0x000028,
+    0x04003d,
+    0x000012,
+    0x00002c,
+    0x00002b,
+    0x03003e,
+    0x000022,
+    0x00002c,
+    0x04003d,
+    0x000012,
+    0x000030,
+    0x000022,
+    0x08004f,
+    0x00002d,
+    0x000031,
+    0x000030,
+    0x000030,
+    00000000,
+    0x000001,
+    0x000002,
+    0x03003e,
+    0x00002f,
+    0x000031,
+    0x050041,
+    0x000032,
+    0x000035,
+    0x000022,
+    0x000034,
+    0x04003d,
+    0x000011,
+    0x000036,
+    0x000035,
+    0x04007f,
+    0x000011,
+    0x000037,
+    0x000036,
+    0x03003e,
+    0x000033,
+    0x000037,
+    0x060041,
+    0x00003a,
+    0x00003b,
+    0x000017,
+    0x000028,
+    0x000028,
+    0x04003d,
+    0x000012,
+    0x00003c,
+    0x00003b,
+    0x08004f,
+    0x00002d,
+    0x00003d,
+    0x00003c,
+    0x00003c,
+    00000000,
+    0x000001,
+    0x000002,
+    0x04003d,
+    0x00002d,
+    0x00003e,
+    0x00002f,
+    0x050094,
+    0x000011,
+    0x00003f,
+    0x00003d,
+    0x00003e,
+    0x070041,
+    0x000040,
+    0x000041,
+    0x000017,
+    0x000028,
+    0x000028,
+    0x000034,
+    0x04003d,
+    0x000011,
+    0x000042,
+    0x000041,
+    0x050081,
+    0x000011,
+    0x000043,
+    0x00003f,
+    0x000042,
+    0x04003d,
+    0x000011,
+    0x000044,
+    0x000033,
+    0x0500be,
+    0x00001d,
+    0x000045,
+    0x000043,
+    0x000044,
+    0x03003e,
+    0x000039,
+    0x000045,
+    0x04003d,
+    0x00001d,
+    0x000046,
+    0x000039,
+    0x0300f7,
+    0x000048,
+    00000000,
+    0x0400fa,
+    0x000046,
+    0x000047,
+    0x000048,
+    0x0200f8,
+    0x000047,
+    0x060041,
+    0x00003a,
+    0x000049,
+    0x000017,
+    0x000028,
+    0x000019,
+    0x04003d,
+    0x000012,
+    0x00004a,
+    0x000049,
+    0x08004f,
+    0x00002d,
+    0x00004b,
+    0x00004a,
+    0x00004a,
+    00000000,
+    0x000001,
+    0x000002,
+    0x04003d,
+    0x00002d,
+    0x00004c,
+    0x00002f,
+    0x050094,
+    0x000011,
+    0x00004d,
+    0x00004b,
+    0x00004c,
+    0x070041,
+    0x000040,
+    0x00004e,
+    0x000017,
+    0x000028,
+    0x000019,
+    0x000034,
+    0x04003d,
+    0x000011,
+    0x00004f,
+    0x00004e,
+    0x050081,
+    0x000011,
+    0x000050,
+    0x00004d,
+    0x00004f,
+    0x04003d,
+    0x000011,
+    0x000051,
+    0x000033,
+    0x0500be,
+    0x00001d,
+    0x000052,
+    0x000050,
+    0x000051,
+    0x0200f9,
+    0x000048,
+    0x0200f8,
+    0x000048,
+    0x0700f5,
+    0x00001d,
+    0x000053,
+    0x000046,
+    0x00001f,
+    0x000052,
+    0x000047,
+    0x03003e,
+    0x000039,
+    0x000053,
+    0x04003d,
+    0x00001d,
+    0x000054,
+    0x000039,
+    0x0300f7,
+    0x000056,
+    00000000,
+    0x0400fa,
+    0x000054,
+    0x000055,
+    0x000056,
+    0x0200f8,
+    0x000055,
+    0x060041,
+    0x00003a,
+    0x000058,
+    0x000017,
+    0x000028,
+    0x000057,
+    0x04003d,
+    0x000012,
+    0x000059,
+    0x000058,
+    0x08004f,
+    0x00002d,
+    0x00005a,
+    0x000059,
+    0x000059,
+    00000000,
+    0x000001,
+    0x000002,
+    0x04003d,
+    0x00002d,
+    0x00005b,
+    0x00002f,
+    0x050094,
+    0x000011,
+    0x00005c,
+    0x00005a,
+    0x00005b,
+    0x070041,
+    0x000040,
+    0x00005d,
+    0x000017,
+    0x000028,
+    0x000057,
+    0x000034,
+    0x04003d,
+    0x000011,
+    0x00005e,
+    0x00005d,
+    0x050081,
+    0x000011,
+    0x00005f,
+    0x00005c,
+    0x00005e,
+    0x04003d,
+    0x000011,
+    0x000060,
+    0x000033,
+    0x0500be,
+    0x00001d,
+    0x000061,
+    0x00005f,
+    0x000060,
+    0x0200f9,
+    0x000056,
+    0x0200f8,
+    0x000056,
+    0x0700f5,
+    0x00001d,
+    0x000062,
+    0x000054,
+    0x000048,
+    0x000061,
+    0x000055,
+    0x03003e,
+    0x000039,
+    0x000062,
+    0x04003d,
+    0x00001d,
+    0x000063,
+    0x000039,
+    0x0300f7,
+    0x000065,
+    00000000,
+    0x0400fa,
+    0x000063,
+    0x000064,
+    0x000065,
+    0x0200f8,
+    0x000064,
+    0x060041,
+    0x00003a,
+    0x000067,
+    0x000017,
+    0x000028,
+    0x000066,
+    0x04003d,
+    0x000012,
+    0x000068,
+    0x000067,
+    0x08004f,
+    0x00002d,
+    0x000069,
+    0x000068,
+    0x000068,
+    00000000,
+    0x000001,
+    0x000002,
+    0x04003d,
+    0x00002d,
+    0x00006a,
+    0x00002f,
+    0x050094,
+    0x000011,
+    0x00006b,
+    0x000069,
+    0x00006a,
+    0x070041,
+    0x000040,
+    0x00006c,
+    0x000017,
+    0x000028,
+    0x000066,
+    0x000034,
+    0x04003d,
+    0x000011,
+    0x00006d,
+    0x00006c,
+    0x050081,
+    0x000011,
+    0x00006e,
+    0x00006b,
+    0x00006d,
+    0x04003d,
+    0x000011,
+    0x00006f,
+    0x000033,
+    0x0500be,
+    0x00001d,
+    0x000070,
+    0x00006e,
+    0x00006f,
+    0x0200f9,
+    0x000065,
+    0x0200f8,
+    0x000065,
+    0x0700f5,
+    0x00001d,
+    0x000071,
+    0x000063,
+    0x000056,
+    0x000070,
+    0x000064,
+    0x03003e,
+    0x000039,
+    0x000071,
+    0x04003d,
+    0x00001d,
+    0x000072,
+    0x000039,
+    0x0300f7,
+    0x000074,
+    00000000,
+    0x0400fa,
+    0x000072,
+    0x000073,
+    0x000074,
+    0x0200f8,
+    0x000073,
+    0x060041,
+    0x00003a,
+    0x000076,
+    0x000017,
+    0x000028,
+    0x000075,
+    0x04003d,
+    0x000012,
+    0x000077,
+    0x000076,
+    0x08004f,
+    0x00002d,
+    0x000078,
+    0x000077,
+    0x000077,
+    00000000,
+    0x000001,
+    0x000002,
+    0x04003d,
+    0x00002d,
+    0x000079,
+    0x00002f,
+    0x050094,
+    0x000011,
+    0x00007a,
+    0x000078,
+    0x000079,
+    0x070041,
+    0x000040,
+    0x00007b,
+    0x000017,
+    0x000028,
+    0x000075,
+    0x000034,
+    0x04003d,
+    0x000011,
+    0x00007c,
+    0x00007b,
+    0x050081,
+    0x000011,
+    0x00007d,
+    0x00007a,
+    0x00007c,
+    0x04003d,
+    0x000011,
+    0x00007e,
+    0x000033,
+    0x0500be,
+    0x00001d,
+    0x00007f,
+    0x00007d,
+    0x00007e,
+    0x0200f9,
+    0x000074,
+    0x0200f8,
+    0x000074,
+    0x0700f5,
+    0x00001d,
+    0x000080,
+    0x000072,
+    0x000065,
+    0x00007f,
+    0x000073,
+    0x03003e,
+    0x000039,
+    0x000080,
+    0x04003d,
+    0x00001d,
+    0x000081,
+    0x000039,
+    0x0300f7,
+    0x000083,
+    00000000,
+    0x0400fa,
+    0x000081,
+    0x000082,
+    0x000083,
+    0x0200f8,
+    0x000082,
+    0x060041,
+    0x00003a,
+    0x000085,
+    0x000017,
+    0x000028,
+    0x000084,
+    0x04003d,
+    0x000012,
+    0x000086,
+    0x000085,
+    0x08004f,
+    0x00002d,
+    0x000087,
+    0x000086,
+    0x000086,
+    00000000,
+    0x000001,
+    0x000002,
+    0x04003d,
+    0x00002d,
+    0x000088,
+    0x00002f,
+    0x050094,
+    0x000011,
+    0x000089,
+    0x000087,
+    0x000088,
+    0x070041,
+    0x000040,
+    0x00008a,
+    0x000017,
+    0x000028,
+    0x000084,
+    0x000034,
+    0x04003d,
+    0x000011,
+    0x00008b,
+    0x00008a,
+    0x050081,
+    0x000011,
+    0x00008c,
+    0x000089,
+    0x00008b,
+    0x04003d,
+    0x000011,
+    0x00008d,
+    0x000033,
+    0x0500be,
+    0x00001d,
+    0x00008e,
+    0x00008c,
+    0x00008d,
+    0x0200f9,
+    0x000083,
+    0x0200f8,
+    0x000083,
+    0x0700f5,
+    0x00001d,
+    0x00008f,
+    0x000081,
+    0x000074,
+    0x00008e,
+    0x000082,
+    0x03003e,
+    0x000039,
+    0x00008f,
+    0x04003d,
+    0x00001d,
+    0x000090,
+    0x000039,
+    0x0300f7,
+    0x000092,
+    00000000,
+    0x0400fa,
+    0x000090,
+    0x000091,
+    0x000092,
+    0x0200f8,
+    0x000091,
+    0x050041,
+    0x000097,
+    0x000098,
+    0x000096,
+    0x000028,
+    0x0700ea,
+    0x000006,
+    0x00009a,
+    0x000098,
+    0x000099,
+    0x00000c,
+    0x000099,
+    0x03003e,
+    0x000093,
+    0x00009a,
+    0x04003d,
+    0x000006,
+    0x0000a0,
+    0x000093,
+    0x04003d,
+    0x000006,
+    0x0000a1,
+    0x000008,
+    0x070041,
+    0x000097,
+    0x0000a2,
+    0x000027,
+    0x000028,
+    0x0000a1,
+    0x000019,
+    0x04003d,
+    0x000006,
+    0x0000a3,
+    0x0000a2,
+    0x070041,
+    0x000097,
+    0x0000a4,
+    0x00009f,
+    0x000028,
+    0x0000a0,
+    0x000028,
+    0x03003e,
+    0x0000a4,
+    0x0000a3,
+    0x04003d,
+    0x000006,
+    0x0000a5,
+    0x000093,
+    0x070041,
+    0x000097,
+    0x0000a6,
+    0x00009f,
+    0x000028,
+    0x0000a5,
+    0x000019,
+    0x03003e,
+    0x0000a6,
+    0x000099,
+    0x04003d,
+    0x000006,
+    0x0000a7,
+    0x000093,
+    0x04003d,
+    0x000006,
+    0x0000a8,
+    0x000008,
+    0x070041,
+    0x000097,
+    0x0000a9,
+    0x000027,
+    0x000028,
+    0x0000a8,
+    0x000057,
+    0x04003d,
+    0x000006,
+    0x0000aa,
+    0x0000a9,
+    0x070041,
+    0x000097,
+    0x0000ab,
+    0x00009f,
+    0x000028,
+    0x0000a7,
+    0x000057,
+    0x03003e,
+    0x0000ab,
+    0x0000aa,
+    0x04003d,
+    0x000006,
+    0x0000ac,
+    0x000093,
+    0x04003d,
+    0x000006,
+    0x0000ad,
+    0x000008,
+    0x070041,
+    0x0000ae,
+    0x0000af,
+    0x000027,
+    0x000028,
+    0x0000ad,
+    0x000066,
+    0x04003d,
+    0x000018,
+    0x0000b0,
+    0x0000af,
+    0x070041,
+    0x0000ae,
+    0x0000b1,
+    0x00009f,
+    0x000028,
+    0x0000ac,
+    0x000066,
+    0x03003e,
+    0x0000b1,
+    0x0000b0,
+    0x04003d,
+    0x000006,
+    0x0000b2,
+    0x000093,
+    0x04003d,
+    0x000006,
+    0x0000b3,
+    0x000008,
+    0x070041,
+    0x000097,
+    0x0000b4,
+    0x000027,
+    0x000028,
+    0x0000b3,
+    0x000075,
+    0x04003d,
+    0x000006,
+    0x0000b5,
+    0x0000b4,
+    0x070041,
+    0x000097,
+    0x0000b6,
+    0x00009f,
+    0x000028,
+    0x0000b2,
+    0x000075,
+    0x03003e,
+    0x0000b6,
+    0x0000b5,
+    0x0200f9,
+    0x000092,
+    0x0200f8,
+    0x000092,
+    0x0200f9,
+    0x000020,
+    0x0200f8,
+    0x000020,
+    0x0100fd,
+    0x010038,
+};
+static VkShaderModuleCreateInfo shaderModuleCreateInfo_IndirectDrawCullerCompShader = 
+{
+    static_cast<VkStructureType>(pvrvk::StructureType::e_SHADER_MODULE_CREATE_INFO),
+    nullptr,
+    VkShaderModuleCreateFlags(0),
+    sizeof(spv_IndirectDrawCullerCompShader),
+    spv_IndirectDrawCullerCompShader,
+};
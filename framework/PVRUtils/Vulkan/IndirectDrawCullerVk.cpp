@@ -0,0 +1,169 @@
+/*!
+\brief Implementation of the IndirectDrawCuller.
+\file PVRUtils/Vulkan/IndirectDrawCullerVk.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+//!\cond NO_DOXYGEN
+#include "IndirectDrawCullerVk.h"
+#include "PVRCore/stream/BufferStream.h"
+#include "PVRUtils/Vulkan/HelperVk.h"
+#include "PVRUtils/Vulkan/IndirectDrawCullerCompShader.h"
+#include "PVRVk/PhysicalDeviceVk.h"
+#include "PVRVk/MemoryBarrierVk.h"
+#include <algorithm>
+
+namespace pvr {
+namespace utils {
+namespace {
+// The push constants of the culling shader
+struct CullingPushConstants
+{
+	glm::vec4 planes[6];
+	uint32_t numInstances;
+};
+
+const uint32_t DrawCommandStride = sizeof(VkDrawIndexedIndirectCommand);
+} // namespace
+
+void IndirectDrawCuller::init(
+	pvrvk::Device& device, uint32_t maxInstances, uint32_t numFramesInFlight, vma::Allocator* bufferAllocator, const pvrvk::PipelineCache& pipelineCache)
+{
+	release();
+	_device = device;
+	_maxInstances = std::max(maxInstances, 1u);
+	_multiDrawIndirect = device->getPhysicalDevice()->getFeatures().getMultiDrawIndirect() != 0;
+	_frames.resize(std::max(numFramesInFlight, 1u));
+
+	pvrvk::DescriptorSetLayoutCreateInfo descSetLayoutInfo;
+	descSetLayoutInfo.setBinding(0, pvrvk::DescriptorType::e_STORAGE_BUFFER, 1, pvrvk::ShaderStageFlags::e_COMPUTE_BIT)
+		.setBinding(1, pvrvk::DescriptorType::e_STORAGE_BUFFER, 1, pvrvk::ShaderStageFlags::e_COMPUTE_BIT)
+		.setBinding(2, pvrvk::DescriptorType::e_STORAGE_BUFFER, 1, pvrvk::ShaderStageFlags::e_COMPUTE_BIT);
+	pvrvk::DescriptorSetLayout descSetLayout = device->createDescriptorSetLayout(descSetLayoutInfo);
+
+	pvrvk::PipelineLayoutCreateInfo pipeLayoutInfo;
+	pipeLayoutInfo.setDescSetLayout(0, descSetLayout);
+	pipeLayoutInfo.setPushConstantRange(0, pvrvk::PushConstantRange(pvrvk::ShaderStageFlags::e_COMPUTE_BIT, 0, sizeof(CullingPushConstants)));
+
+	pvrvk::ComputePipelineCreateInfo pipeCreateInfo;
+	pipeCreateInfo.computeShader.setShader(device->createShaderModule(
+		pvrvk::ShaderModuleCreateInfo(BufferStream("", spv_IndirectDrawCullerCompShader, sizeof(spv_IndirectDrawCullerCompShader)).readToEnd<uint32_t>())));
+	pipeCreateInfo.pipelineLayout = device->createPipelineLayout(pipeLayoutInfo);
+	_pipeline = device->createComputePipeline(pipeCreateInfo, pipelineCache);
+	_pipeline->setObjectName("PVRUtilsVk::IndirectDrawCuller::ComputePipeline");
+
+	const uint16_t numFrames = static_cast<uint16_t>(_frames.size());
+	_descriptorPool = device->createDescriptorPool(
+		pvrvk::DescriptorPoolCreateInfo().setMaxDescriptorSets(numFrames).addDescriptorInfo(pvrvk::DescriptorType::e_STORAGE_BUFFER, static_cast<uint16_t>(numFrames * 3)));
+
+	std::vector<pvrvk::WriteDescriptorSet> writeDescSets;
+	for (Frame& frame : _frames)
+	{
+		frame.instances = createBuffer(device, sizeof(IndirectDrawInstance) * _maxInstances, pvrvk::BufferUsageFlags::e_STORAGE_BUFFER_BIT,
+			pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT, bufferAllocator);
+		frame.drawCommands = createBuffer(device, DrawCommandStride * _maxInstances,
+			pvrvk::BufferUsageFlags::e_STORAGE_BUFFER_BIT | pvrvk::BufferUsageFlags::e_INDIRECT_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT,
+			pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, bufferAllocator);
+		frame.drawCount = createBuffer(device, sizeof(uint32_t),
+			pvrvk::BufferUsageFlags::e_STORAGE_BUFFER_BIT | pvrvk::BufferUsageFlags::e_INDIRECT_BUFFER_BIT | pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT,
+			pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, bufferAllocator);
+		frame.descriptorSet = _descriptorPool->allocateDescriptorSet(descSetLayout);
+
+		writeDescSets.push_back(pvrvk::WriteDescriptorSet(pvrvk::DescriptorType::e_STORAGE_BUFFER, frame.descriptorSet, 0)
+									.setBufferInfo(0, pvrvk::DescriptorBufferInfo(frame.instances, 0, frame.instances->getSize())));
+		writeDescSets.push_back(pvrvk::WriteDescriptorSet(pvrvk::DescriptorType::e_STORAGE_BUFFER, frame.descriptorSet, 1)
+									.setBufferInfo(0, pvrvk::DescriptorBufferInfo(frame.drawCommands, 0, frame.drawCommands->getSize())));
+		writeDescSets.push_back(pvrvk::WriteDescriptorSet(pvrvk::DescriptorType::e_STORAGE_BUFFER, frame.descriptorSet, 2)
+									.setBufferInfo(0, pvrvk::DescriptorBufferInfo(frame.drawCount, 0, frame.drawCount->getSize())));
+	}
+	device->updateDescriptorSets(writeDescSets.data(), static_cast<uint32_t>(writeDescSets.size()), nullptr, 0);
+}
+
+void IndirectDrawCuller::release()
+{
+	_frames.clear();
+	_descriptorPool.reset();
+	_pipeline.reset();
+	_device.reset();
+	_maxInstances = 0;
+}
+
+void IndirectDrawCuller::setInstances(uint32_t frameIndex, const IndirectDrawInstance* instances, uint32_t numInstances)
+{
+	debug_assertion(frameIndex < _frames.size(), "IndirectDrawCuller: frame index out of range");
+	if (numInstances > _maxInstances)
+	{
+		throw std::runtime_error("IndirectDrawCuller: The number of instances exceeds the maximum number of instances the culler was initialised with");
+	}
+	Frame& frame = _frames[frameIndex];
+	frame.numInstances = numInstances;
+	if (numInstances)
+	{
+		updateHostVisibleBuffer(frame.instances, instances, 0, sizeof(IndirectDrawInstance) * numInstances, true);
+	}
+}
+
+void IndirectDrawCuller::recordCulling(pvrvk::CommandBufferBase commandBuffer, uint32_t frameIndex, const math::ViewingFrustum& frustum)
+{
+	debug_assertion(frameIndex < _frames.size(), "IndirectDrawCuller: frame index out of range");
+	Frame& frame = _frames[frameIndex];
+
+	// Clear the commands of the previous use of the frame, so that the slots not written by the culling are empty draws, and reset the count
+	commandBuffer->fillBuffer(frame.drawCommands, 0, 0, DrawCommandStride * _maxInstances);
+	commandBuffer->fillBuffer(frame.drawCount, 0, 0, sizeof(uint32_t));
+	{
+		pvrvk::MemoryBarrierSet barriers;
+		barriers.addBarrier(pvrvk::MemoryBarrier(pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags::e_SHADER_READ_BIT | pvrvk::AccessFlags::e_SHADER_WRITE_BIT));
+		commandBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_COMPUTE_SHADER_BIT, barriers);
+	}
+
+	if (frame.numInstances)
+	{
+		CullingPushConstants pushConstants;
+		pushConstants.planes[0] = frustum.minusX;
+		pushConstants.planes[1] = frustum.plusX;
+		pushConstants.planes[2] = frustum.minusY;
+		pushConstants.planes[3] = frustum.plusY;
+		pushConstants.planes[4] = frustum.minusZ;
+		pushConstants.planes[5] = frustum.plusZ;
+		pushConstants.numInstances = frame.numInstances;
+
+		commandBuffer->bindPipeline(_pipeline);
+		commandBuffer->bindDescriptorSet(pvrvk::PipelineBindPoint::e_COMPUTE, _pipeline->getPipelineLayout(), 0, frame.descriptorSet);
+		commandBuffer->pushConstants(_pipeline->getPipelineLayout(), pvrvk::ShaderStageFlags::e_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+		commandBuffer->dispatch((frame.numInstances + WorkgroupSize - 1) / WorkgroupSize, 1, 1);
+	}
+
+	pvrvk::MemoryBarrierSet barriers;
+	barriers.addBarrier(pvrvk::MemoryBarrier(pvrvk::AccessFlags::e_SHADER_WRITE_BIT | pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags::e_INDIRECT_COMMAND_READ_BIT));
+	commandBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_COMPUTE_SHADER_BIT | pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_DRAW_INDIRECT_BIT, barriers);
+}
+
+void IndirectDrawCuller::recordDraws(pvrvk::CommandBufferBase commandBuffer, uint32_t frameIndex)
+{
+	debug_assertion(frameIndex < _frames.size(), "IndirectDrawCuller: frame index out of range");
+	Frame& frame = _frames[frameIndex];
+	if (!frame.numInstances)
+	{
+		return;
+	}
+	if (_multiDrawIndirect)
+	{
+		const uint32_t maxDrawCount = std::max(_device->getPhysicalDevice()->getProperties().getLimits().getMaxDrawIndirectCount(), 1u);
+		for (uint32_t first = 0; first < frame.numInstances; first += maxDrawCount)
+		{
+			commandBuffer->drawIndexedIndirect(frame.drawCommands, first * DrawCommandStride, std::min(maxDrawCount, frame.numInstances - first), DrawCommandStride);
+		}
+	}
+	else
+	{
+		for (uint32_t i = 0; i < frame.numInstances; ++i)
+		{
+			commandBuffer->drawIndexedIndirect(frame.drawCommands, i * DrawCommandStride, 1, DrawCommandStride);
+		}
+	}
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
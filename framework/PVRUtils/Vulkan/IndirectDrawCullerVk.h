@@ -0,0 +1,144 @@
+/*!
+\brief Contains a GPU-driven draw path which culls instances against the viewing frustum in a compute shader and draws the visible ones indirectly.
+\file PVRUtils/Vulkan/IndirectDrawCullerVk.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+#pragma once
+#include "PVRUtils/Vulkan/MemoryAllocator.h"
+#include "PVRCore/math/AxisAlignedBox.h"
+#include "PVRVk/DeviceVk.h"
+#include "PVRVk/CommandBufferVk.h"
+#include "PVRVk/ComputePipelineVk.h"
+
+namespace pvr {
+namespace utils {
+/// <summary>An instance to be culled and drawn by the IndirectDrawCuller. Matches the layout of the culling shader's input (std430).</summary>
+struct IndirectDrawInstance
+{
+	glm::vec4 boundingSphere; //!< The world space bounding sphere of the instance: centre (xyz) and radius (w)
+	uint32_t indexCount; //!< The number of indices to draw
+	uint32_t firstIndex; //!< The first index to draw
+	int32_t vertexOffset; //!< The value added to each index before indexing into the vertex buffer
+	uint32_t firstInstance; //!< The instance index the instance is drawn with (gl_InstanceIndex). Must be 0 without the drawIndirectFirstInstance feature.
+
+	/// <summary>Constructor. Zero-initialises the instance.</summary>
+	IndirectDrawInstance() : boundingSphere(0.f), indexCount(0), firstIndex(0), vertexOffset(0), firstInstance(0) {}
+
+	/// <summary>Constructor.</summary>
+	/// <param name="boundingSphere">The world space bounding sphere of the instance: centre (xyz) and radius (w)</param>
+	/// <param name="indexCount">The number of indices to draw</param>
+	/// <param name="firstIndex">The first index to draw</param>
+	/// <param name="vertexOffset">The value added to each index before indexing into the vertex buffer</param>
+	/// <param name="firstInstance">The instance index the instance is drawn with</param>
+	IndirectDrawInstance(const glm::vec4& boundingSphere, uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+		: boundingSphere(boundingSphere), indexCount(indexCount), firstIndex(firstIndex), vertexOffset(vertexOffset), firstInstance(firstInstance)
+	{}
+};
+
+/// <summary>Moves frustum culling and draw submission of large numbers of instances to the GPU, taking the per-object CPU work to zero.
+/// The bounding spheres and draw parameters of the instances are uploaded to a buffer. Every frame, recordCulling dispatches a compute shader which tests
+/// every instance against the viewing frustum, and writes a DrawIndexedIndirectCommand for each visible instance (compacted at the start of a command
+/// buffer) plus the number of visible instances. recordDraws then issues the draws with drawIndexedIndirect. The unused tail of the command buffer is
+/// cleared to zero each frame, so the draws it contains are empty.
+///
+/// All instances are drawn with the same pipeline, vertex and index buffers (bound by the application), e.g. meshes packed with
+/// createSharedBuffersFromMeshes. If the multiDrawIndirect feature is not supported, one drawIndexedIndirect per instance slot is recorded instead of
+/// a single one; the count buffer can be used with VK_KHR_draw_indirect_count where available.
+/// Each frame in flight owns its instance, command and count buffers. The culler is not thread safe.</summary>
+class IndirectDrawCuller
+{
+public:
+	/// <summary>The number of invocations of each workgroup of the culling shader.</summary>
+	enum
+	{
+		WorkgroupSize = 64
+	};
+
+	/// <summary>Constructor. Creates an uninitialised culler.</summary>
+	IndirectDrawCuller() : _maxInstances(0), _multiDrawIndirect(false) {}
+
+	/// <summary>Initialise the culler: create the culling pipeline and the buffers of every frame in flight.</summary>
+	/// <param name="device">The device</param>
+	/// <param name="maxInstances">The maximum number of instances</param>
+	/// <param name="numFramesInFlight">The number of frames in flight (typically the number of swapchain images)</param>
+	/// <param name="bufferAllocator">A VMA allocator used to allocate memory for the buffers. Optional.</param>
+	/// <param name="pipelineCache">A pipeline cache used to create the culling pipeline. Optional.</param>
+	void init(pvrvk::Device& device, uint32_t maxInstances, uint32_t numFramesInFlight, vma::Allocator* bufferAllocator = nullptr,
+		const pvrvk::PipelineCache& pipelineCache = pvrvk::PipelineCache());
+
+	/// <summary>Release all objects. The GPU must have finished all command buffers the culler was used in.</summary>
+	void release();
+
+	/// <summary>Set the instances of a frame in flight. Static scenes set the instances of every frame once; dynamic scenes update them every frame
+	/// before recording the culling, once the previous use of the frame has completed.</summary>
+	/// <param name="frameIndex">The index of the frame in flight</param>
+	/// <param name="instances">The instances</param>
+	/// <param name="numInstances">The number of instances. Must not exceed maxInstances.</param>
+	void setInstances(uint32_t frameIndex, const IndirectDrawInstance* instances, uint32_t numInstances);
+
+	/// <summary>Record the culling of a frame: clear the frame's draw commands, cull its instances against the frustum and make the results visible to
+	/// the indirect draws. Must be recorded outside of a render pass, before the draws of the frame.</summary>
+	/// <param name="commandBuffer">The command buffer to record into</param>
+	/// <param name="frameIndex">The index of the frame in flight</param>
+	/// <param name="frustum">The viewing frustum, e.g. from math::getFrustumPlanes</param>
+	void recordCulling(pvrvk::CommandBufferBase commandBuffer, uint32_t frameIndex, const math::ViewingFrustum& frustum);
+
+	/// <summary>Record the indirect draws of the visible instances of a frame. Must be recorded inside a render pass, with the pipeline, descriptor sets,
+	/// vertex buffers and index buffer used by the instances bound.</summary>
+	/// <param name="commandBuffer">The command buffer to record into</param>
+	/// <param name="frameIndex">The index of the frame in flight</param>
+	void recordDraws(pvrvk::CommandBufferBase commandBuffer, uint32_t frameIndex);
+
+	/// <summary>Get the buffer of DrawIndexedIndirectCommands written by the culling of a frame.</summary>
+	/// <param name="frameIndex">The index of the frame in flight</param>
+	/// <returns>The draw command buffer.</returns>
+	const pvrvk::Buffer& getDrawCommandBuffer(uint32_t frameIndex) const
+	{
+		return _frames[frameIndex].drawCommands;
+	}
+
+	/// <summary>Get the buffer containing the number of visible instances (a single uint32_t) written by the culling of a frame.</summary>
+	/// <param name="frameIndex">The index of the frame in flight</param>
+	/// <returns>The count buffer.</returns>
+	const pvrvk::Buffer& getDrawCountBuffer(uint32_t frameIndex) const
+	{
+		return _frames[frameIndex].drawCount;
+	}
+
+	/// <summary>Get the number of instances set for a frame.</summary>
+	/// <param name="frameIndex">The index of the frame in flight</param>
+	/// <returns>The number of instances.</returns>
+	uint32_t getNumInstances(uint32_t frameIndex) const
+	{
+		return _frames[frameIndex].numInstances;
+	}
+
+	/// <summary>Get the maximum number of instances.</summary>
+	/// <returns>The maximum number of instances.</returns>
+	uint32_t getMaxInstances() const
+	{
+		return _maxInstances;
+	}
+
+private:
+	struct Frame
+	{
+		pvrvk::Buffer instances;
+		pvrvk::Buffer drawCommands;
+		pvrvk::Buffer drawCount;
+		pvrvk::DescriptorSet descriptorSet;
+		uint32_t numInstances;
+		Frame() : numInstances(0) {}
+	};
+
+	pvrvk::Device _device;
+	pvrvk::ComputePipeline _pipeline;
+	pvrvk::DescriptorPool _descriptorPool;
+	std::vector<Frame> _frames;
+	uint32_t _maxInstances;
+	bool _multiDrawIndirect;
+};
+} // namespace utils
+} // namespace pvr
@@ -0,0 +1,230 @@
+/*!
+\brief Implementation of the MemoryBudgetManager.
+\file PVRUtils/Vulkan/MemoryBudgetManagerVk.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+//!\cond NO_DOXYGEN
+#include "MemoryBudgetManagerVk.h"
+#include "PVRVk/DeviceVk.h"
+#include "PVRVk/PhysicalDeviceVk.h"
+#include <algorithm>
+
+namespace pvr {
+namespace utils {
+namespace {
+vma::Allocation getAllocation(const pvrvk::DeviceMemory& memory)
+{
+	if (!memory.isValid() || dynamic_cast<const vma::impl::Allocation_*>(memory.get()) == nullptr)
+	{
+		throw std::runtime_error("MemoryBudgetManager: Only resources whose memory was allocated with a VMA allocator can be registered");
+	}
+	return vma::Allocation(memory);
+}
+} // namespace
+
+void MemoryBudgetManager::init(
+	pvrvk::Device& device, vma::Allocator& allocator, uint32_t numFramesInFlight, float budgetFraction, pvrvk::DeviceSize defragmentBytesPerFrame)
+{
+	release();
+	_device = device;
+	_allocator = allocator;
+	_numFramesInFlight = std::max(numFramesInFlight, 1u);
+	_defragmentBytesPerFrame = defragmentBytesPerFrame;
+
+	const pvrvk::PhysicalDeviceMemoryProperties& memoryProperties = device->getPhysicalDevice()->getMemoryProperties();
+	_heaps.resize(memoryProperties.getMemoryHeapCount());
+	for (uint32_t i = 0; i < memoryProperties.getMemoryHeapCount(); ++i)
+	{
+		_heaps[i].budget = static_cast<pvrvk::DeviceSize>(static_cast<double>(memoryProperties.getMemoryHeaps()[i].getSize()) * budgetFraction);
+	}
+}
+
+void MemoryBudgetManager::release()
+{
+	_retiredBuffers.clear();
+	_entries.clear();
+	_freeHandles.clear();
+	_heaps.clear();
+	_allocator.reset();
+	_device.reset();
+	_frame = 0;
+	_defragmentCursor = 0;
+}
+
+MemoryBudgetManager::Handle MemoryBudgetManager::addEntry(const pvrvk::DeviceMemory& memory, pvrvk::DeviceSize size)
+{
+	vma::Allocation allocation = getAllocation(memory);
+	Handle handle;
+	if (_freeHandles.empty())
+	{
+		handle = static_cast<Handle>(_entries.size());
+		_entries.push_back(Entry());
+	}
+	else
+	{
+		handle = _freeHandles.back();
+		_freeHandles.pop_back();
+	}
+	Entry& entry = _entries[handle];
+	entry.size = size;
+	entry.heapIndex = _device->getPhysicalDevice()->getMemoryProperties().getMemoryTypes()[allocation->getMemoryType()].getHeapIndex();
+	entry.lastUsedFrame = _frame;
+	entry.active = true;
+	return handle;
+}
+
+MemoryBudgetManager::Handle MemoryBudgetManager::registerEvictable(const pvrvk::Image& image, const EvictCallback& evictCallback)
+{
+	pvrvk::Image myImage = image;
+	Handle handle = addEntry(myImage->getDeviceMemory(), myImage->getMemoryRequirement().getSize());
+	_entries[handle].evictCallback = evictCallback;
+	return handle;
+}
+
+MemoryBudgetManager::Handle MemoryBudgetManager::registerEvictable(const pvrvk::Buffer& buffer, const EvictCallback& evictCallback)
+{
+	pvrvk::Buffer myBuffer = buffer;
+	Handle handle = addEntry(myBuffer->getDeviceMemory(), myBuffer->getSize());
+	_entries[handle].evictCallback = evictCallback;
+	return handle;
+}
+
+MemoryBudgetManager::Handle MemoryBudgetManager::registerMovable(const pvrvk::Buffer& buffer, const RebindCallback& rebindCallback)
+{
+	pvrvk::Buffer myBuffer = buffer;
+	Handle handle = addEntry(myBuffer->getDeviceMemory(), myBuffer->getSize());
+	_entries[handle].movableBuffer = buffer;
+	_entries[handle].rebindCallback = rebindCallback;
+	return handle;
+}
+
+void MemoryBudgetManager::unregister(Handle handle)
+{
+	debug_assertion(handle < _entries.size() && _entries[handle].active, "MemoryBudgetManager: Invalid handle");
+	_entries[handle] = Entry();
+	_freeHandles.push_back(handle);
+}
+
+void MemoryBudgetManager::update()
+{
+	debug_assertion(_allocator.isValid(), "MemoryBudgetManager: Not initialised");
+	++_frame;
+	while (!_retiredBuffers.empty() && _retiredBuffers.front().frame + _numFramesInFlight <= _frame)
+	{
+		_retiredBuffers.pop_front();
+	}
+	evict();
+	defragment();
+}
+
+void MemoryBudgetManager::evict()
+{
+	const vma::Stats stats = _allocator->calculateStats();
+	std::vector<Handle> candidates;
+	for (uint32_t heapIndex = 0; heapIndex < _heaps.size(); ++heapIndex)
+	{
+		Heap& heap = _heaps[heapIndex];
+		heap.usage = stats.memoryHeap[heapIndex].getUsedBytes();
+		if (heap.usage <= heap.budget)
+		{
+			continue;
+		}
+
+		candidates.clear();
+		for (Handle handle = 0; handle < _entries.size(); ++handle)
+		{
+			const Entry& entry = _entries[handle];
+			if (entry.active && entry.evictCallback && entry.heapIndex == heapIndex && !isInFlight(entry))
+			{
+				candidates.push_back(handle);
+			}
+		}
+		std::sort(candidates.begin(), candidates.end(), [&](Handle a, Handle b) { return _entries[a].lastUsedFrame < _entries[b].lastUsedFrame; });
+
+		for (size_t i = 0; i < candidates.size() && heap.usage > heap.budget; ++i)
+		{
+			if (!_entries[candidates[i]].active || !_entries[candidates[i]].evictCallback)
+			{
+				continue; // Unregistered by the callback of a previous eviction
+			}
+			// The callback may register or unregister resources, so remove the entry first and do not hold references into _entries
+			EvictCallback evictCallback = _entries[candidates[i]].evictCallback;
+			heap.usage -= std::min(heap.usage, _entries[candidates[i]].size);
+			unregister(candidates[i]);
+			++_numEvicted;
+			evictCallback();
+		}
+		if (heap.usage > heap.budget)
+		{
+			Log(LogLevel::Warning, "MemoryBudgetManager: Heap %u is over budget (%llu of %llu bytes used) and nothing more can be evicted", heapIndex,
+				static_cast<unsigned long long>(heap.usage), static_cast<unsigned long long>(heap.budget));
+		}
+	}
+}
+
+void MemoryBudgetManager::defragment()
+{
+	if (_defragmentBytesPerFrame == 0 || _entries.empty())
+	{
+		return;
+	}
+
+	// Only buffers in host visible memory can be moved, and only if no frame in flight uses them. Start after the buffers handled last time, so that
+	// every buffer gets its turn even if the byte cap is reached early.
+	std::vector<Handle> handles;
+	std::vector<vma::Allocation> allocations;
+	const uint32_t numEntries = static_cast<uint32_t>(_entries.size());
+	for (uint32_t i = 0; i < numEntries; ++i)
+	{
+		const Handle handle = (_defragmentCursor + i) % numEntries;
+		Entry& entry = _entries[handle];
+		if (!entry.active || !entry.movableBuffer.isValid() || isInFlight(entry))
+		{
+			continue;
+		}
+		vma::Allocation allocation = getAllocation(entry.movableBuffer->getDeviceMemory());
+		if ((allocation->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT) == pvrvk::MemoryPropertyFlags(0))
+		{
+			continue;
+		}
+		handles.push_back(handle);
+		allocations.push_back(allocation);
+	}
+	_defragmentCursor = (_defragmentCursor + 1) % numEntries;
+	if (allocations.empty())
+	{
+		return;
+	}
+
+	vma::impl::VmaDefragmentationInfo defragmentationInfo;
+	defragmentationInfo.maxBytesToMove = _defragmentBytesPerFrame;
+	defragmentationInfo.maxAllocationsToMove = static_cast<uint32_t>(-1);
+	std::vector<pvrvk::Bool32> changed(allocations.size());
+	_allocator->defragment(allocations.data(), static_cast<uint32_t>(allocations.size()), &defragmentationInfo, changed.data(), nullptr);
+
+	for (size_t i = 0; i < allocations.size(); ++i)
+	{
+		if (!changed[i])
+		{
+			continue;
+		}
+		// A buffer cannot be rebound, so create a new one over the allocation's new location. The old buffer is kept alive until no frame in flight
+		// can be using it.
+		Entry& entry = _entries[handles[i]];
+		pvrvk::Buffer newBuffer = _device->createBuffer(entry.movableBuffer->getCreateInfo());
+		newBuffer->bindMemory(pvrvk::DeviceMemory(allocations[i]), allocations[i]->getOffset());
+		RetiredBuffer retired;
+		retired.buffer = entry.movableBuffer;
+		retired.frame = _frame;
+		_retiredBuffers.push_back(retired);
+		entry.movableBuffer = newBuffer;
+		++_numMoved;
+		RebindCallback rebindCallback = entry.rebindCallback;
+		rebindCallback(newBuffer);
+	}
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,189 @@
+/*!
+\brief Contains a manager keeping the device memory footprint of a VMA allocator within a budget through eviction and incremental defragmentation.
+\file PVRUtils/Vulkan/MemoryBudgetManagerVk.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+#pragma once
+#include "PVRUtils/Vulkan/MemoryAllocator.h"
+#include "PVRVk/BufferVk.h"
+#include "PVRVk/ImageVk.h"
+#include <functional>
+#include <deque>
+
+namespace pvr {
+namespace utils {
+/// <summary>Keeps the memory used through a VMA allocator flat over long running sessions which stream resources in and out.
+/// Once per frame, update():
+/// - measures the memory used in every heap and compares it against the heap's budget (by default a fraction of the heap size),
+/// - if a heap is over budget, evicts the least recently used evictable resources (e.g. streamed textures) of that heap by calling their eviction
+///   callbacks, until the heap is within budget again,
+/// - incrementally defragments the registered movable buffers, moving at most a configurable number of bytes per frame. Every buffer whose memory was
+///   moved is recreated, bound to its new location, and handed to its rebind callback; the old buffer is kept alive until the GPU can no longer be using it.
+///
+/// Only resources which have not been used (see markUsed) by any frame in flight are evicted or moved. The defragmentation supported by the VMA
+/// version used only moves HOST_VISIBLE allocations (the data is moved by the CPU); movable buffers in other memory are never moved.
+/// The manager is not thread safe.</summary>
+class MemoryBudgetManager
+{
+public:
+	/// <summary>A handle to a registered resource.</summary>
+	typedef uint32_t Handle;
+
+	/// <summary>Called when an evictable resource is evicted. The owner must release the resource (and any references to its memory).</summary>
+	typedef std::function<void()> EvictCallback;
+
+	/// <summary>Called when a movable buffer has been recreated in its new location. The owner must replace all references to the old buffer
+	/// (including descriptor sets and buffer views) with the new one.</summary>
+	typedef std::function<void(const pvrvk::Buffer& newBuffer)> RebindCallback;
+
+	/// <summary>The default values of the init parameters.</summary>
+	enum
+	{
+		DefaultDefragmentBytesPerFrame = 4 * 1024 * 1024
+	};
+
+	/// <summary>Constructor. Creates an uninitialised MemoryBudgetManager.</summary>
+	MemoryBudgetManager() : _numFramesInFlight(0), _defragmentBytesPerFrame(0), _frame(0), _defragmentCursor(0), _numEvicted(0), _numMoved(0) {}
+
+	/// <summary>Initialise the manager.</summary>
+	/// <param name="device">The device</param>
+	/// <param name="allocator">The allocator whose memory is managed</param>
+	/// <param name="numFramesInFlight">The number of frames in flight. Resources used in the last numFramesInFlight frames are never evicted or moved.</param>
+	/// <param name="budgetFraction">The budget of every heap as a fraction of its size</param>
+	/// <param name="defragmentBytesPerFrame">The maximum number of bytes moved per frame by the incremental defragmentation. 0 disables it.</param>
+	void init(pvrvk::Device& device, vma::Allocator& allocator, uint32_t numFramesInFlight, float budgetFraction = .8f,
+		pvrvk::DeviceSize defragmentBytesPerFrame = DefaultDefragmentBytesPerFrame);
+
+	/// <summary>Release all registrations and the buffers kept alive for frames in flight.</summary>
+	void release();
+
+	/// <summary>Set the budget of a heap.</summary>
+	/// <param name="heapIndex">The index of the memory heap</param>
+	/// <param name="budget">The number of bytes that may be used from the heap before resources are evicted</param>
+	void setHeapBudget(uint32_t heapIndex, pvrvk::DeviceSize budget)
+	{
+		_heaps[heapIndex].budget = budget;
+	}
+
+	/// <summary>Set the maximum number of bytes moved per frame by the incremental defragmentation.</summary>
+	/// <param name="bytesPerFrame">The number of bytes. 0 disables defragmentation.</param>
+	void setDefragmentBytesPerFrame(pvrvk::DeviceSize bytesPerFrame)
+	{
+		_defragmentBytesPerFrame = bytesPerFrame;
+	}
+
+	/// <summary>Register an image which can be evicted under memory pressure. The manager does not keep a reference to the image.</summary>
+	/// <param name="image">The image. Its memory must have been allocated by the manager's allocator.</param>
+	/// <param name="evictCallback">Called when the image is evicted. The registration is removed before the callback is called.</param>
+	/// <returns>The handle of the registration</returns>
+	Handle registerEvictable(const pvrvk::Image& image, const EvictCallback& evictCallback);
+
+	/// <summary>Register a buffer which can be evicted under memory pressure. The manager does not keep a reference to the buffer.</summary>
+	/// <param name="buffer">The buffer. Its memory must have been allocated by the manager's allocator.</param>
+	/// <param name="evictCallback">Called when the buffer is evicted. The registration is removed before the callback is called.</param>
+	/// <returns>The handle of the registration</returns>
+	Handle registerEvictable(const pvrvk::Buffer& buffer, const EvictCallback& evictCallback);
+
+	/// <summary>Register a buffer whose memory may be moved by the incremental defragmentation. The manager keeps a reference to the (current) buffer
+	/// until it is unregistered.</summary>
+	/// <param name="buffer">The buffer. Its memory must have been allocated by the manager's allocator.</param>
+	/// <param name="rebindCallback">Called with the recreated buffer whenever the buffer's memory has been moved.</param>
+	/// <returns>The handle of the registration</returns>
+	Handle registerMovable(const pvrvk::Buffer& buffer, const RebindCallback& rebindCallback);
+
+	/// <summary>Remove a registration. Must be called before the owner releases a registered resource.</summary>
+	/// <param name="handle">The handle of the registration</param>
+	void unregister(Handle handle);
+
+	/// <summary>Mark a registered resource as used in the current frame.</summary>
+	/// <param name="handle">The handle of the registration</param>
+	void markUsed(Handle handle)
+	{
+		_entries[handle].lastUsedFrame = _frame;
+	}
+
+	/// <summary>Evict resources of heaps over budget and perform a step of the incremental defragmentation. Call once per frame, after waiting for
+	/// the fence of the oldest frame in flight and before recording the new frame.</summary>
+	void update();
+
+	/// <summary>Get the number of bytes used by the allocator in a heap, as measured by the last update.</summary>
+	/// <param name="heapIndex">The index of the memory heap</param>
+	/// <returns>The number of bytes used.</returns>
+	pvrvk::DeviceSize getHeapUsage(uint32_t heapIndex) const
+	{
+		return _heaps[heapIndex].usage;
+	}
+
+	/// <summary>Get the budget of a heap.</summary>
+	/// <param name="heapIndex">The index of the memory heap</param>
+	/// <returns>The budget in bytes.</returns>
+	pvrvk::DeviceSize getHeapBudget(uint32_t heapIndex) const
+	{
+		return _heaps[heapIndex].budget;
+	}
+
+	/// <summary>Get the total number of resources evicted.</summary>
+	/// <returns>The number of resources evicted.</returns>
+	uint32_t getNumEvicted() const
+	{
+		return _numEvicted;
+	}
+
+	/// <summary>Get the total number of buffers moved by the defragmentation.</summary>
+	/// <returns>The number of buffers moved.</returns>
+	uint32_t getNumMoved() const
+	{
+		return _numMoved;
+	}
+
+private:
+	struct Entry
+	{
+		pvrvk::DeviceSize size;
+		uint32_t heapIndex;
+		uint64_t lastUsedFrame;
+		EvictCallback evictCallback;
+		pvrvk::Buffer movableBuffer;
+		RebindCallback rebindCallback;
+		bool active;
+		Entry() : size(0), heapIndex(0), lastUsedFrame(0), active(false) {}
+	};
+
+	struct Heap
+	{
+		pvrvk::DeviceSize budget;
+		pvrvk::DeviceSize usage;
+		Heap() : budget(0), usage(0) {}
+	};
+
+	struct RetiredBuffer
+	{
+		pvrvk::Buffer buffer;
+		uint64_t frame;
+	};
+
+	Handle addEntry(const pvrvk::DeviceMemory& memory, pvrvk::DeviceSize size);
+	bool isInFlight(const Entry& entry) const
+	{
+		return entry.lastUsedFrame + _numFramesInFlight > _frame;
+	}
+	void evict();
+	void defragment();
+
+	pvrvk::Device _device;
+	vma::Allocator _allocator;
+	uint32_t _numFramesInFlight;
+	pvrvk::DeviceSize _defragmentBytesPerFrame;
+	uint64_t _frame;
+	uint32_t _defragmentCursor;
+	uint32_t _numEvicted;
+	uint32_t _numMoved;
+	std::vector<Heap> _heaps;
+	std::vector<Entry> _entries;
+	std::vector<Handle> _freeHandles;
+	std::deque<RetiredBuffer> _retiredBuffers;
+};
+} // namespace utils
+} // namespace pvr
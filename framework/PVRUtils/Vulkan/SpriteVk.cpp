@@ -64,6 +64,7 @@ Sprite_::Sprite_(UIRenderer& uiRenderer) : _color(1.f, 1.f, 1.f, 1.f), _alphaMod
 void Sprite_::commitUpdates() const
 {
 	calculateMvp(0, glm::mat4(1.f), _uiRenderer->getScreenRotation() * _uiRenderer->getProjection(), _uiRenderer->getViewport());
+	_uiRenderer->getTextArena().flush();
 }
 
 void Sprite_::render()
@@ -72,7 +73,14 @@ void Sprite_::render()
 	{
 		throw UIRendererError("Sprite: Render called without first calling uiRenderer::begin to set up the commandbuffer.");
 	}
-	onRender(_uiRenderer->getActiveCommandBuffer(), 0);
+	if (_uiRenderer->isBatchingEnabled())
+	{
+		onAddToBatch(0);
+	}
+	else
+	{
+		onRender(_uiRenderer->getActiveCommandBuffer(), 0);
+	}
 }
 
 void Image_::updateUbo(uint64_t parentIds) const
@@ -179,6 +187,22 @@ void Image_::onRender(CommandBufferBase& commandBuffer, uint64_t parentId)
 	commandBuffer->debugMarkerEndEXT();
 }
 
+void Image_::onAddToBatch(uint64_t parentId)
+{
+	const float u0 = _uv.getOffset().getX();
+	const float v0 = _uv.getOffset().getY();
+	const float u1 = u0 + _uv.getExtent().getWidth();
+	const float v1 = v0 + _uv.getExtent().getHeight();
+
+	// The corners of the image vbo with the uv matrix already applied, in the vertex order of a glyph (upper left, upper right, lower left, lower right)
+	Vertex quad[4];
+	quad[0].setData(-1.f, 1.f, 0.f, 1.f, u0, v1);
+	quad[1].setData(1.f, 1.f, 0.f, 1.f, u1, v1);
+	quad[2].setData(-1.f, -1.f, 0.f, 1.f, u0, v0);
+	quad[3].setData(1.f, -1.f, 0.f, 1.f, u1, v0);
+	_uiRenderer->addToBatch(getTexDescriptorSet(), getImageView(), getSampler(), _color, _alphaMode, _mvpData[parentId].mvp, quad, 1);
+}
+
 void Image_::onAddInstance(uint64_t parentId)
 {
 	if (_mvpData[parentId].bufferArrayId == -1)
@@ -194,7 +218,7 @@ void Image_::onAddInstance(uint64_t parentId)
 
 void Image_::onRemoveInstance(uint64_t parentId)
 {
-	if (_mvpData[parentId].bufferArrayId != -1)
+	if (_uiRenderer && _mvpData[parentId].bufferArrayId != -1)
 	{
 		_uiRenderer->getUbo().releaseBufferSlice(_mvpData[parentId].bufferArrayId);
 		_uiRenderer->getMaterial().releaseBufferArray(_materialData.bufferArrayId);
@@ -352,28 +376,24 @@ Font_::Font_(UIRenderer& uiRenderer, const pvrvk::ImageView& tex2D, const Textur
 		_alphaRenderingMode = true;
 	}
 
+	_sampler = sampler.isValid() ? sampler : uiRenderer.getSamplerBilinear();
 	_texDescSet = uiRenderer.getDescriptorPool()->allocateDescriptorSet(uiRenderer.getTexDescriptorSetLayout());
 	// update the texture descriptor set
 	WriteDescriptorSet writeDescSet(pvrvk::DescriptorType::e_COMBINED_IMAGE_SAMPLER, _texDescSet, 0, 0);
-	writeDescSet.setImageInfo(0, DescriptorImageInfo(_imageView, (sampler.isValid() ? sampler : uiRenderer.getSamplerBilinear()), pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL));
+	writeDescSet.setImageInfo(0, DescriptorImageInfo(_imageView, _sampler, pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL));
 	uiRenderer.getDevice()->updateDescriptorSets(&writeDescSet, 1, nullptr, 0);
 }
 
-uint32_t TextElement_::updateVertices(float fZPos, float xPos, float yPos, const std::vector<uint32_t>& text, Vertex* const pVertices) const
+uint32_t TextElement_::updateVertices(float fZPos, float xPos, float yPos, const std::vector<uint32_t>& text, Vertex* const pVertices, size_t firstChar) const
 {
 	if (pVertices == NULL || text.empty())
 	{
 		return 0;
 	}
-	_boundingRect.clear();
 
 	Font tmp = _font;
 	Font_& font = *tmp;
 
-	yPos -= font.getAscent();
-
-	yPos = glm::round(yPos);
-
 	// The original offset (after screen scale modification) of the X coordinate.
 	float preXPos = xPos;
 
@@ -384,14 +404,37 @@ uint32_t TextElement_::updateVertices(float fZPos, float xPos, float yPos, const
 	int32_t nextChar;
 
 	size_t numCharsInString = text.size();
+	_glyphLayouts.resize(numCharsInString);
 
-	for (size_t index = 0; index < numCharsInString; index++)
+	if (firstChar == 0)
+	{
+		_boundingRect.clear();
+		yPos -= font.getAscent();
+		yPos = glm::round(yPos);
+	}
+	else
+	{
+		// Resume from the state the layout was in when it last reached this character
+		const GlyphLayout& resume = _glyphLayouts[firstChar];
+		xPos = resume.xPos;
+		yPos = resume.yPos;
+		vertexCount = resume.vertexCount;
+		_boundingRect = resume.boundingRect;
+	}
+
+	for (size_t index = firstChar; index < numCharsInString; index++)
 	{
 		if (index > MaxLetters)
 		{
 			break;
 		}
 
+		GlyphLayout& layout = _glyphLayouts[index];
+		layout.xPos = xPos;
+		layout.yPos = yPos;
+		layout.vertexCount = vertexCount;
+		layout.boundingRect = _boundingRect;
+
 		// Newline
 		if (text[index] == 0x0A)
 		{
@@ -475,44 +518,82 @@ void Text_::onAddInstance(uint64_t parentId)
 
 void TextElement_::createBuffers()
 {
-	_vbo = utils::createBuffer(_uiRenderer->getDevice(), static_cast<uint32_t>(sizeof(Vertex) * _maxLength * 4), pvrvk::BufferUsageFlags::e_VERTEX_BUFFER_BIT,
-		pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT, &_uiRenderer->getMemoryAllocator(),
-		pvr::utils::vma::AllocationCreateFlags::e_MAPPED_BIT);
+	// The draw command and the vertices live in a block of the shared, persistently mapped text arena
+	_vbo = _uiRenderer->getTextArena().allocate(
+		static_cast<uint32_t>(TextVertexBlock::HeaderSize + sizeof(Vertex) * _maxLength * 4), &_uiRenderer->getMemoryAllocator());
+	if (_vbo.mappedData == nullptr)
+	{
+		throw UIRendererError("Failed to create Text (vertex arena)");
+	}
+	VkDrawIndexedIndirectCommand cmd;
+	cmd.firstInstance = 0;
+	cmd.firstIndex = 0;
+	cmd.instanceCount = 1;
+	cmd.indexCount = 0;
+	cmd.vertexOffset = 0;
+	memcpy(_vbo.mappedData, &cmd, sizeof(cmd));
+	_uiRenderer->getTextArena().markDirty(_vbo, 0, sizeof(cmd));
+}
 
-	_drawIndirectBuffer = utils::createBuffer(_uiRenderer->getDevice(), sizeof(VkDrawIndexedIndirectCommand), pvrvk::BufferUsageFlags::e_INDIRECT_BUFFER_BIT,
-		pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
-		pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT | pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT |
-			pvrvk::MemoryPropertyFlags::e_HOST_CACHED_BIT,
-		&_uiRenderer->getMemoryAllocator(), pvr::utils::vma::AllocationCreateFlags::e_MAPPED_BIT);
+TextElement_::~TextElement_()
+{
+	if (_uiRenderer)
+	{
+		_uiRenderer->getTextArena().free(_vbo);
+	}
 }
 
 void TextElement_::regenerateText() const
 {
-	_utf32.clear();
+	_newUtf32.clear();
 	if (_isUtf8)
 	{
-		utils::UnicodeConverter::convertUTF8ToUTF32(reinterpret_cast<const utf8*>(_textStr.c_str()), _utf32);
+		utils::UnicodeConverter::convertUTF8ToUTF32(reinterpret_cast<const utf8*>(_textStr.c_str()), _newUtf32);
 	}
 	else
 	{
 		if (sizeof(wchar_t) == 2 && _textWStr.length())
 		{
-			utils::UnicodeConverter::convertUTF16ToUTF32((const utf16*)_textWStr.c_str(), _utf32);
+			utils::UnicodeConverter::convertUTF16ToUTF32((const utf16*)_textWStr.c_str(), _newUtf32);
 		}
 		else if (_textWStr.length()) // if (sizeof(wchar_t) == 4)
 		{
-			_utf32.resize(_textWStr.size());
-			memcpy(&_utf32[0], &_textWStr[0], _textWStr.size() * sizeof(_textWStr[0]));
+			_newUtf32.resize(_textWStr.size());
+			memcpy(&_newUtf32[0], &_textWStr[0], _textWStr.size() * sizeof(_textWStr[0]));
 		}
 	}
 
-	_vertices.clear();
+	// Only the characters from the first difference onwards need to be laid out again. The character before it is included as its
+	// advance depends on the kerning with the (changed) character following it.
+	size_t firstChanged = 0;
+	const size_t numCommonChars = std::min(_utf32.size(), _newUtf32.size());
+	while (firstChanged < numCommonChars && _utf32[firstChanged] == _newUtf32[firstChanged])
+	{
+		++firstChanged;
+	}
+	_firstDirtyVertex = _numCachedVerts;
+	if (firstChanged == _utf32.size() && firstChanged == _newUtf32.size())
+	{
+		_isTextDirty = false;
+		return;
+	}
+	_utf32.swap(_newUtf32);
+
+	size_t firstChar = firstChanged ? firstChanged - 1 : 0;
+	if (firstChar > MaxLetters)
+	{
+		// Everything that changed is beyond the characters that are rendered
+		_isTextDirty = false;
+		return;
+	}
+	_firstDirtyVertex = firstChar ? static_cast<int32_t>(_glyphLayouts[firstChar].vertexCount) : 0;
+
 	if (_vertices.size() < (_utf32.size() * 4))
 	{
 		_vertices.resize(_utf32.size() * 4);
 	}
 
-	_numCachedVerts = updateVertices(0.0f, 0.f, 0.f, _utf32, _vertices.size() ? &_vertices[0] : 0);
+	_numCachedVerts = updateVertices(0.0f, 0.f, 0.f, _utf32, _vertices.size() ? &_vertices[0] : 0, firstChar);
 	assertion((_numCachedVerts % 4) == 0);
 	assertion((_numCachedVerts / 4) < MaxLetters);
 	_isTextDirty = false;
@@ -520,28 +601,33 @@ void TextElement_::regenerateText() const
 
 void TextElement_::updateVbo() const
 {
-	Device deviceTemp = _uiRenderer->getDevice();
-	if (_vertices.size())
+	UIRenderer::TextVertexArena& arena = _uiRenderer->getTextArena();
+	// Only write the vertices that were laid out again
+	if (_numCachedVerts > _firstDirtyVertex)
 	{
-		pvr::utils::updateHostVisibleBuffer(_vbo, _vertices.data(), 0, static_cast<uint32_t>(sizeof(Vertex) * _vertices.size()), true);
+		const uint32_t offset = static_cast<uint32_t>(TextVertexBlock::HeaderSize + sizeof(Vertex) * _firstDirtyVertex);
+		const uint32_t size = static_cast<uint32_t>(sizeof(Vertex) * (_numCachedVerts - _firstDirtyVertex));
+		memcpy(_vbo.mappedData + offset, &_vertices[_firstDirtyVertex], size);
+		arena.markDirty(_vbo, offset, size);
 	}
-	VkDrawIndexedIndirectCommand cmd;
-	cmd.firstInstance = 0;
-	cmd.firstIndex = 0;
-	cmd.instanceCount = 1;
-	cmd.indexCount = (glm::min<int32_t>(_numCachedVerts, 0xFFFC) >> 1) * 3;
-	cmd.vertexOffset = 0;
+	_firstDirtyVertex = _numCachedVerts;
 
-	pvr::utils::updateHostVisibleBuffer(_drawIndirectBuffer, &cmd, 0, static_cast<VkDeviceSize>(sizeof(VkDrawIndexedIndirectCommand)), true);
+	const uint32_t indexCount = (glm::min<int32_t>(_numCachedVerts, 0xFFFC) >> 1) * 3;
+	if (indexCount != _numCachedIndices)
+	{
+		memcpy(_vbo.mappedData + offsetof(VkDrawIndexedIndirectCommand, indexCount), &indexCount, sizeof(indexCount));
+		arena.markDirty(_vbo, offsetof(VkDrawIndexedIndirectCommand, indexCount), sizeof(indexCount));
+		_numCachedIndices = indexCount;
+	}
 }
 
 void TextElement_::onRender(CommandBufferBase& commands)
 {
-	if (_vbo.isValid())
+	if (_vbo.buffer.isValid())
 	{
-		commands->bindVertexBuffer(_vbo, 0, 0);
+		commands->bindVertexBuffer(_vbo.buffer, _vbo.offset + TextVertexBlock::HeaderSize, 0);
 		commands->bindIndexBuffer(_uiRenderer->getFontIbo(), 0, pvrvk::IndexType::e_UINT16);
-		commands->drawIndexedIndirect(_drawIndirectBuffer, 0, 1, 0);
+		commands->drawIndexedIndirect(_vbo.buffer, _vbo.offset, 1, 0);
 	}
 }
 
@@ -641,9 +727,20 @@ void Text_::onRender(CommandBufferBase& commandBuffer, uint64_t parentId)
 	commandBuffer->debugMarkerEndEXT();
 }
 
+void Text_::onAddToBatch(uint64_t parentId)
+{
+	const TextElement_& textElement = *_textElement;
+	const uint32_t numQuads = static_cast<uint32_t>(textElement._numCachedVerts) / 4;
+	if (numQuads)
+	{
+		const Font& font = getFont();
+		_uiRenderer->addToBatch(getTexDescriptorSet(), font->getImageView(), font->getSampler(), _color, 1, _mvpData[parentId].mvp, textElement._vertices.data(), numQuads);
+	}
+}
+
 void Text_::onRemoveInstance(uint64_t parentId)
 {
-	if (_mvpData[parentId].bufferArrayId != -1)
+	if (_uiRenderer && _mvpData[parentId].bufferArrayId != -1)
 	{
 		_uiRenderer->getUbo().releaseBufferSlice(_mvpData[parentId].bufferArrayId);
 		_uiRenderer->getMaterial().releaseBufferArray(_materialData.bufferArrayId);
@@ -743,6 +840,7 @@ MatrixGroup_::MatrixGroup_(UIRenderer& uiRenderer, uint64_t id) : Group_(uiRende
 void MatrixGroup_::commitUpdates() const
 {
 	calculateMvp(0, glm::mat4(1.f), _uiRenderer->getScreenRotation() * _viewProj, _uiRenderer->getViewport());
+	_uiRenderer->getTextArena().flush();
 }
 
 void PixelGroup_::calculateMvp(uint64_t parentIds, const glm::mat4& srt, const glm::mat4& viewProj, Rect2D const& viewport) const
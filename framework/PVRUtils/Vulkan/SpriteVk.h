@@ -149,6 +149,11 @@ private:
 
 	virtual void onRender(pvrvk::CommandBufferBase& commands, uint64_t parentId) {}
 
+	/// <summary>Used instead of onRender when the UIRenderer is in batching mode. Implement this function to add the already transformed
+	/// geometry of the sprite to the current batch of the UIRenderer instead of recording any commands.</summary>
+	/// <param name="parentId">The instance id of the parent.</param>
+	virtual void onAddToBatch(uint64_t parentId) {}
+
 	/// <summary>A function to call when adding a particular instance.</summary>
 	/// <param name="instance">The instance id of the parent.</param>
 	virtual void onAddInstance(uint64_t parentId) = 0;
@@ -481,6 +486,9 @@ private:
 	/// <summary>Function that will be automatically called by the uiRenderer. Do not call.</summary>
 	void onRender(pvrvk::CommandBufferBase& commands, uint64_t parentId);
 
+	/// <summary>Function that will be automatically called by the uiRenderer. Do not call.</summary>
+	void onAddToBatch(uint64_t parentId);
+
 	void updateTextureDescriptorSet() const;
 
 	void updateUbo(uint64_t parentIds) const;
@@ -702,6 +710,7 @@ private:
 	pvrvk::ImageView _imageView;
 	glm::uvec2 _dim;
 	uint32_t _alphaRenderingMode;
+	pvrvk::Sampler _sampler;
 	pvrvk::DescriptorSet _texDescSet;
 	UIRenderer* _uiRenderer;
 
@@ -800,6 +809,13 @@ public:
 	{
 		return _imageView;
 	}
+
+	/// <summary>Retrieve the sampler used to sample this font's texture.</summary>
+	/// <returns>This Font's sampler.</returns>
+	const pvrvk::Sampler& getSampler() const
+	{
+		return _sampler;
+	}
 };
 
 /// <summary>UIRenderer vertex format.</summary>
@@ -837,6 +853,31 @@ struct Vertex
 	}
 };
 
+/// <summary>A sub-range of the shared, persistently mapped text vertex arena of a UIRenderer. Holds the indirect draw command of a
+/// TextElement followed by its vertices.</summary>
+struct TextVertexBlock
+{
+	/// <summary>The size reserved for the indirect draw command at the start of the block.</summary>
+	enum
+	{
+		HeaderSize = 32
+	};
+
+	/// <summary>The arena page buffer the block was allocated from.</summary>
+	pvrvk::Buffer buffer;
+	/// <summary>A host pointer to the start of the block.</summary>
+	char* mappedData;
+	/// <summary>The index of the arena page the block was allocated from.</summary>
+	uint32_t page;
+	/// <summary>The offset of the block from the start of the page buffer.</summary>
+	uint32_t offset;
+	/// <summary>The size of the block.</summary>
+	uint32_t size;
+
+	/// <summary>Constructor. Creates an empty block.</summary>
+	TextVertexBlock() : mappedData(nullptr), page(0), offset(0), size(0) {}
+};
+
 /// <summary>The TextElement class should be used through the Refcounted Framework Object pvr::ui::TextElement. The TextElement_ class handles the
 /// implementation specifics for creating, managing and rendering text elements to the screen including buffer creation, updates and deletion
 /// as well as the rendering of the text element.</summary>
@@ -852,7 +893,8 @@ private:
 	/// <param name="uiRenderer">The UIRenderer to use when creating the Font.</param>
 	/// <param name="font">The font to use for the text element.</param>
 	/// <param name="maxTextLength">The maximum number of characters for the text element.</param>
-	TextElement_(UIRenderer& uiRenderer, const Font& font, uint32_t maxTextLength = 255) : _isTextDirty(true), _font(font), _maxLength(maxTextLength), _uiRenderer(&uiRenderer)
+	TextElement_(UIRenderer& uiRenderer, const Font& font, uint32_t maxTextLength = 255)
+		: _isUtf8(true), _isTextDirty(true), _font(font), _maxLength(maxTextLength), _numCachedVerts(0), _firstDirtyVertex(0), _numCachedIndices(0), _uiRenderer(&uiRenderer)
 	{
 		_maxLength = _maxLength ? _maxLength : 255;
 		createBuffers();
@@ -866,7 +908,8 @@ private:
 	/// <param name="maxTextLength">The maximum number of characters for the text element. If less than strlen(str),
 	/// it is implicitly set to strlen(<paramref name="str"/>)</param>
 	TextElement_(UIRenderer& uiRenderer, const std::string& str, const Font& font, uint32_t maxTextLength = 0)
-		: _isTextDirty(true), _font(font), _maxLength(std::max<uint32_t>(static_cast<uint32_t>(str.length()), maxTextLength)), _uiRenderer(&uiRenderer)
+		: _isUtf8(true), _isTextDirty(true), _font(font), _maxLength(std::max<uint32_t>(static_cast<uint32_t>(str.length()), maxTextLength)), _numCachedVerts(0),
+		  _firstDirtyVertex(0), _numCachedIndices(0), _uiRenderer(&uiRenderer)
 	{
 		_maxLength = _maxLength ? _maxLength : 255;
 		createBuffers();
@@ -881,7 +924,8 @@ private:
 	/// <param name="maxTextLength">The maximum number of characters for the text element. If less than strlen(str),
 	/// it is implicitly set to strlen(<paramref name="str"/>)</param>
 	TextElement_(UIRenderer& uiRenderer, const std::wstring& str, const Font& font, uint32_t maxTextLength = 0)
-		: _isTextDirty(true), _font(font), _maxLength(std::max<uint32_t>(static_cast<uint32_t>(str.length()), maxTextLength)), _uiRenderer(&uiRenderer)
+		: _isUtf8(true), _isTextDirty(true), _font(font), _maxLength(std::max<uint32_t>(static_cast<uint32_t>(str.length()), maxTextLength)), _numCachedVerts(0),
+		  _firstDirtyVertex(0), _numCachedIndices(0), _uiRenderer(&uiRenderer)
 	{
 		_maxLength = _maxLength ? _maxLength : 255;
 		createBuffers();
@@ -906,6 +950,13 @@ private:
 		_uiRenderer = uiRenderer;
 	}
 
+	// Called when the UIRenderer is destroyed before this text element: the block of the text arena is released with the arena.
+	void detachFromUIRenderer()
+	{
+		_vbo = TextVertexBlock();
+		_uiRenderer = nullptr;
+	}
+
 	void createBuffers();
 	void regenerateText() const;
 	void updateVbo() const;
@@ -913,19 +964,31 @@ private:
 	void onRender(pvrvk::CommandBufferBase& commands);
 
 	/// <summary>Function that will be automatically called by the uiRenderer. Do not call.</summary>
-	uint32_t updateVertices(float fZPos, float xPos, float yPos, const std::vector<uint32_t>& text, Vertex* const pVertices) const;
+	uint32_t updateVertices(float fZPos, float xPos, float yPos, const std::vector<uint32_t>& text, Vertex* const pVertices, size_t firstChar = 0) const;
+
+	// The state of the layout when it reached a character, used to lay out only the characters following a change
+	struct GlyphLayout
+	{
+		float xPos;
+		float yPos;
+		uint32_t vertexCount;
+		math::AxisAlignedBox boundingRect;
+	};
 
 	bool _isUtf8;
 	mutable bool _isTextDirty;
 	mutable Font _font;
-	mutable pvrvk::Buffer _vbo;
-	mutable pvrvk::Buffer _drawIndirectBuffer;
+	mutable TextVertexBlock _vbo;
 	mutable uint32_t _maxLength;
 	mutable std::string _textStr;
 	mutable std::wstring _textWStr;
 	mutable std::vector<uint32_t> _utf32;
+	mutable std::vector<uint32_t> _newUtf32;
+	mutable std::vector<GlyphLayout> _glyphLayouts;
 	mutable std::vector<Vertex> _vertices;
 	mutable int32_t _numCachedVerts;
+	mutable int32_t _firstDirtyVertex;
+	mutable uint32_t _numCachedIndices;
 	mutable math::AxisAlignedBox _boundingRect; //< Bounding rectangle of the sprite
 	UIRenderer* _uiRenderer;
 
@@ -936,6 +999,9 @@ public:
 		MaxLetters = 5120
 	};
 
+	/// <summary>Destructor. Returns the vertices of the text element to the arena of the UIRenderer.</summary>
+	~TextElement_();
+
 	/// <summary>Get the Sprite's bounding box dimensions. If the sprite has changed, the value returned is only valid after
 	/// calling the commitUpdates function</summary>
 	/// <returns>The Sprite's bounding box dimensions.</returns>
@@ -1033,13 +1099,14 @@ private:
 
 	void onRender(pvrvk::CommandBufferBase& commands, uint64_t parentId);
 
+	void onAddToBatch(uint64_t parentId);
+
 	void updateUbo(uint64_t parentId) const;
 	mutable TextElement _textElement;
 	mutable std::map<uint64_t, MvpUboData> _mvpData;
 
 	std::string _imageViewObjectName;
 	std::string _vboObjectName;
-	std::string _drawIndirectBufferObjectName;
 
 public:
 	/// <summary>Virtual Descructor for a Text_.</summary>
@@ -1116,7 +1183,7 @@ public:
 	/// <returns>Returns true if the sprite name is dirty and the cached string must be updated.</returns>
 	bool isSpriteNameDirty() const
 	{
-		return !(_textElement->getFont()->getImageView()->getObjectName() == _imageViewObjectName && _textElement->_vbo->getObjectName() == _vboObjectName);
+		return !(_textElement->getFont()->getImageView()->getObjectName() == _imageViewObjectName && _textElement->_vbo.buffer->getObjectName() == _vboObjectName);
 	}
 
 	/// <summary>Get the sprite name.</summary>
@@ -1126,11 +1193,9 @@ public:
 		if (isSpriteNameDirty())
 		{
 			_imageViewObjectName = _textElement->getFont()->getImageView()->getObjectName();
-			_vboObjectName = _textElement->_vbo->getObjectName();
-			_drawIndirectBufferObjectName = _textElement->_drawIndirectBuffer->getObjectName();
+			_vboObjectName = _textElement->_vbo.buffer->getObjectName();
 			_spriteName = "ImageView: " + _imageViewObjectName;
 			_spriteName += ", Vbo: " + _vboObjectName;
-			_spriteName += ", Indirect Buffer: " + _drawIndirectBufferObjectName;
 		}
 		return _spriteName;
 	}
@@ -1172,6 +1237,15 @@ private:
 		}
 	}
 
+	/// <summary>Internal function that UIRenderer calls to render in batching mode. Do not call directly.</summary>
+	virtual void onAddToBatch(uint64_t parentId)
+	{
+		for (ChildContainer::iterator it = _children.begin(); it != _children.end(); ++it)
+		{
+			(*it)->onAddToBatch(packId(parentId, _id));
+		}
+	}
+
 	/// <summary>Constructor. Internal use. The parameter groupid is an implementation detail used to implement and optimize
 	/// group behaviour, and cannot be trivially determined.</summary>
 	Group_(UIRenderer& uiRenderer, uint64_t groupid) : Sprite_(uiRenderer), _id(groupid) {}
@@ -0,0 +1,266 @@
+/*!
+\brief Implementation of the StreamingUploader.
+\file PVRUtils/Vulkan/StreamingUploaderVk.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+//!\cond NO_DOXYGEN
+#include "StreamingUploaderVk.h"
+#include "PVRVk/ImageVk.h"
+#include "PVRVk/FenceVk.h"
+
+namespace pvr {
+namespace utils {
+void StreamingUploader::init(pvrvk::Device& device, pvrvk::Queue& transferQueue, uint32_t dstQueueFamily, vma::Allocator& stagingAllocator,
+	pvrvk::DeviceSize stagingSize, async::Mutex* queueMutex)
+{
+	release();
+	_device = device;
+	_queue = transferQueue;
+	_dstQueueFamily = dstQueueFamily;
+	_stagingAllocator = stagingAllocator;
+	_queueMutex = queueMutex;
+	_commandPool = device->createCommandPool(pvrvk::CommandPoolCreateInfo(transferQueue->getFamilyIndex(), pvrvk::CommandPoolCreateFlags::e_RESET_COMMAND_BUFFER_BIT));
+	_stagingRing.init(device, stagingAllocator, stagingSize, pvrvk::BufferUsageFlags::e_TRANSFER_SRC_BIT);
+	pvrvk::Buffer stagingBuffer = _stagingRing.getBuffer();
+	stagingBuffer->setObjectName("PVRUtilsVk::StreamingUploader::StagingRing");
+}
+
+void StreamingUploader::release()
+{
+	if (!_queue.isValid())
+	{
+		return;
+	}
+	// Unsubmitted uploads would leave their images and buffers without data, so flush them out before waiting for everything.
+	wait(submit());
+	_completed.clear();
+	_freeCommandBuffers.clear();
+	_stagingRing.release();
+	_commandPool.reset();
+	_stagingAllocator.reset();
+	_queue.reset();
+	_device.reset();
+	_queueMutex = nullptr;
+}
+
+void StreamingUploader::beginBatch()
+{
+	Batch& batch = _currentBatch;
+	batch.token = _nextToken;
+	if (_freeCommandBuffers.empty())
+	{
+		batch.commandBuffer = _commandPool->allocateCommandBuffer();
+	}
+	else
+	{
+		batch.commandBuffer = _freeCommandBuffers.back();
+		_freeCommandBuffers.pop_back();
+	}
+	// Every batch gets its own fence, which the staging ring keeps until it has recycled the batch's record. Reusing the fence of a completed batch
+	// would reset it while the ring may still be waiting on it for that batch.
+	batch.fence = _device->createFence();
+	// Everything staged for this batch is reclaimed by the ring as soon as the batch's fence is signalled
+	_stagingRing.beginFrame(static_cast<uint32_t>(batch.token), batch.fence);
+	batch.commandBuffer->begin(pvrvk::CommandBufferUsageFlags::e_ONE_TIME_SUBMIT_BIT);
+	batch.commandBuffer->debugMarkerBeginEXT("PVRUtilsVk::StreamingUploader::Batch");
+}
+
+void StreamingUploader::addReleaseBarrier(const pvrvk::Image& image, pvrvk::ImageLayout finalLayout)
+{
+	const pvrvk::ImageSubresourceRange range(inferAspectFromFormat(image->getFormat()), 0, image->getNumMipLevels(), 0, image->getNumArrayLayers());
+	if (requiresOwnershipTransfer())
+	{
+		// The same layout transition must be specified by both halves of the ownership transfer. It is performed once.
+		_currentBatch.releaseImageBarriers.emplace_back(pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags(0), image, range,
+			pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, finalLayout, _queue->getFamilyIndex(), _dstQueueFamily);
+		_currentBatch.acquireImageBarriers.emplace_back(pvrvk::AccessFlags(0), pvrvk::AccessFlags::e_MEMORY_READ_BIT, image, range, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL,
+			finalLayout, _queue->getFamilyIndex(), _dstQueueFamily);
+	}
+	else
+	{
+		_currentBatch.releaseImageBarriers.emplace_back(pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags::e_MEMORY_READ_BIT, image, range,
+			pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, finalLayout, static_cast<uint32_t>(-1), static_cast<uint32_t>(-1));
+	}
+}
+
+void StreamingUploader::addReleaseBarrier(const pvrvk::Buffer& buffer, pvrvk::DeviceSize offset, pvrvk::DeviceSize size)
+{
+	if (requiresOwnershipTransfer())
+	{
+		_currentBatch.releaseBufferBarriers.emplace_back(pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags(0), buffer, static_cast<uint32_t>(offset),
+			static_cast<uint32_t>(size), _queue->getFamilyIndex(), _dstQueueFamily);
+		_currentBatch.acquireBufferBarriers.emplace_back(pvrvk::AccessFlags(0), pvrvk::AccessFlags::e_MEMORY_READ_BIT, buffer, static_cast<uint32_t>(offset),
+			static_cast<uint32_t>(size), _queue->getFamilyIndex(), _dstQueueFamily);
+	}
+	else
+	{
+		_currentBatch.releaseBufferBarriers.emplace_back(
+			pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags::e_MEMORY_READ_BIT, buffer, static_cast<uint32_t>(offset), static_cast<uint32_t>(size));
+	}
+}
+
+StreamingUploader::Token StreamingUploader::uploadBuffer(const pvrvk::Buffer& buffer, const void* data, pvrvk::DeviceSize offset, pvrvk::DeviceSize size)
+{
+	debug_assertion(_queue.isValid(), "StreamingUploader: uploadBuffer called before init");
+	if (!_currentBatch.commandBuffer.isValid())
+	{
+		beginBatch();
+	}
+	TransientBufferAllocation staging = _stagingRing.allocate(size);
+	if (!staging.isValid() && (!_currentBatch.releaseImageBarriers.empty() || !_currentBatch.releaseBufferBarriers.empty()))
+	{
+		// The ring is full of the current batch: submit it to make room and retry in a new one
+		submit();
+		beginBatch();
+		staging = _stagingRing.allocate(size);
+	}
+	pvrvk::BufferCopy region(staging.offset, offset, size);
+	if (staging.isValid())
+	{
+		memcpy(staging.mappedData, data, static_cast<size_t>(size));
+		_currentBatch.commandBuffer->copyBuffer(staging.buffer, buffer, 1, &region);
+	}
+	else
+	{
+		// Larger than the whole ring. The dedicated buffer is kept alive by the batch until it completes.
+		pvrvk::Buffer stagingBuffer = createBuffer(_device, size, pvrvk::BufferUsageFlags::e_TRANSFER_SRC_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
+			pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT, &_stagingAllocator, vma::AllocationCreateFlags::e_MAPPED_BIT);
+		updateHostVisibleBuffer(stagingBuffer, data, 0, size, true);
+		region.setSrcOffset(0);
+		_currentBatch.commandBuffer->copyBuffer(stagingBuffer, buffer, 1, &region);
+		_currentBatch.stagingBuffers.emplace_back(std::move(stagingBuffer));
+	}
+	addReleaseBarrier(buffer, offset, size);
+	return _currentBatch.token;
+}
+
+StreamingUploader::Token StreamingUploader::uploadImage(const Texture& texture, bool allowDecompress, pvrvk::ImageView& outImageView, pvrvk::ImageUsageFlags usageFlags,
+	pvrvk::ImageLayout finalLayout, vma::Allocator* imageAllocator, vma::AllocationCreateFlags imageAllocationCreateFlags)
+{
+	debug_assertion(_queue.isValid(), "StreamingUploader: uploadImage called before init");
+	if (!_currentBatch.commandBuffer.isValid())
+	{
+		beginBatch();
+	}
+	// Leave the image in e_TRANSFER_DST_OPTIMAL: the transition to the final layout is part of the batched release barriers.
+	outImageView = uploadImageAndView(_device, texture, allowDecompress, _currentBatch.commandBuffer, _stagingRing, usageFlags, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL,
+		imageAllocator, imageAllocationCreateFlags);
+	addReleaseBarrier(outImageView->getImage(), finalLayout);
+	return _currentBatch.token;
+}
+
+StreamingUploader::Token StreamingUploader::submit()
+{
+	Batch& batch = _currentBatch;
+	if (!batch.commandBuffer.isValid())
+	{
+		return _nextToken - 1;
+	}
+	if (!batch.releaseImageBarriers.empty() || !batch.releaseBufferBarriers.empty())
+	{
+		pvrvk::MemoryBarrierSet barriers;
+		for (const pvrvk::ImageMemoryBarrier& barrier : batch.releaseImageBarriers)
+		{
+			barriers.addBarrier(barrier);
+		}
+		for (const pvrvk::BufferMemoryBarrier& barrier : batch.releaseBufferBarriers)
+		{
+			barriers.addBarrier(barrier);
+		}
+		batch.commandBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_ALL_COMMANDS_BIT, barriers, true);
+		batch.releaseImageBarriers.clear();
+		batch.releaseBufferBarriers.clear();
+	}
+	batch.commandBuffer->debugMarkerEndEXT();
+	batch.commandBuffer->end();
+	_stagingRing.flush();
+
+	pvrvk::SubmitInfo submitInfo;
+	submitInfo.commandBuffers = &batch.commandBuffer;
+	submitInfo.numCommandBuffers = 1;
+	if (_queueMutex != nullptr)
+	{
+		std::lock_guard<async::Mutex> lock(*_queueMutex);
+		_queue->submit(&submitInfo, 1, batch.fence);
+	}
+	else
+	{
+		_queue->submit(&submitInfo, 1, batch.fence);
+	}
+
+	const Token token = batch.token;
+	_inFlight.emplace_back(std::move(batch));
+	_currentBatch = Batch();
+	++_nextToken;
+	return token;
+}
+
+void StreamingUploader::pollCompletedBatches()
+{
+	// A single queue completes its submissions in order, so only the oldest batch needs to be checked each time
+	while (!_inFlight.empty() && _inFlight.front().fence->isSignalled())
+	{
+		Batch& batch = _inFlight.front();
+		_completedToken = batch.token;
+		batch.commandBuffer->reset(pvrvk::CommandBufferResetFlags(0));
+		_freeCommandBuffers.emplace_back(std::move(batch.commandBuffer));
+		batch.fence.reset();
+		batch.stagingBuffers.clear();
+		if (!batch.acquireImageBarriers.empty() || !batch.acquireBufferBarriers.empty())
+		{
+			_completed.emplace_back(std::move(batch));
+		}
+		_inFlight.pop_front();
+	}
+}
+
+bool StreamingUploader::isComplete(Token token)
+{
+	if (token > _completedToken)
+	{
+		pollCompletedBatches();
+	}
+	return token <= _completedToken;
+}
+
+void StreamingUploader::wait(Token token)
+{
+	if (token >= _nextToken && _currentBatch.commandBuffer.isValid())
+	{
+		submit();
+	}
+	while (token > _completedToken && !_inFlight.empty())
+	{
+		_inFlight.front().fence->wait();
+		pollCompletedBatches();
+	}
+}
+
+StreamingUploader::Token StreamingUploader::recordOwnershipAcquire(pvrvk::CommandBufferBase commandBuffer)
+{
+	pollCompletedBatches();
+	if (_completed.empty())
+	{
+		return _completedToken;
+	}
+	pvrvk::MemoryBarrierSet barriers;
+	for (const Batch& batch : _completed)
+	{
+		for (const pvrvk::ImageMemoryBarrier& barrier : batch.acquireImageBarriers)
+		{
+			barriers.addBarrier(barrier);
+		}
+		for (const pvrvk::BufferMemoryBarrier& barrier : batch.acquireBufferBarriers)
+		{
+			barriers.addBarrier(barrier);
+		}
+	}
+	commandBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TOP_OF_PIPE_BIT, pvrvk::PipelineStageFlags::e_ALL_COMMANDS_BIT, barriers, true);
+	_completed.clear();
+	return _completedToken;
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,161 @@
+/*!
+\brief Contains an uploader that streams buffer and image data to the GPU through a dedicated transfer queue.
+\file PVRUtils/Vulkan/StreamingUploaderVk.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+#pragma once
+#include "PVRUtils/Vulkan/HelperVk.h"
+#include "PVRCore/Threading.h"
+#include "PVRVk/QueueVk.h"
+#include "PVRVk/CommandPoolVk.h"
+#include "PVRVk/CommandBufferVk.h"
+#include "PVRVk/MemoryBarrierVk.h"
+#include "PVRUtils/Vulkan/TransientBufferAllocatorVk.h"
+#include <deque>
+
+namespace pvr {
+namespace utils {
+/// <summary>Streams buffer and image uploads to the GPU through a (preferably dedicated) transfer queue.
+/// Uploads are recorded into the currently open batch, and all of them are submitted with a single queue submission when submit() is called,
+/// typically once per frame. Every upload returns the completion token of its batch. Tokens increase monotonically and can be polled with isComplete
+/// without ever blocking. The staging data is sub-allocated from a persistent staging ring whose space is reclaimed once a batch's fence is signalled.
+///
+/// If the transfer queue belongs to a different queue family than the queue that will consume the resources, the uploaded resources are released
+/// by the transfer queue family at the end of their batch, and must be acquired by the consuming queue family by calling recordOwnershipAcquire in a
+/// command buffer of that family before they are used. recordOwnershipAcquire records the acquire barriers of all completed batches at once, so it is
+/// normally called at the start of every frame's command buffer. If the families match, no ownership transfer takes place and the resources can be used
+/// as soon as their token is complete.
+///
+/// The uploader is not thread safe: it is meant to be driven from a single (usually the render) thread.</summary>
+class StreamingUploader
+{
+public:
+	/// <summary>A completion token. Tokens of later batches are always larger than those of earlier batches.</summary>
+	typedef uint64_t Token;
+
+	/// <summary>The default size of the staging ring.</summary>
+	enum
+	{
+		DefaultStagingSize = 16 * 1024 * 1024
+	};
+
+	/// <summary>Constructor. Creates an uninitialised StreamingUploader.</summary>
+	StreamingUploader() : _dstQueueFamily(static_cast<uint32_t>(-1)), _queueMutex(nullptr), _nextToken(1), _completedToken(0) {}
+
+	/// <summary>Destructor. Waits for all submitted batches to complete.</summary>
+	~StreamingUploader()
+	{
+		release();
+	}
+
+	/// <summary>Initialise the uploader.</summary>
+	/// <param name="device">The device used to create the command pool, fences and staging ring</param>
+	/// <param name="transferQueue">The queue the uploads are submitted to. Ideally a queue of a transfer-only queue family which is not used for anything else.</param>
+	/// <param name="dstQueueFamily">The queue family of the queue which will use the uploaded resources. If it is different from the family of the
+	/// transfer queue, queue family ownership transfers are performed.</param>
+	/// <param name="stagingAllocator">The VMA allocator used to allocate the staging ring (and the dedicated staging buffers of uploads which do not
+	/// fit in the ring)</param>
+	/// <param name="stagingSize">The size of the staging ring</param>
+	/// <param name="queueMutex">If the transfer queue is also used elsewhere, a mutex that guards all submissions to it. Otherwise nullptr.</param>
+	void init(pvrvk::Device& device, pvrvk::Queue& transferQueue, uint32_t dstQueueFamily, vma::Allocator& stagingAllocator,
+		pvrvk::DeviceSize stagingSize = DefaultStagingSize, async::Mutex* queueMutex = nullptr);
+
+	/// <summary>Release all resources, waiting for all submitted batches to complete first. Resources whose acquire barriers were not yet recorded
+	/// remain owned by the transfer queue family.</summary>
+	void release();
+
+	/// <summary>Upload data to a (typically device local) buffer. The buffer must have been created with e_TRANSFER_DST_BIT usage.</summary>
+	/// <param name="buffer">The destination buffer</param>
+	/// <param name="data">The data to upload. It is copied into the staging ring immediately, so it need not outlive the call.</param>
+	/// <param name="offset">The offset into the destination buffer</param>
+	/// <param name="size">The size of the data</param>
+	/// <returns>The completion token of the upload.</returns>
+	Token uploadBuffer(const pvrvk::Buffer& buffer, const void* data, pvrvk::DeviceSize offset, pvrvk::DeviceSize size);
+
+	/// <summary>Create an image and image view from a texture and upload its data.</summary>
+	/// <param name="texture">The texture to upload. Its data is copied into the staging ring immediately.</param>
+	/// <param name="allowDecompress">Allow decompressing the texture in software if its format is not supported</param>
+	/// <param name="outImageView">The created image view. It must not be used until the returned token is complete (and, if required, acquired).</param>
+	/// <param name="usageFlags">The usage flags of the image</param>
+	/// <param name="finalLayout">The layout the image is transitioned to</param>
+	/// <param name="imageAllocator">A VMA allocator used to allocate memory for the image</param>
+	/// <param name="imageAllocationCreateFlags">VMA Allocation creation flags for the image</param>
+	/// <returns>The completion token of the upload.</returns>
+	Token uploadImage(const Texture& texture, bool allowDecompress, pvrvk::ImageView& outImageView, pvrvk::ImageUsageFlags usageFlags = pvrvk::ImageUsageFlags::e_SAMPLED_BIT,
+		pvrvk::ImageLayout finalLayout = pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL, vma::Allocator* imageAllocator = nullptr,
+		vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE);
+
+	/// <summary>Submit all uploads recorded since the last submit with a single queue submission. Does nothing if nothing was recorded.</summary>
+	/// <returns>The token of the submitted batch, or the token of the last submitted batch if nothing was recorded.</returns>
+	Token submit();
+
+	/// <summary>Check, without blocking, whether the uploads of a token have completed on the transfer queue.</summary>
+	/// <param name="token">A token returned by one of the upload functions or by submit</param>
+	/// <returns>True if the token has completed. A token of a batch that has not been submitted yet is never complete.</returns>
+	bool isComplete(Token token);
+
+	/// <summary>Block until the uploads of a token have completed, submitting the current batch first if the token belongs to it.</summary>
+	/// <param name="token">A token returned by one of the upload functions or by submit</param>
+	void wait(Token token);
+
+	/// <summary>Record the queue family ownership acquire barriers of all batches that have completed since the last call into a command buffer
+	/// of the destination queue family. Does nothing if no ownership transfers are required.</summary>
+	/// <param name="commandBuffer">A command buffer, in the recording state, which will be submitted to a queue of the destination queue family
+	/// before any of the uploaded resources are used.</param>
+	/// <returns>The token up to which (inclusive) the resources are now acquired.</returns>
+	Token recordOwnershipAcquire(pvrvk::CommandBufferBase commandBuffer);
+
+	/// <summary>Check whether the uploaded resources need to be acquired with recordOwnershipAcquire before use.</summary>
+	/// <returns>True if the transfer queue and the destination queue belong to different queue families.</returns>
+	bool requiresOwnershipTransfer() const
+	{
+		return _queue.isValid() && _queue->getFamilyIndex() != _dstQueueFamily;
+	}
+
+	/// <summary>Get the token that the next upload will be recorded with.</summary>
+	/// <returns>The token of the currently open batch.</returns>
+	Token getCurrentToken() const
+	{
+		return _nextToken;
+	}
+
+private:
+	struct Batch
+	{
+		Token token;
+		pvrvk::CommandBuffer commandBuffer;
+		pvrvk::Fence fence;
+		// The barriers are kept as plain vectors (rather than MemoryBarrierSets, which are not copyable) so that batches can be queued.
+		std::vector<pvrvk::ImageMemoryBarrier> releaseImageBarriers;
+		std::vector<pvrvk::BufferMemoryBarrier> releaseBufferBarriers;
+		std::vector<pvrvk::ImageMemoryBarrier> acquireImageBarriers;
+		std::vector<pvrvk::BufferMemoryBarrier> acquireBufferBarriers;
+		// Staging buffers of uploads too large for the ring, released when the batch completes
+		std::vector<pvrvk::Buffer> stagingBuffers;
+		Batch() : token(0) {}
+	};
+
+	void beginBatch();
+	void pollCompletedBatches();
+	void addReleaseBarrier(const pvrvk::Image& image, pvrvk::ImageLayout finalLayout);
+	void addReleaseBarrier(const pvrvk::Buffer& buffer, pvrvk::DeviceSize offset, pvrvk::DeviceSize size);
+
+	pvrvk::Device _device;
+	pvrvk::Queue _queue;
+	pvrvk::CommandPool _commandPool;
+	vma::Allocator _stagingAllocator;
+	uint32_t _dstQueueFamily;
+	async::Mutex* _queueMutex;
+	TransientBufferAllocator _stagingRing;
+
+	Batch _currentBatch;
+	std::deque<Batch> _inFlight; // Submitted, not yet completed
+	std::deque<Batch> _completed; // Completed, acquire barriers not yet recorded
+	std::vector<pvrvk::CommandBuffer> _freeCommandBuffers;
+	Token _nextToken;
+	Token _completedToken;
+};
+} // namespace utils
+} // namespace pvr
@@ -0,0 +1,176 @@
+/*!
+\brief Implementation of the TransientBufferAllocator.
+\file PVRUtils/Vulkan/TransientBufferAllocatorVk.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+//!\cond NO_DOXYGEN
+#include "TransientBufferAllocatorVk.h"
+#include "PVRUtils/Vulkan/HelperVk.h"
+#include "PVRVk/PhysicalDeviceVk.h"
+
+namespace pvr {
+namespace utils {
+void TransientBufferAllocator::init(pvrvk::Device& device, vma::Allocator& allocator, pvrvk::DeviceSize size, pvrvk::BufferUsageFlags bufferUsage)
+{
+	release();
+	const pvrvk::PhysicalDeviceLimits& limits = device->getPhysicalDevice()->getProperties().getLimits();
+
+	// Every allocation must be usable as a dynamic offset / binding offset for all the usages of the buffer
+	_defaultAlignment = 4;
+	if ((bufferUsage & pvrvk::BufferUsageFlags::e_UNIFORM_BUFFER_BIT) != pvrvk::BufferUsageFlags(0))
+	{
+		_defaultAlignment = std::max(_defaultAlignment, limits.getMinUniformBufferOffsetAlignment());
+	}
+	if ((bufferUsage & pvrvk::BufferUsageFlags::e_STORAGE_BUFFER_BIT) != pvrvk::BufferUsageFlags(0))
+	{
+		_defaultAlignment = std::max(_defaultAlignment, limits.getMinStorageBufferOffsetAlignment());
+	}
+
+	_buffer = createBuffer(device, size, bufferUsage, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
+		pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT | pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, &allocator,
+		vma::AllocationCreateFlags::e_MAPPED_BIT);
+	_mappedData = static_cast<char*>(_buffer->getDeviceMemory()->getMappedData());
+	_capacity = size;
+
+	// Flushed ranges must be multiples of nonCoherentAtomSize, so align every allocation to it as well.
+	_nonCoherentAtomSize = 1;
+	if ((_buffer->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == pvrvk::MemoryPropertyFlags(0))
+	{
+		_nonCoherentAtomSize = std::max<pvrvk::DeviceSize>(limits.getNonCoherentAtomSize(), 1);
+		_defaultAlignment = std::max(_defaultAlignment, _nonCoherentAtomSize);
+	}
+}
+
+void TransientBufferAllocator::beginFrame(uint32_t frameIndex, const pvrvk::Fence& frameFence)
+{
+	debug_assertion(_buffer.isValid(), "TransientBufferAllocator: beginFrame called before init");
+	// The previous use of this frame index has completed on the GPU
+	for (FrameRecord& frame : _frames)
+	{
+		if (frame.frameIndex == frameIndex)
+		{
+			frame.complete = true;
+		}
+	}
+	recycleCompletedFrames(false);
+	if (_frames.empty())
+	{
+		// Nothing is in use, so start from the beginning to get the largest possible contiguous range
+		_head = _tail = 0;
+	}
+	_frames.emplace_back(frameIndex, _head, frameFence);
+	_frameBegin = _head;
+	_frameWrapped = false;
+}
+
+void TransientBufferAllocator::recycleCompletedFrames(bool waitForOldest)
+{
+	// Frames are recycled strictly in submission order. The current frame (the last record) is never recycled.
+	while (_frames.size() > 1)
+	{
+		FrameRecord& oldest = _frames.front();
+		if (!oldest.complete && oldest.fence.isValid())
+		{
+			oldest.complete = waitForOldest ? oldest.fence->wait() : oldest.fence->isSignalled();
+		}
+		if (!oldest.complete)
+		{
+			break;
+		}
+		_tail = oldest.end;
+		_frames.pop_front();
+		waitForOldest = false;
+	}
+}
+
+bool TransientBufferAllocator::tryAllocate(pvrvk::DeviceSize size, pvrvk::DeviceSize alignment, pvrvk::DeviceSize& outOffset)
+{
+	pvrvk::DeviceSize offset = align(_head, alignment);
+	// The head is never allowed to catch up with the tail, so that head == tail always means "empty"
+	if (_head >= _tail)
+	{
+		if (offset + size <= _capacity)
+		{
+			outOffset = offset;
+			return true;
+		}
+		if (size < _tail)
+		{
+			outOffset = 0;
+			_frameWrapped = true;
+			return true;
+		}
+		return false;
+	}
+	if (offset + size < _tail)
+	{
+		outOffset = offset;
+		return true;
+	}
+	return false;
+}
+
+TransientBufferAllocation TransientBufferAllocator::allocate(pvrvk::DeviceSize size, pvrvk::DeviceSize alignment)
+{
+	debug_assertion(!_frames.empty(), "TransientBufferAllocator: allocate must be called between beginFrame calls");
+	alignment = alignment ? align(alignment, _nonCoherentAtomSize) : _defaultAlignment;
+	// Round the size up so that the flushed ranges never overlap data of a different frame
+	pvrvk::DeviceSize alignedSize = align(size, _nonCoherentAtomSize);
+
+	TransientBufferAllocation allocation;
+	pvrvk::DeviceSize offset = 0;
+	if (!tryAllocate(alignedSize, alignment, offset))
+	{
+		recycleCompletedFrames(false);
+		while (!tryAllocate(alignedSize, alignment, offset))
+		{
+			// Out of space: block on the oldest frame in flight that has a fence. Give up if nothing else can be recycled.
+			size_t numFrames = _frames.size();
+			recycleCompletedFrames(true);
+			if (_frames.size() == numFrames)
+			{
+				Log(LogLevel::Error, "TransientBufferAllocator: Out of space allocating %llu bytes (capacity %llu, in use %llu)", static_cast<unsigned long long>(size),
+					static_cast<unsigned long long>(_capacity), static_cast<unsigned long long>(getUsedSize()));
+				return allocation;
+			}
+		}
+	}
+	_head = offset + alignedSize;
+	_frames.back().end = _head;
+
+	allocation.buffer = _buffer;
+	allocation.offset = offset;
+	allocation.size = size;
+	allocation.mappedData = _mappedData + offset;
+	return allocation;
+}
+
+void TransientBufferAllocator::flush()
+{
+	if (isHostCoherent() || _frames.empty())
+	{
+		return;
+	}
+	if (_frameWrapped)
+	{
+		if (_frameBegin < _capacity)
+		{
+			_buffer->getDeviceMemory()->flushRange(_frameBegin, VK_WHOLE_SIZE);
+		}
+		if (_head)
+		{
+			_buffer->getDeviceMemory()->flushRange(0, _head);
+		}
+	}
+	else if (_head > _frameBegin)
+	{
+		_buffer->getDeviceMemory()->flushRange(_frameBegin, _head - _frameBegin);
+	}
+	_frameBegin = _head;
+	_frameWrapped = false;
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
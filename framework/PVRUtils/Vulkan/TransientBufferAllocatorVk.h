@@ -0,0 +1,143 @@
+/*!
+\brief Contains a ring allocator handing out per-frame transient sub-ranges of a persistently mapped buffer.
+\file PVRUtils/Vulkan/TransientBufferAllocatorVk.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+#pragma once
+#include "PVRVk/DeviceVk.h"
+#include "PVRVk/BufferVk.h"
+#include "PVRVk/FenceVk.h"
+#include "PVRUtils/Vulkan/MemoryAllocator.h"
+#include <deque>
+
+namespace pvr {
+namespace utils {
+/// <summary>A sub-range of a TransientBufferAllocator's buffer. The buffer and offset can be used directly for binding vertex/index buffers
+/// or as the dynamic offset of a dynamic uniform/storage buffer descriptor bound to the allocator's buffer.</summary>
+struct TransientBufferAllocation
+{
+	pvrvk::Buffer buffer; //!< The buffer the allocation was made from
+	pvrvk::DeviceSize offset; //!< The offset of the allocation from the start of the buffer
+	pvrvk::DeviceSize size; //!< The size of the allocation
+	void* mappedData; //!< A host pointer to the start of the allocation
+
+	/// <summary>Constructor. Creates an invalid allocation.</summary>
+	TransientBufferAllocation() : offset(0), size(0), mappedData(nullptr) {}
+
+	/// <summary>Check whether the allocation succeeded.</summary>
+	/// <returns>True if the allocation is valid, otherwise false.</returns>
+	bool isValid() const
+	{
+		return mappedData != nullptr;
+	}
+};
+
+/// <summary>A linear (bump) allocator for data that is regenerated every frame, such as per-frame uniforms, text, debug lines or particles.
+/// A single persistently mapped buffer is used as a ring. Each frame in flight allocates from the ring as needed and the space used by a frame is
+/// recycled once that frame has completed on the GPU, which is known either because beginFrame was called again for the same frame index (i.e. after
+/// the application waited on that frame's fence) or because the fence passed to beginFrame has been signalled.
+/// Allocations never create buffers or require descriptor updates: bind the buffer once and use the returned offsets.</summary>
+class TransientBufferAllocator
+{
+public:
+	/// <summary>Constructor. Creates an uninitialised TransientBufferAllocator.</summary>
+	TransientBufferAllocator() : _capacity(0), _defaultAlignment(1), _nonCoherentAtomSize(1), _mappedData(nullptr), _head(0), _tail(0), _frameBegin(0), _frameWrapped(false) {}
+
+	/// <summary>Initialise the TransientBufferAllocator, creating its persistently mapped buffer.</summary>
+	/// <param name="device">The device used to create the buffer</param>
+	/// <param name="allocator">The VMA allocator used to allocate the memory for the buffer</param>
+	/// <param name="size">The size of the ring. It should be large enough to hold the transient data of all frames in flight.</param>
+	/// <param name="bufferUsage">The usages the buffer will be used for (e.g. e_UNIFORM_BUFFER_BIT | e_VERTEX_BUFFER_BIT). The default alignment of
+	/// allocations is calculated from the usage so that offsets are always valid dynamic offsets.</param>
+	void init(pvrvk::Device& device, vma::Allocator& allocator, pvrvk::DeviceSize size, pvrvk::BufferUsageFlags bufferUsage);
+
+	/// <summary>Begin allocating for a frame. Everything allocated during the previous use of the same frame index is recycled, so this must
+	/// only be called once the GPU work of that previous use has completed (typically straight after waiting for the frame's fence).</summary>
+	/// <param name="frameIndex">The index of the frame in flight (typically the swapchain index)</param>
+	/// <param name="frameFence">Optional. The fence which will be signalled when the GPU work of this frame has completed. If provided, the space used
+	/// by this frame can be recycled as soon as the fence is signalled, rather than only when frameIndex is used again.</param>
+	void beginFrame(uint32_t frameIndex, const pvrvk::Fence& frameFence = pvrvk::Fence());
+
+	/// <summary>Allocate a sub-range of the buffer for the current frame.</summary>
+	/// <param name="size">The size of the allocation</param>
+	/// <param name="alignment">The alignment of the allocation. 0 uses the default alignment calculated from the buffer usage.</param>
+	/// <returns>The allocation. If the ring does not have enough free space even after recycling completed frames, an invalid allocation is returned.</returns>
+	TransientBufferAllocation allocate(pvrvk::DeviceSize size, pvrvk::DeviceSize alignment = 0);
+
+	/// <summary>Flush everything allocated during the current frame. Only required (and only does anything) if the memory is not host coherent.
+	/// All allocations of the frame are flushed with at most two calls (one if the ring did not wrap around during the frame).</summary>
+	void flush();
+
+	/// <summary>Get the buffer all allocations are made from.</summary>
+	/// <returns>The buffer.</returns>
+	const pvrvk::Buffer& getBuffer() const
+	{
+		return _buffer;
+	}
+
+	/// <summary>Get the total size of the ring.</summary>
+	/// <returns>The size of the ring.</returns>
+	pvrvk::DeviceSize getCapacity() const
+	{
+		return _capacity;
+	}
+
+	/// <summary>Get the number of bytes currently in use by frames that have not yet been recycled.</summary>
+	/// <returns>The number of bytes in use.</returns>
+	pvrvk::DeviceSize getUsedSize() const
+	{
+		return _head >= _tail ? _head - _tail : _capacity - _tail + _head;
+	}
+
+	/// <summary>Get the default alignment of allocations.</summary>
+	/// <returns>The default alignment.</returns>
+	pvrvk::DeviceSize getDefaultAlignment() const
+	{
+		return _defaultAlignment;
+	}
+
+	/// <summary>Check whether the memory of the buffer is host coherent, i.e. whether flush is a no-op.</summary>
+	/// <returns>True if the memory is host coherent, otherwise false.</returns>
+	bool isHostCoherent() const
+	{
+		return _nonCoherentAtomSize == 1;
+	}
+
+	/// <summary>Release the buffer. The GPU must not be using any allocations.</summary>
+	void release()
+	{
+		_frames.clear();
+		_buffer.reset();
+		_mappedData = nullptr;
+		_capacity = _head = _tail = _frameBegin = 0;
+		_frameWrapped = false;
+	}
+
+private:
+	struct FrameRecord
+	{
+		uint32_t frameIndex;
+		pvrvk::DeviceSize end; // One past the last byte used by the frame. Everything before it (back to the previous frame's end) belongs to the frame.
+		pvrvk::Fence fence;
+		bool complete;
+		FrameRecord(uint32_t frameIndex, pvrvk::DeviceSize end, const pvrvk::Fence& fence) : frameIndex(frameIndex), end(end), fence(fence), complete(false) {}
+	};
+
+	void recycleCompletedFrames(bool waitForOldest);
+	bool tryAllocate(pvrvk::DeviceSize size, pvrvk::DeviceSize alignment, pvrvk::DeviceSize& outOffset);
+
+	pvrvk::Buffer _buffer;
+	pvrvk::DeviceSize _capacity;
+	pvrvk::DeviceSize _defaultAlignment;
+	pvrvk::DeviceSize _nonCoherentAtomSize;
+	char* _mappedData;
+	pvrvk::DeviceSize _head;
+	pvrvk::DeviceSize _tail;
+	pvrvk::DeviceSize _frameBegin;
+	bool _frameWrapped;
+	std::deque<FrameRecord> _frames;
+};
+} // namespace utils
+} // namespace pvr
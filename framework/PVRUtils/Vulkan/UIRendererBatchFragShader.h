@@ -0,0 +1,604 @@
+#pragma once
+static uint32_t spv_UIRendererBatchFragShader[] = 
+{
+    0x7230203,
+    0x010000,
+    0x080007,
+    0x00004b,
+    00000000,
+    0x020011,
+    0x000001,
+    0x06000b,
+    0x000001,
+    0x4c534c47,
+    0x6474732e,
+    0x3035342e,
+    00000000,
+    0x03000e,
+    00000000,
+    0x000001,
+    0x08000f,
+    0x000004,
+    0x000004,
+    0x6e69616d,
+    00000000,
+    0x000011,
+    0x000024,
+    0x000026,
+    0x030010,
+    0x000004,
+    0x000007,
+    0x030003,
+    0x000001,
+    0x000140,
+    0x040005,
+    0x000004,
+    0x6e69616d,
+    00000000,
+    0x040005,
+    0x000009,
+    0x78655476,
+    00000000,
+    0x050005,
+    0x00000d,
+    0x746e6f66,
+    0x74786554,
+    0x657275,
+    0x050005,
+    0x000011,
+    0x43786574,
+    0x64726f6f,
+    00000000,
+    0x050005,
+    0x000016,
+    0x6574614d,
+    0x6c616972,
+    00000000,
+    0x060006,
+    0x000016,
+    00000000,
+    0x614d7675,
+    0x78697274,
+    00000000,
+    0x060006,
+    0x000016,
+    0x000001,
+    0x43726176,
+    0x726f6c6f,
+    00000000,
+    0x060006,
+    0x000016,
+    0x000002,
+    0x68706c61,
+    0x646f4d61,
+    0x000065,
+    0x030005,
+    0x000018,
+    00000000,
+    0x040005,
+    0x000024,
+    0x6c6f436f,
+    0x00726f,
+    0x050005,
+    0x000026,
+    0x74726576,
+    0x6f437865,
+    0x726f6c,
+    0x050005,
+    0x00003f,
+    0x42475273,
+    0x74754f5f,
+    0x747570,
+    0x030047,
+    0x000009,
+    00000000,
+    0x030047,
+    0x00000d,
+    00000000,
+    0x040047,
+    0x00000d,
+    0x000022,
+    00000000,
+    0x040047,
+    0x00000d,
+    0x000021,
+    00000000,
+    0x030047,
+    0x00000e,
+    00000000,
+    0x030047,
+    0x000011,
+    00000000,
+    0x040047,
+    0x000011,
+    0x00001e,
+    00000000,
+    0x030047,
+    0x000012,
+    00000000,
+    0x030047,
+    0x000013,
+    00000000,
+    0x040048,
+    0x000016,
+    00000000,
+    0x000005,
+    0x050048,
+    0x000016,
+    00000000,
+    0x000023,
+    00000000,
+    0x050048,
+    0x000016,
+    00000000,
+    0x000007,
+    0x000010,
+    0x040048,
+    0x000016,
+    0x000001,
+    00000000,
+    0x050048,
+    0x000016,
+    0x000001,
+    0x000023,
+    0x000040,
+    0x050048,
+    0x000016,
+    0x000002,
+    0x000023,
+    0x000050,
+    0x030047,
+    0x000016,
+    0x000002,
+    0x040047,
+    0x000018,
+    0x000022,
+    0x000002,
+    0x040047,
+    0x000018,
+    0x000021,
+    00000000,
+    0x030047,
+    0x000024,
+    00000000,
+    0x040047,
+    0x000024,
+    0x00001e,
+    00000000,
+    0x030047,
+    0x000026,
+    00000000,
+    0x040047,
+    0x000026,
+    0x00001e,
+    0x000001,
+    0x030047,
+    0x000028,
+    00000000,
+    0x030047,
+    0x000029,
+    00000000,
+    0x030047,
+    0x00002d,
+    00000000,
+    0x030047,
+    0x000030,
+    00000000,
+    0x030047,
+    0x000031,
+    00000000,
+    0x030047,
+    0x000032,
+    00000000,
+    0x030047,
+    0x000033,
+    00000000,
+    0x030047,
+    0x000034,
+    00000000,
+    0x030047,
+    0x000035,
+    00000000,
+    0x030047,
+    0x000037,
+    00000000,
+    0x030047,
+    0x000038,
+    00000000,
+    0x030047,
+    0x000039,
+    00000000,
+    0x030047,
+    0x00003a,
+    00000000,
+    0x030047,
+    0x00003b,
+    00000000,
+    0x030047,
+    0x00003c,
+    00000000,
+    0x030047,
+    0x00003d,
+    00000000,
+    0x030047,
+    0x00003e,
+    00000000,
+    0x030047,
+    0x00003f,
+    00000000,
+    0x040047,
+    0x00003f,
+    0x000001,
+    00000000,
+    0x030047,
+    0x000044,
+    00000000,
+    0x030047,
+    0x000045,
+    00000000,
+    0x030047,
+    0x000048,
+    00000000,
+    0x020013,
+    0x000002,
+    0x030021,
+    0x000003,
+    0x000002,
+    0x030016,
+    0x000006,
+    0x000020,
+    0x040017,
+    0x000007,
+    0x000006,
+    0x000004,
+    0x040020,
+    0x000008,
+    0x000007,
+    0x000007,
+    0x090019,
+    0x00000a,
+    0x000006,
+    0x000001,
+    00000000,
+    00000000,
+    00000000,
+    0x000001,
+    00000000,
+    0x03001b,
+    0x00000b,
+    0x00000a,
+    0x040020,
+    0x00000c,
+    00000000,
+    0x00000b,
+    0x04003b,
+    0x00000c,
+    0x00000d,
+    00000000,
+    0x040017,
+    0x00000f,
+    0x000006,
+    0x000002,
+    0x040020,
+    0x000010,
+    0x000001,
+    0x00000f,
+    0x04003b,
+    0x000010,
+    0x000011,
+    0x000001,
+    0x040018,
+    0x000014,
+    0x000007,
+    0x000004,
+    0x040015,
+    0x000015,
+    0x000020,
+    00000000,
+    0x05001e,
+    0x000016,
+    0x000014,
+    0x000007,
+    0x000015,
+    0x040020,
+    0x000017,
+    0x000002,
+    0x000016,
+    0x04003b,
+    0x000017,
+    0x000018,
+    0x000002,
+    0x040015,
+    0x000019,
+    0x000020,
+    0x000001,
+    0x04002b,
+    0x000019,
+    0x00001a,
+    0x000002,
+    0x040020,
+    0x00001b,
+    0x000002,
+    0x000015,
+    0x020014,
+    0x00001e,
+    0x04002b,
+    0x000015,
+    0x00001f,
+    00000000,
+    0x040020,
+    0x000023,
+    0x000003,
+    0x000007,
+    0x04003b,
+    0x000023,
+    0x000024,
+    0x000003,
+    0x040020,
+    0x000025,
+    0x000001,
+    0x000007,
+    0x04003b,
+    0x000025,
+    0x000026,
+    0x000001,
+    0x040017,
+    0x000027,
+    0x000006,
+    0x000003,
+    0x04002b,
+    0x000015,
+    0x00002a,
+    0x000003,
+    0x040020,
+    0x00002b,
+    0x000001,
+    0x000006,
+    0x040020,
+    0x00002e,
+    0x000007,
+    0x000006,
+    0x040032,
+    0x000019,
+    0x00003f,
+    00000000,
+    0x04002b,
+    0x000019,
+    0x000040,
+    00000000,
+    0x060034,
+    0x00001e,
+    0x000041,
+    0x0000aa,
+    0x00003f,
+    0x000040,
+    0x04002b,
+    0x000006,
+    0x000046,
+    0x3ee8ba2f,
+    0x06002c,
+    0x000027,
+    0x000047,
+    0x000046,
+    0x000046,
+    0x000046,
+    0x050036,
+    0x000002,
+    0x000004,
+    00000000,
+    0x000003,
+    0x0200f8,
+    0x000005,
+    0x04003b,
+    0x000008,
+    0x000009,
+    0x000007,
+    0x04003d,
+    0x00000b,
+    0x00000e,
+    0x00000d,
+    0x04003d,
+    0x00000f,
+    0x000012,
+    0x000011,
+    0x050057,
+    0x000007,
+    0x000013,
+    0x00000e,
+    0x000012,
+    0x03003e,
+    0x000009,
+    0x000013,
+    0x050041,
+    0x00001b,
+    0x00001c,
+    0x000018,
+    0x00001a,
+    0x04003d,
+    0x000015,
+    0x00001d,
+    0x00001c,
+    0x0500ab,
+    0x00001e,
+    0x000020,
+    0x00001d,
+    0x00001f,
+    0x0300f7,
+    0x000022,
+    00000000,
+    0x0400fa,
+    0x000020,
+    0x000021,
+    0x000036,
+    0x0200f8,
+    0x000021,
+    0x04003d,
+    0x000007,
+    0x000028,
+    0x000026,
+    0x08004f,
+    0x000027,
+    0x000029,
+    0x000028,
+    0x000028,
+    00000000,
+    0x000001,
+    0x000002,
+    0x050041,
+    0x00002b,
+    0x00002c,
+    0x000026,
+    0x00002a,
+    0x04003d,
+    0x000006,
+    0x00002d,
+    0x00002c,
+    0x050041,
+    0x00002e,
+    0x00002f,
+    0x000009,
+    0x00002a,
+    0x04003d,
+    0x000006,
+    0x000030,
+    0x00002f,
+    0x050085,
+    0x000006,
+    0x000031,
+    0x00002d,
+    0x000030,
+    0x050051,
+    0x000006,
+    0x000032,
+    0x000029,
+    00000000,
+    0x050051,
+    0x000006,
+    0x000033,
+    0x000029,
+    0x000001,
+    0x050051,
+    0x000006,
+    0x000034,
+    0x000029,
+    0x000002,
+    0x070050,
+    0x000007,
+    0x000035,
+    0x000032,
+    0x000033,
+    0x000034,
+    0x000031,
+    0x03003e,
+    0x000024,
+    0x000035,
+    0x0200f9,
+    0x000022,
+    0x0200f8,
+    0x000036,
+    0x04003d,
+    0x000007,
+    0x000037,
+    0x000026,
+    0x04003d,
+    0x000007,
+    0x000038,
+    0x000009,
+    0x050085,
+    0x000007,
+    0x000039,
+    0x000037,
+    0x000038,
+    0x050051,
+    0x000006,
+    0x00003a,
+    0x000039,
+    00000000,
+    0x050051,
+    0x000006,
+    0x00003b,
+    0x000039,
+    0x000001,
+    0x050051,
+    0x000006,
+    0x00003c,
+    0x000039,
+    0x000002,
+    0x050051,
+    0x000006,
+    0x00003d,
+    0x000039,
+    0x000003,
+    0x070050,
+    0x000007,
+    0x00003e,
+    0x00003a,
+    0x00003b,
+    0x00003c,
+    0x00003d,
+    0x03003e,
+    0x000024,
+    0x00003e,
+    0x0200f9,
+    0x000022,
+    0x0200f8,
+    0x000022,
+    0x0300f7,
+    0x000043,
+    00000000,
+    0x0400fa,
+    0x000041,
+    0x000042,
+    0x000043,
+    0x0200f8,
+    0x000042,
+    0x04003d,
+    0x000007,
+    0x000044,
+    0x000024,
+    0x08004f,
+    0x000027,
+    0x000045,
+    0x000044,
+    0x000044,
+    00000000,
+    0x000001,
+    0x000002,
+    0x07000c,
+    0x000027,
+    0x000048,
+    0x000001,
+    0x00001a,
+    0x000045,
+    0x000047,
+    0x04003d,
+    0x000007,
+    0x000049,
+    0x000024,
+    0x09004f,
+    0x000007,
+    0x00004a,
+    0x000049,
+    0x000048,
+    0x000004,
+    0x000005,
+    0x000006,
+    0x000003,
+    0x03003e,
+    0x000024,
+    0x00004a,
+    0x0200f9,
+    0x000043,
+    0x0200f8,
+    0x000043,
+    0x0100fd,
+    0x010038,
+};
+static VkShaderModuleCreateInfo shaderModuleCreateInfo_UIRendererBatchFragShader = 
+{
+    static_cast<VkStructureType>(pvrvk::StructureType::e_SHADER_MODULE_CREATE_INFO),
+    nullptr,
+    VkShaderModuleCreateFlags(0),
+    sizeof(spv_UIRendererBatchFragShader),
+    spv_UIRendererBatchFragShader,
+};
@@ -0,0 +1,319 @@
+#pragma once
+static uint32_t spv_UIRendererBatchVertShader[] = 
+{
+    0x7230203,
+    0x010000,
+    0x080007,
+    0x000023,
+    00000000,
+    0x020011,
+    0x000001,
+    0x06000b,
+    0x000001,
+    0x4c534c47,
+    0x6474732e,
+    0x3035342e,
+    00000000,
+    0x03000e,
+    00000000,
+    0x000001,
+    0x0b000f,
+    00000000,
+    0x000004,
+    0x6e69616d,
+    00000000,
+    0x00000a,
+    0x000015,
+    0x00001c,
+    0x00001e,
+    0x000020,
+    0x000021,
+    0x030003,
+    0x000001,
+    0x000140,
+    0x040005,
+    0x000004,
+    0x6e69616d,
+    00000000,
+    0x060005,
+    0x000008,
+    0x505f6c67,
+    0x65567265,
+    0x78657472,
+    00000000,
+    0x060006,
+    0x000008,
+    00000000,
+    0x505f6c67,
+    0x7469736f,
+    0x6e6f69,
+    0x070006,
+    0x000008,
+    0x000001,
+    0x505f6c67,
+    0x746e696f,
+    0x657a6953,
+    00000000,
+    0x030005,
+    0x00000a,
+    00000000,
+    0x030005,
+    0x00000e,
+    0x50564d,
+    0x060006,
+    0x00000e,
+    00000000,
+    0x564d796d,
+    0x74614d50,
+    0x786972,
+    0x030005,
+    0x000010,
+    00000000,
+    0x050005,
+    0x000015,
+    0x6556796d,
+    0x78657472,
+    00000000,
+    0x050005,
+    0x00001c,
+    0x43786574,
+    0x64726f6f,
+    00000000,
+    0x040005,
+    0x00001e,
+    0x5655796d,
+    00000000,
+    0x050005,
+    0x000020,
+    0x74726576,
+    0x6f437865,
+    0x726f6c,
+    0x040005,
+    0x000021,
+    0x6f43796d,
+    0x726f6c,
+    0x050048,
+    0x000008,
+    00000000,
+    0x00000b,
+    00000000,
+    0x050048,
+    0x000008,
+    0x000001,
+    0x00000b,
+    0x000001,
+    0x030047,
+    0x000008,
+    0x000002,
+    0x040048,
+    0x00000e,
+    00000000,
+    0x000005,
+    0x050048,
+    0x00000e,
+    00000000,
+    0x000023,
+    00000000,
+    0x050048,
+    0x00000e,
+    00000000,
+    0x000007,
+    0x000010,
+    0x030047,
+    0x00000e,
+    0x000002,
+    0x040047,
+    0x000010,
+    0x000022,
+    0x000001,
+    0x040047,
+    0x000010,
+    0x000021,
+    00000000,
+    0x040047,
+    0x000015,
+    0x00001e,
+    00000000,
+    0x030047,
+    0x00001c,
+    00000000,
+    0x040047,
+    0x00001c,
+    0x00001e,
+    00000000,
+    0x030047,
+    0x00001e,
+    00000000,
+    0x040047,
+    0x00001e,
+    0x00001e,
+    0x000001,
+    0x030047,
+    0x00001f,
+    00000000,
+    0x030047,
+    0x000020,
+    00000000,
+    0x040047,
+    0x000020,
+    0x00001e,
+    0x000001,
+    0x030047,
+    0x000021,
+    00000000,
+    0x040047,
+    0x000021,
+    0x00001e,
+    0x000002,
+    0x030047,
+    0x000022,
+    00000000,
+    0x020013,
+    0x000002,
+    0x030021,
+    0x000003,
+    0x000002,
+    0x030016,
+    0x000006,
+    0x000020,
+    0x040017,
+    0x000007,
+    0x000006,
+    0x000004,
+    0x04001e,
+    0x000008,
+    0x000007,
+    0x000006,
+    0x040020,
+    0x000009,
+    0x000003,
+    0x000008,
+    0x04003b,
+    0x000009,
+    0x00000a,
+    0x000003,
+    0x040015,
+    0x00000b,
+    0x000020,
+    0x000001,
+    0x04002b,
+    0x00000b,
+    0x00000c,
+    00000000,
+    0x040018,
+    0x00000d,
+    0x000007,
+    0x000004,
+    0x03001e,
+    0x00000e,
+    0x00000d,
+    0x040020,
+    0x00000f,
+    0x000002,
+    0x00000e,
+    0x04003b,
+    0x00000f,
+    0x000010,
+    0x000002,
+    0x040020,
+    0x000011,
+    0x000002,
+    0x00000d,
+    0x040020,
+    0x000014,
+    0x000001,
+    0x000007,
+    0x04003b,
+    0x000014,
+    0x000015,
+    0x000001,
+    0x040020,
+    0x000018,
+    0x000003,
+    0x000007,
+    0x040017,
+    0x00001a,
+    0x000006,
+    0x000002,
+    0x040020,
+    0x00001b,
+    0x000003,
+    0x00001a,
+    0x04003b,
+    0x00001b,
+    0x00001c,
+    0x000003,
+    0x040020,
+    0x00001d,
+    0x000001,
+    0x00001a,
+    0x04003b,
+    0x00001d,
+    0x00001e,
+    0x000001,
+    0x04003b,
+    0x000018,
+    0x000020,
+    0x000003,
+    0x04003b,
+    0x000014,
+    0x000021,
+    0x000001,
+    0x050036,
+    0x000002,
+    0x000004,
+    00000000,
+    0x000003,
+    0x0200f8,
+    0x000005,
+    0x050041,
+    0x000011,
+    0x000012,
+    0x000010,
+    0x00000c,
+    0x04003d,
+    0x00000d,
+    0x000013,
+    0x000012,
+    0x04003d,
+    0x000007,
+    0x000016,
+    0x000015,
+    0x050091,
+    0x000007,
+    0x000017,
+    0x000013,
+    0x000016,
+    0x050041,
+    0x000018,
+    0x000019,
+    0x00000a,
+    0x00000c,
+    0x03003e,
+    0x000019,
+    0x000017,
+    0x04003d,
+    0x00001a,
+    0x00001f,
+    0x00001e,
+    0x03003e,
+    0x00001c,
+    0x00001f,
+    0x04003d,
+    0x000007,
+    0x000022,
+    0x000021,
+    0x03003e,
+    0x000020,
+    0x000022,
+    0x0100fd,
+    0x010038,
+};
+static VkShaderModuleCreateInfo shaderModuleCreateInfo_UIRendererBatchVertShader = 
+{
+    static_cast<VkStructureType>(pvrvk::StructureType::e_SHADER_MODULE_CREATE_INFO),
+    nullptr,
+    VkShaderModuleCreateFlags(0),
+    sizeof(spv_UIRendererBatchVertShader),
+    spv_UIRendererBatchVertShader,
+};
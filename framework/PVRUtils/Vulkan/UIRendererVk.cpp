@@ -16,6 +16,8 @@
 #include "PVRUtils/PowerVRLogo.h"
 #include "PVRUtils/Vulkan/UIRendererVertShader.h"
 #include "PVRUtils/Vulkan/UIRendererFragShader.h"
+#include "PVRUtils/Vulkan/UIRendererBatchVertShader.h"
+#include "PVRUtils/Vulkan/UIRendererBatchFragShader.h"
 #include "PVRUtils/Vulkan/HelperVk.h"
 using std::map;
 using std::vector;
@@ -38,6 +40,14 @@ enum class UboDescSetBindingId
 	MVP,
 	Material
 };
+
+// Compile-time equivalent of the material ubo layout, used to write the materials of the batches
+typedef utils::StructuredMemoryLayout<utils::StructuredMemoryMember<glm::mat4>, utils::StructuredMemoryMember<glm::vec4>, utils::StructuredMemoryMember<int32_t>> MaterialLayout;
+
+bool boundsOverlap(const glm::vec2& minA, const glm::vec2& maxA, const glm::vec2& minB, const glm::vec2& maxB)
+{
+	return minA.x < maxB.x && minB.x < maxA.x && minA.y < maxB.y && minB.y < maxA.y;
+}
 } // namespace
 void UIRenderer::init_CreatePipeline(bool isFrameBufferSrgb)
 {
@@ -92,6 +102,26 @@ void UIRenderer::init_CreatePipeline(bool isFrameBufferSrgb)
 	_pipeline->setObjectName("PVRUtilsVk::UIRenderer::UI GraphicsPipeline");
 }
 
+void UIRenderer::init_CreateBatchPipeline()
+{
+	debug_assertion(_pipeline.isValid(), "UIRenderer: The batch pipeline is derived from the UI pipeline, which must be created first");
+	// Same state as the UI pipeline, except that the colour of each sprite is read from the vertex stream instead of the material
+	GraphicsPipelineCreateInfo pipelineDesc = _pipeline->getCreateInfo();
+	pipelineDesc.vertexShader.setShader(
+		_device->createShaderModule(ShaderModuleCreateInfo(BufferStream("", spv_UIRendererBatchVertShader, sizeof(spv_UIRendererBatchVertShader)).readToEnd<uint32_t>())));
+	pipelineDesc.fragmentShader.setShader(
+		_device->createShaderModule(ShaderModuleCreateInfo(BufferStream("", spv_UIRendererBatchFragShader, sizeof(spv_UIRendererBatchFragShader)).readToEnd<uint32_t>())));
+	pipelineDesc.vertexInput.clear();
+	pipelineDesc.vertexInput.addInputBinding(VertexInputBindingDescription(0, sizeof(BatchVertex), pvrvk::VertexInputRate::e_VERTEX))
+		.addInputAttribute(VertexInputAttributeDescription(0, 0, pvrvk::Format::e_R32G32B32A32_SFLOAT, static_cast<uint32_t>(offsetof(BatchVertex, position))))
+		.addInputAttribute(VertexInputAttributeDescription(1, 0, pvrvk::Format::e_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(BatchVertex, uv))))
+		.addInputAttribute(VertexInputAttributeDescription(2, 0, pvrvk::Format::e_R32G32B32A32_SFLOAT, static_cast<uint32_t>(offsetof(BatchVertex, color))));
+	pipelineDesc.flags = pvrvk::PipelineCreateFlags::e_DERIVATIVE_BIT;
+	pipelineDesc.basePipeline = _pipeline;
+	_batchPipeline = _device->createGraphicsPipeline(pipelineDesc, _pipelineCache);
+	_batchPipeline->setObjectName("PVRUtilsVk::UIRenderer::UI Batch GraphicsPipeline");
+}
+
 void UIRenderer::init_CreateDescriptorSetLayout()
 {
 	assertion(_device.isValid(), "NULL GRAPHICS CONTEXT");
@@ -250,6 +280,10 @@ void UIRenderer::init(uint32_t width, uint32_t height, bool fullscreen, const Re
 
 	init_CreatePipeline(isFrameBufferSrgb);
 	setUpUboPools(maxNumInstances, maxNumSprites);
+	{
+		pvrvk::Device device = getDevice()->getReference();
+		_textArena.init(device);
+	}
 	init_CreateDefaultSampler();
 
 	if (createDefaultLogo)
@@ -355,31 +389,11 @@ void UIRenderer::init_CreateDefaultTitle()
 		_defaultTitle = createText(createTextElement("DefaultTitle", _defaultFont, 256));
 		_defaultTitle->setAnchor(Anchor::TopLeft, glm::vec2(-.98f, .98f))->setScale(glm::vec2(.8, .8));
 		_defaultTitle->commitUpdates();
-		// set object names
-		if (_defaultTitle->getTextElement()->_vbo->getVkHandle() != VK_NULL_HANDLE)
-		{
-			_defaultTitle->getTextElement()->_vbo->setObjectName("PVRUtilsVk::UIRenderer::Default Title Vbo");
-		}
-
-		if (_defaultTitle->getTextElement()->_drawIndirectBuffer->getVkHandle() != VK_NULL_HANDLE)
-		{
-			_defaultTitle->getTextElement()->_drawIndirectBuffer->setObjectName("PVRUtilsVk::UIRenderer::Default Title Draw Indirect Buffer");
-		}
 	}
 
 	// Default Description
 	{
 		_defaultDescription = createText(createTextElement("", _defaultFont, 256));
-		// set object names
-		if (_defaultDescription->getTextElement()->_vbo->getVkHandle() != VK_NULL_HANDLE)
-		{
-			_defaultDescription->getTextElement()->_vbo->setObjectName("PVRUtilsVk::UIRenderer::Default Description Vbo");
-		}
-
-		if (_defaultDescription->getTextElement()->_drawIndirectBuffer->getVkHandle() != VK_NULL_HANDLE)
-		{
-			_defaultDescription->getTextElement()->_drawIndirectBuffer->setObjectName("PVRUtilsVk::UIRenderer::Default Description Draw Indirect Buffer");
-		}
 		_defaultDescription->setAnchor(Anchor::TopLeft, glm::vec2(-.98f, .98f - _defaultTitle->getFont()->getFontLineSpacing() / static_cast<float>(getRenderingDimY()) * 1.5f))
 			->setScale(glm::vec2(.60, .60));
 		_defaultDescription->commitUpdates();
@@ -388,16 +402,6 @@ void UIRenderer::init_CreateDefaultTitle()
 	// Default Controls
 	{
 		_defaultControls = createText(createTextElement("", _defaultFont, 256));
-		// set object names
-		if (_defaultControls->getTextElement()->_vbo->getVkHandle() != VK_NULL_HANDLE)
-		{
-			_defaultControls->getTextElement()->_vbo->setObjectName("PVRUtilsVk::UIRenderer::Default Controls Vbo");
-		}
-
-		if (_defaultControls->getTextElement()->_drawIndirectBuffer->getVkHandle() != VK_NULL_HANDLE)
-		{
-			_defaultControls->getTextElement()->_drawIndirectBuffer->setObjectName("PVRUtilsVk::UIRenderer::Default Controls Draw Indirect Buffer");
-		}
 		_defaultControls->setAnchor(Anchor::BottomLeft, glm::vec2(-.98f, -.98f))->setScale(glm::vec2(.5, .5));
 		_defaultControls->commitUpdates();
 	}
@@ -528,6 +532,328 @@ void UIRenderer::UboMvp::updateMvp(uint32_t bufferArrayId, const glm::mat4x4& mv
 		_buffer->getDeviceMemory()->flushRange(_structuredBufferView.getDynamicSliceOffset(bufferArrayId), _structuredBufferView.getDynamicSliceSize());
 	}
 }
+
+void UIRenderer::enableBatching(pvrvk::DeviceSize ringSize)
+{
+	debug_assertion(_device.isValid(), "UIRenderer: Batching must be enabled after the UIRenderer has been initialised");
+	Device device = getDevice()->getReference();
+	if (!_batchPipeline.isValid())
+	{
+		init_CreateBatchPipeline();
+	}
+	// The ring holds both the vertex streams and the materials of the batches, which are bound using dynamic offsets
+	_batchAllocator.init(device, _vmaAllocator, ringSize, pvrvk::BufferUsageFlags::e_VERTEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_UNIFORM_BUFFER_BIT);
+	pvrvk::Buffer batchBuffer = _batchAllocator.getBuffer();
+	batchBuffer->setObjectName("PVRUtilsVk::UIRenderer::Batch Ring Buffer");
+
+	if (!_batchMvpDescSet.isValid())
+	{
+		_batchMvpDescSet = _descPool->allocateDescriptorSet(_uboMvpDescLayout);
+		_batchMvpDescSet->setObjectName("PVRUtilsVk::UIRenderer::Batch Mvp DescriptorSet");
+		_batchMaterialDescSet = _descPool->allocateDescriptorSet(_uboMaterialLayout);
+		_batchMaterialDescSet->setObjectName("PVRUtilsVk::UIRenderer::Batch Material DescriptorSet");
+	}
+	WriteDescriptorSet writeDescSets[2] = { WriteDescriptorSet(pvrvk::DescriptorType::e_UNIFORM_BUFFER_DYNAMIC, _batchMvpDescSet, 0, 0),
+		WriteDescriptorSet(pvrvk::DescriptorType::e_UNIFORM_BUFFER_DYNAMIC, _batchMaterialDescSet, 0, 0) };
+	writeDescSets[0].setBufferInfo(0, DescriptorBufferInfo(batchBuffer, 0, _uboMvp._structuredBufferView.getDynamicSliceSize()));
+	writeDescSets[1].setBufferInfo(0, DescriptorBufferInfo(batchBuffer, 0, _uboMaterial._structuredBufferView.getDynamicSliceSize()));
+	device->updateDescriptorSets(writeDescSets, ARRAY_SIZE(writeDescSets), nullptr, 0);
+	_numBatches = 0;
+}
+
+void UIRenderer::addToBatch(const pvrvk::DescriptorSet& texDescSet, const pvrvk::ImageView& imageView, const pvrvk::Sampler& sampler, const glm::vec4& color,
+	int32_t alphaMode, const glm::mat4& mvp, const impl::Vertex* vertices, uint32_t numQuads)
+{
+	if (!isRendering())
+	{
+		throw UIRendererError("Sprite: Render called without first calling uiRenderer::begin to set up the commandbuffer.");
+	}
+	// Transform the vertices to clip space so that sprites with different transformations can share a draw
+	const uint32_t numVertices = numQuads * 4;
+	_batchVertices.resize(numVertices);
+	glm::vec2 boundsMin(std::numeric_limits<float>::max());
+	glm::vec2 boundsMax(-std::numeric_limits<float>::max());
+	for (uint32_t i = 0; i < numVertices; ++i)
+	{
+		const glm::vec4 position = mvp * glm::vec4(vertices[i].x, vertices[i].y, vertices[i].z, vertices[i].rhw);
+		_batchVertices[i].position = position;
+		_batchVertices[i].uv = glm::vec2(vertices[i].tu, vertices[i].tv);
+		_batchVertices[i].color = color;
+		if (position.w > 0.f)
+		{
+			const glm::vec2 ndc = glm::vec2(position) / position.w;
+			boundsMin = glm::min(boundsMin, ndc);
+			boundsMax = glm::max(boundsMax, ndc);
+		}
+		else
+		{
+			// Cannot be projected, so conservatively assume it covers everything
+			boundsMin = glm::vec2(-std::numeric_limits<float>::max());
+			boundsMax = glm::vec2(std::numeric_limits<float>::max());
+		}
+	}
+
+	// Find the most recent batch with the same state, as long as no batch recorded after it overlaps this sprite
+	SpriteBatch* batch = nullptr;
+	for (uint32_t i = _numBatches; i-- > 0;)
+	{
+		SpriteBatch& candidate = _batches[i];
+		if (candidate.imageView == imageView->getVkHandle() && candidate.sampler == sampler->getVkHandle() && candidate.alphaMode == alphaMode)
+		{
+			batch = &candidate;
+			break;
+		}
+		if (boundsOverlap(candidate.boundsMin, candidate.boundsMax, boundsMin, boundsMax))
+		{
+			break;
+		}
+	}
+
+	if (batch == nullptr)
+	{
+		if (_numBatches == _batches.size())
+		{
+			_batches.emplace_back();
+		}
+		batch = &_batches[_numBatches++];
+		batch->texDescSet = texDescSet;
+		batch->imageView = imageView->getVkHandle();
+		batch->sampler = sampler->getVkHandle();
+		batch->alphaMode = alphaMode;
+		batch->boundsMin = boundsMin;
+		batch->boundsMax = boundsMax;
+		batch->vertices.clear();
+	}
+	else
+	{
+		batch->boundsMin = glm::min(batch->boundsMin, boundsMin);
+		batch->boundsMax = glm::max(batch->boundsMax, boundsMax);
+	}
+	batch->vertices.insert(batch->vertices.end(), _batchVertices.begin(), _batchVertices.end());
+}
+
+void UIRenderer::recordBatches()
+{
+	if (_numBatches == 0)
+	{
+		return;
+	}
+	size_t numVertices = 0;
+	for (uint32_t i = 0; i < _numBatches; ++i)
+	{
+		numVertices += _batches[i].vertices.size();
+	}
+
+	// One mvp (identity, as the vertices are already in clip space) followed by one material per batch
+	const uint64_t mvpSliceSize = _uboMvp._structuredBufferView.getDynamicSliceSize();
+	const uint64_t materialSliceSize = _uboMaterial._structuredBufferView.getDynamicSliceSize();
+	utils::TransientBufferAllocation uboAllocation = _batchAllocator.allocate(mvpSliceSize + materialSliceSize * _numBatches);
+	utils::TransientBufferAllocation vertexAllocation = _batchAllocator.allocate(sizeof(BatchVertex) * numVertices);
+	if (!uboAllocation.isValid() || !vertexAllocation.isValid())
+	{
+		Log(LogLevel::Error, "UIRenderer: Failed to allocate the batched sprites. Consider increasing the size of the batch ring buffer.");
+		_numBatches = 0;
+		return;
+	}
+
+	const glm::mat4 identity(1.f);
+	memcpy(uboAllocation.mappedData, glm::value_ptr(identity), sizeof(identity));
+	utils::StructuredBufferWriter<MaterialLayout> materialWriter(
+		static_cast<char*>(uboAllocation.mappedData) + mvpSliceSize, _device->getPhysicalDevice()->getProperties().getLimits().getMinUniformBufferOffsetAlignment());
+	debug_assertion(materialWriter.getDynamicSliceSize() == materialSliceSize, "UIRenderer: Material layout mismatch");
+
+	BatchVertex* mappedVertices = static_cast<BatchVertex*>(vertexAllocation.mappedData);
+	for (uint32_t i = 0; i < _numBatches; ++i)
+	{
+		materialWriter.setValue<static_cast<uint32_t>(MaterialBufferElement::UVMtx)>(identity, 0, i);
+		materialWriter.setValue<static_cast<uint32_t>(MaterialBufferElement::AlphaMode)>(_batches[i].alphaMode, 0, i);
+		memcpy(mappedVertices, _batches[i].vertices.data(), sizeof(BatchVertex) * _batches[i].vertices.size());
+		mappedVertices += _batches[i].vertices.size();
+	}
+	_batchAllocator.flush();
+
+	CommandBufferBase& commandBuffer = _activeCommandBuffer;
+	debug_assertion(commandBuffer->getRetainObjectReferences(),
+		"UIRenderer: The command buffer must retain its object references to keep the batch ring buffer alive if batching is re-enabled or the UIRenderer is destroyed");
+	commandBuffer->debugMarkerBeginEXT("PVRUtilsVk::UIRenderer::Batches");
+	commandBuffer->bindPipeline(_batchPipeline);
+	commandBuffer->bindVertexBuffer(vertexAllocation.buffer, static_cast<uint32_t>(vertexAllocation.offset), 0);
+	commandBuffer->bindIndexBuffer(getFontIbo(), 0, pvrvk::IndexType::e_UINT16);
+	const uint32_t mvpOffset = static_cast<uint32_t>(uboAllocation.offset);
+	commandBuffer->bindDescriptorSet(PipelineBindPoint::e_GRAPHICS, _pipelineLayout, 1, _batchMvpDescSet, &mvpOffset, 1);
+
+	uint32_t firstVertex = 0;
+	for (uint32_t i = 0; i < _numBatches; ++i)
+	{
+		const SpriteBatch& batch = _batches[i];
+		if (i == 0 || batch.texDescSet != _batches[i - 1].texDescSet)
+		{
+			commandBuffer->bindDescriptorSet(PipelineBindPoint::e_GRAPHICS, _pipelineLayout, 0, batch.texDescSet);
+		}
+		const uint32_t materialOffset = static_cast<uint32_t>(uboAllocation.offset + mvpSliceSize + materialSliceSize * i);
+		commandBuffer->bindDescriptorSet(PipelineBindPoint::e_GRAPHICS, _pipelineLayout, 2, _batchMaterialDescSet, &materialOffset, 1);
+
+		// The font ibo addresses at most MaxRenderableLetters quads, so larger batches are split using the vertex offset
+		const uint32_t numQuads = static_cast<uint32_t>(batch.vertices.size() / 4);
+		for (uint32_t quad = 0; quad < numQuads; quad += impl::Font_::MaxRenderableLetters)
+		{
+			const uint32_t numDrawQuads = std::min<uint32_t>(numQuads - quad, impl::Font_::MaxRenderableLetters);
+			commandBuffer->drawIndexed(0, numDrawQuads * 6, firstVertex + quad * 4);
+		}
+		firstVertex += static_cast<uint32_t>(batch.vertices.size());
+	}
+	commandBuffer->debugMarkerEndEXT();
+	_numBatches = 0;
+}
+
+void UIRenderer::TextVertexArena::init(Device& device)
+{
+	_pages.clear();
+	_device = device;
+	_nonCoherentAtomSize = 1;
+}
+
+impl::TextVertexBlock UIRenderer::TextVertexArena::allocate(uint32_t size, utils::vma::Allocator* allocator)
+{
+	size = align(size, static_cast<uint32_t>(BlockAlignment));
+	impl::TextVertexBlock block;
+	uint32_t pageIndex = 0;
+	uint32_t rangeIndex = 0;
+	// First fit
+	for (; pageIndex < _pages.size(); ++pageIndex)
+	{
+		std::vector<FreeRange>& freeRanges = _pages[pageIndex].freeRanges;
+		for (rangeIndex = 0; rangeIndex < freeRanges.size() && freeRanges[rangeIndex].size < size; ++rangeIndex) {}
+		if (rangeIndex < freeRanges.size())
+		{
+			break;
+		}
+	}
+
+	if (pageIndex == _pages.size())
+	{
+		Page page;
+		page.size = std::max<uint32_t>(PageSize, size);
+		// Prefer host coherent memory, so that no flushes are required at all
+		page.buffer = utils::createBuffer(_device, page.size, pvrvk::BufferUsageFlags::e_VERTEX_BUFFER_BIT | pvrvk::BufferUsageFlags::e_INDIRECT_BUFFER_BIT,
+			pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT, pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT, allocator,
+			pvr::utils::vma::AllocationCreateFlags::e_MAPPED_BIT);
+		if (!page.buffer.isValid())
+		{
+			return block;
+		}
+		page.buffer->setObjectName("PVRUtilsVk::UIRenderer::Text Vertex Arena");
+		page.mappedData = static_cast<char*>(page.buffer->getDeviceMemory()->getMappedData());
+		page.dirtyBegin = page.size;
+		page.dirtyEnd = 0;
+		FreeRange range = { 0, page.size };
+		page.freeRanges.push_back(range);
+		if (static_cast<uint32_t>(page.buffer->getDeviceMemory()->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == 0)
+		{
+			_nonCoherentAtomSize =
+				std::max<pvrvk::DeviceSize>(_nonCoherentAtomSize, _device->getPhysicalDevice()->getProperties().getLimits().getNonCoherentAtomSize());
+		}
+		_pages.push_back(page);
+		rangeIndex = 0;
+	}
+
+	Page& page = _pages[pageIndex];
+	FreeRange& range = page.freeRanges[rangeIndex];
+	block.buffer = page.buffer;
+	block.mappedData = page.mappedData + range.offset;
+	block.page = pageIndex;
+	block.offset = range.offset;
+	block.size = size;
+	range.offset += size;
+	range.size -= size;
+	if (range.size == 0)
+	{
+		page.freeRanges.erase(page.freeRanges.begin() + rangeIndex);
+	}
+	return block;
+}
+
+void UIRenderer::TextVertexArena::free(const impl::TextVertexBlock& block)
+{
+	// Ignore blocks of an arena which has since been reset
+	if (block.size == 0 || block.page >= _pages.size() || _pages[block.page].buffer != block.buffer)
+	{
+		return;
+	}
+	if (!_isTrackingFrames)
+	{
+		// Frames are not being tracked, so there is nothing to wait for
+		release(block);
+		return;
+	}
+	RetiredBlock retired = { block, _frameCount };
+	_retiredBlocks.push_back(retired);
+}
+
+void UIRenderer::TextVertexArena::beginFrame(uint32_t frameIndex)
+{
+	debug_assertion(frameIndex < static_cast<uint32_t>(pvrvk::FrameworkCaps::MaxSwapChains), "UIRenderer: beginFrame frame index out of range");
+	_isTrackingFrames = true;
+	++_frameCount;
+	// Beginning a frame means that the previous use of its index has completed. There are never more frames in flight than swapchain
+	// images, so once that many frames have begun, every frame that was in flight when a block was freed has completed.
+	while (!_retiredBlocks.empty() && _retiredBlocks.front().frame + static_cast<uint32_t>(pvrvk::FrameworkCaps::MaxSwapChains) <= _frameCount)
+	{
+		release(_retiredBlocks.front().block);
+		_retiredBlocks.pop_front();
+	}
+}
+
+void UIRenderer::TextVertexArena::release(const impl::TextVertexBlock& block)
+{
+	std::vector<FreeRange>& freeRanges = _pages[block.page].freeRanges;
+	std::vector<FreeRange>::iterator next = freeRanges.begin();
+	while (next != freeRanges.end() && next->offset < block.offset)
+	{
+		++next;
+	}
+	// Merge with the neighbouring free ranges
+	const bool mergePrevious = next != freeRanges.begin() && (next - 1)->offset + (next - 1)->size == block.offset;
+	const bool mergeNext = next != freeRanges.end() && block.offset + block.size == next->offset;
+	if (mergePrevious && mergeNext)
+	{
+		(next - 1)->size += block.size + next->size;
+		freeRanges.erase(next);
+	}
+	else if (mergePrevious)
+	{
+		(next - 1)->size += block.size;
+	}
+	else if (mergeNext)
+	{
+		next->offset = block.offset;
+		next->size += block.size;
+	}
+	else
+	{
+		FreeRange range = { block.offset, block.size };
+		freeRanges.insert(next, range);
+	}
+}
+
+void UIRenderer::TextVertexArena::flush()
+{
+	if (_nonCoherentAtomSize == 1)
+	{
+		return;
+	}
+	for (Page& page : _pages)
+	{
+		if (page.dirtyEnd > page.dirtyBegin)
+		{
+			const pvrvk::DeviceSize begin = page.dirtyBegin - page.dirtyBegin % _nonCoherentAtomSize;
+			const pvrvk::DeviceSize end = align<pvrvk::DeviceSize>(page.dirtyEnd, _nonCoherentAtomSize);
+			page.buffer->getDeviceMemory()->flushRange(begin, end >= page.size ? VK_WHOLE_SIZE : end - begin);
+			page.dirtyBegin = page.size;
+			page.dirtyEnd = 0;
+		}
+	}
+}
 } // namespace ui
 } // namespace pvr
 //!\endcond
@@ -11,6 +11,7 @@
 #include "PVRVk/RenderPassVk.h"
 #include "PVRVk/ApiObjectsVk.h"
 #include "PVRUtils/Vulkan/MemoryAllocator.h"
+#include "PVRUtils/Vulkan/TransientBufferAllocatorVk.h"
 
 namespace pvr {
 namespace ui {
@@ -97,7 +98,7 @@ public:
 		return _imageVbo;
 	}
 	/// <summary>Constructor. Does not produce a ready-to-use object, use the init function before use.</summary>
-	UIRenderer() : _screenRotation(.0f), _numSprites(0) {}
+	UIRenderer() : _screenRotation(.0f), _numSprites(0), _numBatches(0) {}
 
 	/// <summary>Move Constructor. Does not produce a ready-to-use object, use the init function before use.</summary>
 	/// <param name="rhs">Another UIRenderer to initiialise from.</param>
@@ -105,12 +106,15 @@ public:
 		: _renderpass(std::move(rhs._renderpass)), _subpass(std::move(rhs._subpass)), _programData(std::move(rhs._programData)), _defaultFont(std::move(rhs._defaultFont)),
 		  _sdkLogo(std::move(rhs._sdkLogo)), _defaultTitle(std::move(rhs._defaultTitle)), _defaultDescription(std::move(rhs._defaultDescription)),
 		  _defaultControls(std::move(rhs._defaultControls)), _device(std::move(rhs._device)), _pipelineLayout(std::move(rhs._pipelineLayout)), _pipeline(std::move(rhs._pipeline)),
-		  _texDescLayout(std::move(rhs._texDescLayout)), _uboMvpDescLayout(std::move(rhs._uboMvpDescLayout)), _uboMaterialLayout(std::move(rhs._uboMaterialLayout)),
+		  _batchPipeline(std::move(rhs._batchPipeline)), _texDescLayout(std::move(rhs._texDescLayout)), _uboMvpDescLayout(std::move(rhs._uboMvpDescLayout)), _uboMaterialLayout(std::move(rhs._uboMaterialLayout)),
 		  _samplerBilinear(std::move(rhs._samplerBilinear)), _samplerTrilinear(std::move(rhs._samplerTrilinear)), _descPool(std::move(rhs._descPool)),
 		  _activeCommandBuffer(std::move(rhs._activeCommandBuffer)), _mustEndCommandBuffer(std::move(rhs._mustEndCommandBuffer)), _fontIbo(std::move(rhs._fontIbo)),
 		  _imageVbo(std::move(rhs._imageVbo)), _screenDimensions(std::move(rhs._screenDimensions)), _screenRotation(std::move(rhs._screenRotation)),
 		  _groupId(std::move(rhs._groupId)), _uboMvp(std::move(rhs._uboMvp)), _uboMaterial(std::move(rhs._uboMaterial)), _numSprites(std::move(rhs._numSprites)),
-		  _sprites(std::move(rhs._sprites)), _textElements(std::move(rhs._textElements)), _fonts(std::move(rhs._fonts))
+		  _sprites(std::move(rhs._sprites)), _textElements(std::move(rhs._textElements)), _fonts(std::move(rhs._fonts)), _textArena(std::move(rhs._textArena)),
+		  _batchAllocator(std::move(rhs._batchAllocator)),
+		  _batchMvpDescSet(std::move(rhs._batchMvpDescSet)), _batchMaterialDescSet(std::move(rhs._batchMaterialDescSet)), _batches(std::move(rhs._batches)),
+		  _batchVertices(std::move(rhs._batchVertices)), _numBatches(rhs._numBatches)
 
 	{
 		updateResourceOwnsership();
@@ -136,6 +140,7 @@ public:
 		_device = std::move(rhs._device);
 		_pipelineLayout = std::move(rhs._pipelineLayout);
 		_pipeline = std::move(rhs._pipeline);
+		_batchPipeline = std::move(rhs._batchPipeline);
 		_texDescLayout = std::move(rhs._texDescLayout);
 		_uboMvpDescLayout = std::move(rhs._uboMvpDescLayout);
 		_uboMaterialLayout = std::move(rhs._uboMaterialLayout);
@@ -152,6 +157,13 @@ public:
 		_uboMvp = std::move(rhs._uboMvp);
 		_uboMaterial = std::move(rhs._uboMaterial);
 		_numSprites = std::move(rhs._numSprites);
+		_textArena = std::move(rhs._textArena);
+		_batchAllocator = std::move(rhs._batchAllocator);
+		_batchMvpDescSet = std::move(rhs._batchMvpDescSet);
+		_batchMaterialDescSet = std::move(rhs._batchMaterialDescSet);
+		_batches = std::move(rhs._batches);
+		_batchVertices = std::move(rhs._batchVertices);
+		_numBatches = rhs._numBatches;
 		updateResourceOwnsership();
 		return *this;
 	}
@@ -261,17 +273,40 @@ public:
 		_uboMaterialLayout.reset();
 		_pipelineLayout.reset();
 		_pipeline.reset();
+		_batchPipeline.reset();
 		_samplerBilinear.reset();
 		_samplerTrilinear.reset();
 		_activeCommandBuffer.reset();
 		_fontIbo.reset();
 		_imageVbo.reset();
 
+		_batchAllocator.release();
+		_batchMvpDescSet.reset();
+		_batchMaterialDescSet.reset();
+		_batches.clear();
+		_batchVertices.clear();
+		_numBatches = 0;
+
 		_descPool.reset();
 
+		// Sprites and text elements held by the application may outlive the UIRenderer. Detach them, so that they do not release their buffer
+		// slices and text arena blocks into the destroyed UIRenderer.
+		std::for_each(_sprites.begin(), _sprites.end(), [](SpriteWeakRef& sprite) {
+			if (sprite.isValid())
+			{
+				sprite->setUIRenderer(nullptr);
+			}
+		});
+		std::for_each(_textElements.begin(), _textElements.end(), [](TextElementWeakRef& textElement) {
+			if (textElement.isValid())
+			{
+				textElement->detachFromUIRenderer();
+			}
+		});
 		_sprites.clear();
 		_fonts.clear();
 		_textElements.clear();
+		_textArena.reset();
 		_vmaAllocator.reset();
 		_device.reset();
 
@@ -608,6 +643,10 @@ public:
 	{
 		if (_activeCommandBuffer.isValid())
 		{
+			if (isBatchingEnabled())
+			{
+				recordBatches();
+			}
 			_activeCommandBuffer->debugMarkerEndEXT();
 			if (_mustEndCommandBuffer)
 			{
@@ -626,6 +665,52 @@ public:
 		return _activeCommandBuffer;
 	}
 
+	/// <summary>The default size of the ring buffer used by batching mode.</summary>
+	enum
+	{
+		DefaultBatchRingSize = 1024 * 1024
+	};
+
+	/// <summary>Enable batching mode. In batching mode, rendering a sprite does not record any commands. Instead, the geometry of every
+	/// sprite rendered between beginRendering and endRendering is transformed on the CPU and written into a single transient vertex stream,
+	/// and endRendering records one draw for each batch of sprites sharing the same texture, sampler and alpha mode. The colour of each
+	/// sprite is written into its vertices, so sprites of different colours share a batch. A sprite is merged into an earlier batch only if
+	/// it does not overlap anything rendered in between, so the result is the same as without batching. The batches are drawn with a
+	/// dedicated pipeline derived from the UIRenderer pipeline, so a custom pipeline passed to beginRendering is not used for them.
+	/// As the vertex stream is regenerated every time the sprites are rendered, command buffers recorded in batching mode are only valid
+	/// for a single frame and must be re-recorded every frame. Call beginFrame once per frame before rendering.</summary>
+	/// <param name="ringSize">The size of the ring buffer holding the vertex streams of all frames in flight.</param>
+	void enableBatching(pvrvk::DeviceSize ringSize = DefaultBatchRingSize);
+
+	/// <summary>Disable batching mode and release its ring buffer. Command buffers recorded afterwards render each sprite separately.</summary>
+	void disableBatching()
+	{
+		_batchAllocator.release();
+		_numBatches = 0;
+	}
+
+	/// <summary>Check whether batching mode is enabled.</summary>
+	/// <returns>True if batching mode is enabled, otherwise false.</returns>
+	bool isBatchingEnabled() const
+	{
+		return _batchAllocator.getBuffer().isValid();
+	}
+
+	/// <summary>Begin a new frame. Must be called once per frame, before the first beginRendering of the frame, once the GPU work of the
+	/// previous use of frameIndex has completed. The vertices of destroyed Text elements are only reused once every frame that may have
+	/// been drawing them has begun again, so applications which destroy Text elements while frames are in flight must call it every frame
+	/// (otherwise the vertices are reused immediately). It is required in batching mode.</summary>
+	/// <param name="frameIndex">The index of the frame in flight (typically the swapchain index)</param>
+	/// <param name="frameFence">Optional. The fence which will be signalled when the GPU work of this frame has completed.</param>
+	void beginFrame(uint32_t frameIndex, const pvrvk::Fence& frameFence = pvrvk::Fence())
+	{
+		_textArena.beginFrame(frameIndex);
+		if (isBatchingEnabled())
+		{
+			_batchAllocator.beginFrame(frameIndex, frameFence);
+		}
+	}
+
 	/// <summary>The UIRenderer has a built-in default pvr::ui::Font that can always be used when the UIRenderer is
 	/// initialized. Used throughout the PowerVR SDK Examples.</summary>
 	/// <returns>The default font. Constant overload.</returns>
@@ -830,6 +915,8 @@ private:
 	friend class pvr::ui::impl::Group_;
 	friend class pvr::ui::impl::Sprite_;
 	friend class pvr::ui::impl::Font_;
+	friend class pvr::ui::impl::MatrixGroup_;
+	friend class pvr::ui::impl::TextElement_;
 
 	/// <summary>return the default DescriptorSetLayout. ONLY to be used by the Sprites</summary>
 	/// <returns>const pvrvk::DescriptorSetLayout&</returns>
@@ -945,16 +1032,112 @@ private:
 		std::vector<uint32_t> _freeArrayIds;
 	};
 
+	// Sub-allocates the vertices of all TextElements from a few large, persistently mapped buffers. Writes only record the dirty
+	// range of each page, which is flushed with a single call per page when the updates are committed. Freed blocks may still be
+	// read by frames in flight, so they are only reused once every frame in flight at the time they were freed has begun again.
+	struct TextVertexArena
+	{
+		friend class ::pvr::ui::UIRenderer;
+		TextVertexArena() : _nonCoherentAtomSize(1), _frameCount(0), _isTrackingFrames(false) {}
+
+		enum
+		{
+			PageSize = 256 * 1024,
+			BlockAlignment = 16
+		};
+
+		void init(pvrvk::Device& device);
+		impl::TextVertexBlock allocate(uint32_t size, utils::vma::Allocator* allocator);
+		void free(const impl::TextVertexBlock& block);
+		void flush();
+		void beginFrame(uint32_t frameIndex);
+
+		void markDirty(const impl::TextVertexBlock& block, uint32_t offset, uint32_t size)
+		{
+			if (_nonCoherentAtomSize > 1)
+			{
+				Page& page = _pages[block.page];
+				page.dirtyBegin = std::min(page.dirtyBegin, block.offset + offset);
+				page.dirtyEnd = std::max(page.dirtyEnd, block.offset + offset + size);
+			}
+		}
+
+		void reset()
+		{
+			_pages.clear();
+			_retiredBlocks.clear();
+			_frameCount = 0;
+			_isTrackingFrames = false;
+			_device.reset();
+		}
+
+	private:
+		struct FreeRange
+		{
+			uint32_t offset;
+			uint32_t size;
+		};
+		struct RetiredBlock
+		{
+			impl::TextVertexBlock block;
+			uint64_t frame; // The frame during which the block was freed
+		};
+		struct Page
+		{
+			pvrvk::Buffer buffer;
+			char* mappedData;
+			uint32_t size;
+			uint32_t dirtyBegin;
+			uint32_t dirtyEnd;
+			std::vector<FreeRange> freeRanges; // Sorted by offset, never adjacent
+		};
+		void release(const impl::TextVertexBlock& block);
+
+		pvrvk::DeviceWeakPtr _device;
+		pvrvk::DeviceSize _nonCoherentAtomSize;
+		std::vector<Page> _pages;
+		std::deque<RetiredBlock> _retiredBlocks; // In the order they were freed
+		uint64_t _frameCount;
+		bool _isTrackingFrames; // Set by the first beginFrame
+	};
+
 	UboMvp& getUbo()
 	{
 		return _uboMvp;
 	}
 
+	TextVertexArena& getTextArena()
+	{
+		return _textArena;
+	}
+
 	UboMaterial& getMaterial()
 	{
 		return _uboMaterial;
 	}
 
+	struct BatchVertex
+	{
+		glm::vec4 position; // Clip space
+		glm::vec2 uv;
+		glm::vec4 color;
+	};
+
+	struct SpriteBatch
+	{
+		pvrvk::DescriptorSet texDescSet;
+		VkImageView imageView;
+		VkSampler sampler;
+		int32_t alphaMode;
+		glm::vec2 boundsMin; // Normalised device coordinates
+		glm::vec2 boundsMax;
+		std::vector<BatchVertex> vertices;
+	};
+
+	void addToBatch(const pvrvk::DescriptorSet& texDescSet, const pvrvk::ImageView& imageView, const pvrvk::Sampler& sampler, const glm::vec4& color, int32_t alphaMode,
+		const glm::mat4& mvp, const impl::Vertex* vertices, uint32_t numQuads);
+	void recordBatches();
+
 	void setUpUboPoolLayouts(uint32_t numInstances, uint32_t numSprites);
 	void setUpUboPools(uint32_t numInstances, uint32_t numSprites);
 
@@ -963,6 +1146,7 @@ private:
 	void init_CreateDefaultSampler();
 	void init_CreateDefaultTitle();
 	void init_CreatePipeline(bool isFramebufferSrgb);
+	void init_CreateBatchPipeline();
 	void init_CreateDescriptorSetLayout();
 
 	pvr::utils::vma::Allocator _vmaAllocator;
@@ -982,6 +1166,7 @@ private:
 
 	pvrvk::PipelineLayout _pipelineLayout;
 	pvrvk::GraphicsPipeline _pipeline;
+	pvrvk::GraphicsPipeline _batchPipeline;
 	pvrvk::PipelineCache _pipelineCache;
 	pvrvk::DescriptorSetLayout _texDescLayout;
 	pvrvk::DescriptorSetLayout _uboMvpDescLayout;
@@ -999,6 +1184,13 @@ private:
 	UboMvp _uboMvp;
 	UboMaterial _uboMaterial;
 	uint32_t _numSprites;
+	TextVertexArena _textArena;
+	utils::TransientBufferAllocator _batchAllocator;
+	pvrvk::DescriptorSet _batchMvpDescSet;
+	pvrvk::DescriptorSet _batchMaterialDescSet;
+	std::vector<SpriteBatch> _batches;
+	std::vector<BatchVertex> _batchVertices;
+	uint32_t _numBatches;
 };
 } // namespace ui
 } // namespace pvr
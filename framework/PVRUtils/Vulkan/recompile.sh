@@ -1,5 +1,11 @@
 #!/bin/bash
 ../../../external/spir-v/glslangValidator -V UIRendererVertShader.vsh -o UIRendererVertShader.vsh.spv -S vert
 ../../../external/spir-v/glslangValidator -V UIRendererFragShader.fsh -o UIRendererFragShader.fsh.spv -S frag
+../../../external/spir-v/glslangValidator -V UIRendererBatchVertShader.vsh -o UIRendererBatchVertShader.vsh.spv -S vert
+../../../external/spir-v/glslangValidator -V UIRendererBatchFragShader.fsh -o UIRendererBatchFragShader.fsh.spv -S frag
+../../../external/spir-v/glslangValidator -V IndirectDrawCullerCompShader.csh -o IndirectDrawCullerCompShader.csh.spv -S comp
 ../../../external/spir-v/dumpSpv.sh UIRendererVertShader.vsh.spv UIRendererVertShader
 ../../../external/spir-v/dumpSpv.sh UIRendererFragShader.fsh.spv UIRendererFragShader
+../../../external/spir-v/dumpSpv.sh UIRendererBatchVertShader.vsh.spv UIRendererBatchVertShader
+../../../external/spir-v/dumpSpv.sh UIRendererBatchFragShader.fsh.spv UIRendererBatchFragShader
+../../../external/spir-v/dumpSpv.sh IndirectDrawCullerCompShader.csh.spv IndirectDrawCullerCompShader
@@ -68,8 +68,8 @@ VkBufferMemoryBarrier bufferBarrier(const BufferMemoryBarrier& buffBarrier)
 	barrier.srcAccessMask = static_cast<VkAccessFlags>(buffBarrier.getSrcAccessMask());
 	barrier.dstAccessMask = static_cast<VkAccessFlags>(buffBarrier.getDstAccessMask());
 
-	barrier.dstQueueFamilyIndex = static_cast<uint32_t>(-1);
-	barrier.srcQueueFamilyIndex = static_cast<uint32_t>(-1);
+	barrier.dstQueueFamilyIndex = buffBarrier.getDstQueueFamilyIndex();
+	barrier.srcQueueFamilyIndex = buffBarrier.getSrcQueueFamilyIndex();
 
 	barrier.buffer = buffBarrier.getBuffer()->getVkHandle();
 	barrier.offset = buffBarrier.getOffset();
@@ -162,7 +162,7 @@ void CommandBufferBase_::pipelineBarrier(PipelineStageFlags srcStage, PipelineSt
 
 void CommandBufferBase_::waitForEvent(const Event& event, PipelineStageFlags srcStage, PipelineStageFlags dstStage, const MemoryBarrierSet& barriers)
 {
-	_objectReferences.push_back(event);
+	addObjectReference(event);
 	VkMemoryBarrier mem[16];
 	VkImageMemoryBarrier img[16];
 	VkBufferMemoryBarrier buf[16];
@@ -209,7 +209,7 @@ void CommandBufferBase_::waitForEvents(const Event* events, uint32_t numEvents,
 	ArrayOrVector<VkEvent, 4> vkEvents(numEvents);
 	for (uint32_t i = 0; i < numEvents; ++i)
 	{
-		_objectReferences.push_back(events[i]);
+		addObjectReference(events[i]);
 		vkEvents[i] = events[i]->getVkHandle();
 	}
 
@@ -240,25 +240,24 @@ void CommandBufferBase_::bindDescriptorSets(PipelineBindPoint bindingPoint, cons
 		VkDescriptorSet native_sets[static_cast<uint32_t>(FrameworkCaps::MaxDescriptorSets)] = { VK_NULL_HANDLE };
 		for (uint32_t i = 0; i < numDescriptorSets; ++i)
 		{
-			_objectReferences.push_back(sets[i]);
+			addObjectReference(sets[i]);
 			native_sets[i] = sets[i]->getVkHandle();
 		}
 		_device->getVkBindings().vkCmdBindDescriptorSets(getVkHandle(), static_cast<VkPipelineBindPoint>(bindingPoint), pipelineLayout->getVkHandle(), firstSet, numDescriptorSets,
 			native_sets, numDynamicOffsets, dynamicOffsets);
 	}
-	_objectReferences.push_back(pipelineLayout);
+	addObjectReference(pipelineLayout);
 }
 
 void CommandBufferBase_::bindVertexBuffer(Buffer const* buffers, uint32_t* offsets, uint16_t numBuffers, uint16_t startBinding, uint16_t numBindings)
 {
 	if (numBuffers <= 8)
 	{
-		_objectReferences.push_back(buffers[numBuffers]);
 		VkBuffer buff[8];
 		VkDeviceSize sizes[8];
 		for (uint16_t i = 0; i < numBuffers; ++i)
 		{
-			_objectReferences.push_back(buffers[i]);
+			addObjectReference(buffers[i]);
 			buff[i] = buffers[i]->getVkHandle();
 			sizes[i] = offsets[i];
 		}
@@ -270,7 +269,7 @@ void CommandBufferBase_::bindVertexBuffer(Buffer const* buffers, uint32_t* offse
 		VkDeviceSize* sizes = new VkDeviceSize[numBuffers];
 		for (uint16_t i = 0; i < numBuffers; ++i)
 		{
-			_objectReferences.push_back(buffers[i]);
+			addObjectReference(buffers[i]);
 			buff[i] = buffers[i]->getVkHandle();
 			sizes[i] = offsets[i];
 		}
@@ -313,7 +312,7 @@ void SecondaryCommandBuffer_::begin(const Framebuffer& framebuffer, uint32_t sub
 		throw ErrorValidationFailedEXT("Called CommandBuffer::begin while a recording was already in progress. Call CommandBuffer::end first");
 	}
 	reset(CommandBufferResetFlags(0));
-	_objectReferences.push_back(framebuffer);
+	addObjectReference(framebuffer);
 	_isRecording = true;
 	VkCommandBufferBeginInfo info = {};
 	VkCommandBufferInheritanceInfo inheritanceInfo = {};
@@ -336,7 +335,7 @@ void SecondaryCommandBuffer_::begin(const RenderPass& renderPass, uint32_t subpa
 									   " in progress. Call CommandBuffer::end first");
 	}
 	reset(CommandBufferResetFlags(0));
-	_objectReferences.push_back(renderPass);
+	addObjectReference(renderPass);
 	_isRecording = true;
 	VkCommandBufferBeginInfo info = {};
 	VkCommandBufferInheritanceInfo inheritInfo = {};
@@ -378,7 +377,7 @@ void CommandBuffer_::executeCommands(const SecondaryCommandBuffer& secondaryCmdB
 	{
 		throw ErrorValidationFailedEXT("Secondary command buffer was NULL for ExecuteCommands");
 	}
-	_objectReferences.push_back(secondaryCmdBuffer);
+	addObjectReference(secondaryCmdBuffer);
 
 	_device->getVkBindings().vkCmdExecuteCommands(getVkHandle(), 1, &secondaryCmdBuffer->getVkHandle());
 }
@@ -388,7 +387,7 @@ void CommandBuffer_::executeCommands(const SecondaryCommandBuffer* secondaryCmdB
 	ArrayOrVector<VkCommandBuffer, 16> cmdBuffs(numCommandBuffers);
 	for (uint32_t i = 0; i < numCommandBuffers; ++i)
 	{
-		_objectReferences.push_back(secondaryCmdBuffers[i]);
+		addObjectReference(secondaryCmdBuffers[i]);
 		cmdBuffs[i] = secondaryCmdBuffers[i]->getVkHandle();
 	}
 
@@ -399,8 +398,8 @@ void CommandBuffer_::executeCommands(const SecondaryCommandBuffer* secondaryCmdB
 void CommandBuffer_::beginRenderPass(
 	const Framebuffer& framebuffer, const RenderPass& renderPass, const Rect2D& renderArea, bool inlineFirstSubpass, const ClearValue* clearValues, uint32_t numClearValues)
 {
-	_objectReferences.push_back(framebuffer);
-	_objectReferences.push_back(renderPass);
+	addObjectReference(framebuffer);
+	addObjectReference(renderPass);
 	VkRenderPassBeginInfo nfo = {};
 	nfo.sType = static_cast<VkStructureType>(StructureType::e_RENDER_PASS_BEGIN_INFO);
 	nfo.pClearValues = (VkClearValue*)clearValues;
@@ -427,20 +426,20 @@ void CommandBuffer_::beginRenderPass(const Framebuffer& framebuffer, bool inline
 // buffers, textures, images, push constants
 void CommandBufferBase_::updateBuffer(const Buffer& buffer, const void* data, uint32_t offset, uint32_t length)
 {
-	_objectReferences.push_back(buffer);
+	addObjectReference(buffer);
 	_device->getVkBindings().vkCmdUpdateBuffer(getVkHandle(), buffer->getVkHandle(), offset, length, (const uint32_t*)data);
 }
 
 void CommandBufferBase_::pushConstants(const PipelineLayout& pipelineLayout, ShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* data)
 {
-	_objectReferences.push_back(pipelineLayout);
+	addObjectReference(pipelineLayout);
 	_device->getVkBindings().vkCmdPushConstants(getVkHandle(), pipelineLayout->getVkHandle(), static_cast<VkShaderStageFlags>(stageFlags), offset, size, data);
 }
 
 void CommandBufferBase_::resolveImage(const Image& srcImage, const Image& dstImage, const ImageResolve* regions, uint32_t numRegions, ImageLayout srcLayout, ImageLayout dstLayout)
 {
-	_objectReferences.push_back(srcImage);
-	_objectReferences.push_back(dstImage);
+	addObjectReference(srcImage);
+	addObjectReference(dstImage);
 	assert(sizeof(ImageResolve) == sizeof(VkImageResolve));
 	_device->getVkBindings().vkCmdResolveImage(getVkHandle(), srcImage->getVkHandle(), static_cast<VkImageLayout>(srcLayout), dstImage->getVkHandle(),
 		static_cast<VkImageLayout>(dstLayout), numRegions, (const VkImageResolve*)(regions));
@@ -448,8 +447,8 @@ void CommandBufferBase_::resolveImage(const Image& srcImage, const Image& dstIma
 
 void CommandBufferBase_::blitImage(const Image& src, const Image& dst, const ImageBlit* regions, uint32_t numRegions, Filter filter, ImageLayout srcLayout, ImageLayout dstLayout)
 {
-	_objectReferences.push_back(src);
-	_objectReferences.push_back(dst);
+	addObjectReference(src);
+	addObjectReference(dst);
 	ArrayOrVector<VkImageBlit, 8> imageBlits(numRegions);
 	for (uint32_t i = 0; i < numRegions; ++i)
 	{
@@ -462,8 +461,8 @@ void CommandBufferBase_::blitImage(const Image& src, const Image& dst, const Ima
 
 void CommandBufferBase_::copyImage(const Image& srcImage, const Image& dstImage, ImageLayout srcImageLayout, ImageLayout dstImageLayout, uint32_t numRegions, const ImageCopy* regions)
 {
-	_objectReferences.push_back(srcImage);
-	_objectReferences.push_back(dstImage);
+	addObjectReference(srcImage);
+	addObjectReference(dstImage);
 	// Try to avoid heap allocation
 	ArrayOrVector<VkImageCopy, 8> pRegions(numRegions);
 
@@ -478,8 +477,8 @@ void CommandBufferBase_::copyImage(const Image& srcImage, const Image& dstImage,
 
 void CommandBufferBase_::copyImageToBuffer(const Image& srcImage, ImageLayout srcImageLayout, Buffer& dstBuffer, const BufferImageCopy* regions, uint32_t numRegions)
 {
-	_objectReferences.push_back(srcImage);
-	_objectReferences.push_back(dstBuffer);
+	addObjectReference(srcImage);
+	addObjectReference(dstBuffer);
 
 	ArrayOrVector<VkBufferImageCopy, 8> pRegions(numRegions);
 	// Try to avoid heap allocation
@@ -495,15 +494,15 @@ void CommandBufferBase_::copyImageToBuffer(const Image& srcImage, ImageLayout sr
 
 void CommandBufferBase_::copyBuffer(const Buffer& srcBuffer, const Buffer& dstBuffer, uint32_t numRegions, const BufferCopy* regions)
 {
-	_objectReferences.push_back(srcBuffer);
-	_objectReferences.push_back(dstBuffer);
+	addObjectReference(srcBuffer);
+	addObjectReference(dstBuffer);
 	_device->getVkBindings().vkCmdCopyBuffer(getVkHandle(), srcBuffer->getVkHandle(), dstBuffer->getVkHandle(), numRegions, (const VkBufferCopy*)regions);
 }
 void CommandBufferBase_::copyBufferToImage(const Buffer& buffer, const Image& image, ImageLayout dstImageLayout, uint32_t regionsCount, const BufferImageCopy* regions)
 {
 	ArrayOrVector<VkBufferImageCopy, 8> bufferImageCopy(regionsCount);
-	_objectReferences.push_back(buffer);
-	_objectReferences.push_back(image);
+	addObjectReference(buffer);
+	addObjectReference(image);
 	for (uint32_t i = 0; i < regionsCount; ++i)
 	{
 		bufferImageCopy[i] = regions[i].get();
@@ -514,7 +513,7 @@ void CommandBufferBase_::copyBufferToImage(const Buffer& buffer, const Image& im
 
 void CommandBufferBase_::fillBuffer(const Buffer& dstBuffer, uint32_t dstOffset, uint32_t data, uint64_t size)
 {
-	_objectReferences.push_back(dstBuffer);
+	addObjectReference(dstBuffer);
 	_device->getVkBindings().vkCmdFillBuffer(getVkHandle(), dstBuffer->getVkHandle(), dstOffset, size, data);
 }
 
@@ -588,14 +587,14 @@ inline void clearcolorimage(const DeviceWeakPtr& device, VkCommandBuffer buffer,
 void CommandBufferBase_::clearColorImage(const ImageView& image, const ClearColorValue& clearColor, ImageLayout currentLayout, const uint32_t baseMipLevel,
 	const uint32_t numLevels, const uint32_t baseArrayLayer, const uint32_t numLayers)
 {
-	_objectReferences.push_back(image);
+	addObjectReference(image);
 	clearcolorimage(_device, getVkHandle(), image, clearColor, &baseMipLevel, &numLevels, &baseArrayLayer, &numLayers, 1u, currentLayout);
 }
 
 void CommandBufferBase_::clearColorImage(const ImageView& image, const ClearColorValue& clearColor, ImageLayout layout, const uint32_t* baseMipLevel, const uint32_t* numLevels,
 	const uint32_t* baseArrayLayers, const uint32_t* numLayers, uint32_t numRanges)
 {
-	_objectReferences.push_back(image);
+	addObjectReference(image);
 
 	clearcolorimage(_device, getVkHandle(), image, clearColor, baseMipLevel, numLevels, baseArrayLayers, numLayers, numRanges, layout);
 }
@@ -630,21 +629,21 @@ inline static void clearDepthStencilImageHelper(const DeviceWeakPtr& device, VkC
 void CommandBufferBase_::clearDepthImage(
 	const Image& image, float clearDepth, const uint32_t baseMipLevel, const uint32_t numLevels, const uint32_t baseArrayLayer, const uint32_t numLayers, ImageLayout layout)
 {
-	_objectReferences.push_back(image);
+	addObjectReference(image);
 	clearDepthStencilImageHelper(_device, getVkHandle(), image, layout, ImageAspectFlags::e_DEPTH_BIT, clearDepth, 0u, &baseMipLevel, &numLevels, &baseArrayLayer, &numLayers, 1u);
 }
 
 void CommandBufferBase_::clearDepthImage(const Image& image, float clearDepth, const uint32_t* baseMipLevel, const uint32_t* numLevels, const uint32_t* baseArrayLayers,
 	const uint32_t* numLayers, uint32_t numRanges, ImageLayout layout)
 {
-	_objectReferences.push_back(image);
+	addObjectReference(image);
 	clearDepthStencilImageHelper(_device, getVkHandle(), image, layout, ImageAspectFlags::e_DEPTH_BIT, clearDepth, 0u, baseMipLevel, numLevels, baseArrayLayers, numLayers, numRanges);
 }
 
 void CommandBufferBase_::clearStencilImage(
 	const Image& image, uint32_t clearStencil, const uint32_t baseMipLevel, const uint32_t numLevels, const uint32_t baseArrayLayer, const uint32_t numLayers, ImageLayout layout)
 {
-	_objectReferences.push_back(image);
+	addObjectReference(image);
 	clearDepthStencilImageHelper(
 		_device, getVkHandle(), image, layout, ImageAspectFlags::e_STENCIL_BIT, 0.0f, clearStencil, &baseMipLevel, &numLevels, &baseArrayLayer, &numLayers, 1u);
 }
@@ -652,7 +651,7 @@ void CommandBufferBase_::clearStencilImage(
 void CommandBufferBase_::clearStencilImage(const Image& image, uint32_t clearStencil, const uint32_t* baseMipLevel, const uint32_t* numLevels, const uint32_t* baseArrayLayers,
 	const uint32_t* numLayers, uint32_t numRanges, ImageLayout layout)
 {
-	_objectReferences.push_back(image);
+	addObjectReference(image);
 	clearDepthStencilImageHelper(
 		_device, getVkHandle(), image, layout, ImageAspectFlags::e_STENCIL_BIT, 0.0f, clearStencil, baseMipLevel, numLevels, baseArrayLayers, numLayers, numRanges);
 }
@@ -660,7 +659,7 @@ void CommandBufferBase_::clearStencilImage(const Image& image, uint32_t clearSte
 void CommandBufferBase_::clearDepthStencilImage(const Image& image, float clearDepth, uint32_t clearStencil, const uint32_t baseMipLevel, const uint32_t numLevels,
 	const uint32_t baseArrayLayer, const uint32_t numLayers, ImageLayout layout)
 {
-	_objectReferences.push_back(image);
+	addObjectReference(image);
 	clearDepthStencilImageHelper(_device, getVkHandle(), image, layout, ImageAspectFlags::e_DEPTH_BIT | ImageAspectFlags::e_STENCIL_BIT, clearDepth, clearStencil, &baseMipLevel,
 		&numLevels, &baseArrayLayer, &numLayers, 1u);
 }
@@ -668,7 +667,7 @@ void CommandBufferBase_::clearDepthStencilImage(const Image& image, float clearD
 void CommandBufferBase_::clearDepthStencilImage(const Image& image, float clearDepth, uint32_t clearStencil, const uint32_t* baseMipLevel, const uint32_t* numLevels,
 	const uint32_t* baseArrayLayers, const uint32_t* numLayers, uint32_t numRanges, ImageLayout layout)
 {
-	_objectReferences.push_back(image);
+	addObjectReference(image);
 	clearDepthStencilImageHelper(_device, getVkHandle(), image, layout, ImageAspectFlags::e_DEPTH_BIT | ImageAspectFlags::e_STENCIL_BIT, clearDepth, clearStencil, baseMipLevel,
 		numLevels, baseArrayLayers, numLayers, numRanges);
 }
@@ -709,13 +708,13 @@ void CommandBufferBase_::draw(uint32_t firstVertex, uint32_t numVertices, uint32
 
 void CommandBufferBase_::drawIndexedIndirect(const Buffer& buffer, uint32_t offset, uint32_t count, uint32_t stride)
 {
-	_objectReferences.push_back(buffer);
+	addObjectReference(buffer);
 	_device->getVkBindings().vkCmdDrawIndexedIndirect(getVkHandle(), buffer->getVkHandle(), offset, count, stride);
 }
 
 void CommandBufferBase_::drawIndirect(const Buffer& buffer, uint32_t offset, uint32_t count, uint32_t stride)
 {
-	_objectReferences.push_back(buffer);
+	addObjectReference(buffer);
 	_device->getVkBindings().vkCmdDrawIndirect(getVkHandle(), buffer->getVkHandle(), offset, count, stride);
 }
 
@@ -731,7 +730,7 @@ void CommandBufferBase_::dispatchIndirect(Buffer& buffer, uint32_t offset)
 
 void CommandBufferBase_::resetQueryPool(QueryPool& queryPool, uint32_t firstQuery, uint32_t queryCount)
 {
-	_objectReferences.push_back(queryPool);
+	addObjectReference(queryPool);
 	debug_assertion(firstQuery + queryCount <= queryPool->getNumQueries(), "Attempted to reset a query with index larger than the number of queries available to the QueryPool");
 
 	_device->getVkBindings().vkCmdResetQueryPool(getVkHandle(), queryPool->getVkHandle(), firstQuery, queryCount);
@@ -739,7 +738,7 @@ void CommandBufferBase_::resetQueryPool(QueryPool& queryPool, uint32_t firstQuer
 
 void CommandBufferBase_::resetQueryPool(QueryPool& queryPool, uint32_t queryIndex)
 {
-	_objectReferences.push_back(queryPool);
+	addObjectReference(queryPool);
 	resetQueryPool(queryPool, queryIndex, 1);
 }
 
@@ -749,7 +748,7 @@ void CommandBufferBase_::beginQuery(QueryPool& queryPool, uint32_t queryIndex, Q
 	{
 		throw ErrorValidationFailedEXT("Attempted to begin a query with index larger than the number of queries available to the QueryPool");
 	}
-	_objectReferences.push_back(queryPool);
+	addObjectReference(queryPool);
 	_device->getVkBindings().vkCmdBeginQuery(getVkHandle(), queryPool->getVkHandle(), queryIndex, static_cast<VkQueryControlFlags>(flags));
 }
 
@@ -759,7 +758,7 @@ void CommandBufferBase_::endQuery(QueryPool& queryPool, uint32_t queryIndex)
 	{
 		throw ErrorValidationFailedEXT("Attempted to end a query with index larger than the number of queries available to the QueryPool");
 	}
-	_objectReferences.push_back(queryPool);
+	addObjectReference(queryPool);
 	_device->getVkBindings().vkCmdEndQuery(getVkHandle(), queryPool->getVkHandle(), queryIndex);
 }
 
@@ -770,7 +769,7 @@ void CommandBufferBase_::copyQueryPoolResults(
 	{
 		throw ErrorValidationFailedEXT("Attempted to copy query results with index larger than the number of queries available to the QueryPool");
 	}
-	_objectReferences.push_back(queryPool);
+	addObjectReference(queryPool);
 	_device->getVkBindings().vkCmdCopyQueryPoolResults(
 		getVkHandle(), queryPool->getVkHandle(), firstQuery, queryCount, dstBuffer->getVkHandle(), offset, stride, static_cast<VkQueryControlFlags>(flags));
 }
@@ -781,7 +780,7 @@ void CommandBufferBase_::writeTimestamp(QueryPool& queryPool, uint32_t queryInde
 	{
 		throw ErrorValidationFailedEXT("Attempted to write a timestamp for a with index larger than the number of queries available to the QueryPool");
 	}
-	_objectReferences.push_back(queryPool);
+	addObjectReference(queryPool);
 	_device->getVkBindings().vkCmdWriteTimestamp(getVkHandle(), static_cast<VkPipelineStageFlagBits>(pipelineStage), queryPool->getVkHandle(), queryIndex);
 }
 } // namespace impl
@@ -146,7 +146,7 @@ public:
 	{
 		if (!_lastBoundGraphicsPipe.isValid() || _lastBoundGraphicsPipe != pipeline)
 		{
-			_objectReferences.push_back(pipeline);
+			addObjectReference(pipeline);
 			_device->getVkBindings().vkCmdBindPipeline(getVkHandle(), static_cast<VkPipelineBindPoint>(PipelineBindPoint::e_GRAPHICS), pipeline->getVkHandle());
 			_lastBoundGraphicsPipe = pipeline;
 		}
@@ -159,7 +159,7 @@ public:
 		if (!_lastBoundComputePipe.isValid() || _lastBoundComputePipe != pipeline)
 		{
 			_lastBoundComputePipe = pipeline;
-			_objectReferences.push_back(pipeline);
+			addObjectReference(pipeline);
 			_device->getVkBindings().vkCmdBindPipeline(getVkHandle(), static_cast<VkPipelineBindPoint>(PipelineBindPoint::e_COMPUTE), pipeline->getVkHandle());
 		}
 	}
@@ -198,7 +198,7 @@ public:
 		VkBuffer native_buffers[static_cast<uint32_t>(FrameworkCaps::MaxVertexBindings)] = { VK_NULL_HANDLE };
 		for (uint32_t i = 0; i < bindingCount; ++i)
 		{
-			_objectReferences.push_back(buffers[i]);
+			addObjectReference(buffers[i]);
 			native_buffers[i] = buffers[i]->getVkHandle();
 		}
 
@@ -211,7 +211,7 @@ public:
 	/// <param name="bindingIndex">The index of the vertex input binding whose state is updated by the command.</param>
 	void bindVertexBuffer(const Buffer& buffer, uint32_t offset, uint16_t bindingIndex)
 	{
-		_objectReferences.push_back(buffer);
+		addObjectReference(buffer);
 		VkDeviceSize offs = offset;
 		_device->getVkBindings().vkCmdBindVertexBuffers(getVkHandle(), bindingIndex, 1, &buffer->getVkHandle(), &offs);
 	}
@@ -230,7 +230,7 @@ public:
 	/// <param name="indexType">IndexType</param>
 	void bindIndexBuffer(const Buffer& buffer, uint32_t offset, IndexType indexType)
 	{
-		_objectReferences.push_back(buffer);
+		addObjectReference(buffer);
 		_device->getVkBindings().vkCmdBindIndexBuffer(getVkHandle(), buffer->getVkHandle(), offset, static_cast<VkIndexType>(indexType));
 	}
 
@@ -263,7 +263,7 @@ public:
 	/// <param name="pipelineStageFlags">Specifies the src stage mask used to determine when the event is signaled.</param>
 	void setEvent(Event& event, PipelineStageFlags pipelineStageFlags = PipelineStageFlags::e_ALL_COMMANDS_BIT)
 	{
-		_objectReferences.push_back(event);
+		addObjectReference(event);
 		_device->getVkBindings().vkCmdSetEvent(getVkHandle(), event->getVkHandle(), static_cast<VkPipelineStageFlags>(pipelineStageFlags));
 	}
 
@@ -280,7 +280,9 @@ public:
 	/// <param name="resetFlags">Is a bitmask of CommandBufferResetFlagBits controlling the reset operation.</param>
 	void reset(CommandBufferResetFlags resetFlags)
 	{
+		// clear() keeps the capacity, so after the first few frames recording does not allocate to track references
 		_objectReferences.clear();
+		std::fill(_recentObjectReferences, _recentObjectReferences + NumRecentObjectReferences, nullptr);
 		_lastBoundComputePipe.reset();
 		_lastBoundGraphicsPipe.reset();
 
@@ -571,6 +573,28 @@ public:
 	/// <param name="data">An array of size bytes containing the new push constant values.</param>
 	void pushConstants(const PipelineLayout& pipelineLayout, ShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* data);
 
+	/// <summary>Sets whether the command buffer keeps references to the objects used by the commands recorded into it.
+	/// By default (true) every object used by a command (pipelines, descriptor sets, buffers, images, render passes, framebuffers etc.) is kept alive
+	/// until the command buffer is reset or re-recorded. If false, no references are taken while recording and the caller guarantees that all
+	/// objects used outlive the execution of the command buffer, which avoids the reference counting overhead when recording large numbers of commands.
+	/// Can only be changed while the command buffer is not recording.</summary>
+	/// <param name="retainObjectReferences">True to keep the objects used alive, false if the caller guarantees their lifetime.</param>
+	void setRetainObjectReferences(bool retainObjectReferences)
+	{
+		if (_isRecording)
+		{
+			throw ErrorValidationFailedEXT("Called CommandBuffer::setRetainObjectReferences while a recording was in progress");
+		}
+		_retainObjectReferences = retainObjectReferences;
+	}
+
+	/// <summary>Gets whether the command buffer keeps references to the objects used by the commands recorded into it.</summary>
+	/// <returns>True if references are kept, false if the caller guarantees the lifetime of the objects used.</returns>
+	bool getRetainObjectReferences() const
+	{
+		return _retainObjectReferences;
+	}
+
 	/// <summary>Const getter for the command pool used to allocate this command buffer.</summary>
 	/// <returns>The command pool used to allocate this command buffer.</returns>
 	const CommandPool& getCommandPool() const
@@ -591,12 +615,46 @@ protected:
 	{
 		_pool = pool;
 		_isRecording = false;
+		_retainObjectReferences = true;
+		std::fill(_recentObjectReferences, _recentObjectReferences + NumRecentObjectReferences, nullptr);
+	}
+
+	/// <summary>Keeps an object used by a recorded command alive until the command buffer is reset. Objects which were referenced recently are
+	/// only referenced once, so repeatedly using the same pipeline layouts, descriptor sets or buffers does not grow the list of references.</summary>
+	/// <param name="object">The object to keep a reference to.</param>
+	template<typename ObjectType>
+	void addObjectReference(const ObjectType& object)
+	{
+		if (!_retainObjectReferences)
+		{
+			return;
+		}
+		const void* pointee = object.get();
+		// A direct mapped cache of the most recently referenced objects. A collision only costs a redundant reference.
+		// The objects in the cache are referenced by _objectReferences, so their addresses cannot be reused while recording.
+		const void*& slot = _recentObjectReferences[(reinterpret_cast<uintptr_t>(pointee) >> 4) & (NumRecentObjectReferences - 1)];
+		if (slot != pointee)
+		{
+			slot = pointee;
+			_objectReferences.push_back(object);
+		}
 	}
 
 	/// <summary>Holds a list of references to the objects currently in use by this command buffer. This ensures that objects are kept alive through
 	/// reference counting until the command buffer is finished with them.</summary>
 	std::vector<EmbeddedRefCountedResource<void> /**/> _objectReferences;
 
+	enum
+	{
+		NumRecentObjectReferences = 64 //!< The size of the de-duplication cache of the object references. Must be a power of two.
+	};
+
+	/// <summary>The addresses of the objects most recently added to _objectReferences, used to avoid referencing the same objects repeatedly.</summary>
+	const void* _recentObjectReferences[NumRecentObjectReferences];
+
+	/// <summary>Specifies whether references are kept to the objects used by the recorded commands.</summary>
+	bool _retainObjectReferences;
+
 	/// <summary>The command pool from which this command buffer was allocated.</summary>
 	CommandPool _pool;
 
@@ -23,8 +23,14 @@ pvrvk::DescriptorSet DescriptorPool_::allocateDescriptorSet(const DescriptorSetL
 	return set;
 }
 
+void DescriptorPool_::reset()
+{
+	vkThrowIfFailed(_device->getVkBindings().vkResetDescriptorPool(_device->getVkHandle(), getVkHandle(), 0), "Reset Descriptor Pool failed");
+	++_resetCount;
+}
+
 DescriptorPool_::DescriptorPool_(const DeviceWeakPtr& device, const DescriptorPoolCreateInfo& createInfo)
-	: DeviceObjectHandle(device), DeviceObjectDebugMarker(DebugReportObjectTypeEXT::e_DESCRIPTOR_POOL_EXT)
+	: DeviceObjectHandle(device), DeviceObjectDebugMarker(DebugReportObjectTypeEXT::e_DESCRIPTOR_POOL_EXT), _resetCount(0)
 {
 	VkDescriptorPoolCreateInfo descPoolInfo;
 	descPoolInfo.sType = static_cast<VkStructureType>(StructureType::e_DESCRIPTOR_POOL_CREATE_INFO);
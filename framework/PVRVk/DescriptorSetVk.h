@@ -677,6 +677,18 @@ public:
 	/// <returns>Return DescriptorSet else null if fails.</returns>
 	DescriptorSet allocateDescriptorSet(const DescriptorSetLayout& layout);
 
+	/// <summary>Return all descriptor sets allocated from this pool to the pool at once. This is much cheaper than freeing the sets individually.
+	/// All descriptor sets allocated from the pool before the reset become invalid and must not be used (or be in use by the GPU) any more.
+	/// Their DescriptorSet objects may still be released afterwards; they will not attempt to free their (already recycled) handles.</summary>
+	void reset();
+
+	/// <summary>Get the number of times this pool has been reset.</summary>
+	/// <returns>The number of times this pool has been reset.</returns>
+	uint32_t getResetCount() const
+	{
+		return _resetCount;
+	}
+
 private:
 	DECLARE_NO_COPY_SEMANTICS(DescriptorPool_)
 	// Implementing EmbeddedRefCount
@@ -684,6 +696,8 @@ private:
 	friend class ::pvrvk::EmbeddedRefCount;
 	friend class ::pvrvk::impl::Device_;
 
+	uint32_t _resetCount;
+
 	void destroy();
 
 	~DescriptorPool_()
@@ -745,13 +759,14 @@ private:
 		_keepAlive.clear();
 		if (getVkHandle() != VK_NULL_HANDLE)
 		{
-			if (_descPool->getDevice().isValid())
+			// If the pool was reset after this set was allocated, the handle has already been returned to the pool
+			if (_descPool->getDevice().isValid() && _descPool->getResetCount() == _poolResetCount)
 			{
 				_device->getVkBindings().vkFreeDescriptorSets(_descPool->getDevice()->getVkHandle(), _descPool->getVkHandle(), 1, &getVkHandle());
 				_vkHandle = VK_NULL_HANDLE;
 				_descPool->getDevice().reset();
 			}
-			else
+			else if (!_descPool->getDevice().isValid())
 			{
 				reportDestroyedAfterDevice("DescriptorSet");
 			}
@@ -761,7 +776,8 @@ private:
 	}
 
 	DescriptorSet_(const DescriptorSetLayout& descSetLayout, const DescriptorPool& pool)
-		: DeviceObjectHandle(pool->getDevice()), DeviceObjectDebugMarker(pvrvk::DebugReportObjectTypeEXT::e_DESCRIPTOR_SET_EXT), _descSetLayout(descSetLayout), _descPool(pool)
+		: DeviceObjectHandle(pool->getDevice()), DeviceObjectDebugMarker(pvrvk::DebugReportObjectTypeEXT::e_DESCRIPTOR_SET_EXT), _descSetLayout(descSetLayout), _descPool(pool),
+		  _poolResetCount(pool->getResetCount())
 	{
 		VkDescriptorSetAllocateInfo allocInfo = {};
 		allocInfo.sType = static_cast<VkStructureType>(pvrvk::StructureType::e_DESCRIPTOR_SET_ALLOCATE_INFO);
@@ -788,6 +804,7 @@ private:
 	mutable std::vector<std::vector<RefCountedResource<void> /**/> /**/> _keepAlive;
 	DescriptorSetLayout _descSetLayout;
 	DescriptorPool _descPool;
+	uint32_t _poolResetCount;
 };
 
 } // namespace impl
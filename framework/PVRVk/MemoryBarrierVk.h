@@ -67,10 +67,15 @@ private:
 	Buffer buffer; //!< Handle to the buffer whose backing memory is affected by the barrier.
 	uint32_t offset; //!< Offset in bytes into the backing memory for buffer. This is relative to the base offset as bound to the buffer
 	uint32_t size; //!< Size in bytes of the affected area of backing memory for buffer, or VK_WHOLE_SIZE to use the range from offset to the end of the buffer.
+	uint32_t srcQueueFamilyIndex; //!< Source queue family for a queue family ownership transfer.
+	uint32_t dstQueueFamilyIndex; //!< Destination queue family for a queue family ownership transfer
 
 public:
 	/// <summary>Constructor, zero initialization</summary>
-	BufferMemoryBarrier() : srcAccessMask(pvrvk::AccessFlags(0)), dstAccessMask(pvrvk::AccessFlags(0)) {}
+	BufferMemoryBarrier()
+		: srcAccessMask(pvrvk::AccessFlags(0)), dstAccessMask(pvrvk::AccessFlags(0)), srcQueueFamilyIndex(static_cast<uint32_t>(-1)),
+		  dstQueueFamilyIndex(static_cast<uint32_t>(-1))
+	{}
 
 	/// <summary>Constructor, individual elementssummary>
 	/// <param name="srcAccessMask">Bitmask of pvrvk::AccessFlagBits specifying a source access mask.</param>
@@ -79,7 +84,22 @@ public:
 	/// <param name="offset">Offset in bytes into the backing memory for buffer. This is relative to the base offset as bound to the buffer</param>
 	/// <param name="size">Size in bytes of the affected area of backing memory for buffer, or VK_WHOLE_SIZE to use the range from offset to the end of the buffer.</param>
 	BufferMemoryBarrier(pvrvk::AccessFlags srcAccessMask, pvrvk::AccessFlags dstAccessMask, Buffer buffer, uint32_t offset, uint32_t size)
-		: srcAccessMask(srcAccessMask), dstAccessMask(dstAccessMask), buffer(buffer), offset(offset), size(size)
+		: srcAccessMask(srcAccessMask), dstAccessMask(dstAccessMask), buffer(buffer), offset(offset), size(size), srcQueueFamilyIndex(static_cast<uint32_t>(-1)),
+		  dstQueueFamilyIndex(static_cast<uint32_t>(-1))
+	{}
+
+	/// <summary>Constructor, individual elements, including a queue family ownership transfer</summary>
+	/// <param name="srcAccessMask">Bitmask of pvrvk::AccessFlagBits specifying a source access mask.</param>
+	/// <param name="dstAccessMask">Bitmask of pvrvk::AccessFlagBits specifying a destination access mask.</param>
+	/// <param name="buffer">Handle to the buffer whose backing memory is affected by the barrier.</param>
+	/// <param name="offset">Offset in bytes into the backing memory for buffer. This is relative to the base offset as bound to the buffer</param>
+	/// <param name="size">Size in bytes of the affected area of backing memory for buffer, or VK_WHOLE_SIZE to use the range from offset to the end of the buffer.</param>
+	/// <param name="srcQueueFamilyIndex">Source queue family for a queue family ownership transfer.</param>
+	/// <param name="dstQueueFamilyIndex">Destination queue family for a queue family ownership transfer</param>
+	BufferMemoryBarrier(pvrvk::AccessFlags srcAccessMask, pvrvk::AccessFlags dstAccessMask, Buffer buffer, uint32_t offset, uint32_t size, uint32_t srcQueueFamilyIndex,
+		uint32_t dstQueueFamilyIndex)
+		: srcAccessMask(srcAccessMask), dstAccessMask(dstAccessMask), buffer(buffer), offset(offset), size(size), srcQueueFamilyIndex(srcQueueFamilyIndex),
+		  dstQueueFamilyIndex(dstQueueFamilyIndex)
 	{}
 
 	/// <summary>Get srcAccessMask</summary>
@@ -149,6 +169,32 @@ public:
 	{
 		this->offset = offset;
 	}
+
+	/// <summary>Get the source queue family index for the buffer associated with the memory barrier</summary>
+	/// <returns>The source queue family index of the buffer associated with the memory barrier</returns>
+	inline uint32_t getSrcQueueFamilyIndex() const
+	{
+		return srcQueueFamilyIndex;
+	}
+	/// <summary>Set the source queue family index </summary>
+	/// <param name="srcQueueFamilyIndex">The source queue family index of the buffer associated with the memory barrier</param>
+	inline void setSrcQueueFamilyIndex(uint32_t srcQueueFamilyIndex)
+	{
+		this->srcQueueFamilyIndex = srcQueueFamilyIndex;
+	}
+
+	/// <summary>Get the destination queue family index for the buffer associated with the memory barrier</summary>
+	/// <returns>The destination queue family index of the buffer associated with the memory barrier</returns>
+	inline uint32_t getDstQueueFamilyIndex() const
+	{
+		return dstQueueFamilyIndex;
+	}
+	/// <summary>Set the destination queue family index </summary>
+	/// <param name="dstQueueFamilyIndex">The destination queue family index of the buffer associated with the memory barrier</param>
+	inline void setDstQueueFamilyIndex(uint32_t dstQueueFamilyIndex)
+	{
+		this->dstQueueFamilyIndex = dstQueueFamilyIndex;
+	}
 };
 
 /// <summary>A Image memory barrier used only for memory accesses involving a specific subresource range of the